@@ -0,0 +1,2789 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 2
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+/* Substitute the type names.  */
+#define YYSTYPE         YY_CPSL_CC_PARSERSTYPE
+/* Substitute the variable and function names.  */
+#define yyparse         yy_cpsl_cc_parserparse
+#define yylex           yy_cpsl_cc_parserlex
+#define yyerror         yy_cpsl_cc_parsererror
+#define yydebug         yy_cpsl_cc_parserdebug
+#define yynerrs         yy_cpsl_cc_parsernerrs
+
+/* First part of user prologue.  */
+#line 14 "src/parser.bison"
+
+#define yylex yy_cpsl_cc_parserlex
+#define yyparse yy_cpsl_cc_parserparse
+#define yyerror yy_cpsl_cc_parsererror
+#line 28 "src/parser.bison"
+
+#define YYLTYPE parser_yyltype_t
+#line 108 "src/parser.bison"
+
+#include <memory>      // std::shared_ptr
+#include <sstream>     // std::ostringstream
+#include <vector>      // std::vector
+
+#include "lexer.hh"    // comment_tag, Lexeme, whitespace_tag
+#include "grammar.hh"  // Grammar, GrammarError
+
+#include "parser.hh"
+#line 135 "src/parser.bison"
+
+#define pg parser_state->grammar
+
+#line 99 "_build/parser.yy.cc"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+
+/* Debug traces.  */
+#ifndef YY_CPSL_CC_PARSERDEBUG
+# if defined YYDEBUG
+#if YYDEBUG
+#   define YY_CPSL_CC_PARSERDEBUG 1
+#  else
+#   define YY_CPSL_CC_PARSERDEBUG 0
+#  endif
+# else /* ! defined YYDEBUG */
+#  define YY_CPSL_CC_PARSERDEBUG 1
+# endif /* ! defined YYDEBUG */
+#endif  /* ! defined YY_CPSL_CC_PARSERDEBUG */
+#if YY_CPSL_CC_PARSERDEBUG
+extern int yy_cpsl_cc_parserdebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YY_CPSL_CC_PARSERTOKENTYPE
+# define YY_CPSL_CC_PARSERTOKENTYPE
+  enum yy_cpsl_cc_parsertokentype
+  {
+    YY_CPSL_CC_PARSEREMPTY = -2,
+    YY_CPSL_CC_PARSEREOF = 0,      /* "end of file"  */
+    YY_CPSL_CC_PARSERerror = 256,  /* error  */
+    YY_CPSL_CC_PARSERUNDEF = 257,  /* "invalid token"  */
+    IDENTIFIER = 2,                /* IDENTIFIER  */
+    INTEGER = 4,                   /* INTEGER  */
+    CHAR = 5,                      /* CHAR  */
+    STRING = 6,                    /* STRING  */
+    COMMENT = 7,                   /* COMMENT  */
+    WHITESPACE = 8,                /* WHITESPACE  */
+    ARRAY_KEYWORD = 10,            /* ARRAY_KEYWORD  */
+    BEGIN_KEYWORD = 11,            /* BEGIN_KEYWORD  */
+    CHR_KEYWORD = 12,              /* CHR_KEYWORD  */
+    CONST_KEYWORD = 13,            /* CONST_KEYWORD  */
+    DO_KEYWORD = 14,               /* DO_KEYWORD  */
+    DOWNTO_KEYWORD = 15,           /* DOWNTO_KEYWORD  */
+    ELSE_KEYWORD = 16,             /* ELSE_KEYWORD  */
+    ELSEIF_KEYWORD = 17,           /* ELSEIF_KEYWORD  */
+    END_KEYWORD = 18,              /* END_KEYWORD  */
+    FOR_KEYWORD = 19,              /* FOR_KEYWORD  */
+    FORWARD_KEYWORD = 20,          /* FORWARD_KEYWORD  */
+    FUNCTION_KEYWORD = 21,         /* FUNCTION_KEYWORD  */
+    IF_KEYWORD = 22,               /* IF_KEYWORD  */
+    OF_KEYWORD = 23,               /* OF_KEYWORD  */
+    ORD_KEYWORD = 24,              /* ORD_KEYWORD  */
+    PRED_KEYWORD = 25,             /* PRED_KEYWORD  */
+    PROCEDURE_KEYWORD = 26,        /* PROCEDURE_KEYWORD  */
+    READ_KEYWORD = 27,             /* READ_KEYWORD  */
+    RECORD_KEYWORD = 28,           /* RECORD_KEYWORD  */
+    REF_KEYWORD = 29,              /* REF_KEYWORD  */
+    REPEAT_KEYWORD = 30,           /* REPEAT_KEYWORD  */
+    RETURN_KEYWORD = 31,           /* RETURN_KEYWORD  */
+    STOP_KEYWORD = 32,             /* STOP_KEYWORD  */
+    SUCC_KEYWORD = 33,             /* SUCC_KEYWORD  */
+    THEN_KEYWORD = 34,             /* THEN_KEYWORD  */
+    TO_KEYWORD = 35,               /* TO_KEYWORD  */
+    TYPE_KEYWORD = 36,             /* TYPE_KEYWORD  */
+    UNTIL_KEYWORD = 37,            /* UNTIL_KEYWORD  */
+    VAR_KEYWORD = 38,              /* VAR_KEYWORD  */
+    WHILE_KEYWORD = 39,            /* WHILE_KEYWORD  */
+    WRITE_KEYWORD = 40,            /* WRITE_KEYWORD  */
+    PLUS_OPERATOR = 42,            /* PLUS_OPERATOR  */
+    MINUS_OPERATOR = 43,           /* MINUS_OPERATOR  */
+    TIMES_OPERATOR = 44,           /* TIMES_OPERATOR  */
+    SLASH_OPERATOR = 45,           /* SLASH_OPERATOR  */
+    AMPERSAND_OPERATOR = 46,       /* AMPERSAND_OPERATOR  */
+    PIPE_OPERATOR = 47,            /* PIPE_OPERATOR  */
+    TILDE_OPERATOR = 48,           /* TILDE_OPERATOR  */
+    EQUALS_OPERATOR = 49,          /* EQUALS_OPERATOR  */
+    LT_OR_GT_OPERATOR = 50,        /* LT_OR_GT_OPERATOR  */
+    LT_OPERATOR = 51,              /* LT_OPERATOR  */
+    LE_OPERATOR = 52,              /* LE_OPERATOR  */
+    GT_OPERATOR = 53,              /* GT_OPERATOR  */
+    GE_OPERATOR = 54,              /* GE_OPERATOR  */
+    DOT_OPERATOR = 55,             /* DOT_OPERATOR  */
+    COMMA_OPERATOR = 56,           /* COMMA_OPERATOR  */
+    COLON_OPERATOR = 57,           /* COLON_OPERATOR  */
+    SEMICOLON_OPERATOR = 58,       /* SEMICOLON_OPERATOR  */
+    LEFTPARENTHESIS_OPERATOR = 59, /* LEFTPARENTHESIS_OPERATOR  */
+    RIGHTPARENTHESIS_OPERATOR = 60, /* RIGHTPARENTHESIS_OPERATOR  */
+    LEFTBRACKET_OPERATOR = 61,     /* LEFTBRACKET_OPERATOR  */
+    RIGHTBRACKET_OPERATOR = 62,    /* RIGHTBRACKET_OPERATOR  */
+    COLONEQUALS_OPERATOR = 63,     /* COLONEQUALS_OPERATOR  */
+    PERCENT_OPERATOR = 64,         /* PERCENT_OPERATOR  */
+    UNARY_MINUS = 258              /* UNARY_MINUS  */
+  };
+  typedef enum yy_cpsl_cc_parsertokentype yy_cpsl_cc_parsertoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YY_CPSL_CC_PARSERSTYPE && ! defined YY_CPSL_CC_PARSERSTYPE_IS_DECLARED
+typedef parser_yystype_t YY_CPSL_CC_PARSERSTYPE;
+# define YY_CPSL_CC_PARSERSTYPE_IS_TRIVIAL 1
+# define YY_CPSL_CC_PARSERSTYPE_IS_DECLARED 1
+#endif
+
+
+
+
+int yy_cpsl_cc_parserparse (std::shared_ptr<ParserState> parser_state);
+
+
+
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_IDENTIFIER = 3,                 /* IDENTIFIER  */
+  YYSYMBOL_INTEGER = 4,                    /* INTEGER  */
+  YYSYMBOL_CHAR = 5,                       /* CHAR  */
+  YYSYMBOL_STRING = 6,                     /* STRING  */
+  YYSYMBOL_COMMENT = 7,                    /* COMMENT  */
+  YYSYMBOL_WHITESPACE = 8,                 /* WHITESPACE  */
+  YYSYMBOL_ARRAY_KEYWORD = 9,              /* ARRAY_KEYWORD  */
+  YYSYMBOL_BEGIN_KEYWORD = 10,             /* BEGIN_KEYWORD  */
+  YYSYMBOL_CHR_KEYWORD = 11,               /* CHR_KEYWORD  */
+  YYSYMBOL_CONST_KEYWORD = 12,             /* CONST_KEYWORD  */
+  YYSYMBOL_DO_KEYWORD = 13,                /* DO_KEYWORD  */
+  YYSYMBOL_DOWNTO_KEYWORD = 14,            /* DOWNTO_KEYWORD  */
+  YYSYMBOL_ELSE_KEYWORD = 15,              /* ELSE_KEYWORD  */
+  YYSYMBOL_ELSEIF_KEYWORD = 16,            /* ELSEIF_KEYWORD  */
+  YYSYMBOL_END_KEYWORD = 17,               /* END_KEYWORD  */
+  YYSYMBOL_FOR_KEYWORD = 18,               /* FOR_KEYWORD  */
+  YYSYMBOL_FORWARD_KEYWORD = 19,           /* FORWARD_KEYWORD  */
+  YYSYMBOL_FUNCTION_KEYWORD = 20,          /* FUNCTION_KEYWORD  */
+  YYSYMBOL_IF_KEYWORD = 21,                /* IF_KEYWORD  */
+  YYSYMBOL_OF_KEYWORD = 22,                /* OF_KEYWORD  */
+  YYSYMBOL_ORD_KEYWORD = 23,               /* ORD_KEYWORD  */
+  YYSYMBOL_PRED_KEYWORD = 24,              /* PRED_KEYWORD  */
+  YYSYMBOL_PROCEDURE_KEYWORD = 25,         /* PROCEDURE_KEYWORD  */
+  YYSYMBOL_READ_KEYWORD = 26,              /* READ_KEYWORD  */
+  YYSYMBOL_RECORD_KEYWORD = 27,            /* RECORD_KEYWORD  */
+  YYSYMBOL_REF_KEYWORD = 28,               /* REF_KEYWORD  */
+  YYSYMBOL_REPEAT_KEYWORD = 29,            /* REPEAT_KEYWORD  */
+  YYSYMBOL_RETURN_KEYWORD = 30,            /* RETURN_KEYWORD  */
+  YYSYMBOL_STOP_KEYWORD = 31,              /* STOP_KEYWORD  */
+  YYSYMBOL_SUCC_KEYWORD = 32,              /* SUCC_KEYWORD  */
+  YYSYMBOL_THEN_KEYWORD = 33,              /* THEN_KEYWORD  */
+  YYSYMBOL_TO_KEYWORD = 34,                /* TO_KEYWORD  */
+  YYSYMBOL_TYPE_KEYWORD = 35,              /* TYPE_KEYWORD  */
+  YYSYMBOL_UNTIL_KEYWORD = 36,             /* UNTIL_KEYWORD  */
+  YYSYMBOL_VAR_KEYWORD = 37,               /* VAR_KEYWORD  */
+  YYSYMBOL_WHILE_KEYWORD = 38,             /* WHILE_KEYWORD  */
+  YYSYMBOL_WRITE_KEYWORD = 39,             /* WRITE_KEYWORD  */
+  YYSYMBOL_PLUS_OPERATOR = 40,             /* PLUS_OPERATOR  */
+  YYSYMBOL_MINUS_OPERATOR = 41,            /* MINUS_OPERATOR  */
+  YYSYMBOL_TIMES_OPERATOR = 42,            /* TIMES_OPERATOR  */
+  YYSYMBOL_SLASH_OPERATOR = 43,            /* SLASH_OPERATOR  */
+  YYSYMBOL_AMPERSAND_OPERATOR = 44,        /* AMPERSAND_OPERATOR  */
+  YYSYMBOL_PIPE_OPERATOR = 45,             /* PIPE_OPERATOR  */
+  YYSYMBOL_TILDE_OPERATOR = 46,            /* TILDE_OPERATOR  */
+  YYSYMBOL_EQUALS_OPERATOR = 47,           /* EQUALS_OPERATOR  */
+  YYSYMBOL_LT_OR_GT_OPERATOR = 48,         /* LT_OR_GT_OPERATOR  */
+  YYSYMBOL_LT_OPERATOR = 49,               /* LT_OPERATOR  */
+  YYSYMBOL_LE_OPERATOR = 50,               /* LE_OPERATOR  */
+  YYSYMBOL_GT_OPERATOR = 51,               /* GT_OPERATOR  */
+  YYSYMBOL_GE_OPERATOR = 52,               /* GE_OPERATOR  */
+  YYSYMBOL_DOT_OPERATOR = 53,              /* DOT_OPERATOR  */
+  YYSYMBOL_COMMA_OPERATOR = 54,            /* COMMA_OPERATOR  */
+  YYSYMBOL_COLON_OPERATOR = 55,            /* COLON_OPERATOR  */
+  YYSYMBOL_SEMICOLON_OPERATOR = 56,        /* SEMICOLON_OPERATOR  */
+  YYSYMBOL_LEFTPARENTHESIS_OPERATOR = 57,  /* LEFTPARENTHESIS_OPERATOR  */
+  YYSYMBOL_RIGHTPARENTHESIS_OPERATOR = 58, /* RIGHTPARENTHESIS_OPERATOR  */
+  YYSYMBOL_LEFTBRACKET_OPERATOR = 59,      /* LEFTBRACKET_OPERATOR  */
+  YYSYMBOL_RIGHTBRACKET_OPERATOR = 60,     /* RIGHTBRACKET_OPERATOR  */
+  YYSYMBOL_COLONEQUALS_OPERATOR = 61,      /* COLONEQUALS_OPERATOR  */
+  YYSYMBOL_PERCENT_OPERATOR = 62,          /* PERCENT_OPERATOR  */
+  YYSYMBOL_UNARY_MINUS = 63,               /* UNARY_MINUS  */
+  YYSYMBOL_YYACCEPT = 64,                  /* $accept  */
+  YYSYMBOL_start = 65,                     /* start  */
+  YYSYMBOL_program = 66,                   /* program  */
+  YYSYMBOL_constant_decl_opt = 67,         /* constant_decl_opt  */
+  YYSYMBOL_type_decl_opt = 68,             /* type_decl_opt  */
+  YYSYMBOL_var_decl_opt = 69,              /* var_decl_opt  */
+  YYSYMBOL_procedure_decl_or_function_decl_list = 70, /* procedure_decl_or_function_decl_list  */
+  YYSYMBOL_procedure_decl_or_function_decl = 71, /* procedure_decl_or_function_decl  */
+  YYSYMBOL_constant_decl = 72,             /* constant_decl  */
+  YYSYMBOL_constant_assignment_list = 73,  /* constant_assignment_list  */
+  YYSYMBOL_constant_assignment = 74,       /* constant_assignment  */
+  YYSYMBOL_procedure_decl = 75,            /* procedure_decl  */
+  YYSYMBOL_function_decl = 76,             /* function_decl  */
+  YYSYMBOL_formal_parameters = 77,         /* formal_parameters  */
+  YYSYMBOL_formal_parameter_prefixed_list = 78, /* formal_parameter_prefixed_list  */
+  YYSYMBOL_formal_parameter = 79,          /* formal_parameter  */
+  YYSYMBOL_var_or_ref = 80,                /* var_or_ref  */
+  YYSYMBOL_body = 81,                      /* body  */
+  YYSYMBOL_block = 82,                     /* block  */
+  YYSYMBOL_type_decl = 83,                 /* type_decl  */
+  YYSYMBOL_type_assignment_list = 84,      /* type_assignment_list  */
+  YYSYMBOL_type_assignment = 85,           /* type_assignment  */
+  YYSYMBOL_type = 86,                      /* type  */
+  YYSYMBOL_simple_type = 87,               /* simple_type  */
+  YYSYMBOL_record_type = 88,               /* record_type  */
+  YYSYMBOL_typed_identifier_sequence_list = 89, /* typed_identifier_sequence_list  */
+  YYSYMBOL_typed_identifier_sequence = 90, /* typed_identifier_sequence  */
+  YYSYMBOL_array_type = 91,                /* array_type  */
+  YYSYMBOL_ident_list = 92,                /* ident_list  */
+  YYSYMBOL_identifier_prefixed_list = 93,  /* identifier_prefixed_list  */
+  YYSYMBOL_var_decl = 94,                  /* var_decl  */
+  YYSYMBOL_statement_sequence = 95,        /* statement_sequence  */
+  YYSYMBOL_statement_prefixed_list = 96,   /* statement_prefixed_list  */
+  YYSYMBOL_statement = 97,                 /* statement  */
+  YYSYMBOL_assignment = 98,                /* assignment  */
+  YYSYMBOL_if_statement = 99,              /* if_statement  */
+  YYSYMBOL_elseif_clause_list = 100,       /* elseif_clause_list  */
+  YYSYMBOL_elseif_clause = 101,            /* elseif_clause  */
+  YYSYMBOL_else_clause_opt = 102,          /* else_clause_opt  */
+  YYSYMBOL_else_clause = 103,              /* else_clause  */
+  YYSYMBOL_while_statement = 104,          /* while_statement  */
+  YYSYMBOL_repeat_statement = 105,         /* repeat_statement  */
+  YYSYMBOL_for_statement = 106,            /* for_statement  */
+  YYSYMBOL_to_or_downto = 107,             /* to_or_downto  */
+  YYSYMBOL_stop_statement = 108,           /* stop_statement  */
+  YYSYMBOL_return_statement = 109,         /* return_statement  */
+  YYSYMBOL_expression_opt = 110,           /* expression_opt  */
+  YYSYMBOL_read_statement = 111,           /* read_statement  */
+  YYSYMBOL_lvalue_sequence = 112,          /* lvalue_sequence  */
+  YYSYMBOL_lvalue_prefixed_list = 113,     /* lvalue_prefixed_list  */
+  YYSYMBOL_write_statement = 114,          /* write_statement  */
+  YYSYMBOL_expression_sequence = 115,      /* expression_sequence  */
+  YYSYMBOL_expression_prefixed_list = 116, /* expression_prefixed_list  */
+  YYSYMBOL_procedure_call = 117,           /* procedure_call  */
+  YYSYMBOL_expression_sequence_opt = 118,  /* expression_sequence_opt  */
+  YYSYMBOL_null_statement = 119,           /* null_statement  */
+  YYSYMBOL_expression = 120,               /* expression  */
+  YYSYMBOL_lvalue = 121,                   /* lvalue  */
+  YYSYMBOL_lvalue_accessor_clause_list = 122, /* lvalue_accessor_clause_list  */
+  YYSYMBOL_lvalue_accessor_clause = 123    /* lvalue_accessor_clause  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if 1
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* 1 */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YY_CPSL_CC_PARSERSTYPE_IS_TRIVIAL && YY_CPSL_CC_PARSERSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  8
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   523
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  64
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  60
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  121
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  241
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   258
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     3,     2,     4,     5,     6,     7,     8,     2,
+       9,    10,    11,    12,    13,    14,    15,    16,    17,    18,
+      19,    20,    21,    22,    23,    24,    25,    26,    27,    28,
+      29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      39,     2,    40,    41,    42,    43,    44,    45,    46,    47,
+      48,    49,    50,    51,    52,    53,    54,    55,    56,    57,
+      58,    59,    60,    61,    62,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,    63
+};
+
+#if YY_CPSL_CC_PARSERDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,   208,   208,   214,   218,   219,   223,   224,   228,   229,
+     233,   234,   238,   239,   245,   249,   250,   254,   258,   259,
+     263,   264,   272,   273,   277,   278,   282,   286,   287,   288,
+     292,   296,   300,   304,   305,   309,   313,   314,   315,   319,
+     323,   327,   328,   332,   336,   344,   348,   349,   353,   359,
+     363,   364,   368,   369,   370,   371,   372,   373,   374,   375,
+     376,   377,   378,   382,   386,   390,   391,   395,   399,   400,
+     404,   408,   412,   416,   420,   421,   425,   429,   433,   434,
+     438,   442,   446,   447,   451,   455,   459,   460,   464,   468,
+     469,   473,   485,   486,   487,   488,   489,   490,   491,   492,
+     493,   494,   495,   496,   497,   498,   499,   500,   501,   502,
+     503,   504,   505,   506,   507,   508,   509,   513,   517,   518,
+     522,   523
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  static const char *const yy_sname[] =
+  {
+  "end of file", "error", "invalid token", "IDENTIFIER", "INTEGER",
+  "CHAR", "STRING", "COMMENT", "WHITESPACE", "ARRAY_KEYWORD",
+  "BEGIN_KEYWORD", "CHR_KEYWORD", "CONST_KEYWORD", "DO_KEYWORD",
+  "DOWNTO_KEYWORD", "ELSE_KEYWORD", "ELSEIF_KEYWORD", "END_KEYWORD",
+  "FOR_KEYWORD", "FORWARD_KEYWORD", "FUNCTION_KEYWORD", "IF_KEYWORD",
+  "OF_KEYWORD", "ORD_KEYWORD", "PRED_KEYWORD", "PROCEDURE_KEYWORD",
+  "READ_KEYWORD", "RECORD_KEYWORD", "REF_KEYWORD", "REPEAT_KEYWORD",
+  "RETURN_KEYWORD", "STOP_KEYWORD", "SUCC_KEYWORD", "THEN_KEYWORD",
+  "TO_KEYWORD", "TYPE_KEYWORD", "UNTIL_KEYWORD", "VAR_KEYWORD",
+  "WHILE_KEYWORD", "WRITE_KEYWORD", "PLUS_OPERATOR", "MINUS_OPERATOR",
+  "TIMES_OPERATOR", "SLASH_OPERATOR", "AMPERSAND_OPERATOR",
+  "PIPE_OPERATOR", "TILDE_OPERATOR", "EQUALS_OPERATOR",
+  "LT_OR_GT_OPERATOR", "LT_OPERATOR", "LE_OPERATOR", "GT_OPERATOR",
+  "GE_OPERATOR", "DOT_OPERATOR", "COMMA_OPERATOR", "COLON_OPERATOR",
+  "SEMICOLON_OPERATOR", "LEFTPARENTHESIS_OPERATOR",
+  "RIGHTPARENTHESIS_OPERATOR", "LEFTBRACKET_OPERATOR",
+  "RIGHTBRACKET_OPERATOR", "COLONEQUALS_OPERATOR", "PERCENT_OPERATOR",
+  "UNARY_MINUS", "$accept", "start", "program", "constant_decl_opt",
+  "type_decl_opt", "var_decl_opt", "procedure_decl_or_function_decl_list",
+  "procedure_decl_or_function_decl", "constant_decl",
+  "constant_assignment_list", "constant_assignment", "procedure_decl",
+  "function_decl", "formal_parameters", "formal_parameter_prefixed_list",
+  "formal_parameter", "var_or_ref", "body", "block", "type_decl",
+  "type_assignment_list", "type_assignment", "type", "simple_type",
+  "record_type", "typed_identifier_sequence_list",
+  "typed_identifier_sequence", "array_type", "ident_list",
+  "identifier_prefixed_list", "var_decl", "statement_sequence",
+  "statement_prefixed_list", "statement", "assignment", "if_statement",
+  "elseif_clause_list", "elseif_clause", "else_clause_opt", "else_clause",
+  "while_statement", "repeat_statement", "for_statement", "to_or_downto",
+  "stop_statement", "return_statement", "expression_opt", "read_statement",
+  "lvalue_sequence", "lvalue_prefixed_list", "write_statement",
+  "expression_sequence", "expression_prefixed_list", "procedure_call",
+  "expression_sequence_opt", "null_statement", "expression", "lvalue",
+  "lvalue_accessor_clause_list", "lvalue_accessor_clause", YY_NULLPTR
+  };
+  return yy_sname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-113)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-30)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+      -6,     5,    10,  -113,   -10,  -113,   -19,  -113,  -113,    60,
+      20,  -113,    47,     5,    18,  -113,    75,  -113,  -113,    23,
+    -113,  -113,  -113,    24,    25,    26,    27,    47,    47,    47,
+     245,  -113,  -113,     0,    60,  -113,  -113,    32,    44,    47,
+       3,    47,    47,    47,    47,  -113,   -29,   268,    47,    47,
+      47,    47,    47,    47,    47,    47,    47,    47,    47,    47,
+    -113,    47,  -113,    30,  -113,    34,  -113,  -113,  -113,  -113,
+      37,    75,     0,    92,    83,    91,  -113,  -113,  -113,    43,
+    -113,    39,   445,    96,    47,  -113,   291,   314,   337,   360,
+    -113,   -38,   -38,  -113,  -113,   -29,   461,   -29,   -29,   -29,
+     -29,   -29,   -29,  -113,    47,    58,  -113,    99,  -113,    51,
+      52,   109,    47,    57,    92,    47,  -113,    47,    59,    98,
+    -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,
+    -113,  -113,    56,    62,    67,  -113,  -113,    71,  -113,   383,
+    -113,  -113,  -113,  -113,   406,  -113,  -113,  -113,    47,    65,
+     206,   124,    93,  -113,   445,   127,    47,  -113,    72,    47,
+      31,    31,    47,  -113,    47,    74,    47,    92,  -113,    76,
+    -113,    47,    92,    80,    92,   445,  -113,  -113,    81,  -113,
+      75,    84,   445,   422,  -113,   183,  -113,  -113,    87,   445,
+     126,  -113,  -113,    90,    95,    94,    97,   133,  -113,  -113,
+      47,    61,   124,  -113,     0,    -2,     0,    54,     0,   160,
+      92,    47,  -113,   129,  -113,  -113,   100,  -113,  -113,   102,
+     -10,   104,  -113,    92,  -113,   229,  -113,    55,  -113,    20,
+    -113,   131,    92,   105,   106,   153,  -113,  -113,  -113,  -113,
+    -113
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       4,     0,     0,     2,     6,     5,     0,    15,     1,     0,
+       8,     7,     0,    14,     0,    33,     0,    10,     9,   118,
+     114,   115,   116,     0,     0,     0,     0,     0,     0,     0,
+       0,   113,    16,     0,    32,    46,    41,     0,     0,    89,
+     117,     0,     0,     0,     0,   106,   105,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+      17,     0,    39,     0,    41,     0,    36,    37,    38,    34,
+      45,    48,     0,    91,     0,     0,    11,    12,    13,     0,
+      90,     0,    86,     0,     0,   119,     0,     0,     0,     0,
+     107,   100,   101,   102,   103,    93,    92,    94,    95,    98,
+      96,    99,    97,   104,     0,     0,    35,     0,    42,     0,
+     118,     0,     0,     0,    91,    78,    76,     0,     0,     0,
+      50,    52,    53,    54,    55,    56,    57,    58,    59,    60,
+      61,    62,     0,     0,     0,     3,   108,    85,   120,     0,
+     109,   110,   111,   112,     0,    40,    47,    43,    89,     0,
+       0,     0,     0,    77,    79,     0,     0,    31,    49,     0,
+      22,    22,     0,   121,     0,     0,     0,    91,   118,     0,
+      82,     0,    91,     0,    91,    63,    28,    27,     0,    24,
+       0,     0,    87,     0,    88,     0,    65,    80,    81,    72,
+       0,    84,    51,     0,    23,     0,     0,     0,    75,    74,
+       0,    68,     0,    71,     0,    29,     0,     4,     0,     0,
+      91,     0,    66,     0,    69,    83,     0,    25,    26,     0,
+       6,     0,    44,    91,    70,     0,    64,     4,    18,     8,
+      19,     0,    91,     0,     0,     0,    73,    67,    20,    21,
+      30
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -113,  -113,  -113,   164,   -55,   -49,  -113,  -113,  -113,  -113,
+     168,  -113,  -113,    21,  -113,   -22,  -113,   -43,   -50,  -113,
+    -113,   152,   -71,  -113,  -113,   123,   174,  -113,    11,  -113,
+    -113,  -112,  -113,    19,  -113,  -113,  -113,  -113,  -113,  -113,
+    -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,
+    -113,    36,  -113,  -113,    46,  -113,   -12,   -66,  -113,  -113
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
+{
+       0,     2,     3,   220,    10,    17,    38,    76,     5,    13,
+       7,    77,    78,   178,   194,   179,   180,   221,    79,    11,
+      34,    15,    65,    66,    67,    71,   108,    68,    37,    70,
+      18,   119,   158,   120,   121,   122,   201,   212,   213,   214,
+     123,   124,   125,   200,   126,   127,   153,   128,   169,   188,
+     129,    80,   137,   130,    81,   131,    82,    31,    40,    85
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+      30,   109,   152,    62,    50,    51,     1,   132,     6,    63,
+       8,    48,    49,    50,    51,    45,    46,    47,    54,    55,
+      56,    57,    58,    59,    61,     9,   176,    64,    12,    86,
+      87,    88,    89,    61,   -29,   177,    91,    92,    93,    94,
+      95,    96,    97,    98,    99,   100,   101,   102,   132,   103,
+      19,    20,    21,    22,    73,   186,    83,    16,    23,   176,
+     190,    35,    84,    14,    74,    33,     1,     1,   177,    75,
+      24,    25,   139,   219,   233,   145,   210,   211,    35,    26,
+      39,    41,    42,    43,    44,   170,   133,    72,    27,   104,
+     106,   107,   144,    28,   134,   110,   135,   136,   224,   138,
+     150,   132,   146,   154,    29,   155,   132,   147,   132,   148,
+     111,   231,   149,   112,   151,   157,   156,   159,   113,   160,
+     237,   114,   115,   116,   161,   162,   166,   168,   174,   171,
+     117,   118,   184,   216,   187,   218,   215,   222,   191,   193,
+     172,   202,   196,   203,   132,   204,   226,   175,   236,   206,
+     182,   205,   183,   207,   185,   208,   227,   132,   228,   189,
+     230,   238,   239,    73,     4,   229,   132,    48,    49,    50,
+      51,    52,    53,   223,    54,    55,    56,    57,    58,    59,
+     235,    32,   181,   217,   234,   240,    69,   105,   209,    61,
+      36,   195,   173,   192,   165,     0,     0,   198,     0,   225,
+      48,    49,    50,    51,    52,    53,     0,    54,    55,    56,
+      57,    58,    59,     0,     0,     0,     0,   199,     0,     0,
+       0,     0,    61,    48,    49,    50,    51,    52,    53,     0,
+      54,    55,    56,    57,    58,    59,     0,     0,     0,   167,
+       0,     0,     0,     0,     0,    61,    48,    49,    50,    51,
+      52,    53,     0,    54,    55,    56,    57,    58,    59,     0,
+       0,     0,   232,     0,     0,     0,     0,     0,    61,    48,
+      49,    50,    51,    52,    53,     0,    54,    55,    56,    57,
+      58,    59,     0,     0,     0,    48,    49,    50,    51,    52,
+      53,    61,    54,    55,    56,    57,    58,    59,     0,     0,
+       0,    60,     0,     0,     0,     0,     0,    61,    48,    49,
+      50,    51,    52,    53,     0,    54,    55,    56,    57,    58,
+      59,     0,     0,     0,     0,     0,    90,     0,     0,     0,
+      61,    48,    49,    50,    51,    52,    53,     0,    54,    55,
+      56,    57,    58,    59,     0,     0,     0,     0,     0,   140,
+       0,     0,     0,    61,    48,    49,    50,    51,    52,    53,
+       0,    54,    55,    56,    57,    58,    59,     0,     0,     0,
+       0,     0,   141,     0,     0,     0,    61,    48,    49,    50,
+      51,    52,    53,     0,    54,    55,    56,    57,    58,    59,
+       0,     0,     0,     0,     0,   142,     0,     0,     0,    61,
+      48,    49,    50,    51,    52,    53,     0,    54,    55,    56,
+      57,    58,    59,     0,     0,     0,     0,     0,   143,     0,
+       0,     0,    61,    48,    49,    50,    51,    52,    53,     0,
+      54,    55,    56,    57,    58,    59,     0,     0,     0,     0,
+       0,     0,     0,   163,     0,    61,    48,    49,    50,    51,
+      52,    53,     0,    54,    55,    56,    57,    58,    59,     0,
+       0,   164,    48,    49,    50,    51,    52,    53,    61,    54,
+      55,    56,    57,    58,    59,     0,     0,     0,     0,     0,
+       0,     0,   197,     0,    61,    48,    49,    50,    51,    52,
+      53,     0,    54,    55,    56,    57,    58,    59,     0,     0,
+       0,    48,    49,    50,    51,    52,     0,    61,    54,    55,
+      56,    57,    58,    59,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,    61
+};
+
+static const yytype_int16 yycheck[] =
+{
+      12,    72,   114,     3,    42,    43,    12,    73,     3,     9,
+       0,    40,    41,    42,    43,    27,    28,    29,    47,    48,
+      49,    50,    51,    52,    62,    35,    28,    27,    47,    41,
+      42,    43,    44,    62,     3,    37,    48,    49,    50,    51,
+      52,    53,    54,    55,    56,    57,    58,    59,   114,    61,
+       3,     4,     5,     6,    10,   167,    53,    37,    11,    28,
+     172,     3,    59,     3,    20,    47,    12,    12,    37,    25,
+      23,    24,    84,    19,    19,    17,    15,    16,     3,    32,
+      57,    57,    57,    57,    57,   151,     3,    55,    41,    59,
+      56,    54,   104,    46,     3,     3,    53,    58,   210,     3,
+     112,   167,     3,   115,    57,   117,   172,    56,   174,    57,
+      18,   223,     3,    21,    57,    17,    57,    61,    26,    57,
+     232,    29,    30,    31,    57,    54,    61,     3,    56,    36,
+      38,    39,    58,   204,    58,   206,   202,   208,    58,    58,
+      13,    54,    58,    17,   210,    55,    17,   159,    17,    55,
+     162,    56,   164,    56,   166,    22,    56,   223,    56,   171,
+      56,    56,    56,    10,     0,   220,   232,    40,    41,    42,
+      43,    44,    45,    13,    47,    48,    49,    50,    51,    52,
+     229,    13,   161,   205,   227,   235,    34,    64,   200,    62,
+      16,   180,   156,   174,   148,    -1,    -1,    14,    -1,   211,
+      40,    41,    42,    43,    44,    45,    -1,    47,    48,    49,
+      50,    51,    52,    -1,    -1,    -1,    -1,    34,    -1,    -1,
+      -1,    -1,    62,    40,    41,    42,    43,    44,    45,    -1,
+      47,    48,    49,    50,    51,    52,    -1,    -1,    -1,    33,
+      -1,    -1,    -1,    -1,    -1,    62,    40,    41,    42,    43,
+      44,    45,    -1,    47,    48,    49,    50,    51,    52,    -1,
+      -1,    -1,    33,    -1,    -1,    -1,    -1,    -1,    62,    40,
+      41,    42,    43,    44,    45,    -1,    47,    48,    49,    50,
+      51,    52,    -1,    -1,    -1,    40,    41,    42,    43,    44,
+      45,    62,    47,    48,    49,    50,    51,    52,    -1,    -1,
+      -1,    56,    -1,    -1,    -1,    -1,    -1,    62,    40,    41,
+      42,    43,    44,    45,    -1,    47,    48,    49,    50,    51,
+      52,    -1,    -1,    -1,    -1,    -1,    58,    -1,    -1,    -1,
+      62,    40,    41,    42,    43,    44,    45,    -1,    47,    48,
+      49,    50,    51,    52,    -1,    -1,    -1,    -1,    -1,    58,
+      -1,    -1,    -1,    62,    40,    41,    42,    43,    44,    45,
+      -1,    47,    48,    49,    50,    51,    52,    -1,    -1,    -1,
+      -1,    -1,    58,    -1,    -1,    -1,    62,    40,    41,    42,
+      43,    44,    45,    -1,    47,    48,    49,    50,    51,    52,
+      -1,    -1,    -1,    -1,    -1,    58,    -1,    -1,    -1,    62,
+      40,    41,    42,    43,    44,    45,    -1,    47,    48,    49,
+      50,    51,    52,    -1,    -1,    -1,    -1,    -1,    58,    -1,
+      -1,    -1,    62,    40,    41,    42,    43,    44,    45,    -1,
+      47,    48,    49,    50,    51,    52,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    60,    -1,    62,    40,    41,    42,    43,
+      44,    45,    -1,    47,    48,    49,    50,    51,    52,    -1,
+      -1,    55,    40,    41,    42,    43,    44,    45,    62,    47,
+      48,    49,    50,    51,    52,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    60,    -1,    62,    40,    41,    42,    43,    44,
+      45,    -1,    47,    48,    49,    50,    51,    52,    -1,    -1,
+      -1,    40,    41,    42,    43,    44,    -1,    62,    47,    48,
+      49,    50,    51,    52,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    62
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,    12,    65,    66,    67,    72,     3,    74,     0,    35,
+      68,    83,    47,    73,     3,    85,    37,    69,    94,     3,
+       4,     5,     6,    11,    23,    24,    32,    41,    46,    57,
+     120,   121,    74,    47,    84,     3,    90,    92,    70,    57,
+     122,    57,    57,    57,    57,   120,   120,   120,    40,    41,
+      42,    43,    44,    45,    47,    48,    49,    50,    51,    52,
+      56,    62,     3,     9,    27,    86,    87,    88,    91,    85,
+      93,    89,    55,    10,    20,    25,    71,    75,    76,    82,
+     115,   118,   120,    53,    59,   123,   120,   120,   120,   120,
+      58,   120,   120,   120,   120,   120,   120,   120,   120,   120,
+     120,   120,   120,   120,    59,    89,    56,    54,    90,    86,
+       3,    18,    21,    26,    29,    30,    31,    38,    39,    95,
+      97,    98,    99,   104,   105,   106,   108,   109,   111,   114,
+     117,   119,   121,     3,     3,    53,    58,   116,     3,   120,
+      58,    58,    58,    58,   120,    17,     3,    56,    57,     3,
+     120,    57,    95,   110,   120,   120,    57,    17,    96,    61,
+      57,    57,    54,    60,    55,   118,    61,    33,     3,   112,
+     121,    36,    13,   115,    56,   120,    28,    37,    77,    79,
+      80,    77,   120,   120,    58,   120,    95,    58,   113,   120,
+      95,    58,    97,    58,    78,    92,    58,    60,    14,    34,
+     107,   100,    54,    17,    55,    56,    55,    56,    22,   120,
+      15,    16,   101,   102,   103,   121,    86,    79,    86,    19,
+      67,    81,    86,    13,    95,   120,    17,    56,    56,    68,
+      56,    95,    33,    19,    81,    69,    17,    95,    56,    56,
+      82
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    64,    65,    66,    67,    67,    68,    68,    69,    69,
+      70,    70,    71,    71,    72,    73,    73,    74,    75,    75,
+      76,    76,    77,    77,    78,    78,    79,    80,    80,    80,
+      81,    82,    83,    84,    84,    85,    86,    86,    86,    87,
+      88,    89,    89,    90,    91,    92,    93,    93,    94,    95,
+      96,    96,    97,    97,    97,    97,    97,    97,    97,    97,
+      97,    97,    97,    98,    99,   100,   100,   101,   102,   102,
+     103,   104,   105,   106,   107,   107,   108,   109,   110,   110,
+     111,   112,   113,   113,   114,   115,   116,   116,   117,   118,
+     118,   119,   120,   120,   120,   120,   120,   120,   120,   120,
+     120,   120,   120,   120,   120,   120,   120,   120,   120,   120,
+     120,   120,   120,   120,   120,   120,   120,   121,   122,   122,
+     123,   123
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     6,     0,     1,     0,     1,     0,     1,
+       0,     2,     1,     1,     3,     0,     2,     4,     8,     8,
+      10,    10,     0,     2,     0,     3,     4,     1,     1,     0,
+       4,     3,     3,     0,     2,     4,     1,     1,     1,     1,
+       3,     0,     2,     4,     8,     2,     0,     3,     3,     2,
+       0,     3,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     3,     7,     0,     2,     4,     0,     1,
+       2,     5,     4,     9,     1,     1,     1,     2,     0,     1,
+       4,     2,     0,     3,     4,     2,     0,     3,     4,     0,
+       1,     0,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     2,     2,     3,     4,     4,
+       4,     4,     4,     1,     1,     1,     1,     2,     0,     2,
+       2,     3
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YY_CPSL_CC_PARSEREMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YY_CPSL_CC_PARSEREMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (parser_state, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YY_CPSL_CC_PARSERerror or YY_CPSL_CC_PARSERUNDEF. */
+#define YYERRCODE YY_CPSL_CC_PARSERUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YY_CPSL_CC_PARSERDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, parser_state); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, std::shared_ptr<ParserState> parser_state)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (parser_state);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, std::shared_ptr<ParserState> parser_state)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep, parser_state);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, std::shared_ptr<ParserState> parser_state)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], parser_state);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, parser_state); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YY_CPSL_CC_PARSERDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YY_CPSL_CC_PARSERDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
+
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
+/* Return the length of YYSTR.  */
+static YYPTRDIFF_T
+yystrlen (const char *yystr)
+{
+  YYPTRDIFF_T yylen;
+  for (yylen = 0; yystr[yylen]; yylen++)
+    continue;
+  return yylen;
+}
+# endif
+#endif
+
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
+/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
+   YYDEST.  */
+static char *
+yystpcpy (char *yydest, const char *yysrc)
+{
+  char *yyd = yydest;
+  const char *yys = yysrc;
+
+  while ((*yyd++ = *yys++) != '\0')
+    continue;
+
+  return yyd - 1;
+}
+# endif
+#endif
+
+
+
+static int
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  /* There are many possibilities here to consider:
+     - If this state is a consistent state with a default action, then
+       the only way this function was invoked is if the default action
+       is an error action.  In that case, don't check for expected
+       tokens because there are none.
+     - The only way there can be no lookahead present (in yychar) is if
+       this state is a consistent state with a default action.  Thus,
+       detecting the absence of a lookahead is sufficient to determine
+       that there is no unexpected or expected token to report.  In that
+       case, just report a simple "syntax error".
+     - Don't assume there isn't a lookahead just because this state is a
+       consistent state with a default action.  There might have been a
+       previous inconsistent state, consistent state with a non-default
+       action, or user semantic action that manipulated yychar.
+     - Of course, the expected token list depends on states to have
+       correct lookahead information, and it depends on the parser not
+       to perform extra reductions after fetching a lookahead from the
+       scanner and before detecting a syntax error.  Thus, state merging
+       (from LALR or IELR) and default reductions corrupt the expected
+       token list.  However, the list is correct for canonical LR with
+       one exception: it will still contain any token that will not be
+       accepted due to an error action in a later state.
+  */
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
+    {
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
+    }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
+
+  switch (yycount)
+    {
+#define YYCASE_(N, S)                       \
+      case N:                               \
+        yyformat = S;                       \
+        break
+    default: /* Avoid compiler warnings. */
+      YYCASE_(0, YY_("syntax error"));
+      YYCASE_(1, YY_("syntax error, unexpected %s"));
+      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
+      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+    }
+
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
+  {
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yystrlen (yysymbol_name (yyarg[yyi]));
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
+  }
+
+  if (*yymsg_alloc < yysize)
+    {
+      *yymsg_alloc = 2 * yysize;
+      if (! (yysize <= *yymsg_alloc
+             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
+        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
+      return -1;
+    }
+
+  /* Avoid sprintf, as that infringes on the user's name space.
+     Don't have undefined behavior even if the translation
+     produced a string with the wrong number of "%s"s.  */
+  {
+    char *yyp = *yymsg;
+    int yyi = 0;
+    while ((*yyp = *yyformat) != '\0')
+      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
+        {
+          yyp = yystpcpy (yyp, yysymbol_name (yyarg[yyi++]));
+          yyformat += 2;
+        }
+      else
+        {
+          ++yyp;
+          ++yyformat;
+        }
+  }
+  return 0;
+}
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, std::shared_ptr<ParserState> parser_state)
+{
+  YY_USE (yyvaluep);
+  YY_USE (parser_state);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (std::shared_ptr<ParserState> parser_state)
+{
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+  /* Buffer for error messages, and its allocated size.  */
+  char yymsgbuf[128];
+  char *yymsg = yymsgbuf;
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YY_CPSL_CC_PARSEREMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YY_CPSL_CC_PARSEREMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, parser_state);
+    }
+
+  if (yychar <= YY_CPSL_CC_PARSEREOF)
+    {
+      yychar = YY_CPSL_CC_PARSEREOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YY_CPSL_CC_PARSERerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YY_CPSL_CC_PARSERUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YY_CPSL_CC_PARSEREMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* start: program  */
+#line 208 "src/parser.bison"
+                 {yyval = pg.new_start(yyvsp[0]);}
+#line 1780 "_build/parser.yy.cc"
+    break;
+
+  case 3: /* program: constant_decl_opt type_decl_opt var_decl_opt procedure_decl_or_function_decl_list block DOT_OPERATOR  */
+#line 214 "src/parser.bison"
+                                                                                                             {yyval = pg.new_program(yyvsp[-5], yyvsp[-4], yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1786 "_build/parser.yy.cc"
+    break;
+
+  case 4: /* constant_decl_opt: %empty  */
+#line 218 "src/parser.bison"
+                        {yyval = pg.new_constant_decl_opt_empty();}
+#line 1792 "_build/parser.yy.cc"
+    break;
+
+  case 5: /* constant_decl_opt: constant_decl  */
+#line 219 "src/parser.bison"
+                        {yyval = pg.new_constant_decl_opt_value(yyvsp[0]);}
+#line 1798 "_build/parser.yy.cc"
+    break;
+
+  case 6: /* type_decl_opt: %empty  */
+#line 223 "src/parser.bison"
+                    {yyval = pg.new_type_decl_opt_empty();}
+#line 1804 "_build/parser.yy.cc"
+    break;
+
+  case 7: /* type_decl_opt: type_decl  */
+#line 224 "src/parser.bison"
+                    {yyval = pg.new_type_decl_opt_value(yyvsp[0]);}
+#line 1810 "_build/parser.yy.cc"
+    break;
+
+  case 8: /* var_decl_opt: %empty  */
+#line 228 "src/parser.bison"
+                   {yyval = pg.new_var_decl_opt_empty();}
+#line 1816 "_build/parser.yy.cc"
+    break;
+
+  case 9: /* var_decl_opt: var_decl  */
+#line 229 "src/parser.bison"
+                   {yyval = pg.new_var_decl_opt_value(yyvsp[0]);}
+#line 1822 "_build/parser.yy.cc"
+    break;
+
+  case 10: /* procedure_decl_or_function_decl_list: %empty  */
+#line 233 "src/parser.bison"
+                                                                               {yyval = pg.new_procedure_decl_or_function_decl_list_empty();}
+#line 1828 "_build/parser.yy.cc"
+    break;
+
+  case 11: /* procedure_decl_or_function_decl_list: procedure_decl_or_function_decl_list procedure_decl_or_function_decl  */
+#line 234 "src/parser.bison"
+                                                                               {yyval = pg.new_procedure_decl_or_function_decl_list_cons(yyvsp[-1], yyvsp[0]);}
+#line 1834 "_build/parser.yy.cc"
+    break;
+
+  case 12: /* procedure_decl_or_function_decl: procedure_decl  */
+#line 238 "src/parser.bison"
+                         {yyval = pg.new_procedure_decl_or_function_decl_procedure(yyvsp[0]);}
+#line 1840 "_build/parser.yy.cc"
+    break;
+
+  case 13: /* procedure_decl_or_function_decl: function_decl  */
+#line 239 "src/parser.bison"
+                         {yyval = pg.new_procedure_decl_or_function_decl_function(yyvsp[0]);}
+#line 1846 "_build/parser.yy.cc"
+    break;
+
+  case 14: /* constant_decl: CONST_KEYWORD constant_assignment constant_assignment_list  */
+#line 245 "src/parser.bison"
+                                                                   {yyval = pg.new_constant_decl(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1852 "_build/parser.yy.cc"
+    break;
+
+  case 15: /* constant_assignment_list: %empty  */
+#line 249 "src/parser.bison"
+                                                       {yyval = pg.new_constant_assignment_list_empty();}
+#line 1858 "_build/parser.yy.cc"
+    break;
+
+  case 16: /* constant_assignment_list: constant_assignment_list constant_assignment  */
+#line 250 "src/parser.bison"
+                                                       {yyval = pg.new_constant_assignment_list_cons(yyvsp[-1], yyvsp[0]);}
+#line 1864 "_build/parser.yy.cc"
+    break;
+
+  case 17: /* constant_assignment: IDENTIFIER EQUALS_OPERATOR expression SEMICOLON_OPERATOR  */
+#line 254 "src/parser.bison"
+                                                                 {yyval = pg.new_constant_assignment(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1870 "_build/parser.yy.cc"
+    break;
+
+  case 18: /* procedure_decl: PROCEDURE_KEYWORD IDENTIFIER LEFTPARENTHESIS_OPERATOR formal_parameters RIGHTPARENTHESIS_OPERATOR SEMICOLON_OPERATOR FORWARD_KEYWORD SEMICOLON_OPERATOR  */
+#line 258 "src/parser.bison"
+                                                                                                                                                                  {yyval = pg.new_procedure_decl_forward(yyvsp[-7], yyvsp[-6], yyvsp[-5], yyvsp[-4], yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1876 "_build/parser.yy.cc"
+    break;
+
+  case 19: /* procedure_decl: PROCEDURE_KEYWORD IDENTIFIER LEFTPARENTHESIS_OPERATOR formal_parameters RIGHTPARENTHESIS_OPERATOR SEMICOLON_OPERATOR body SEMICOLON_OPERATOR  */
+#line 259 "src/parser.bison"
+                                                                                                                                                                  {yyval = pg.new_procedure_decl_definition(yyvsp[-7], yyvsp[-6], yyvsp[-5], yyvsp[-4], yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1882 "_build/parser.yy.cc"
+    break;
+
+  case 20: /* function_decl: FUNCTION_KEYWORD IDENTIFIER LEFTPARENTHESIS_OPERATOR formal_parameters RIGHTPARENTHESIS_OPERATOR COLON_OPERATOR type SEMICOLON_OPERATOR FORWARD_KEYWORD SEMICOLON_OPERATOR  */
+#line 263 "src/parser.bison"
+                                                                                                                                                                                     {yyval = pg.new_function_decl_forward(yyvsp[-9], yyvsp[-8], yyvsp[-7], yyvsp[-6], yyvsp[-5], yyvsp[-4], yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1888 "_build/parser.yy.cc"
+    break;
+
+  case 21: /* function_decl: FUNCTION_KEYWORD IDENTIFIER LEFTPARENTHESIS_OPERATOR formal_parameters RIGHTPARENTHESIS_OPERATOR COLON_OPERATOR type SEMICOLON_OPERATOR body SEMICOLON_OPERATOR  */
+#line 264 "src/parser.bison"
+                                                                                                                                                                                     {yyval = pg.new_function_decl_definition(yyvsp[-9], yyvsp[-8], yyvsp[-7], yyvsp[-6], yyvsp[-5], yyvsp[-4], yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1894 "_build/parser.yy.cc"
+    break;
+
+  case 22: /* formal_parameters: %empty  */
+#line 272 "src/parser.bison"
+                                                          {yyval = pg.new_formal_parameters_empty();}
+#line 1900 "_build/parser.yy.cc"
+    break;
+
+  case 23: /* formal_parameters: formal_parameter formal_parameter_prefixed_list  */
+#line 273 "src/parser.bison"
+                                                          {yyval = pg.new_formal_parameters_first(yyvsp[-1], yyvsp[0]);}
+#line 1906 "_build/parser.yy.cc"
+    break;
+
+  case 24: /* formal_parameter_prefixed_list: %empty  */
+#line 277 "src/parser.bison"
+                                                                             {yyval = pg.new_formal_parameter_prefixed_list_empty();}
+#line 1912 "_build/parser.yy.cc"
+    break;
+
+  case 25: /* formal_parameter_prefixed_list: formal_parameter_prefixed_list SEMICOLON_OPERATOR formal_parameter  */
+#line 278 "src/parser.bison"
+                                                                             {yyval = pg.new_formal_parameter_prefixed_list_cons(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1918 "_build/parser.yy.cc"
+    break;
+
+  case 26: /* formal_parameter: var_or_ref ident_list COLON_OPERATOR type  */
+#line 282 "src/parser.bison"
+                                                  {yyval = pg.new_formal_parameter(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1924 "_build/parser.yy.cc"
+    break;
+
+  case 27: /* var_or_ref: VAR_KEYWORD  */
+#line 286 "src/parser.bison"
+                      {yyval = pg.new_var_or_ref_var(yyvsp[0]);}
+#line 1930 "_build/parser.yy.cc"
+    break;
+
+  case 28: /* var_or_ref: REF_KEYWORD  */
+#line 287 "src/parser.bison"
+                      {yyval = pg.new_var_or_ref_ref(yyvsp[0]);}
+#line 1936 "_build/parser.yy.cc"
+    break;
+
+  case 29: /* var_or_ref: %empty  */
+#line 288 "src/parser.bison"
+                      {yyval = pg.new_var_or_ref_empty();}
+#line 1942 "_build/parser.yy.cc"
+    break;
+
+  case 30: /* body: constant_decl_opt type_decl_opt var_decl_opt block  */
+#line 292 "src/parser.bison"
+                                                           {yyval = pg.new_body(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1948 "_build/parser.yy.cc"
+    break;
+
+  case 31: /* block: BEGIN_KEYWORD statement_sequence END_KEYWORD  */
+#line 296 "src/parser.bison"
+                                                     {yyval = pg.new_block(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1954 "_build/parser.yy.cc"
+    break;
+
+  case 32: /* type_decl: TYPE_KEYWORD type_assignment type_assignment_list  */
+#line 300 "src/parser.bison"
+                                                          {yyval = pg.new_type_decl(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1960 "_build/parser.yy.cc"
+    break;
+
+  case 33: /* type_assignment_list: %empty  */
+#line 304 "src/parser.bison"
+                                               {yyval = pg.new_type_assignment_list_empty();}
+#line 1966 "_build/parser.yy.cc"
+    break;
+
+  case 34: /* type_assignment_list: type_assignment_list type_assignment  */
+#line 305 "src/parser.bison"
+                                               {yyval = pg.new_type_assignment_list_cons(yyvsp[-1], yyvsp[0]);}
+#line 1972 "_build/parser.yy.cc"
+    break;
+
+  case 35: /* type_assignment: IDENTIFIER EQUALS_OPERATOR type SEMICOLON_OPERATOR  */
+#line 309 "src/parser.bison"
+                                                           {yyval = pg.new_type_assignment(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 1978 "_build/parser.yy.cc"
+    break;
+
+  case 36: /* type: simple_type  */
+#line 313 "src/parser.bison"
+                      {yyval = pg.new_type_simple(yyvsp[0]);}
+#line 1984 "_build/parser.yy.cc"
+    break;
+
+  case 37: /* type: record_type  */
+#line 314 "src/parser.bison"
+                      {yyval = pg.new_type_record(yyvsp[0]);}
+#line 1990 "_build/parser.yy.cc"
+    break;
+
+  case 38: /* type: array_type  */
+#line 315 "src/parser.bison"
+                      {yyval = pg.new_type_array(yyvsp[0]);}
+#line 1996 "_build/parser.yy.cc"
+    break;
+
+  case 39: /* simple_type: IDENTIFIER  */
+#line 319 "src/parser.bison"
+                   {yyval = pg.new_simple_type(yyvsp[0]);}
+#line 2002 "_build/parser.yy.cc"
+    break;
+
+  case 40: /* record_type: RECORD_KEYWORD typed_identifier_sequence_list END_KEYWORD  */
+#line 323 "src/parser.bison"
+                                                                  {yyval = pg.new_record_type(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2008 "_build/parser.yy.cc"
+    break;
+
+  case 41: /* typed_identifier_sequence_list: %empty  */
+#line 327 "src/parser.bison"
+                                                                   {yyval = pg.new_typed_identifier_sequence_list_empty();}
+#line 2014 "_build/parser.yy.cc"
+    break;
+
+  case 42: /* typed_identifier_sequence_list: typed_identifier_sequence_list typed_identifier_sequence  */
+#line 328 "src/parser.bison"
+                                                                   {yyval = pg.new_typed_identifier_sequence_list_cons(yyvsp[-1], yyvsp[0]);}
+#line 2020 "_build/parser.yy.cc"
+    break;
+
+  case 43: /* typed_identifier_sequence: ident_list COLON_OPERATOR type SEMICOLON_OPERATOR  */
+#line 332 "src/parser.bison"
+                                                          {yyval = pg.new_typed_identifier_sequence(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2026 "_build/parser.yy.cc"
+    break;
+
+  case 44: /* array_type: ARRAY_KEYWORD LEFTBRACKET_OPERATOR expression COLON_OPERATOR expression RIGHTBRACKET_OPERATOR OF_KEYWORD type  */
+#line 336 "src/parser.bison"
+                                                                                                                      {yyval = pg.new_array_type(yyvsp[-7], yyvsp[-6], yyvsp[-5], yyvsp[-4], yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2032 "_build/parser.yy.cc"
+    break;
+
+  case 45: /* ident_list: IDENTIFIER identifier_prefixed_list  */
+#line 344 "src/parser.bison"
+                                            {yyval = pg.new_ident_list(yyvsp[-1], yyvsp[0]);}
+#line 2038 "_build/parser.yy.cc"
+    break;
+
+  case 46: /* identifier_prefixed_list: %empty  */
+#line 348 "src/parser.bison"
+                                                             {yyval = pg.new_identifier_prefixed_list_empty();}
+#line 2044 "_build/parser.yy.cc"
+    break;
+
+  case 47: /* identifier_prefixed_list: identifier_prefixed_list COMMA_OPERATOR IDENTIFIER  */
+#line 349 "src/parser.bison"
+                                                             {yyval = pg.new_identifier_prefixed_list_cons(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2050 "_build/parser.yy.cc"
+    break;
+
+  case 48: /* var_decl: VAR_KEYWORD typed_identifier_sequence typed_identifier_sequence_list  */
+#line 353 "src/parser.bison"
+                                                                             {yyval = pg.new_var_decl(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2056 "_build/parser.yy.cc"
+    break;
+
+  case 49: /* statement_sequence: statement statement_prefixed_list  */
+#line 359 "src/parser.bison"
+                                          {yyval = pg.new_statement_sequence(yyvsp[-1], yyvsp[0]);}
+#line 2062 "_build/parser.yy.cc"
+    break;
+
+  case 50: /* statement_prefixed_list: %empty  */
+#line 363 "src/parser.bison"
+                                                               {yyval = pg.new_statement_prefixed_list_empty();}
+#line 2068 "_build/parser.yy.cc"
+    break;
+
+  case 51: /* statement_prefixed_list: statement_prefixed_list SEMICOLON_OPERATOR statement  */
+#line 364 "src/parser.bison"
+                                                               {yyval = pg.new_statement_prefixed_list_cons(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2074 "_build/parser.yy.cc"
+    break;
+
+  case 52: /* statement: assignment  */
+#line 368 "src/parser.bison"
+                           {yyval = pg.new_statement_assignment(yyvsp[0]);}
+#line 2080 "_build/parser.yy.cc"
+    break;
+
+  case 53: /* statement: if_statement  */
+#line 369 "src/parser.bison"
+                           {yyval = pg.new_statement_if(yyvsp[0]);}
+#line 2086 "_build/parser.yy.cc"
+    break;
+
+  case 54: /* statement: while_statement  */
+#line 370 "src/parser.bison"
+                           {yyval = pg.new_statement_while(yyvsp[0]);}
+#line 2092 "_build/parser.yy.cc"
+    break;
+
+  case 55: /* statement: repeat_statement  */
+#line 371 "src/parser.bison"
+                           {yyval = pg.new_statement_repeat(yyvsp[0]);}
+#line 2098 "_build/parser.yy.cc"
+    break;
+
+  case 56: /* statement: for_statement  */
+#line 372 "src/parser.bison"
+                           {yyval = pg.new_statement_for(yyvsp[0]);}
+#line 2104 "_build/parser.yy.cc"
+    break;
+
+  case 57: /* statement: stop_statement  */
+#line 373 "src/parser.bison"
+                           {yyval = pg.new_statement_stop(yyvsp[0]);}
+#line 2110 "_build/parser.yy.cc"
+    break;
+
+  case 58: /* statement: return_statement  */
+#line 374 "src/parser.bison"
+                           {yyval = pg.new_statement_return(yyvsp[0]);}
+#line 2116 "_build/parser.yy.cc"
+    break;
+
+  case 59: /* statement: read_statement  */
+#line 375 "src/parser.bison"
+                           {yyval = pg.new_statement_read(yyvsp[0]);}
+#line 2122 "_build/parser.yy.cc"
+    break;
+
+  case 60: /* statement: write_statement  */
+#line 376 "src/parser.bison"
+                           {yyval = pg.new_statement_write(yyvsp[0]);}
+#line 2128 "_build/parser.yy.cc"
+    break;
+
+  case 61: /* statement: procedure_call  */
+#line 377 "src/parser.bison"
+                           {yyval = pg.new_statement_call(yyvsp[0]);}
+#line 2134 "_build/parser.yy.cc"
+    break;
+
+  case 62: /* statement: null_statement  */
+#line 378 "src/parser.bison"
+                           {yyval = pg.new_statement_null_(yyvsp[0]);}
+#line 2140 "_build/parser.yy.cc"
+    break;
+
+  case 63: /* assignment: lvalue COLONEQUALS_OPERATOR expression  */
+#line 382 "src/parser.bison"
+                                               {yyval = pg.new_assignment(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2146 "_build/parser.yy.cc"
+    break;
+
+  case 64: /* if_statement: IF_KEYWORD expression THEN_KEYWORD statement_sequence elseif_clause_list else_clause_opt END_KEYWORD  */
+#line 386 "src/parser.bison"
+                                                                                                             {yyval = pg.new_if_statement(yyvsp[-6], yyvsp[-5], yyvsp[-4], yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2152 "_build/parser.yy.cc"
+    break;
+
+  case 65: /* elseif_clause_list: %empty  */
+#line 390 "src/parser.bison"
+                                           {yyval = pg.new_elseif_clause_list_empty();}
+#line 2158 "_build/parser.yy.cc"
+    break;
+
+  case 66: /* elseif_clause_list: elseif_clause_list elseif_clause  */
+#line 391 "src/parser.bison"
+                                           {yyval = pg.new_elseif_clause_list_cons(yyvsp[-1], yyvsp[0]);}
+#line 2164 "_build/parser.yy.cc"
+    break;
+
+  case 67: /* elseif_clause: ELSEIF_KEYWORD expression THEN_KEYWORD statement_sequence  */
+#line 395 "src/parser.bison"
+                                                                  {yyval = pg.new_elseif_clause(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2170 "_build/parser.yy.cc"
+    break;
+
+  case 68: /* else_clause_opt: %empty  */
+#line 399 "src/parser.bison"
+                      {yyval = pg.new_else_clause_opt_empty();}
+#line 2176 "_build/parser.yy.cc"
+    break;
+
+  case 69: /* else_clause_opt: else_clause  */
+#line 400 "src/parser.bison"
+                      {yyval = pg.new_else_clause_opt_value(yyvsp[0]);}
+#line 2182 "_build/parser.yy.cc"
+    break;
+
+  case 70: /* else_clause: ELSE_KEYWORD statement_sequence  */
+#line 404 "src/parser.bison"
+                                        {yyval = pg.new_else_clause(yyvsp[-1], yyvsp[0]);}
+#line 2188 "_build/parser.yy.cc"
+    break;
+
+  case 71: /* while_statement: WHILE_KEYWORD expression DO_KEYWORD statement_sequence END_KEYWORD  */
+#line 408 "src/parser.bison"
+                                                                           {yyval = pg.new_while_statement(yyvsp[-4], yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2194 "_build/parser.yy.cc"
+    break;
+
+  case 72: /* repeat_statement: REPEAT_KEYWORD statement_sequence UNTIL_KEYWORD expression  */
+#line 412 "src/parser.bison"
+                                                                   {yyval = pg.new_repeat_statement(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2200 "_build/parser.yy.cc"
+    break;
+
+  case 73: /* for_statement: FOR_KEYWORD IDENTIFIER COLONEQUALS_OPERATOR expression to_or_downto expression DO_KEYWORD statement_sequence END_KEYWORD  */
+#line 416 "src/parser.bison"
+                                                                                                                                 {yyval = pg.new_for_statement(yyvsp[-8], yyvsp[-7], yyvsp[-6], yyvsp[-5], yyvsp[-4], yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2206 "_build/parser.yy.cc"
+    break;
+
+  case 74: /* to_or_downto: TO_KEYWORD  */
+#line 420 "src/parser.bison"
+                         {yyval = pg.new_to_or_downto_to(yyvsp[0]);}
+#line 2212 "_build/parser.yy.cc"
+    break;
+
+  case 75: /* to_or_downto: DOWNTO_KEYWORD  */
+#line 421 "src/parser.bison"
+                         {yyval = pg.new_to_or_downto_downto(yyvsp[0]);}
+#line 2218 "_build/parser.yy.cc"
+    break;
+
+  case 76: /* stop_statement: STOP_KEYWORD  */
+#line 425 "src/parser.bison"
+                     {yyval = pg.new_stop_statement(yyvsp[0]);}
+#line 2224 "_build/parser.yy.cc"
+    break;
+
+  case 77: /* return_statement: RETURN_KEYWORD expression_opt  */
+#line 429 "src/parser.bison"
+                                      {yyval = pg.new_return_statement(yyvsp[-1], yyvsp[0]);}
+#line 2230 "_build/parser.yy.cc"
+    break;
+
+  case 78: /* expression_opt: %empty  */
+#line 433 "src/parser.bison"
+                     {yyval = pg.new_expression_opt_empty();}
+#line 2236 "_build/parser.yy.cc"
+    break;
+
+  case 79: /* expression_opt: expression  */
+#line 434 "src/parser.bison"
+                     {yyval = pg.new_expression_opt_value(yyvsp[0]);}
+#line 2242 "_build/parser.yy.cc"
+    break;
+
+  case 80: /* read_statement: READ_KEYWORD LEFTPARENTHESIS_OPERATOR lvalue_sequence RIGHTPARENTHESIS_OPERATOR  */
+#line 438 "src/parser.bison"
+                                                                                        {yyval = pg.new_read_statement(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2248 "_build/parser.yy.cc"
+    break;
+
+  case 81: /* lvalue_sequence: lvalue lvalue_prefixed_list  */
+#line 442 "src/parser.bison"
+                                    {yyval = pg.new_lvalue_sequence(yyvsp[-1], yyvsp[0]);}
+#line 2254 "_build/parser.yy.cc"
+    break;
+
+  case 82: /* lvalue_prefixed_list: %empty  */
+#line 446 "src/parser.bison"
+                                                     {yyval = pg.new_lvalue_prefixed_list_empty();}
+#line 2260 "_build/parser.yy.cc"
+    break;
+
+  case 83: /* lvalue_prefixed_list: lvalue_prefixed_list COMMA_OPERATOR lvalue  */
+#line 447 "src/parser.bison"
+                                                     {yyval = pg.new_lvalue_prefixed_list_cons(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2266 "_build/parser.yy.cc"
+    break;
+
+  case 84: /* write_statement: WRITE_KEYWORD LEFTPARENTHESIS_OPERATOR expression_sequence RIGHTPARENTHESIS_OPERATOR  */
+#line 451 "src/parser.bison"
+                                                                                             {yyval = pg.new_write_statement(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2272 "_build/parser.yy.cc"
+    break;
+
+  case 85: /* expression_sequence: expression expression_prefixed_list  */
+#line 455 "src/parser.bison"
+                                            {yyval = pg.new_expression_sequence(yyvsp[-1], yyvsp[0]);}
+#line 2278 "_build/parser.yy.cc"
+    break;
+
+  case 86: /* expression_prefixed_list: %empty  */
+#line 459 "src/parser.bison"
+                                                             {yyval = pg.new_expression_prefixed_list_empty();}
+#line 2284 "_build/parser.yy.cc"
+    break;
+
+  case 87: /* expression_prefixed_list: expression_prefixed_list COMMA_OPERATOR expression  */
+#line 460 "src/parser.bison"
+                                                             {yyval = pg.new_expression_prefixed_list_cons(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2290 "_build/parser.yy.cc"
+    break;
+
+  case 88: /* procedure_call: IDENTIFIER LEFTPARENTHESIS_OPERATOR expression_sequence_opt RIGHTPARENTHESIS_OPERATOR  */
+#line 464 "src/parser.bison"
+                                                                                              {yyval = pg.new_procedure_call(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2296 "_build/parser.yy.cc"
+    break;
+
+  case 89: /* expression_sequence_opt: %empty  */
+#line 468 "src/parser.bison"
+                              {yyval = pg.new_expression_sequence_opt_empty();}
+#line 2302 "_build/parser.yy.cc"
+    break;
+
+  case 90: /* expression_sequence_opt: expression_sequence  */
+#line 469 "src/parser.bison"
+                              {yyval = pg.new_expression_sequence_opt_value(yyvsp[0]);}
+#line 2308 "_build/parser.yy.cc"
+    break;
+
+  case 91: /* null_statement: %empty  */
+#line 473 "src/parser.bison"
+                 {yyval = pg.new_null_statement();}
+#line 2314 "_build/parser.yy.cc"
+    break;
+
+  case 92: /* expression: expression PIPE_OPERATOR expression  */
+#line 485 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_pipe(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2320 "_build/parser.yy.cc"
+    break;
+
+  case 93: /* expression: expression AMPERSAND_OPERATOR expression  */
+#line 486 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_ampersand(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2326 "_build/parser.yy.cc"
+    break;
+
+  case 94: /* expression: expression EQUALS_OPERATOR expression  */
+#line 487 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_equals(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2332 "_build/parser.yy.cc"
+    break;
+
+  case 95: /* expression: expression LT_OR_GT_OPERATOR expression  */
+#line 488 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_lt_or_gt(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2338 "_build/parser.yy.cc"
+    break;
+
+  case 96: /* expression: expression LE_OPERATOR expression  */
+#line 489 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_le(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2344 "_build/parser.yy.cc"
+    break;
+
+  case 97: /* expression: expression GE_OPERATOR expression  */
+#line 490 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_ge(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2350 "_build/parser.yy.cc"
+    break;
+
+  case 98: /* expression: expression LT_OPERATOR expression  */
+#line 491 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_lt(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2356 "_build/parser.yy.cc"
+    break;
+
+  case 99: /* expression: expression GT_OPERATOR expression  */
+#line 492 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_gt(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2362 "_build/parser.yy.cc"
+    break;
+
+  case 100: /* expression: expression PLUS_OPERATOR expression  */
+#line 493 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_plus(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2368 "_build/parser.yy.cc"
+    break;
+
+  case 101: /* expression: expression MINUS_OPERATOR expression  */
+#line 494 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_minus(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2374 "_build/parser.yy.cc"
+    break;
+
+  case 102: /* expression: expression TIMES_OPERATOR expression  */
+#line 495 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_times(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2380 "_build/parser.yy.cc"
+    break;
+
+  case 103: /* expression: expression SLASH_OPERATOR expression  */
+#line 496 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_slash(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2386 "_build/parser.yy.cc"
+    break;
+
+  case 104: /* expression: expression PERCENT_OPERATOR expression  */
+#line 497 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_percent(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2392 "_build/parser.yy.cc"
+    break;
+
+  case 105: /* expression: TILDE_OPERATOR expression  */
+#line 498 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_tilde(yyvsp[-1], yyvsp[0]);}
+#line 2398 "_build/parser.yy.cc"
+    break;
+
+  case 106: /* expression: MINUS_OPERATOR expression  */
+#line 499 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_unary_minus(yyvsp[-1], yyvsp[0]);}
+#line 2404 "_build/parser.yy.cc"
+    break;
+
+  case 107: /* expression: LEFTPARENTHESIS_OPERATOR expression RIGHTPARENTHESIS_OPERATOR  */
+#line 500 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_parentheses(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2410 "_build/parser.yy.cc"
+    break;
+
+  case 108: /* expression: IDENTIFIER LEFTPARENTHESIS_OPERATOR expression_sequence_opt RIGHTPARENTHESIS_OPERATOR  */
+#line 501 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_call(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2416 "_build/parser.yy.cc"
+    break;
+
+  case 109: /* expression: CHR_KEYWORD LEFTPARENTHESIS_OPERATOR expression RIGHTPARENTHESIS_OPERATOR  */
+#line 502 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_chr(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2422 "_build/parser.yy.cc"
+    break;
+
+  case 110: /* expression: ORD_KEYWORD LEFTPARENTHESIS_OPERATOR expression RIGHTPARENTHESIS_OPERATOR  */
+#line 503 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_ord(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2428 "_build/parser.yy.cc"
+    break;
+
+  case 111: /* expression: PRED_KEYWORD LEFTPARENTHESIS_OPERATOR expression RIGHTPARENTHESIS_OPERATOR  */
+#line 504 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_pred(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2434 "_build/parser.yy.cc"
+    break;
+
+  case 112: /* expression: SUCC_KEYWORD LEFTPARENTHESIS_OPERATOR expression RIGHTPARENTHESIS_OPERATOR  */
+#line 505 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_succ(yyvsp[-3], yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2440 "_build/parser.yy.cc"
+    break;
+
+  case 113: /* expression: lvalue  */
+#line 506 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_lvalue(yyvsp[0]);}
+#line 2446 "_build/parser.yy.cc"
+    break;
+
+  case 114: /* expression: INTEGER  */
+#line 507 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_integer(yyvsp[0]);}
+#line 2452 "_build/parser.yy.cc"
+    break;
+
+  case 115: /* expression: CHAR  */
+#line 508 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_char_(yyvsp[0]);}
+#line 2458 "_build/parser.yy.cc"
+    break;
+
+  case 116: /* expression: STRING  */
+#line 509 "src/parser.bison"
+                                                                                                {yyval = pg.new_expression_string(yyvsp[0]);}
+#line 2464 "_build/parser.yy.cc"
+    break;
+
+  case 117: /* lvalue: IDENTIFIER lvalue_accessor_clause_list  */
+#line 513 "src/parser.bison"
+                                               {yyval = pg.new_lvalue(yyvsp[-1], yyvsp[0]);}
+#line 2470 "_build/parser.yy.cc"
+    break;
+
+  case 118: /* lvalue_accessor_clause_list: %empty  */
+#line 517 "src/parser.bison"
+                                                             {yyval = pg.new_lvalue_accessor_clause_list_empty();}
+#line 2476 "_build/parser.yy.cc"
+    break;
+
+  case 119: /* lvalue_accessor_clause_list: lvalue_accessor_clause_list lvalue_accessor_clause  */
+#line 518 "src/parser.bison"
+                                                             {yyval = pg.new_lvalue_accessor_clause_list_cons(yyvsp[-1], yyvsp[0]);}
+#line 2482 "_build/parser.yy.cc"
+    break;
+
+  case 120: /* lvalue_accessor_clause: DOT_OPERATOR IDENTIFIER  */
+#line 522 "src/parser.bison"
+                                                                {yyval = pg.new_lvalue_accessor_clause_index(yyvsp[-1], yyvsp[0]);}
+#line 2488 "_build/parser.yy.cc"
+    break;
+
+  case 121: /* lvalue_accessor_clause: LEFTBRACKET_OPERATOR expression RIGHTBRACKET_OPERATOR  */
+#line 523 "src/parser.bison"
+                                                                {yyval = pg.new_lvalue_accessor_clause_array(yyvsp[-2], yyvsp[-1], yyvsp[0]);}
+#line 2494 "_build/parser.yy.cc"
+    break;
+
+
+#line 2498 "_build/parser.yy.cc"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YY_CPSL_CC_PARSEREMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      {
+        yypcontext_t yyctx
+          = {yyssp, yytoken};
+        char const *yymsgp = YY_("syntax error");
+        int yysyntax_error_status;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+        if (yysyntax_error_status == 0)
+          yymsgp = yymsg;
+        else if (yysyntax_error_status == -1)
+          {
+            if (yymsg != yymsgbuf)
+              YYSTACK_FREE (yymsg);
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
+              {
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
+              }
+            else
+              {
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
+              }
+          }
+        yyerror (parser_state, yymsgp);
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
+      }
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YY_CPSL_CC_PARSEREOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YY_CPSL_CC_PARSEREOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, parser_state);
+          yychar = YY_CPSL_CC_PARSEREMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, parser_state);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (parser_state, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YY_CPSL_CC_PARSEREMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, parser_state);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, parser_state);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+  if (yymsg != yymsgbuf)
+    YYSTACK_FREE (yymsg);
+  return yyresult;
+}
+
+#line 526 "src/parser.bison"
+
+
+ParserState::ParserState(Grammar &grammar)
+	: grammar(grammar)
+	, next_lexeme(0)
+	{}
+
+/*
+ * Feed in a lexeme: *lvalp = semantic value; return token type;
+ */
+int yy_cpsl_cc_parserlex(parser_yystype_t *lvalp, std::shared_ptr<ParserState> parser_state) {
+	for (; parser_state->next_lexeme < parser_state->grammar.lexemes.size(); ++parser_state->next_lexeme) {
+		const Lexeme &lexeme = parser_state->grammar.lexemes[parser_state->next_lexeme];
+
+		// Skip whitespace and comments when feeding the parser.
+		if (lexeme.tag == comment_tag || lexeme.tag == whitespace_tag) {
+			continue;
+		} else {
+			*lvalp = parser_state->next_lexeme++;
+			return lexeme.get_enumerated_token_kind();
+		}
+	}
+
+	// Done traversing lexemes.
+	return 0;
+}
+
+void yy_cpsl_cc_parsererror(std::shared_ptr<ParserState> parser_state, const char *s) {
+	std::ostringstream sstr;
+	sstr << "parser error: " << s;
+	throw GrammarError(sstr.str());
+}
+
+Grammar parse_lexemes(const std::vector<Lexeme> &lexemes, bool parser_trace) {
+	// Create a new storage for an AST.
+	Grammar grammar(lexemes);
+
+	if (parser_trace) {
+		yy_cpsl_cc_parserdebug = 1;
+	}
+
+	std::shared_ptr<ParserState> parser_state(new ParserState(grammar));
+	int status = yy_cpsl_cc_parserparse(parser_state);
+	// status: c.f. https://www.gnu.org/software/bison/manual/html_node/Parser-Function.html
+	switch (status) {
+		case 0: {
+			// Success.
+			break;
+		} case 1: {
+			// Invalid input.
+			std::ostringstream sstr;
+			sstr << "parser: Invalid input.";
+			throw GrammarError(sstr.str());
+		} case 2: {
+			// Out of memory.
+			std::ostringstream sstr;
+			sstr << "parser: out of memory.";
+			throw GrammarError(sstr.str());
+		} default: {
+			// Unknown status.
+			std::ostringstream sstr;
+			sstr << "parser: unrecognized status from parse: " << status;
+			throw GrammarError(sstr.str());
+		}
+	}
+
+	return grammar;
+}
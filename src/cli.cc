@@ -11,7 +11,7 @@
 #include <set>           // std::set
 #include <sstream>       // std::ostringstream
 #include <stdexcept>     // std::runtime_error
-#include <string>        // std::string
+#include <string>        // std::stoul, std::string
 #include <system_error>  // std::error_code (::message)
 #include <utility>       // std::as_const, std::exit, std::move, std::pair
 #include <vector>        // std::vector
@@ -184,15 +184,24 @@ bool cli::ArgsSpec::verify() const {
 const cli::ArgsSpec cli::ArgsSpec::default_args_spec {
 	// std::map<std::string, cli::ArgsSpec::OptionSpec> options
 	{
-		{"help",         {true}},
-		{"version",      {true}},
-		{"verbose",      {true}},
-		{"input",        {false}},
-		{"output",       {false}},
-		{"lexer",        {true}},
-		{"parser",       {true}},
-		{"parser-trace", {true}},
-		{"no-optimize",  {true}},
+		{"help",             {true}},
+		{"version",          {true}},
+		{"verbose",          {true}},
+		{"input",            {false}},
+		{"output",           {false}},
+		{"lexer",            {true}},
+		{"parser",           {true}},
+		{"parser-trace",     {true}},
+		{"no-optimize",      {true}},
+		{"unroll",           {false}},
+		{"auto-memoize",     {true}},
+		{"target-cpu",       {false}},
+		{"delayed-branches", {true}},
+		{"march",            {false}},
+		{"optimize",         {false}},
+		{"bounds-check",     {true}},
+		{"profile-generate", {true}},
+		{"profile-use",      {false}},
 	},
 
 	// std::map<std::string, std::string> option_aliases
@@ -210,6 +219,7 @@ const cli::ArgsSpec cli::ArgsSpec::default_args_spec {
 		{'v', "verbose"},
 		{'i', "input"},
 		{'o', "output"},
+		{'O', "optimize"},
 	},
 };
 
@@ -465,6 +475,20 @@ std::string cli::get_usage(const std::optional<std::string> &prog) {
 		<< "      --grammar        indicate if parsing the grammar of the input succeeded and stop after the parsing stage." << std::endl
 		<< "      --parser-trace," << std::endl
 		<< "      --grammar-trace  print bison tracing information while parsing." << std::endl
+		<< "      --unroll N       unroll small for loops to run N bodies per loop check (default " << Semantics::default_unroll_factor << "; 1 disables)." << std::endl
+		<< "      --auto-memoize   cache the results of pure recursive functions of small integer arguments." << std::endl
+		<< "      --target-cpu CPU[,KIND=CYCLES]..." << std::endl
+		<< "                       schedule instructions to hide latency on CPU (none (default), 5-stage, r3000, or r4000)," << std::endl
+		<< "                       optionally overriding the latency of alu, load, mult, or div instructions." << std::endl
+		<< "      --delayed-branches" << std::endl
+		<< "                       emit code for branches with delay slots, as on hardware, filling them where possible." << std::endl
+		<< "      --march ARCH     emit instructions from ARCH: mips1, mips32 (default), or mips32r2." << std::endl
+		<< "  -O, --optimize LEVEL optimize for speed (2, default) or for size (s)." << std::endl
+		<< "      --bounds-check   trap on array indices out of bounds, leaving out checks that are proven to pass." << std::endl
+		<< "      --profile-generate" << std::endl
+		<< "                       count how often each block runs, and print the counts when the program stops." << std::endl
+		<< "      --profile-use PATH" << std::endl
+		<< "                       optimize for the counts that a program compiled with --profile-generate printed to PATH." << std::endl
 		// Commented out until there are actually optimizations implemented.
 		//<< "      --no-optimize    don't apply optimizations." << std::endl
 		;
@@ -930,7 +954,145 @@ std::vector<std::string> cli::assemble(const ParsedArgs &parsed_args, const std:
 	Grammar grammar = parse_lexemes(lexemes, parsed_args.is("parser-trace"));
 
 	// Analyze the semantics and assemble the code.
-	Semantics semantics(std::move(Grammar(grammar)), !parsed_args.is("no-optimize"));
+	Semantics semantics(std::move(Grammar(grammar)), !parsed_args.is("no-optimize"), false);
+
+	// Get the loop unrolling factor.
+	std::optional<std::string> unroll_option = parsed_args.find("unroll");
+	if (unroll_option) {
+		const std::string &unroll_str = *unroll_option;
+		bool valid = unroll_str.size() >= 1 && unroll_str.size() <= 3;
+		for (const char &c : std::as_const(unroll_str)) {
+			if (c < '0' || c > '9') {
+				valid = false;
+			}
+		}
+		if (!valid || std::stoul(unroll_str) < 1) {
+			std::ostringstream sstr;
+			sstr << "cli::assemble: the unroll factor must be a number from 1 to 999, not `" << unroll_str << "'.";
+			throw cli::CLIError(sstr.str());
+		}
+		semantics.set_unroll_factor(static_cast<uint32_t>(std::stoul(unroll_str)));
+	}
+
+	semantics.set_auto_memoize(parsed_args.is("auto-memoize"));
+
+	// Get the CPU to schedule for, and any latencies that differ from it.
+	std::optional<std::string> target_cpu_option = parsed_args.find("target-cpu");
+	if (target_cpu_option) {
+		std::vector<std::string> target_cpu_fields;
+		for (std::string::size_type field_begin = 0; field_begin <= target_cpu_option->size(); ) {
+			const std::string::size_type field_end = std::min(target_cpu_option->find(',', field_begin), target_cpu_option->size());
+			target_cpu_fields.push_back(target_cpu_option->substr(field_begin, field_end - field_begin));
+			field_begin = field_end + 1;
+		}
+
+		std::optional<Semantics::LatencyModel> target_cpu;
+		const std::map<std::string, Semantics::LatencyModel>::const_iterator target_cpu_search = Semantics::target_cpus.find(target_cpu_fields[0]);
+		if        (target_cpu_search != Semantics::target_cpus.cend()) {
+			target_cpu = target_cpu_search->second;
+		} else if (target_cpu_fields[0] != "none") {
+			std::ostringstream sstr;
+			sstr << "cli::assemble: unrecognized target CPU `" << target_cpu_fields[0] << "'; expected none, 5-stage, r3000, or r4000.";
+			throw cli::CLIError(sstr.str());
+		}
+
+		for (const std::string &field : std::as_const(target_cpu_fields)) {
+			if (&field == &target_cpu_fields[0]) {
+				continue;
+			}
+			const std::string::size_type equals_pos = field.find('=');
+			const std::string            kind       = field.substr(0, equals_pos);
+			const std::string            cycles_str = equals_pos == std::string::npos ? "" : field.substr(equals_pos + 1);
+			bool valid = cycles_str.size() >= 1 && cycles_str.size() <= 3 && cycles_str.find_first_not_of("0123456789") == std::string::npos && std::stoul(cycles_str) >= 1;
+			uint32_t *latency = nullptr;
+			if        (!target_cpu.has_value()) {
+				valid = false;
+			} else if (kind == "alu") {
+				latency = &target_cpu->alu_latency;
+			} else if (kind == "load") {
+				latency = &target_cpu->load_latency;
+			} else if (kind == "mult") {
+				latency = &target_cpu->mult_latency;
+			} else if (kind == "div") {
+				latency = &target_cpu->div_latency;
+			} else {
+				valid = false;
+			}
+			if (!valid) {
+				std::ostringstream sstr;
+				sstr << "cli::assemble: a target CPU latency must be alu, load, mult, or div, then `=', then a number of cycles from 1 to 999, not `" << field << "'.";
+				throw cli::CLIError(sstr.str());
+			}
+			*latency = static_cast<uint32_t>(std::stoul(cycles_str));
+		}
+
+		semantics.set_target_cpu(target_cpu);
+	}
+
+	semantics.set_delayed_branches(parsed_args.is("delayed-branches"));
+
+	// Get the instruction set to emit.
+	std::optional<std::string> march_option = parsed_args.find("march");
+	if (march_option) {
+		const std::map<std::string, Semantics::architecture_t>::const_iterator architecture_search = Semantics::architectures.find(*march_option);
+		if (architecture_search == Semantics::architectures.cend()) {
+			std::ostringstream sstr;
+			sstr << "cli::assemble: unrecognized architecture `" << *march_option << "'; expected mips1, mips32, or mips32r2.";
+			throw cli::CLIError(sstr.str());
+		}
+		semantics.set_architecture(architecture_search->second);
+	}
+
+	// Check array indices at runtime?  The checks trap, which MIPS I can't.
+	if (parsed_args.is("bounds-check") && march_option && Semantics::architectures.at(*march_option) < Semantics::mips32_architecture) {
+		std::ostringstream sstr;
+		sstr << "cli::assemble: --bounds-check needs trap instructions, which architecture `" << *march_option << "' lacks.";
+		throw cli::CLIError(sstr.str());
+	}
+	semantics.set_bounds_check(parsed_args.is("bounds-check"));
+
+	// Optimize for speed or size?
+	std::optional<std::string> optimize_option = parsed_args.find("optimize");
+	if (optimize_option) {
+		if        (*optimize_option == "s") {
+			semantics.set_optimize_size(true);
+		} else if (*optimize_option == "2") {
+			semantics.set_optimize_size(false);
+		} else {
+			std::ostringstream sstr;
+			sstr << "cli::assemble: unrecognized optimization level `" << *optimize_option << "'; expected 2 or s.";
+			throw cli::CLIError(sstr.str());
+		}
+	}
+
+	// Count how often each block runs, or optimize for such counts?
+	semantics.set_profile_generate(parsed_args.is("profile-generate"));
+	std::optional<std::string> profile_use_option = parsed_args.find("profile-use");
+	if (profile_use_option) {
+		const Semantics::Profile profile = Semantics::parse_profile(readlines(parsed_args, *profile_use_option));
+		if (profile.empty()) {
+			std::ostringstream sstr;
+			sstr << "cli::assemble: no profile counts were found in `" << *profile_use_option << "'.";
+			throw cli::CLIError(sstr.str());
+		}
+		semantics.set_profile(profile);
+	}
+
+	semantics.analyze();
+
+	// Report what was memoized, with -Os, the size of each routine, and, with
+	// --bounds-check, how many checks are left.
+	if (parsed_args.is("verbose")) {
+		for (const std::string &memoized_function : std::as_const(semantics.get_memoized_functions())) {
+			std::cerr << memoized_function << std::endl;
+		}
+		for (const std::string &size_line : std::as_const(semantics.get_size_report())) {
+			std::cerr << size_line << std::endl;
+		}
+		if (parsed_args.is("bounds-check")) {
+			std::cerr << "array bounds checks left: " << semantics.get_num_bounds_checks() << "." << std::endl;
+		}
+	}
 
 	// Obtain the assembly output.
 	output_lines = semantics.get_normalized_output_lines_copy();
@@ -1,6 +1,6 @@
 // TODO: this should be split into multiple files.
 
-#include <algorithm>     // std::max, std::min, std::reverse, std::stable_sort, std::swap
+#include <algorithm>     // std::find, std::max, std::max_element, std::min, std::min_element, std::reverse, std::sort, std::stable_sort, std::swap
 #include <cassert>       // assert
 #include <cctype>        // isalnum, isprint, tolower
 #include <cstddef>       // std::size_t
@@ -11,8 +11,9 @@
 #include <memory>        // std::shared_ptr
 #include <optional>      // std::optional
 #include <set>           // std::set
-#include <sstream>       // std::ostringstream
+#include <sstream>       // std::istringstream, std::ostringstream
 #include <string>        // std::string, std::to_string
+#include <tuple>         // std::get, std::tuple
 #include <type_traits>   // std::make_unsigned
 #include <utility>       // std::as_const, std::move, std::pair
 #include <vector>        // std::vector
@@ -43,6 +44,33 @@ const bool Semantics::permit_shadowing               = CPSL_CC_SEMANTICS_PERMIT_
 const bool Semantics::emit_some_redundant_labels     = CPSL_CC_SEMANTICS_EMIT_SOME_REDUNDANT_LABELS;
 const bool Semantics::emit_extra_redundant_labels    = CPSL_CC_SEMANTICS_EMIT_EXTRA_REDUNDANT_LABELS;
 const bool Semantics::permit_unused_function_outputs = CPSL_CC_SEMANTICS_PERMIT_UNUSED_FUNCTION_OUTPUTS;
+const uint32_t Semantics::small_data_threshold       = CPSL_CC_SEMANTICS_SMALL_DATA_THRESHOLD;
+const uint32_t Semantics::small_data_max_size        = CPSL_CC_SEMANTICS_SMALL_DATA_MAX_SIZE;
+const uint32_t Semantics::default_unroll_factor      = CPSL_CC_SEMANTICS_DEFAULT_UNROLL_FACTOR;
+const uint32_t Semantics::max_unroll_body_size       = CPSL_CC_SEMANTICS_MAX_UNROLL_BODY_SIZE;
+const uint32_t Semantics::max_full_unroll_size       = CPSL_CC_SEMANTICS_MAX_FULL_UNROLL_SIZE;
+const uint32_t Semantics::max_if_conversion_arm_size = CPSL_CC_SEMANTICS_MAX_IF_CONVERSION_ARM_SIZE;
+const uint32_t Semantics::max_routine_specializations  = CPSL_CC_SEMANTICS_MAX_ROUTINE_SPECIALIZATIONS;
+const uint64_t Semantics::min_specialization_weight    = CPSL_CC_SEMANTICS_MIN_SPECIALIZATION_WEIGHT;
+const uint64_t Semantics::max_specialized_routine_size = CPSL_CC_SEMANTICS_MAX_SPECIALIZED_ROUTINE_SIZE;
+const uint32_t Semantics::max_memo_table_entries       = CPSL_CC_SEMANTICS_MAX_MEMO_TABLE_ENTRIES;
+const uint32_t Semantics::min_scalar_record_working_registers = CPSL_CC_SEMANTICS_MIN_SCALAR_RECORD_WORKING_REGISTERS;
+const uint32_t Semantics::peephole_window              = CPSL_CC_SEMANTICS_PEEPHOLE_WINDOW;
+const Semantics::architecture_t Semantics::default_architecture = CPSL_CC_SEMANTICS_DEFAULT_ARCHITECTURE;
+
+const std::map<std::string, Semantics::architecture_t> Semantics::architectures {
+	{"mips1",    mips1_architecture},
+	{"mips32",   mips32_architecture},
+	{"mips32r2", mips32r2_architecture},
+};
+
+const std::map<std::string, Semantics::LatencyModel> Semantics::target_cpus {
+	// A classic 5-stage pipeline with forwarding: loads have a 1-cycle delay,
+	// and a small iterative multiplier and divider.
+	{"5-stage", {1, 2, 5, 20}},
+	{"r3000",   {1, 2, 12, 35}},
+	{"r4000",   {1, 3, 10, 69}},
+};
 
 Semantics::RoutineBlockState::RoutineBlockState()
 	{}
@@ -51,6 +79,62 @@ Semantics::RoutineBlockState::RoutineBlockState(int32_t dynamically_allocated)
 	: dynamically_allocated(dynamically_allocated)
 	{}
 
+Semantics::RoutineSpecialization::RoutineSpecialization()
+	{}
+
+Semantics::RoutineSpecialization::RoutineSpecialization(const Symbol &location, const std::vector<std::optional<ConstantValue>> &arguments, const std::string &label_suffix)
+	: location(location)
+	, arguments(arguments)
+	, label_suffix(label_suffix)
+	{}
+
+bool Semantics::RoutineSpecialization::matches(const std::vector<ConstantValue> &call_arguments) const {
+	for (const std::optional<ConstantValue> &argument : std::as_const(arguments)) {
+		const std::vector<std::optional<ConstantValue>>::size_type argument_index = &argument - &arguments[0];
+		if (argument.has_value() && (argument_index >= call_arguments.size() || !argument->matches(call_arguments[argument_index]))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint64_t Semantics::RoutineSpecialization::count_constants() const {
+	uint64_t constants = 0;
+	for (const std::optional<ConstantValue> &argument : std::as_const(arguments)) {
+		if (argument.has_value()) {
+			++constants;
+		}
+	}
+	return constants;
+}
+
+Semantics::MemoTable::MemoTable()
+	{}
+
+Semantics::MemoTable::MemoTable(const Symbol &body_location, const Symbol &values_symbol, const Symbol &valid_symbol, const std::vector<uint32_t> &extents, bool is_word)
+	: body_location(body_location)
+	, values_symbol(values_symbol)
+	, valid_symbol(valid_symbol)
+	, extents(extents)
+	, is_word(is_word)
+	{}
+
+uint32_t Semantics::MemoTable::get_num_entries() const {
+	uint32_t num_entries = 1;
+	for (const uint32_t &extent : std::as_const(extents)) {
+		num_entries *= extent;
+	}
+	return num_entries;
+}
+
+Semantics::PeepholeRule::PeepholeRule()
+	{}
+
+Semantics::PeepholeRule::PeepholeRule(const std::vector<std::vector<std::string>> &pattern, const std::vector<std::vector<std::string>> &replacement)
+	: pattern(pattern)
+	, replacement(replacement)
+	{}
+
 Semantics::Symbol::Symbol()
 	{}
 
@@ -633,21 +717,24 @@ bool Semantics::Output::is_section_empty(section_t section) const {
 Semantics::Type::Base::Base()
 	{}
 
-Semantics::Type::Base::Base(const std::string &identifier, bool fixed_width, uint32_t size)
+Semantics::Type::Base::Base(const std::string &identifier, bool fixed_width, uint32_t size, uint32_t alignment)
 	: identifier(identifier)
 	, fixed_width(fixed_width)
 	, size(size)
+	, alignment(alignment != 0 ? alignment : std::max(static_cast<uint32_t>(1), std::min(size, static_cast<uint32_t>(4))))
 	{}
 
-Semantics::Type::Base::Base(std::string &&identifier, bool fixed_width, uint32_t size)
+Semantics::Type::Base::Base(std::string &&identifier, bool fixed_width, uint32_t size, uint32_t alignment)
 	: identifier(std::move(identifier))
 	, fixed_width(fixed_width)
 	, size(size)
+	, alignment(alignment != 0 ? alignment : std::max(static_cast<uint32_t>(1), std::min(size, static_cast<uint32_t>(4))))
 	{}
 
 const std::string &Semantics::Type::Base::get_identifier()  const { return identifier; }
 bool               Semantics::Type::Base::get_fixed_width() const { return fixed_width; }
 uint32_t           Semantics::Type::Base::get_size()        const { return size; }
+uint32_t           Semantics::Type::Base::get_alignment()   const { return alignment; }
 
 Semantics::Type::Primitive::Primitive()
 	{}
@@ -855,7 +942,7 @@ Semantics::Type::Simple::Simple(Base &&base, const Type &referent)
 #endif /* #if 0 */
 
 Semantics::Type::Simple::Simple(const std::string &identifier, TypeIndex referent, const IdentifierScope &storage_scope)
-	: Base(identifier, storage_scope.type(referent).get_fixed_width(), storage_scope.type(referent).get_size())
+	: Base(identifier, storage_scope.type(referent).get_fixed_width(), storage_scope.type(referent).get_size(), storage_scope.type(referent).get_alignment())
 	, referent(referent)
 	{}
 
@@ -937,20 +1024,34 @@ Semantics::Type::Record::Record(const std::string &identifier, std::vector<std::
 	this->identifier = identifier;
 	fixed_width = true;
 	size = 0;
-	for (const std::pair<std::string, TypeIndex> &field : this->fields) {
+	alignment = 1;
+
+	// Lay out the most strictly aligned fields first.  Every size is a
+	// multiple of its alignment, so no padding is needed between fields.
+	std::vector<std::vector<std::pair<std::string, TypeIndex>>::size_type> layout_order;
+	for (const std::pair<std::string, TypeIndex> &field : std::as_const(this->fields)) {
+		layout_order.push_back(&field - &this->fields[0]);
+	}
+	std::stable_sort(layout_order.begin(), layout_order.end(), [&] (std::vector<std::pair<std::string, TypeIndex>>::size_type a, std::vector<std::pair<std::string, TypeIndex>>::size_type b) -> bool {
+		return storage_scope.type(this->fields[a].second).get_alignment() > storage_scope.type(this->fields[b].second).get_alignment();
+	});
+
+	field_offsets = std::vector<uint32_t>(this->fields.size(), 0);
+	for (const std::vector<std::pair<std::string, TypeIndex>>::size_type &field_index : std::as_const(layout_order)) {
 		// TODO: check for overflow.
-		const std::string &field_identifier = field.first;
-		const Type        &field_type       = storage_scope.type(field.second);
+		const Type &field_type = storage_scope.type(this->fields[field_index].second);
 
 		if (!field_type.get_fixed_width()) {
 			fixed_width = false;
 		}
 
-		size = Instruction::AddSp::round_to_align(size, field_type.get_size());
+		size = Instruction::AddSp::round_to_align(size, field_type.get_alignment());
+		field_offsets[field_index] = size;
 		size += field_type.get_size();
+		alignment = std::max(alignment, field_type.get_alignment());
 	}
 
-	size = Instruction::AddSp::round_to_align(size);
+	size = Instruction::AddSp::round_to_align(size, alignment);
 }
 
 // | Used for comparison and equality checking.
@@ -1034,6 +1135,7 @@ Semantics::Type::Array::Array(const std::string &identifier, TypeIndex base_type
 		throw SemanticsError(sstr.str());
 	}
 	size = get_index_range() * storage_scope.type(base_type).get_size();
+	alignment = storage_scope.type(base_type).get_alignment();
 }
 
 int32_t Semantics::Type::Array::get_min_index() const {
@@ -1141,6 +1243,10 @@ uint32_t Semantics::Type::get_size() const {
 	return get_base().size;
 }
 
+uint32_t Semantics::Type::get_alignment() const {
+	return get_base().alignment;
+}
+
 Semantics::Type::Base &&Semantics::Type::get_base() {
 	switch(tag) {
 		case primitive_tag:
@@ -2143,6 +2249,22 @@ std::string Semantics::ConstantValue::get_tag_repr() const {
 	return get_tag_repr(tag);
 }
 
+bool Semantics::ConstantValue::matches(const ConstantValue &other) const {
+	if (tag != other.tag) {
+		return false;
+	}
+	switch (tag) {
+		case integer_tag:
+			return get_integer() == other.get_integer();
+		case char_tag:
+			return get_char() == other.get_char();
+		case boolean_tag:
+			return get_boolean() == other.get_boolean();
+		default:
+			return false;
+	}
+}
+
 const Semantics::Type::Primitive &Semantics::ConstantValue::get_static_primitive_type() const {
 	switch(tag) {
 		case dynamic_tag: {
@@ -2307,6 +2429,154 @@ std::vector<Semantics::Output::Line> Semantics::ConstantValue::data_string(const
 	return data_lines;
 }
 
+Semantics::ValueRange::ValueRange()
+	: min(std::numeric_limits<int32_t>::min())
+	, max(std::numeric_limits<int32_t>::max())
+	{}
+
+Semantics::ValueRange::ValueRange(int64_t min, int64_t max)
+	: min(min)
+	, max(max)
+	{}
+
+Semantics::ValueRange::ValueRange(const ConstantValue &constant_value)
+	: ValueRange()
+{
+	if        (constant_value.is_integer()) {
+		min = max = constant_value.get_integer();
+	} else if (constant_value.is_char()) {
+		min = max = static_cast<int32_t>(constant_value.get_char());
+	} else if (constant_value.is_boolean()) {
+		min = max = constant_value.get_boolean() ? 1 : 0;
+	}
+}
+
+const Semantics::ValueRange Semantics::ValueRange::word_range    {};
+const Semantics::ValueRange Semantics::ValueRange::byte_range    {std::numeric_limits<int8_t>::min(), std::numeric_limits<int8_t>::max()};
+const Semantics::ValueRange Semantics::ValueRange::boolean_range {0, 1};
+
+bool Semantics::ValueRange::operator==(const ValueRange &other) const {
+	return min == other.min && max == other.max;
+}
+
+bool Semantics::ValueRange::operator!=(const ValueRange &other) const {
+	return !(*this == other);
+}
+
+bool Semantics::ValueRange::is_constant() const {
+	return min == max;
+}
+
+bool Semantics::ValueRange::is_within(int64_t min, int64_t max) const {
+	return this->min >= min && this->max <= max;
+}
+
+bool Semantics::ValueRange::is_within(const ValueRange &other) const {
+	return is_within(other.min, other.max);
+}
+
+bool Semantics::ValueRange::is_nonnegative() const {
+	return min >= 0;
+}
+
+std::optional<uint32_t> Semantics::ValueRange::get_power_of_2() const {
+	if (!is_constant() || min <= 0 || (min & (min - 1)) != 0) {
+		return std::optional<uint32_t>();
+	}
+
+	uint32_t power = 0;
+	while ((static_cast<int64_t>(1) << power) < min) {
+		++power;
+	}
+	return power;
+}
+
+Semantics::ValueRange Semantics::ValueRange::join(const ValueRange &other) const {
+	return ValueRange(std::min(min, other.min), std::max(max, other.max));
+}
+
+Semantics::ValueRange Semantics::ValueRange::meet(const ValueRange &other) const {
+	const ValueRange both(std::max(min, other.min), std::min(max, other.max));
+	if (both.min > both.max) {
+		return *this;
+	}
+	return both;
+}
+
+Semantics::ValueRange Semantics::ValueRange::wrap(int64_t min, int64_t max) {
+	if (min < std::numeric_limits<int32_t>::min() || max > std::numeric_limits<int32_t>::max()) {
+		return word_range;
+	}
+	return ValueRange(min, max);
+}
+
+Semantics::ValueRange Semantics::ValueRange::add(const ValueRange &other) const {
+	return wrap(min + other.min, max + other.max);
+}
+
+Semantics::ValueRange Semantics::ValueRange::subtract(const ValueRange &other) const {
+	return wrap(min - other.max, max - other.min);
+}
+
+Semantics::ValueRange Semantics::ValueRange::multiply(const ValueRange &other) const {
+	// Both are words, so the products fit.
+	const int64_t products[4] {min * other.min, min * other.max, max * other.min, max * other.max};
+	return wrap(*std::min_element(products, products + 4), *std::max_element(products, products + 4));
+}
+
+Semantics::ValueRange Semantics::ValueRange::divide(const ValueRange &other) const {
+	if (other.min <= 0 && other.max >= 0) {
+		return word_range;
+	}
+
+	// With a divisor of one sign, the extremes are at the corners.
+	const int64_t quotients[4] {min / other.min, min / other.max, max / other.min, max / other.max};
+	return wrap(*std::min_element(quotients, quotients + 4), *std::max_element(quotients, quotients + 4));
+}
+
+Semantics::ValueRange Semantics::ValueRange::remainder(const ValueRange &other) const {
+	if (other.min <= 0 && other.max >= 0) {
+		return word_range;
+	}
+
+	// The remainder is smaller in magnitude than the divisor and the
+	// dividend, and takes the dividend's sign.
+	const int64_t magnitude = std::max(other.min < 0 ? -other.min : other.min, other.max < 0 ? -other.max : other.max) - 1;
+	return ValueRange(std::max(std::min(min, static_cast<int64_t>(0)), -magnitude), std::min(std::max(max, static_cast<int64_t>(0)), magnitude));
+}
+
+Semantics::ValueRange Semantics::ValueRange::bitwise_and(const ValueRange &other) const {
+	if        (is_nonnegative() && other.is_nonnegative()) {
+		return ValueRange(0, std::min(max, other.max));
+	} else if (is_nonnegative()) {
+		return ValueRange(0, max);
+	} else if (other.is_nonnegative()) {
+		return ValueRange(0, other.max);
+	} else {
+		return word_range;
+	}
+}
+
+Semantics::ValueRange Semantics::ValueRange::bitwise_or(const ValueRange &other) const {
+	if (!is_nonnegative() || !other.is_nonnegative()) {
+		return word_range;
+	}
+
+	// No more bits than the wider of the two.
+	int64_t mask = 0;
+	while (mask < std::max(max, other.max)) {
+		mask = (mask << 1) | 1;
+	}
+	return ValueRange(std::max(min, other.min), mask);
+}
+
+Semantics::ValueRange Semantics::ValueRange::store_byte() const {
+	if (is_within(byte_range)) {
+		return *this;
+	}
+	return join(byte_range);
+}
+
 Semantics::IdentifierScope::IdentifierBinding::Static::Static()
 	{}
 
@@ -2909,6 +3179,117 @@ void Semantics::set_grammar(Grammar &&grammar) {
 	}
 }
 
+void Semantics::set_unroll_factor(uint32_t unroll_factor) {
+	this->unroll_factor = unroll_factor >= 1 ? unroll_factor : 1;
+
+	if (auto_analyze) {
+		analyze();
+	}
+}
+
+void Semantics::set_auto_memoize(bool auto_memoize) {
+	this->auto_memoize = auto_memoize;
+
+	if (auto_analyze) {
+		analyze();
+	}
+}
+
+void Semantics::set_target_cpu(const std::optional<LatencyModel> &target_cpu) {
+	this->target_cpu = target_cpu;
+
+	if (auto_analyze) {
+		analyze();
+	}
+}
+
+void Semantics::set_delayed_branches(bool delayed_branches) {
+	this->delayed_branches = delayed_branches;
+
+	if (auto_analyze) {
+		analyze();
+	}
+}
+
+void Semantics::set_architecture(architecture_t architecture) {
+	this->architecture = architecture;
+
+	if (auto_analyze) {
+		analyze();
+	}
+}
+
+const std::vector<std::string> &Semantics::get_memoized_functions() const {
+	return memoized_functions;
+}
+
+void Semantics::set_optimize_size(bool optimize_size) {
+	this->optimize_size = optimize_size;
+
+	if (auto_analyze) {
+		analyze();
+	}
+}
+
+const std::vector<std::string> &Semantics::get_size_report() const {
+	return size_report;
+}
+
+void Semantics::set_bounds_check(bool bounds_check) {
+	this->bounds_check = bounds_check;
+
+	if (auto_analyze) {
+		analyze();
+	}
+}
+
+uint64_t Semantics::get_num_bounds_checks() const {
+	return num_bounds_checks;
+}
+
+void Semantics::set_profile_generate(bool profile_generate) {
+	this->profile_generate = profile_generate;
+
+	if (auto_analyze) {
+		analyze();
+	}
+}
+
+void Semantics::set_profile(const Profile &profile) {
+	this->profile = profile;
+
+	if (auto_analyze) {
+		analyze();
+	}
+}
+
+// | Each counter is printed on a line of its own as "profile ROUTINE BLOCK
+// COUNT", but the program's own output may precede it on the line.
+Semantics::Profile Semantics::parse_profile(const std::vector<std::string> &lines) {
+	Profile profile;
+	for (const std::string &line : std::as_const(lines)) {
+		const std::string::size_type profile_pos = line.rfind("profile ");
+		if (profile_pos == std::string::npos) {
+			continue;
+		}
+
+		std::istringstream sline(line.substr(profile_pos + 8));
+		std::string routine;
+		std::string block;
+		int64_t     count;
+		if (!(sline >> routine >> block >> count)) {
+			continue;
+		}
+
+		// The program prints counts as signed words.
+		if (count < 0) {
+			count += static_cast<int64_t>(1) << 32;
+		}
+		profile[{routine, block}] += static_cast<uint64_t>(count);
+	}
+	return profile;
+}
+
 // | Determine whether the expression in the grammar tree is a constant expression.
 Semantics::ConstantValue Semantics::is_expression_constant(
 	// | Reference to the expression in the grammar tree.
@@ -4638,6 +5019,28 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::emit_binary_operati
 	return lines;
 }
 
+void Semantics::Instruction::emit_load(std::vector<Output::Line> &lines, const Storage &source_storage, const std::string &destination_register, bool is_word) {
+	Output::Line sized_load = is_word ? "\tlw    " : "\tlb    ";
+
+	if        (source_storage.is_register_direct()) {
+		if (source_storage.register_ != destination_register) {
+			lines.push_back("\tla    " + destination_register + ", (" + source_storage.register_ + ")");
+		}
+	} else if (source_storage.is_register_dereference()) {
+		std::string offset_string = source_storage.offset == 0 ? "" : std::to_string(source_storage.offset);
+		lines.push_back(sized_load + destination_register + ", " + offset_string + "(" + source_storage.register_ + ")");
+	} else if (source_storage.is_global_address()) {
+		lines.push_back("\tla    " + destination_register + ", " + source_storage.global_address);
+		if (source_storage.offset != 0) {
+			lines.push_back("\tla    " + destination_register + ", " + std::to_string(source_storage.offset) + "(" + destination_register + ")");
+		}
+	} else { //source_storage.is_global_dereference)
+		lines.push_back("\tla    " + destination_register + ", " + source_storage.global_address);
+		std::string offset_string = source_storage.offset == 0 ? "" : std::to_string(source_storage.offset);
+		lines.push_back(sized_load + destination_register + ", " + offset_string + "(" + destination_register + ")");
+	}
+}
+
 Semantics::Instruction::Base::Base()
 	: has_symbol(false)
 	{}
@@ -4970,7 +5373,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::LoadImmediate::emit
 Semantics::Instruction::LoadFrom::LoadFrom()
 	{}
 
-Semantics::Instruction::LoadFrom::LoadFrom(const Base &base, bool is_word_save, bool is_word_load, int32_t addition, bool is_save_fixed, bool is_load_fixed, const Storage &fixed_save_storage, const Storage &fixed_load_storage, bool dereference_save, bool dereference_load, bool get_dest_address_from_input )
+Semantics::Instruction::LoadFrom::LoadFrom(const Base &base, bool is_word_save, bool is_word_load, int32_t addition, bool is_save_fixed, bool is_load_fixed, const Storage &fixed_save_storage, const Storage &fixed_load_storage, bool dereference_save, bool dereference_load, bool get_dest_address_from_input, int32_t dereference_save_offset, int32_t dereference_load_offset)
 	: Base(base)
 	, is_word_save(is_word_save)
 	, is_word_load(is_word_load)
@@ -4982,6 +5385,8 @@ Semantics::Instruction::LoadFrom::LoadFrom(const Base &base, bool is_word_save,
 	, dereference_save(dereference_save)
 	, dereference_load(dereference_load)
 	, get_dest_address_from_input(get_dest_address_from_input)
+	, dereference_save_offset(dereference_save_offset)
+	, dereference_load_offset(dereference_load_offset)
 	{}
 
 Semantics::Instruction::LoadFrom::LoadFrom(const Base &base, bool is_word_save, bool is_word_load, int32_t addition)
@@ -5076,6 +5481,10 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::LoadFrom::emit(cons
 	// Get virtual addition.
 	int32_t virtual_addition = addition;
 
+	// Get the offsets applied to dereferenced addresses.
+	const std::string load_dereference_offset_string = dereference_load_offset == 0 ? "" : std::to_string(dereference_load_offset);
+	const std::string save_dereference_offset_string = dereference_save_offset == 0 ? "" : std::to_string(dereference_save_offset);
+
 	// Part 1: load/read into $t9 unless it's a non-dereferenced direct register.
 	std::string source_register = "$t9";
 	bool is_t9_free = false;
@@ -5094,7 +5503,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::LoadFrom::emit(cons
 			}
 		} else {
 			if (post_dereference_load) {
-				lines.push_back(sized_load + source_register + ", (" + source_storage.register_ + ")");
+				lines.push_back(sized_load + source_register + ", " + load_dereference_offset_string + "(" + source_storage.register_ + ")");
 				if (virtual_addition != 0) {
 					lines.push_back("\tla    " + source_register + ", " + std::to_string(virtual_addition) + "(" + source_register + ")");
 				}
@@ -5109,7 +5518,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::LoadFrom::emit(cons
 			lines.push_back(sized_load + source_register + ", " + offset_string + "(" + source_storage.register_ + ")");
 		} else {
 			lines.push_back("\tlw    " + source_register + ", " + offset_string + "(" + source_storage.register_ + ")");
-			lines.push_back(sized_load + source_register + ", ($t9)");
+			lines.push_back(sized_load + source_register + ", " + load_dereference_offset_string + "(" + source_register + ")");
 		}
 		if (virtual_addition != 0) {
 			lines.push_back("\tla    " + source_register + ", " + std::to_string(virtual_addition) + "(" + source_register + ")");
@@ -5117,7 +5526,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::LoadFrom::emit(cons
 	} else if (source_storage.is_global_address()) {
 		lines.push_back("\tla    " + source_register + ", " + source_storage.global_address);
 		if (post_dereference_load) {
-			lines.push_back(sized_load + source_register + ", (" + source_register + ")");
+			lines.push_back(sized_load + source_register + ", " + load_dereference_offset_string + "(" + source_register + ")");
 		}
 		if (virtual_addition != 0) {
 			lines.push_back("\tla    " + source_register + ", " + std::to_string(virtual_addition) + "(" + source_register + ")");
@@ -5132,7 +5541,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::LoadFrom::emit(cons
 			lines.push_back(sized_load + source_register + ", " + offset_string + "(" + source_register + ")");
 		} else {
 			lines.push_back("\tlw    " + source_register + ", " + offset_string + "(" + source_register + ")");
-			lines.push_back(sized_load + source_register + ", (" + source_register + ")");
+			lines.push_back(sized_load + source_register + ", " + load_dereference_offset_string + "(" + source_register + ")");
 		}
 		if (virtual_addition != 0) {
 			lines.push_back("\tla    " + source_register + ", " + std::to_string(virtual_addition) + "(" + source_register + ")");
@@ -5152,7 +5561,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::LoadFrom::emit(cons
 				lines.push_back("\tla    " + destination_storage.register_ + ", " + std::to_string(virtual_addition) + "(" + source_register + ")");
 			}
 		} else {
-			lines.push_back(sized_save + source_register + ", (" + destination_storage.register_ + ")");
+			lines.push_back(sized_save + source_register + ", " + save_dereference_offset_string + "(" + destination_storage.register_ + ")");
 		}
 	} else if (destination_storage.is_register_dereference()) {
 		std::string offset_string = destination_storage.offset == 0 ? "" : std::to_string(destination_storage.offset);
@@ -5160,7 +5569,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::LoadFrom::emit(cons
 			lines.push_back(sized_save + source_register + ", " + offset_string + "(" + destination_storage.register_ + ")");
 		} else {
 			lines.push_back("\tlw    " + free_register + ", " + offset_string + "(" + destination_storage.register_ + ")");
-			lines.push_back(sized_save + source_register + ", (" + free_register + ")");
+			lines.push_back(sized_save + source_register + ", " + save_dereference_offset_string + "(" + free_register + ")");
 		}
 	} else if (destination_storage.is_global_address()) {
 		if (!post_dereference_save) {
@@ -5169,7 +5578,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::LoadFrom::emit(cons
 			throw SemanticsError(sstr.str());
 		} else {
 			lines.push_back("\tla    " + free_register + ", " + destination_storage.global_address);
-			std::string offset_string = destination_storage.offset == 0 ? "" : std::to_string(destination_storage.offset);
+			std::string offset_string = destination_storage.offset + dereference_save_offset == 0 ? "" : std::to_string(destination_storage.offset + dereference_save_offset);
 			lines.push_back(sized_save + source_register + ", " + offset_string + "(" + free_register + ")");
 		}
 	} else { //destination_storage.is_global_dereference()
@@ -5179,7 +5588,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::LoadFrom::emit(cons
 			lines.push_back(sized_save + source_register + ", " + offset_string + "(" + free_register + ")");
 		} else {
 			lines.push_back("\tlw    " + free_register + ", " + offset_string + "(" +  free_register+ ")");
-			lines.push_back(sized_save + source_register + ", (" + free_register + ")");
+			lines.push_back(sized_save + source_register + ", " + save_dereference_offset_string + "(" + free_register + ")");
 		}
 	}
 
@@ -5334,7 +5743,7 @@ std::vector<uint32_t> Semantics::Instruction::MultFrom::get_working_sizes() cons
 std::vector<uint32_t> Semantics::Instruction::MultFrom::get_output_sizes() const { if (ignore_hi && ignore_lo) { return {}; } else if (ignore_hi != ignore_lo) { return {static_cast<uint32_t>(is_word ? 4 : 1)}; } else { return {static_cast<uint32_t>(is_word ? 4 : 1), static_cast<uint32_t>(is_word ? 4 : 1)}; } }
 std::vector<uint32_t> Semantics::Instruction::MultFrom::get_all_sizes() const { std::vector<uint32_t> v, i(std::move(get_input_sizes())), w(std::move(get_working_sizes())), o(std::move(get_output_sizes())); v.insert(v.end(), i.cbegin(), i.cend()); v.insert(v.end(), w.cbegin(), w.cend()); v.insert(v.end(), o.cbegin(), o.cend()); return v; }
 
-std::vector<Semantics::Output::Line> Semantics::Instruction::MultFrom::emit(const std::vector<Storage> &storages) const {
+std::vector<Semantics::Output::Line> Semantics::Instruction::MultFrom::emit(const std::vector<Storage> &storages, architecture_t architecture) const {
 	// Get operations and configuration.
 	const Instruction  instruction(*this);
 	const bool         is_save_word     = is_word;
@@ -5444,15 +5853,21 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::MultFrom::emit(cons
 		lines.push_back(sized_load + "" + left_register + ", " + offset_string + "(" + left_register + ")");
 	}
 
-	// Part 3: perform the binary operation.
-	lines.push_back(binary_operation + left_register + ", " + right_register);
+	// Part 3: perform the binary operation.  If only Lo is wanted, MIPS32's
+	// "mul" can write it straight to a register instead, in part 4.
+	const bool is_mul = ignore_hi && !ignore_lo && architecture >= mips32_architecture;
+	const Output::Line move_from_lo = is_mul ? "\tmul   " : "\tmflo  ";
+	const std::string  mul_operands = is_mul ? ", " + left_register + ", " + right_register : "";
+	if (!is_mul) {
+		lines.push_back(binary_operation + left_register + ", " + right_register);
+	}
 
 	// Part 4: write to the left destination.
 	if (!ignore_lo) {
 		if        (left_destination_storage.is_register_direct()) {
-			lines.push_back("\tmflo  " + left_destination_storage.register_);
+			lines.push_back(move_from_lo + left_destination_storage.register_ + mul_operands);
 		} else if (left_destination_storage.is_register_dereference()) {
-			lines.push_back("\tmflo  $t9");
+			lines.push_back(move_from_lo + "$t9" + mul_operands);
 			std::string offset_string = left_destination_storage.offset == 0 ? "" : std::to_string(left_destination_storage.offset);
 			lines.push_back(sized_save + "$t9" + ", " + offset_string + "(" + left_destination_storage.register_ + ")");
 		} else if (left_destination_storage.is_global_address()) {
@@ -5460,7 +5875,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::MultFrom::emit(cons
 			sstr << "Semantics::Instruction::MultFrom::emit: error: cannot save to a global address without dereferencing it.";
 			throw SemanticsError(sstr.str());
 		} else { //left_destination_storage.is_global_dereference)
-			lines.push_back("\tmflo  $t9");
+			lines.push_back(move_from_lo + "$t9" + mul_operands);
 			lines.push_back("\tla    $t8, " + left_destination_storage.global_address);
 			std::string offset_string = left_destination_storage.offset == 0 ? "" : std::to_string(left_destination_storage.offset);
 			lines.push_back(sized_save + "$t9, " + offset_string + "($t8)");
@@ -5473,7 +5888,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::MultFrom::emit(cons
 			lines.push_back("\tmfhi  " + right_destination_storage.register_);
 		} else if (right_destination_storage.is_register_dereference()) {
 			lines.push_back("\tmfhi  $t9");
-			std::string offset_string = right_destination_storage.offset == 0 ? "" : std::to_string(left_destination_storage.offset);
+			std::string offset_string = right_destination_storage.offset == 0 ? "" : std::to_string(right_destination_storage.offset);
 			lines.push_back(sized_save + "$t9" + ", " + offset_string + "(" + right_destination_storage.register_ + ")");
 		} else if (right_destination_storage.is_global_address()) {
 			std::ostringstream sstr;
@@ -5482,7 +5897,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::MultFrom::emit(cons
 		} else { //right_destination_storage.is_global_dereference)
 			lines.push_back("\tmfhi  $t9");
 			lines.push_back("\tla    $t8, " + right_destination_storage.global_address);
-			std::string offset_string = right_destination_storage.offset == 0 ? "" : std::to_string(left_destination_storage.offset);
+			std::string offset_string = right_destination_storage.offset == 0 ? "" : std::to_string(right_destination_storage.offset);
 			lines.push_back(sized_save + "$t9, " + offset_string + "($t8)");
 		}
 	}
@@ -5494,11 +5909,12 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::MultFrom::emit(cons
 Semantics::Instruction::DivFrom::DivFrom()
 	{}
 
-Semantics::Instruction::DivFrom::DivFrom(const Base &base, bool is_word, bool ignore_hi, bool ignore_lo)
+Semantics::Instruction::DivFrom::DivFrom(const Base &base, bool is_word, bool ignore_hi, bool ignore_lo, bool is_shift)
 	: Base(base)
 	, is_word(is_word)
 	, ignore_hi(ignore_hi)
 	, ignore_lo(ignore_lo)
+	, is_shift(is_shift)
 	{}
 
 std::vector<uint32_t> Semantics::Instruction::DivFrom::get_input_sizes() const { return {static_cast<uint32_t>(is_word ? 4 : 1), static_cast<uint32_t>(is_word ? 4 : 1)}; }
@@ -5513,6 +5929,16 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::DivFrom::emit(const
 	const bool         is_load_word     = is_word;
 	const Output::Line binary_operation = "\tdiv   ";
 
+	// Shift out or mask the low bits instead, if that gives the same result.
+	if (is_shift) {
+		if (ignore_hi == ignore_lo) {
+			std::ostringstream sstr;
+			sstr << "Semantics::Instruction::DivFrom::emit: internal error: shifting rather than dividing keeps exactly one result.";
+			throw SemanticsError(sstr.str());
+		}
+		return emit_binary_operation(instruction, ignore_hi ? "\tsrlv  " : "\tand   ", is_save_word, is_load_word, storages);
+	}
+
 	// Check sizes.
 	if (Storage::get_sizes(storages) != instruction.get_all_sizes()) {
 		std::ostringstream sstr;
@@ -5644,7 +6070,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::DivFrom::emit(const
 			lines.push_back("\tmfhi  " + right_destination_storage.register_);
 		} else if (right_destination_storage.is_register_dereference()) {
 			lines.push_back("\tmfhi  $t9");
-			std::string offset_string = right_destination_storage.offset == 0 ? "" : std::to_string(left_destination_storage.offset);
+			std::string offset_string = right_destination_storage.offset == 0 ? "" : std::to_string(right_destination_storage.offset);
 			lines.push_back(sized_save + "$t9" + ", " + offset_string + "(" + right_destination_storage.register_ + ")");
 		} else if (right_destination_storage.is_global_address()) {
 			std::ostringstream sstr;
@@ -5653,7 +6079,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::DivFrom::emit(const
 		} else { //right_destination_storage.is_global_dereference)
 			lines.push_back("\tmfhi  $t9");
 			lines.push_back("\tla    $t8, " + right_destination_storage.global_address);
-			std::string offset_string = right_destination_storage.offset == 0 ? "" : std::to_string(left_destination_storage.offset);
+			std::string offset_string = right_destination_storage.offset == 0 ? "" : std::to_string(right_destination_storage.offset);
 			lines.push_back(sized_save + "$t9, " + offset_string + "($t8)");
 		}
 	}
@@ -5996,45 +6422,281 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::BranchNonnegative::
 	return lines;
 }
 
-Semantics::Instruction::Instruction(tag_t tag, const data_t &data)
-	: tag(tag)
-	, data(data)
+Semantics::Instruction::Select::Select()
 	{}
 
-Semantics::Instruction::Instruction(tag_t tag, data_t &&data)
-	: tag(tag)
-	, data(std::move(data))
+Semantics::Instruction::Select::Select(const Base &base, bool is_word, bool is_condition_word)
+	: Base(base)
+	, is_word(is_word)
+	, is_condition_word(is_condition_word)
 	{}
 
-Semantics::Instruction::Instruction(const Ignore &ignore)
-	: tag(ignore_tag)
-	, data(ignore)
-	{}
+std::vector<uint32_t> Semantics::Instruction::Select::get_input_sizes() const { return {static_cast<uint32_t>(is_condition_word ? 4 : 1), static_cast<uint32_t>(is_word ? 4 : 1), static_cast<uint32_t>(is_word ? 4 : 1)}; }
+std::vector<uint32_t> Semantics::Instruction::Select::get_working_sizes() const { return {}; }
+std::vector<uint32_t> Semantics::Instruction::Select::get_output_sizes() const { return {static_cast<uint32_t>(is_word ? 4 : 1)}; }
+std::vector<uint32_t> Semantics::Instruction::Select::get_all_sizes() const { std::vector<uint32_t> v, i(std::move(get_input_sizes())), w(std::move(get_working_sizes())), o(std::move(get_output_sizes())); v.insert(v.end(), i.cbegin(), i.cend()); v.insert(v.end(), w.cbegin(), w.cend()); v.insert(v.end(), o.cbegin(), o.cend()); return v; }
 
-Semantics::Instruction::Instruction(const Custom &custom)
-	: tag(custom_tag)
-	, data(custom)
-	{}
+std::vector<Semantics::Output::Line> Semantics::Instruction::Select::emit(const std::vector<Storage> &storages, architecture_t architecture) const {
+	// Check sizes.
+	if (Storage::get_sizes(storages) != get_all_sizes()) {
+		std::ostringstream sstr;
+		sstr << "Semantics::Instruction::Select::emit: the number or sizes of storage units provided does not match what was expected.";
+		throw SemanticsError(sstr.str());
+	}
+	if (architecture < mips32_architecture) {
+		std::ostringstream sstr;
+		sstr << "Semantics::Instruction::Select::emit: internal error: selecting requires movn, which MIPS I lacks.";
+		throw SemanticsError(sstr.str());
+	}
+	const Storage &condition_storage   = storages[0];
+	const Storage &true_storage        = storages[1];
+	const Storage &false_storage       = storages[2];
+	const Storage &destination_storage = storages[3];
 
-Semantics::Instruction::Instruction(const Syscall &syscall)
-	: tag(syscall_tag)
-	, data(syscall)
-	{}
+	for (const Storage &source_storage : {condition_storage, true_storage, false_storage}) {
+		if (source_storage.is_register_direct() && source_storage.offset != 0) {
+			std::ostringstream sstr;
+			sstr << "Semantics::Instruction::Select::emit: internal error: this operation on direct registers with offsets is currently unsupported.  Use LoadFrom meanwhile.";
+			throw SemanticsError(sstr.str());
+		}
+	}
 
-Semantics::Instruction::Instruction(const AddSp &add_sp)
-	: tag(add_sp_tag)
-	, data(add_sp)
-	{}
+	// Prepare output vector.
+	std::vector<Output::Line> lines;
 
-Semantics::Instruction::Instruction(const LoadImmediate &load_immediate)
-	: tag(load_immediate_tag)
-	, data(load_immediate)
-	{}
+	// Emit a symbol for this instruction if there is one.
+	if (has_symbol) {
+		lines.push_back({":", symbol});
+	}
 
-Semantics::Instruction::Instruction(const LoadFrom &load_from)
-	: tag(load_from_tag)
-	, data(load_from)
-	{}
+	// Get sized save and load operations.
+	Output::Line sized_save = is_word ? "\tsw    " : "\tsb    ";
+	Output::Line sized_load = is_word ? "\tlw    " : "\tlb    ";
+
+	// movn needs the condition, the true value, and the result in registers
+	// at once, but we only have $t8 and $t9 to spare.  If none of the
+	// condition, the true value, and the destination is a register, combine
+	// the values arithmetically, using the destination as a third storage:
+	// 	destination = false ^ ((true ^ false) & -(condition != 0))
+	if (!condition_storage.is_register_direct() && !true_storage.is_register_direct() && !destination_storage.is_register_direct()) {
+		if (!destination_storage.is_register_dereference()) {
+			std::ostringstream sstr;
+			sstr << "Semantics::Instruction::Select::emit: internal error: selecting into a global storage unit when no registers are available is currently unsupported.";
+			throw SemanticsError(sstr.str());
+		}
+		const std::string destination_string = (destination_storage.offset == 0 ? "" : std::to_string(destination_storage.offset)) + "(" + destination_storage.register_ + ")";
+
+		// destination = true ^ false.
+		emit_load(lines, true_storage, "$t9", is_word);
+		lines.push_back(sized_save + "$t9, " + destination_string);
+		emit_load(lines, false_storage, "$t9", is_word);
+		lines.push_back(sized_load + "$t8, " + destination_string);
+		lines.push_back("\txor   $t9, $t9, $t8");
+		lines.push_back(sized_save + "$t9, " + destination_string);
+
+		// Mask it with -(condition != 0).
+		emit_load(lines, condition_storage, "$t8", is_condition_word);
+		lines.push_back("\tsltu  $t8, $zero, $t8");
+		lines.push_back("\tsubu  $t8, $zero, $t8");
+		lines.push_back(sized_load + "$t9, " + destination_string);
+		lines.push_back("\tand   $t9, $t9, $t8");
+		lines.push_back(sized_save + "$t9, " + destination_string);
+
+		// Flip back to the false value where the mask is clear.
+		emit_load(lines, false_storage, "$t9", is_word);
+		lines.push_back(sized_load + "$t8, " + destination_string);
+		lines.push_back("\txor   $t9, $t9, $t8");
+		lines.push_back(sized_save + "$t9, " + destination_string);
+
+		// Return the output.
+		return lines;
+	}
+
+	// Part 1: load the condition and the true value.
+	std::string condition_register = "$t8";
+	if (condition_storage.is_register_direct()) {
+		condition_register = condition_storage.register_;
+	} else {
+		emit_load(lines, condition_storage, condition_register, is_condition_word);
+	}
+	std::string true_register = condition_storage.is_register_direct() ? "$t8" : "$t9";
+	if (true_storage.is_register_direct()) {
+		true_register = true_storage.register_;
+	} else {
+		emit_load(lines, true_storage, true_register, is_word);
+	}
+
+	// Part 2: load the false value into the result register, unless that
+	// would clobber the other inputs.
+	std::string result_register = "$t9";
+	if (destination_storage.is_register_direct() && destination_storage.register_ != condition_register && destination_storage.register_ != true_register) {
+		result_register = destination_storage.register_;
+	}
+	emit_load(lines, false_storage, result_register, is_word);
+
+	// Part 3: select.
+	lines.push_back("\tmovn  " + result_register + ", " + true_register + ", " + condition_register);
+
+	// Part 4: write to the destination.
+	if        (destination_storage.is_register_direct()) {
+		if (destination_storage.register_ != result_register) {
+			lines.push_back("\tla    " + destination_storage.register_ + ", (" + result_register + ")");
+		}
+	} else if (destination_storage.is_register_dereference()) {
+		std::string offset_string = destination_storage.offset == 0 ? "" : std::to_string(destination_storage.offset);
+		lines.push_back(sized_save + result_register + ", " + offset_string + "(" + destination_storage.register_ + ")");
+	} else if (destination_storage.is_global_address()) {
+		std::ostringstream sstr;
+		sstr << "Semantics::Instruction::Select::emit: error: cannot save to a global address without dereferencing it.";
+		throw SemanticsError(sstr.str());
+	} else { //destination_storage.is_global_dereference)
+		lines.push_back("\tla    $t8, " + destination_storage.global_address);
+		std::string offset_string = destination_storage.offset == 0 ? "" : std::to_string(destination_storage.offset);
+		lines.push_back(sized_save + result_register + ", " + offset_string + "($t8)");
+	}
+
+	// Return the output.
+	return lines;
+}
+
+Semantics::Instruction::CheckBounds::CheckBounds()
+	{}
+
+Semantics::Instruction::CheckBounds::CheckBounds(const Base &base, int32_t min_index, int32_t max_index)
+	: Base(base)
+	, min_index(min_index)
+	, max_index(max_index)
+	{}
+
+std::vector<uint32_t> Semantics::Instruction::CheckBounds::get_input_sizes() const { return {4}; }
+std::vector<uint32_t> Semantics::Instruction::CheckBounds::get_working_sizes() const { return {}; }
+std::vector<uint32_t> Semantics::Instruction::CheckBounds::get_output_sizes() const { return {4}; }
+std::vector<uint32_t> Semantics::Instruction::CheckBounds::get_all_sizes() const { std::vector<uint32_t> v, i(std::move(get_input_sizes())), w(std::move(get_working_sizes())), o(std::move(get_output_sizes())); v.insert(v.end(), i.cbegin(), i.cend()); v.insert(v.end(), w.cbegin(), w.cend()); v.insert(v.end(), o.cbegin(), o.cend()); return v; }
+
+std::vector<Semantics::Output::Line> Semantics::Instruction::CheckBounds::emit(const std::vector<Storage> &storages, architecture_t architecture) const {
+	// Check sizes.
+	if (Storage::get_sizes(storages) != get_all_sizes()) {
+		std::ostringstream sstr;
+		sstr << "Semantics::Instruction::CheckBounds::emit: the number or sizes of storage units provided does not match what was expected.";
+		throw SemanticsError(sstr.str());
+	}
+	if (architecture < mips32_architecture) {
+		std::ostringstream sstr;
+		sstr << "Semantics::Instruction::CheckBounds::emit: internal error: bounds checking requires trap instructions, which MIPS I lacks.";
+		throw SemanticsError(sstr.str());
+	}
+	if (max_index < min_index) {
+		std::ostringstream sstr;
+		sstr << "Semantics::Instruction::CheckBounds::emit: internal error: the index range is empty: " << min_index << " to " << max_index << ".";
+		throw SemanticsError(sstr.str());
+	}
+	const Storage &source_storage      = storages[0];
+	const Storage &destination_storage = storages[1];
+
+	if (source_storage.is_register_direct() && source_storage.offset != 0) {
+		std::ostringstream sstr;
+		sstr << "Semantics::Instruction::CheckBounds::emit: internal error: this operation on direct registers with offsets is currently unsupported.  Use LoadFrom meanwhile.";
+		throw SemanticsError(sstr.str());
+	}
+
+	// Prepare output vector.
+	std::vector<Output::Line> lines;
+
+	// Emit a symbol for this instruction if there is one.
+	if (has_symbol) {
+		lines.push_back({":", symbol});
+	}
+
+	// Part 1: load the index.
+	std::string source_register = "$t9";
+	if (source_storage.is_register_direct()) {
+		source_register = source_storage.register_;
+	} else {
+		emit_load(lines, source_storage, source_register, true);
+	}
+
+	// Part 2: subtract the minimum index.  Indices below it wrap around to
+	// large unsigned values, so one unsigned comparison checks both ends.
+	const std::string result_register = destination_storage.is_register_direct() ? destination_storage.register_ : "$t9";
+	if (min_index != 0) {
+		const int64_t addition = -static_cast<int64_t>(min_index);
+		if (addition >= -32768 && addition <= 32767) {
+			lines.push_back("\taddiu " + result_register + ", " + source_register + ", " + std::to_string(addition));
+		} else {
+			lines.push_back("\tla    " + result_register + ", " + std::to_string(static_cast<int32_t>(static_cast<uint32_t>(addition))) + "(" + source_register + ")");
+		}
+	} else if (result_register != source_register) {
+		lines.push_back("\tla    " + result_register + ", (" + source_register + ")");
+	}
+
+	// Part 3: trap unless it is less than the number of elements.
+	const uint64_t num_elements = static_cast<uint64_t>(static_cast<int64_t>(max_index) - static_cast<int64_t>(min_index) + 1);
+	if (num_elements <= 32767) {
+		lines.push_back("\ttgeiu " + result_register + ", " + std::to_string(num_elements));
+	} else {
+		lines.push_back("\tli    $t8, " + std::to_string(static_cast<int32_t>(static_cast<uint32_t>(num_elements))));
+		lines.push_back("\ttgeu  " + result_register + ", $t8");
+	}
+
+	// Part 4: write to the destination.
+	if        (destination_storage.is_register_direct()) {
+		// Already there.
+	} else if (destination_storage.is_register_dereference()) {
+		std::string offset_string = destination_storage.offset == 0 ? "" : std::to_string(destination_storage.offset);
+		lines.push_back("\tsw    " + result_register + ", " + offset_string + "(" + destination_storage.register_ + ")");
+	} else if (destination_storage.is_global_address()) {
+		std::ostringstream sstr;
+		sstr << "Semantics::Instruction::CheckBounds::emit: error: cannot save to a global address without dereferencing it.";
+		throw SemanticsError(sstr.str());
+	} else { //destination_storage.is_global_dereference)
+		lines.push_back("\tla    $t8, " + destination_storage.global_address);
+		std::string offset_string = destination_storage.offset == 0 ? "" : std::to_string(destination_storage.offset);
+		lines.push_back("\tsw    " + result_register + ", " + offset_string + "($t8)");
+	}
+
+	// Return the output.
+	return lines;
+}
+
+Semantics::Instruction::Instruction(tag_t tag, const data_t &data)
+	: tag(tag)
+	, data(data)
+	{}
+
+Semantics::Instruction::Instruction(tag_t tag, data_t &&data)
+	: tag(tag)
+	, data(std::move(data))
+	{}
+
+Semantics::Instruction::Instruction(const Ignore &ignore)
+	: tag(ignore_tag)
+	, data(ignore)
+	{}
+
+Semantics::Instruction::Instruction(const Custom &custom)
+	: tag(custom_tag)
+	, data(custom)
+	{}
+
+Semantics::Instruction::Instruction(const Syscall &syscall)
+	: tag(syscall_tag)
+	, data(syscall)
+	{}
+
+Semantics::Instruction::Instruction(const AddSp &add_sp)
+	: tag(add_sp_tag)
+	, data(add_sp)
+	{}
+
+Semantics::Instruction::Instruction(const LoadImmediate &load_immediate)
+	: tag(load_immediate_tag)
+	, data(load_immediate)
+	{}
+
+Semantics::Instruction::Instruction(const LoadFrom &load_from)
+	: tag(load_from_tag)
+	, data(load_from)
+	{}
 
 Semantics::Instruction::Instruction(const LessThanFrom &less_than_from)
 	: tag(less_than_from_tag)
@@ -6106,6 +6768,16 @@ Semantics::Instruction::Instruction(const BranchNonnegative &branch_nonnegative)
 	, data(branch_nonnegative)
 	{}
 
+Semantics::Instruction::Instruction(const Select &select)
+	: tag(select_tag)
+	, data(select)
+	{}
+
+Semantics::Instruction::Instruction(const CheckBounds &check_bounds)
+	: tag(check_bounds_tag)
+	, data(check_bounds)
+	{}
+
 const Semantics::Instruction::Base &Semantics::Instruction::get_base() const {
 	switch(tag) {
 		case ignore_tag:
@@ -6148,6 +6820,10 @@ const Semantics::Instruction::Base &Semantics::Instruction::get_base() const {
 			return get_branch_zero();
 		case branch_nonnegative_tag:
 			return get_branch_nonnegative();
+		case select_tag:
+			return get_select();
+		case check_bounds_tag:
+			return get_check_bounds();
 
 		case null_tag:
 		default:
@@ -6199,6 +6875,10 @@ Semantics::Instruction::Base &&Semantics::Instruction::get_base() {
 			return std::move(get_branch_zero());
 		case branch_nonnegative_tag:
 			return std::move(get_branch_nonnegative());
+		case select_tag:
+			return std::move(get_select());
+		case check_bounds_tag:
+			return std::move(get_check_bounds());
 
 		case null_tag:
 		default:
@@ -6250,6 +6930,10 @@ Semantics::Instruction::Base &Semantics::Instruction::get_base_mutable() {
 			return get_branch_zero_mutable();
 		case branch_nonnegative_tag:
 			return get_branch_nonnegative_mutable();
+		case select_tag:
+			return get_select_mutable();
+		case check_bounds_tag:
+			return get_check_bounds_mutable();
 
 		case null_tag:
 		default:
@@ -6282,6 +6966,8 @@ bool Semantics::Instruction::is_ignore() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6316,6 +7002,8 @@ bool Semantics::Instruction::is_custom() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6350,6 +7038,8 @@ bool Semantics::Instruction::is_syscall() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6384,6 +7074,8 @@ bool Semantics::Instruction::is_add_sp() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6418,6 +7110,8 @@ bool Semantics::Instruction::is_load_immediate() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6452,6 +7146,8 @@ bool Semantics::Instruction::is_load_from() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6486,6 +7182,8 @@ bool Semantics::Instruction::is_less_than_from() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6520,6 +7218,8 @@ bool Semantics::Instruction::is_nor_from() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6554,6 +7254,8 @@ bool Semantics::Instruction::is_and_from() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6588,6 +7290,8 @@ bool Semantics::Instruction::is_or_from() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6622,6 +7326,8 @@ bool Semantics::Instruction::is_add_from() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6656,6 +7362,8 @@ bool Semantics::Instruction::is_sub_from() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6690,6 +7398,8 @@ bool Semantics::Instruction::is_mult_from() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6724,6 +7434,8 @@ bool Semantics::Instruction::is_div_from() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6758,6 +7470,8 @@ bool Semantics::Instruction::is_jump_to() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6792,6 +7506,8 @@ bool Semantics::Instruction::is_jump() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6826,6 +7542,8 @@ bool Semantics::Instruction::is_call() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6860,6 +7578,8 @@ bool Semantics::Instruction::is_return() const {
 			return true;
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6894,6 +7614,8 @@ bool Semantics::Instruction::is_branch_zero() const {
 		case branch_zero_tag:
 			return true;
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			return false;
 
 		case null_tag:
@@ -6928,6 +7650,9 @@ bool Semantics::Instruction::is_branch_nonnegative() const {
 			return false;
 		case branch_nonnegative_tag:
 			return true;
+		case select_tag:
+		case check_bounds_tag:
+			return false;
 
 		case null_tag:
 		default:
@@ -6937,6 +7662,76 @@ bool Semantics::Instruction::is_branch_nonnegative() const {
 	}
 }
 
+bool Semantics::Instruction::is_select() const {
+	switch(tag) {
+		case ignore_tag:
+		case custom_tag:
+		case syscall_tag:
+		case add_sp_tag:
+		case load_immediate_tag:
+		case load_from_tag:
+		case less_than_from_tag:
+		case nor_from_tag:
+		case and_from_tag:
+		case or_from_tag:
+		case add_from_tag:
+		case sub_from_tag:
+		case mult_from_tag:
+		case div_from_tag:
+		case jump_to_tag:
+		case jump_tag:
+		case call_tag:
+		case return_tag:
+		case branch_zero_tag:
+		case branch_nonnegative_tag:
+		case check_bounds_tag:
+			return false;
+		case select_tag:
+			return true;
+
+		case null_tag:
+		default:
+			std::ostringstream sstr;
+			sstr << "Semantics::Instruction::is_select: invalid tag: " << tag;
+			throw SemanticsError(sstr.str());
+	}
+}
+
+bool Semantics::Instruction::is_check_bounds() const {
+	switch(tag) {
+		case ignore_tag:
+		case custom_tag:
+		case syscall_tag:
+		case add_sp_tag:
+		case load_immediate_tag:
+		case load_from_tag:
+		case less_than_from_tag:
+		case nor_from_tag:
+		case and_from_tag:
+		case or_from_tag:
+		case add_from_tag:
+		case sub_from_tag:
+		case mult_from_tag:
+		case div_from_tag:
+		case jump_to_tag:
+		case jump_tag:
+		case call_tag:
+		case return_tag:
+		case branch_zero_tag:
+		case branch_nonnegative_tag:
+		case select_tag:
+			return false;
+		case check_bounds_tag:
+			return true;
+
+		case null_tag:
+		default:
+			std::ostringstream sstr;
+			sstr << "Semantics::Instruction::is_check_bounds: invalid tag: " << tag;
+			throw SemanticsError(sstr.str());
+	}
+}
+
 // | The tags must be correct, or else an exception will be thrown, including for set_*.
 const Semantics::Instruction::Ignore &Semantics::Instruction::get_ignore() const {
 	switch(tag) {
@@ -6961,6 +7756,8 @@ const Semantics::Instruction::Ignore &Semantics::Instruction::get_ignore() const
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -6999,6 +7796,8 @@ const Semantics::Instruction::Custom &Semantics::Instruction::get_custom() const
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7037,6 +7836,8 @@ const Semantics::Instruction::Syscall &Semantics::Instruction::get_syscall() con
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7075,6 +7876,8 @@ const Semantics::Instruction::AddSp &Semantics::Instruction::get_add_sp() const
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7113,6 +7916,8 @@ const Semantics::Instruction::LoadImmediate &Semantics::Instruction::get_load_im
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7151,6 +7956,8 @@ const Semantics::Instruction::LoadFrom &Semantics::Instruction::get_load_from()
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7189,6 +7996,8 @@ const Semantics::Instruction::LessThanFrom &Semantics::Instruction::get_less_tha
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7227,6 +8036,8 @@ const Semantics::Instruction::NorFrom &Semantics::Instruction::get_nor_from() co
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7265,6 +8076,8 @@ const Semantics::Instruction::AndFrom &Semantics::Instruction::get_and_from() co
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7303,6 +8116,8 @@ const Semantics::Instruction::OrFrom &Semantics::Instruction::get_or_from() cons
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7341,6 +8156,8 @@ const Semantics::Instruction::AddFrom &Semantics::Instruction::get_add_from() co
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7379,6 +8196,8 @@ const Semantics::Instruction::SubFrom &Semantics::Instruction::get_sub_from() co
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7417,6 +8236,8 @@ const Semantics::Instruction::MultFrom &Semantics::Instruction::get_mult_from()
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7455,6 +8276,8 @@ const Semantics::Instruction::DivFrom &Semantics::Instruction::get_div_from() co
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7493,6 +8316,8 @@ const Semantics::Instruction::JumpTo &Semantics::Instruction::get_jump_to() cons
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7531,6 +8356,8 @@ const Semantics::Instruction::Jump &Semantics::Instruction::get_jump() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7569,6 +8396,8 @@ const Semantics::Instruction::Call &Semantics::Instruction::get_call() const {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7607,6 +8436,8 @@ const Semantics::Instruction::Return &Semantics::Instruction::get_return() const
 			return std::get<Return>(data);
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7645,6 +8476,8 @@ const Semantics::Instruction::BranchZero &Semantics::Instruction::get_branch_zer
 		case branch_zero_tag:
 			return std::get<BranchZero>(data);
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -7683,6 +8516,9 @@ const Semantics::Instruction::BranchNonnegative &Semantics::Instruction::get_bra
 			break;
 		case branch_nonnegative_tag:
 			return std::get<BranchNonnegative>(data);
+		case select_tag:
+		case check_bounds_tag:
+			break;
 
 		case null_tag:
 		default:
@@ -7696,10 +8532,9 @@ const Semantics::Instruction::BranchNonnegative &Semantics::Instruction::get_bra
 	throw SemanticsError(sstr.str());
 }
 
-Semantics::Instruction::Ignore &&Semantics::Instruction::get_ignore() {
+const Semantics::Instruction::Select &Semantics::Instruction::get_select() const {
 	switch(tag) {
 		case ignore_tag:
-			return std::get<Ignore>(std::move(data));
 		case custom_tag:
 		case syscall_tag:
 		case add_sp_tag:
@@ -7719,26 +8554,27 @@ Semantics::Instruction::Ignore &&Semantics::Instruction::get_ignore() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case check_bounds_tag:
 			break;
+		case select_tag:
+			return std::get<Select>(data);
 
 		case null_tag:
 		default:
 			std::ostringstream sstr;
-			sstr << "Semantics::Instruction::get_ignore: invalid tag: " << tag;
+			sstr << "Semantics::Instruction::get_select: invalid tag: " << tag;
 			throw SemanticsError(sstr.str());
 	}
 
 	std::ostringstream sstr;
-	sstr << "Semantics::Instruction::get_ignore: binding has a different type tag: " << tag;
+	sstr << "Semantics::Instruction::get_select: binding has a different type tag: " << tag;
 	throw SemanticsError(sstr.str());
 }
 
-Semantics::Instruction::Custom &&Semantics::Instruction::get_custom() {
+const Semantics::Instruction::CheckBounds &Semantics::Instruction::get_check_bounds() const {
 	switch(tag) {
 		case ignore_tag:
-			break;
 		case custom_tag:
-			return std::get<Custom>(std::move(data));
 		case syscall_tag:
 		case add_sp_tag:
 		case load_immediate_tag:
@@ -7757,27 +8593,29 @@ Semantics::Instruction::Custom &&Semantics::Instruction::get_custom() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
 			break;
+		case check_bounds_tag:
+			return std::get<CheckBounds>(data);
 
 		case null_tag:
 		default:
 			std::ostringstream sstr;
-			sstr << "Semantics::Instruction::get_custom: invalid tag: " << tag;
+			sstr << "Semantics::Instruction::get_check_bounds: invalid tag: " << tag;
 			throw SemanticsError(sstr.str());
 	}
 
 	std::ostringstream sstr;
-	sstr << "Semantics::Instruction::get_custom: binding has a different type tag: " << tag;
+	sstr << "Semantics::Instruction::get_check_bounds: binding has a different type tag: " << tag;
 	throw SemanticsError(sstr.str());
 }
 
-Semantics::Instruction::Syscall &&Semantics::Instruction::get_syscall() {
+Semantics::Instruction::Ignore &&Semantics::Instruction::get_ignore() {
 	switch(tag) {
 		case ignore_tag:
+			return std::get<Ignore>(std::move(data));
 		case custom_tag:
-			break;
 		case syscall_tag:
-			return std::get<Syscall>(std::move(data));
 		case add_sp_tag:
 		case load_immediate_tag:
 		case load_from_tag:
@@ -7795,28 +8633,30 @@ Semantics::Instruction::Syscall &&Semantics::Instruction::get_syscall() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
 		default:
 			std::ostringstream sstr;
-			sstr << "Semantics::Instruction::get_syscall: invalid tag: " << tag;
+			sstr << "Semantics::Instruction::get_ignore: invalid tag: " << tag;
 			throw SemanticsError(sstr.str());
 	}
 
 	std::ostringstream sstr;
-	sstr << "Semantics::Instruction::get_syscall: binding has a different type tag: " << tag;
+	sstr << "Semantics::Instruction::get_ignore: binding has a different type tag: " << tag;
 	throw SemanticsError(sstr.str());
 }
 
-Semantics::Instruction::AddSp &&Semantics::Instruction::get_add_sp() {
+Semantics::Instruction::Custom &&Semantics::Instruction::get_custom() {
 	switch(tag) {
 		case ignore_tag:
+			break;
 		case custom_tag:
+			return std::get<Custom>(std::move(data));
 		case syscall_tag:
-			break;
 		case add_sp_tag:
-			return std::get<AddSp>(std::move(data));
 		case load_immediate_tag:
 		case load_from_tag:
 		case less_than_from_tag:
@@ -7833,29 +8673,31 @@ Semantics::Instruction::AddSp &&Semantics::Instruction::get_add_sp() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
 		default:
 			std::ostringstream sstr;
-			sstr << "Semantics::Instruction::get_add_sp: invalid tag: " << tag;
+			sstr << "Semantics::Instruction::get_custom: invalid tag: " << tag;
 			throw SemanticsError(sstr.str());
 	}
 
 	std::ostringstream sstr;
-	sstr << "Semantics::Instruction::get_add_sp: binding has a different type tag: " << tag;
+	sstr << "Semantics::Instruction::get_custom: binding has a different type tag: " << tag;
 	throw SemanticsError(sstr.str());
 }
 
-Semantics::Instruction::LoadImmediate &&Semantics::Instruction::get_load_immediate() {
+Semantics::Instruction::Syscall &&Semantics::Instruction::get_syscall() {
 	switch(tag) {
 		case ignore_tag:
 		case custom_tag:
+			break;
 		case syscall_tag:
+			return std::get<Syscall>(std::move(data));
 		case add_sp_tag:
-			break;
 		case load_immediate_tag:
-			return std::get<LoadImmediate>(std::move(data));
 		case load_from_tag:
 		case less_than_from_tag:
 		case nor_from_tag:
@@ -7871,30 +8713,32 @@ Semantics::Instruction::LoadImmediate &&Semantics::Instruction::get_load_immedia
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
 		default:
 			std::ostringstream sstr;
-			sstr << "Semantics::Instruction::get_load_immediate: invalid tag: " << tag;
+			sstr << "Semantics::Instruction::get_syscall: invalid tag: " << tag;
 			throw SemanticsError(sstr.str());
 	}
 
 	std::ostringstream sstr;
-	sstr << "Semantics::Instruction::get_load_immediate: binding has a different type tag: " << tag;
+	sstr << "Semantics::Instruction::get_syscall: binding has a different type tag: " << tag;
 	throw SemanticsError(sstr.str());
 }
 
-Semantics::Instruction::LoadFrom &&Semantics::Instruction::get_load_from() {
+Semantics::Instruction::AddSp &&Semantics::Instruction::get_add_sp() {
 	switch(tag) {
 		case ignore_tag:
 		case custom_tag:
 		case syscall_tag:
+			break;
 		case add_sp_tag:
+			return std::get<AddSp>(std::move(data));
 		case load_immediate_tag:
-			break;
 		case load_from_tag:
-			return std::get<LoadFrom>(std::move(data));
 		case less_than_from_tag:
 		case nor_from_tag:
 		case and_from_tag:
@@ -7909,31 +8753,33 @@ Semantics::Instruction::LoadFrom &&Semantics::Instruction::get_load_from() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
 		default:
 			std::ostringstream sstr;
-			sstr << "Semantics::Instruction::get_load_from: invalid tag: " << tag;
+			sstr << "Semantics::Instruction::get_add_sp: invalid tag: " << tag;
 			throw SemanticsError(sstr.str());
 	}
 
 	std::ostringstream sstr;
-	sstr << "Semantics::Instruction::get_load_from: binding has a different type tag: " << tag;
+	sstr << "Semantics::Instruction::get_add_sp: binding has a different type tag: " << tag;
 	throw SemanticsError(sstr.str());
 }
 
-Semantics::Instruction::LessThanFrom &&Semantics::Instruction::get_less_than_from() {
+Semantics::Instruction::LoadImmediate &&Semantics::Instruction::get_load_immediate() {
 	switch(tag) {
 		case ignore_tag:
 		case custom_tag:
 		case syscall_tag:
 		case add_sp_tag:
+			break;
 		case load_immediate_tag:
+			return std::get<LoadImmediate>(std::move(data));
 		case load_from_tag:
-			break;
 		case less_than_from_tag:
-			return std::get<LessThanFrom>(std::move(data));
 		case nor_from_tag:
 		case and_from_tag:
 		case or_from_tag:
@@ -7947,21 +8793,103 @@ Semantics::Instruction::LessThanFrom &&Semantics::Instruction::get_less_than_fro
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
 		default:
 			std::ostringstream sstr;
-			sstr << "Semantics::Instruction::get_less_than_from: invalid tag: " << tag;
+			sstr << "Semantics::Instruction::get_load_immediate: invalid tag: " << tag;
 			throw SemanticsError(sstr.str());
 	}
 
 	std::ostringstream sstr;
-	sstr << "Semantics::Instruction::get_less_than_from: binding has a different type tag: " << tag;
+	sstr << "Semantics::Instruction::get_load_immediate: binding has a different type tag: " << tag;
 	throw SemanticsError(sstr.str());
 }
 
-Semantics::Instruction::NorFrom &&Semantics::Instruction::get_nor_from() {
+Semantics::Instruction::LoadFrom &&Semantics::Instruction::get_load_from() {
+	switch(tag) {
+		case ignore_tag:
+		case custom_tag:
+		case syscall_tag:
+		case add_sp_tag:
+		case load_immediate_tag:
+			break;
+		case load_from_tag:
+			return std::get<LoadFrom>(std::move(data));
+		case less_than_from_tag:
+		case nor_from_tag:
+		case and_from_tag:
+		case or_from_tag:
+		case add_from_tag:
+		case sub_from_tag:
+		case mult_from_tag:
+		case div_from_tag:
+		case jump_to_tag:
+		case jump_tag:
+		case call_tag:
+		case return_tag:
+		case branch_zero_tag:
+		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
+			break;
+
+		case null_tag:
+		default:
+			std::ostringstream sstr;
+			sstr << "Semantics::Instruction::get_load_from: invalid tag: " << tag;
+			throw SemanticsError(sstr.str());
+	}
+
+	std::ostringstream sstr;
+	sstr << "Semantics::Instruction::get_load_from: binding has a different type tag: " << tag;
+	throw SemanticsError(sstr.str());
+}
+
+Semantics::Instruction::LessThanFrom &&Semantics::Instruction::get_less_than_from() {
+	switch(tag) {
+		case ignore_tag:
+		case custom_tag:
+		case syscall_tag:
+		case add_sp_tag:
+		case load_immediate_tag:
+		case load_from_tag:
+			break;
+		case less_than_from_tag:
+			return std::get<LessThanFrom>(std::move(data));
+		case nor_from_tag:
+		case and_from_tag:
+		case or_from_tag:
+		case add_from_tag:
+		case sub_from_tag:
+		case mult_from_tag:
+		case div_from_tag:
+		case jump_to_tag:
+		case jump_tag:
+		case call_tag:
+		case return_tag:
+		case branch_zero_tag:
+		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
+			break;
+
+		case null_tag:
+		default:
+			std::ostringstream sstr;
+			sstr << "Semantics::Instruction::get_less_than_from: invalid tag: " << tag;
+			throw SemanticsError(sstr.str());
+	}
+
+	std::ostringstream sstr;
+	sstr << "Semantics::Instruction::get_less_than_from: binding has a different type tag: " << tag;
+	throw SemanticsError(sstr.str());
+}
+
+Semantics::Instruction::NorFrom &&Semantics::Instruction::get_nor_from() {
 	switch(tag) {
 		case ignore_tag:
 		case custom_tag:
@@ -7985,6 +8913,8 @@ Semantics::Instruction::NorFrom &&Semantics::Instruction::get_nor_from() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8023,6 +8953,8 @@ Semantics::Instruction::AndFrom &&Semantics::Instruction::get_and_from() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8061,6 +8993,8 @@ Semantics::Instruction::OrFrom &&Semantics::Instruction::get_or_from() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8099,6 +9033,8 @@ Semantics::Instruction::AddFrom &&Semantics::Instruction::get_add_from() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8137,6 +9073,8 @@ Semantics::Instruction::SubFrom &&Semantics::Instruction::get_sub_from() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8175,6 +9113,8 @@ Semantics::Instruction::MultFrom &&Semantics::Instruction::get_mult_from() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8213,6 +9153,8 @@ Semantics::Instruction::DivFrom &&Semantics::Instruction::get_div_from() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8251,6 +9193,8 @@ Semantics::Instruction::JumpTo &&Semantics::Instruction::get_jump_to() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8289,6 +9233,8 @@ Semantics::Instruction::Jump &&Semantics::Instruction::get_jump() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8327,6 +9273,8 @@ Semantics::Instruction::Call &&Semantics::Instruction::get_call() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8365,6 +9313,8 @@ Semantics::Instruction::Return &&Semantics::Instruction::get_return() {
 			return std::get<Return>(std::move(data));
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8403,6 +9353,8 @@ Semantics::Instruction::BranchZero &&Semantics::Instruction::get_branch_zero() {
 		case branch_zero_tag:
 			return std::get<BranchZero>(std::move(data));
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8441,6 +9393,9 @@ Semantics::Instruction::BranchNonnegative &&Semantics::Instruction::get_branch_n
 			break;
 		case branch_nonnegative_tag:
 			return std::get<BranchNonnegative>(std::move(data));
+		case select_tag:
+		case check_bounds_tag:
+			break;
 
 		case null_tag:
 		default:
@@ -8454,6 +9409,84 @@ Semantics::Instruction::BranchNonnegative &&Semantics::Instruction::get_branch_n
 	throw SemanticsError(sstr.str());
 }
 
+Semantics::Instruction::Select &&Semantics::Instruction::get_select() {
+	switch(tag) {
+		case ignore_tag:
+		case custom_tag:
+		case syscall_tag:
+		case add_sp_tag:
+		case load_immediate_tag:
+		case load_from_tag:
+		case less_than_from_tag:
+		case nor_from_tag:
+		case and_from_tag:
+		case or_from_tag:
+		case add_from_tag:
+		case sub_from_tag:
+		case mult_from_tag:
+		case div_from_tag:
+		case jump_to_tag:
+		case jump_tag:
+		case call_tag:
+		case return_tag:
+		case branch_zero_tag:
+		case branch_nonnegative_tag:
+		case check_bounds_tag:
+			break;
+		case select_tag:
+			return std::get<Select>(std::move(data));
+
+		case null_tag:
+		default:
+			std::ostringstream sstr;
+			sstr << "Semantics::Instruction::get_select: invalid tag: " << tag;
+			throw SemanticsError(sstr.str());
+	}
+
+	std::ostringstream sstr;
+	sstr << "Semantics::Instruction::get_select: binding has a different type tag: " << tag;
+	throw SemanticsError(sstr.str());
+}
+
+Semantics::Instruction::CheckBounds &&Semantics::Instruction::get_check_bounds() {
+	switch(tag) {
+		case ignore_tag:
+		case custom_tag:
+		case syscall_tag:
+		case add_sp_tag:
+		case load_immediate_tag:
+		case load_from_tag:
+		case less_than_from_tag:
+		case nor_from_tag:
+		case and_from_tag:
+		case or_from_tag:
+		case add_from_tag:
+		case sub_from_tag:
+		case mult_from_tag:
+		case div_from_tag:
+		case jump_to_tag:
+		case jump_tag:
+		case call_tag:
+		case return_tag:
+		case branch_zero_tag:
+		case branch_nonnegative_tag:
+		case select_tag:
+			break;
+		case check_bounds_tag:
+			return std::get<CheckBounds>(std::move(data));
+
+		case null_tag:
+		default:
+			std::ostringstream sstr;
+			sstr << "Semantics::Instruction::get_check_bounds: invalid tag: " << tag;
+			throw SemanticsError(sstr.str());
+	}
+
+	std::ostringstream sstr;
+	sstr << "Semantics::Instruction::get_check_bounds: binding has a different type tag: " << tag;
+	throw SemanticsError(sstr.str());
+}
+
 // Non-constant lvalue references.
 Semantics::Instruction::Ignore &Semantics::Instruction::get_ignore_mutable() {
 	switch(tag) {
@@ -8478,6 +9511,8 @@ Semantics::Instruction::Ignore &Semantics::Instruction::get_ignore_mutable() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8516,6 +9551,8 @@ Semantics::Instruction::Custom &Semantics::Instruction::get_custom_mutable() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8554,6 +9591,8 @@ Semantics::Instruction::Syscall &Semantics::Instruction::get_syscall_mutable() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8592,6 +9631,8 @@ Semantics::Instruction::AddSp &Semantics::Instruction::get_add_sp_mutable() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8630,6 +9671,8 @@ Semantics::Instruction::LoadImmediate &Semantics::Instruction::get_load_immediat
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8668,6 +9711,8 @@ Semantics::Instruction::LoadFrom &Semantics::Instruction::get_load_from_mutable(
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8706,6 +9751,8 @@ Semantics::Instruction::LessThanFrom &Semantics::Instruction::get_less_than_from
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8744,6 +9791,8 @@ Semantics::Instruction::NorFrom &Semantics::Instruction::get_nor_from_mutable()
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8782,6 +9831,8 @@ Semantics::Instruction::AndFrom &Semantics::Instruction::get_and_from_mutable()
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8820,6 +9871,8 @@ Semantics::Instruction::OrFrom &Semantics::Instruction::get_or_from_mutable() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8858,6 +9911,8 @@ Semantics::Instruction::AddFrom &Semantics::Instruction::get_add_from_mutable()
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8896,6 +9951,8 @@ Semantics::Instruction::SubFrom &Semantics::Instruction::get_sub_from_mutable()
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8934,6 +9991,8 @@ Semantics::Instruction::MultFrom &Semantics::Instruction::get_mult_from_mutable(
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -8972,6 +10031,8 @@ Semantics::Instruction::DivFrom &Semantics::Instruction::get_div_from_mutable()
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -9010,6 +10071,8 @@ Semantics::Instruction::JumpTo &Semantics::Instruction::get_jump_to_mutable() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -9048,6 +10111,8 @@ Semantics::Instruction::Jump &Semantics::Instruction::get_jump_mutable() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -9086,6 +10151,8 @@ Semantics::Instruction::Call &Semantics::Instruction::get_call_mutable() {
 		case return_tag:
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -9124,6 +10191,8 @@ Semantics::Instruction::Return &Semantics::Instruction::get_return_mutable() {
 			return std::get<Return>(data);
 		case branch_zero_tag:
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -9162,6 +10231,8 @@ Semantics::Instruction::BranchZero &Semantics::Instruction::get_branch_zero_muta
 		case branch_zero_tag:
 			return std::get<BranchZero>(data);
 		case branch_nonnegative_tag:
+		case select_tag:
+		case check_bounds_tag:
 			break;
 
 		case null_tag:
@@ -9200,6 +10271,9 @@ Semantics::Instruction::BranchNonnegative &Semantics::Instruction::get_branch_no
 			break;
 		case branch_nonnegative_tag:
 			return std::get<BranchNonnegative>(data);
+		case select_tag:
+		case check_bounds_tag:
+			break;
 
 		case null_tag:
 		default:
@@ -9213,6 +10287,84 @@ Semantics::Instruction::BranchNonnegative &Semantics::Instruction::get_branch_no
 	throw SemanticsError(sstr.str());
 }
 
+Semantics::Instruction::Select &Semantics::Instruction::get_select_mutable() {
+	switch(tag) {
+		case ignore_tag:
+		case custom_tag:
+		case syscall_tag:
+		case add_sp_tag:
+		case load_immediate_tag:
+		case load_from_tag:
+		case less_than_from_tag:
+		case nor_from_tag:
+		case and_from_tag:
+		case or_from_tag:
+		case add_from_tag:
+		case sub_from_tag:
+		case mult_from_tag:
+		case div_from_tag:
+		case jump_to_tag:
+		case jump_tag:
+		case call_tag:
+		case return_tag:
+		case branch_zero_tag:
+		case branch_nonnegative_tag:
+		case check_bounds_tag:
+			break;
+		case select_tag:
+			return std::get<Select>(data);
+
+		case null_tag:
+		default:
+			std::ostringstream sstr;
+			sstr << "Semantics::Instruction::get_select_mutable: invalid tag: " << tag;
+			throw SemanticsError(sstr.str());
+	}
+
+	std::ostringstream sstr;
+	sstr << "Semantics::Instruction::get_select_mutable: binding has a different type tag: " << tag;
+	throw SemanticsError(sstr.str());
+}
+
+Semantics::Instruction::CheckBounds &Semantics::Instruction::get_check_bounds_mutable() {
+	switch(tag) {
+		case ignore_tag:
+		case custom_tag:
+		case syscall_tag:
+		case add_sp_tag:
+		case load_immediate_tag:
+		case load_from_tag:
+		case less_than_from_tag:
+		case nor_from_tag:
+		case and_from_tag:
+		case or_from_tag:
+		case add_from_tag:
+		case sub_from_tag:
+		case mult_from_tag:
+		case div_from_tag:
+		case jump_to_tag:
+		case jump_tag:
+		case call_tag:
+		case return_tag:
+		case branch_zero_tag:
+		case branch_nonnegative_tag:
+		case select_tag:
+			break;
+		case check_bounds_tag:
+			return std::get<CheckBounds>(data);
+
+		case null_tag:
+		default:
+			std::ostringstream sstr;
+			sstr << "Semantics::Instruction::get_check_bounds_mutable: invalid tag: " << tag;
+			throw SemanticsError(sstr.str());
+	}
+
+	std::ostringstream sstr;
+	sstr << "Semantics::Instruction::get_check_bounds_mutable: binding has a different type tag: " << tag;
+	throw SemanticsError(sstr.str());
+}
+
 // | Return "ignore", "custom", "syscall", "add_sp", "load_immediate", "less_than_from", "load_from", or "nor_from", etc.
 std::string Semantics::Instruction::get_tag_repr(tag_t tag) {
 	switch(tag) {
@@ -9256,6 +10408,10 @@ std::string Semantics::Instruction::get_tag_repr(tag_t tag) {
 			return "branch_zero";
 		case branch_nonnegative_tag:
 			return "branch_nonnegative";
+		case select_tag:
+			return "select";
+		case check_bounds_tag:
+			return "check_bounds";
 
 		case null_tag:
 		default:
@@ -9311,6 +10467,10 @@ std::vector<uint32_t> Semantics::Instruction::get_input_sizes() const {
 			return get_branch_zero().get_input_sizes();
 		case branch_nonnegative_tag:
 			return get_branch_nonnegative().get_input_sizes();
+		case select_tag:
+			return get_select().get_input_sizes();
+		case check_bounds_tag:
+			return get_check_bounds().get_input_sizes();
 
 		case null_tag:
 		default:
@@ -9362,6 +10522,10 @@ std::vector<uint32_t> Semantics::Instruction::get_working_sizes() const {
 			return get_branch_zero().get_working_sizes();
 		case branch_nonnegative_tag:
 			return get_branch_nonnegative().get_working_sizes();
+		case select_tag:
+			return get_select().get_working_sizes();
+		case check_bounds_tag:
+			return get_check_bounds().get_working_sizes();
 
 		case null_tag:
 		default:
@@ -9413,6 +10577,10 @@ std::vector<uint32_t> Semantics::Instruction::get_output_sizes() const {
 			return get_branch_zero().get_output_sizes();
 		case branch_nonnegative_tag:
 			return get_branch_nonnegative().get_output_sizes();
+		case select_tag:
+			return get_select().get_output_sizes();
+		case check_bounds_tag:
+			return get_check_bounds().get_output_sizes();
 
 		case null_tag:
 		default:
@@ -9464,6 +10632,10 @@ std::vector<uint32_t> Semantics::Instruction::get_all_sizes() const {
 			return get_branch_zero().get_all_sizes();
 		case branch_nonnegative_tag:
 			return get_branch_nonnegative().get_all_sizes();
+		case select_tag:
+			return get_select().get_all_sizes();
+		case check_bounds_tag:
+			return get_check_bounds().get_all_sizes();
 
 		case null_tag:
 		default:
@@ -9473,7 +10645,7 @@ std::vector<uint32_t> Semantics::Instruction::get_all_sizes() const {
 	}
 }
 
-std::vector<Semantics::Output::Line> Semantics::Instruction::emit(const std::vector<Storage> &storages) const {
+std::vector<Semantics::Output::Line> Semantics::Instruction::emit(const std::vector<Storage> &storages, architecture_t architecture) const {
 	switch(tag) {
 		case ignore_tag:
 			return get_ignore().emit(storages);
@@ -9500,7 +10672,7 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::emit(const std::vec
 		case sub_from_tag:
 			return get_sub_from().emit(storages);
 		case mult_from_tag:
-			return get_mult_from().emit(storages);
+			return get_mult_from().emit(storages, architecture);
 		case div_from_tag:
 			return get_div_from().emit(storages);
 		case jump_to_tag:
@@ -9515,6 +10687,10 @@ std::vector<Semantics::Output::Line> Semantics::Instruction::emit(const std::vec
 			return get_branch_zero().emit(storages);
 		case branch_nonnegative_tag:
 			return get_branch_nonnegative().emit(storages);
+		case select_tag:
+			return get_select().emit(storages, architecture);
+		case check_bounds_tag:
+			return get_check_bounds().emit(storages, architecture);
 
 		case null_tag:
 		default:
@@ -9535,7 +10711,7 @@ std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepa
 	return prepare_permutation(capture_outputs_, back);
 }
 
-std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepare_permutation(const std::set<IO> &capture_outputs_, std::optional<Index> back) const {
+std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepare_permutation(const std::set<IO> &capture_outputs_, std::optional<Index> back, Schedule *schedule) const {
 	// Emulate emit(), except don't emit, and add working storage unit requirements when more are needed.
 	std::vector<Storage>  working_storages;
 	std::vector<uint64_t> working_storages_num_claims;
@@ -9569,6 +10745,7 @@ std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepa
 	std::vector<Index> children_stack;
 	std::set<Index>    in_children_stack;
 	std::set<Index>    ancestors;  // Detect cycles: DFS can detect already visited notes (e.g. diamond) but not ancestors.
+	const std::map<Index, std::pair<uint64_t, std::vector<IOIndex>>> input_emission_orders = get_input_emission_orders();  // Sethi-Ullman order.
 	for (const std::map<Index, std::map<IOIndex, Storage>>::value_type &output_pair : std::as_const(expanded_capture_outputs)) {
 		root_stack.push_back(output_pair.first);
 	}
@@ -9597,9 +10774,21 @@ std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepa
 		// and marking it as visited.
 		bool has_unvisited_children = false;
 
-		// Search connections.
-		for (IOIndex input_index_ = 0; input_index_ < instruction.get_input_sizes().size(); ++input_index_) {
-			const IOIndex input_index = instruction.get_input_sizes().size() - 1 - input_index_;
+		// Search connections.  Push in reverse so that the first input to
+		// emit ends up on top of the stack.  Emit the heavier inputs first
+		// when the inputs in their original order would need more working
+		// storage units than remain in the register budget.
+		std::vector<IOIndex> input_order;
+		std::map<Index, std::pair<uint64_t, std::vector<IOIndex>>>::const_iterator input_emission_orders_search = input_emission_orders.find(this_node);
+		if (input_emission_orders_search != input_emission_orders.cend() && claimed_working_storages.size() + input_emission_orders_search->second.first > register_budget) {
+			input_order = input_emission_orders_search->second.second;
+		} else {
+			for (IOIndex input_index = 0; input_index < instruction.get_input_sizes().size(); ++input_index) {
+				input_order.push_back(input_index);
+			}
+		}
+		for (std::vector<IOIndex>::size_type input_order_index_ = 0; input_order_index_ < input_order.size(); ++input_order_index_) {
+			const IOIndex input_index = input_order[input_order.size() - 1 - input_order_index_];
 			std::map<IO, IO>::const_iterator connections_search = connections.find({this_node, input_index});
 			if (connections_search != connections.cend()) {
 				const Index child_node = connections_search->second.first;
@@ -9652,6 +10841,7 @@ std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepa
 		in_children_stack.erase(this_node);
 
 		// Emit this node.
+		std::set<Storage::Index> scheduled_working_storages;
 
 		// Construct the instruction's input storage.
 		//std::vector<Storage> input_storage;
@@ -9721,6 +10911,7 @@ std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepa
 				}
 
 				const Storage &working_storage = working_storages[reverse_claimed_working_storages_search->second];
+				scheduled_working_storages.insert(reverse_claimed_working_storages_search->second);
 				//input_storage.push_back(working_storage);
 				if (working_storage.max_size != instruction.get_input_sizes().at(input_index)) {
 					std::ostringstream sstr;
@@ -9798,6 +10989,7 @@ std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepa
 							reverse_claimed_working_storages.insert({output_io, working_storage_index});
 							claimed_working_storages.insert({working_storage_index, output_io});
 							++working_storages_num_claims[working_storage_index];
+							scheduled_working_storages.insert(working_storage_index);
 
 							// Add the working storage.
 							//output_storage.push_back(working_storage);
@@ -9813,6 +11005,7 @@ std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepa
 					// Add and claim a new working storage.
 					reverse_claimed_working_storages.insert({output_io, working_storages.size()});
 					claimed_working_storages.insert({working_storages.size(), output_io});
+					scheduled_working_storages.insert(working_storages.size());
 					working_storages.push_back(Storage(instruction.get_output_sizes().at(output_index), false, Symbol(), "", false, 0));
 					working_storages_num_claims.push_back(1);
 				}
@@ -9834,6 +11027,7 @@ std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepa
 						// Claim the working storage.
 						instruction_claimed_working_storages.insert(working_storage_index);
 						++working_storages_num_claims[working_storage_index];
+						scheduled_working_storages.insert(working_storage_index);
 
 						// Add the working storage.
 						//instruction_working_storage.push_back(working_storage);
@@ -9848,6 +11042,7 @@ std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepa
 
 				// Add and claim a new working storage.
 				instruction_claimed_working_storages.insert(working_storages.size());
+				scheduled_working_storages.insert(working_storages.size());
 				working_storages.push_back(Storage(instruction.get_working_sizes().at(working_index), false, Symbol(), "", false, 0));
 				working_storages_num_claims.push_back(1);
 			}
@@ -9863,6 +11058,10 @@ std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepa
 		//instruction_output = instruction.emit(instruction_storage);
 		//output_lines.insert(output_lines.end(), instruction_output.cbegin(), instruction_output.cend());
 
+		if (schedule != nullptr) {
+			schedule->push_back({this_node, scheduled_working_storages});
+		}
+
 		// Free working storages: for each input that's in a working storage
 		// unit (as opposed to being provided by "input_storages"), check all
 		// the other nodes that are using that same output as input.  If there
@@ -9975,40 +11174,294 @@ std::pair<std::vector<uint32_t>, std::vector<uint64_t>> Semantics::MIPSIO::prepa
 	return std::pair<std::vector<uint32_t>, std::vector<uint64_t>>(Storage::get_sizes(working_storages), permutation);
 }
 
-std::vector<Semantics::Output::Line> Semantics::MIPSIO::emit(const std::map<IO, Storage> &input_storages, const std::vector<Storage> &working_storages, const std::map<IO, Storage> &capture_outputs, bool permit_uncaptured_outputs, std::optional<Index> back) const {
-	std::map<Index, std::map<IOIndex, Storage>> expanded_capture_outputs = expand_map<Index, IOIndex, Storage>(capture_outputs);
-
-	std::vector<uint32_t> working_storage_sizes = Storage::get_sizes(working_storages);
-	std::map<IO, Storage::Index> reverse_claimed_working_storages;  // For a node's output, which working storage units is it using?
-	std::map<Storage::Index, IO> claimed_working_storages;          // Which output IO claims a working storage?
+bool Semantics::MIPSIO::is_reorderable_instruction(Index index) const {
+	const Instruction &instruction = instructions.at(index);
 
-	std::vector<Output::Line> output_lines;
+	// Labels pin an instruction in place.
+	if (instruction.get_base().has_symbol) {
+		return false;
+	}
 
-	std::vector<Storage> pushed_registers;
-	std::set<Storage> in_pushed_registers;
+	// A node sequenced before another may only be reached through that
+	// node, which holds for nodes without outputs (e.g. the Ignore that an
+	// lvalue read is sequenced after).
+	if (sequences.find(index) != sequences.cend() && instruction.get_output_sizes().size() > 0) {
+		return false;
+	}
 
-	int32_t add_sp_total    = 0;  // Includes pushed_sp_total.
-	int32_t pushed_sp_total = 0;  // Applied even if no_sp_adjust.
-	int32_t add_sp_total_at_last_push = 0;
+	switch (instruction.tag) {
+		case Instruction::ignore_tag:
+		case Instruction::load_immediate_tag:
+		case Instruction::less_than_from_tag:
+		case Instruction::nor_from_tag:
+		case Instruction::and_from_tag:
+		case Instruction::or_from_tag:
+		case Instruction::add_from_tag:
+		case Instruction::sub_from_tag:
+		case Instruction::mult_from_tag:
+		case Instruction::div_from_tag:
+		case Instruction::select_tag:
+			return true;
+		case Instruction::load_from_tag: {
+			// Reads are fine; writes to memory or fixed storage are not.
+			const Instruction::LoadFrom &load_from = instruction.get_load_from();
+			return !load_from.is_save_fixed && !load_from.dereference_save && !load_from.get_dest_address_from_input;
+		}
+		default:
+			return false;
+	}
+}
 
-	std::map<std::string, std::pair<int32_t, int32_t>> markers;  // marker name -> {top, bottom}, i.e. {add_sp_total before push, add_sp_total after push}
+std::vector<Semantics::ValueRange> Semantics::MIPSIO::get_value_ranges() const {
+	// 0: unvisited, 1: its inputs are being visited, 2: done.
+	std::vector<ValueRange> ranges(instructions.size());
+	std::vector<uint8_t>    states(instructions.size(), 0);
 
-	// Except for nosave_registers, only allow nosaves corresponding to these
-	// nodes.  This should only be storages used between "push_registers" and
-	// "jal" (TODO: double check this) that aren't re-used later on; only
-	// instructions between pushing saved registers and the jal that are *not*
-	// re-used later on.
-	//
-	// TODO: implement!  For now, just leave this empty to disable it, because
-	// nosaves is broken, and is unnecessary but prevents unnecessary saves.
-	//
-	// For calls, the arguments were being added to nosaves unconditionally,
-	// but this is only correct when the arguments are not used *after* the
-	// call.
-	std::set<Storage::Index> nosave_allowed;
+	// The range of an input whose producer is done.  Inputs from storage
+	// units, from a second output, or from a cycle may hold anything.
+	const auto get_input_range = [this, &ranges, &states](Index index, IOIndex input_index) -> ValueRange {
+		std::map<IO, IO>::const_iterator connections_search = connections.find({index, input_index});
+		if (connections_search == connections.cend() || connections_search->second.second != 0 || states[connections_search->second.first] != 2) {
+			return ValueRange::word_range;
+		}
+		return ranges[connections_search->second.first];
+	};
 
-	// DFS from each output vertex.  Don't revisit instructions.  Write outputs
-	// to available working storage units.  After all of a given node's output
+	// Post-order traversal over the connections.
+	for (Index root = 0; root < instructions.size(); ++root) {
+		std::vector<std::pair<Index, bool>> stack {{root, false}};
+		while (stack.size() > 0) {
+			const std::pair<Index, bool> top = stack.back();
+			stack.pop_back();
+			const Index        this_node   = top.first;
+			const Instruction &instruction = instructions.at(this_node);
+			if (!top.second) {
+				if (states[this_node] != 0) {
+					continue;
+				}
+				states[this_node] = 1;
+				stack.push_back({this_node, true});
+				for (IOIndex input_index = 0; input_index < instruction.get_input_sizes().size(); ++input_index) {
+					std::map<IO, IO>::const_iterator connections_search = connections.find({this_node, input_index});
+					if (connections_search != connections.cend() && states[connections_search->second.first] == 0) {
+						stack.push_back({connections_search->second.first, false});
+					}
+				}
+				continue;
+			}
+
+			ValueRange range;
+			switch (instruction.tag) {
+				case Instruction::load_immediate_tag: {
+					range = ValueRange(instruction.get_load_immediate().constant_value);
+					break;
+				} case Instruction::load_from_tag: {
+					const Instruction::LoadFrom &load_from = instruction.get_load_from();
+					if (!load_from.is_load_fixed) {
+						range = load_from.dereference_load ? (load_from.is_word_load ? ValueRange::word_range : ValueRange::byte_range) : get_input_range(this_node, 0);
+					} else if ((load_from.fixed_load_storage.is_register_direct() || load_from.fixed_load_storage.is_global_address()) && !load_from.dereference_load) {
+						range = load_from.fixed_load_storage.is_register_direct() && load_from.fixed_load_storage.register_ == "$zero" ? ValueRange(0, 0) : ValueRange::word_range;
+					} else {
+						// Bytes in memory are loaded sign-extended.
+						range = load_from.is_word_load ? ValueRange::word_range : ValueRange::byte_range;
+					}
+					range = range.add(ValueRange(load_from.addition, load_from.addition));
+					break;
+				} case Instruction::less_than_from_tag: {
+					range = ValueRange::boolean_range;
+					break;
+				} case Instruction::and_from_tag: {
+					range = get_input_range(this_node, 0).bitwise_and(get_input_range(this_node, 1));
+					break;
+				} case Instruction::or_from_tag: {
+					range = get_input_range(this_node, 0).bitwise_or(get_input_range(this_node, 1));
+					break;
+				} case Instruction::add_from_tag: {
+					range = get_input_range(this_node, 0).add(get_input_range(this_node, 1));
+					break;
+				} case Instruction::sub_from_tag: {
+					range = get_input_range(this_node, 0).subtract(get_input_range(this_node, 1));
+					break;
+				} case Instruction::mult_from_tag: {
+					if (!instruction.get_mult_from().ignore_lo) {
+						range = get_input_range(this_node, 0).multiply(get_input_range(this_node, 1));
+					}
+					break;
+				} case Instruction::div_from_tag: {
+					const Instruction::DivFrom &div_from = instruction.get_div_from();
+					const ValueRange left_range  = get_input_range(this_node, 0);
+					const ValueRange right_range = get_input_range(this_node, 1);
+					if        (div_from.is_shift && !div_from.ignore_lo) {
+						range = right_range.is_within(0, 31) ? ValueRange(left_range.min >> right_range.max, left_range.max >> right_range.min) : ValueRange::word_range;
+					} else if (div_from.is_shift) {
+						range = left_range.bitwise_and(right_range);
+					} else if (!div_from.ignore_lo) {
+						range = left_range.divide(right_range);
+					} else {
+						range = left_range.remainder(right_range);
+					}
+					break;
+				} case Instruction::select_tag: {
+					range = get_input_range(this_node, 1).join(get_input_range(this_node, 2));
+					break;
+				} default: {
+					break;
+				}
+			}
+
+			// Byte outputs may be truncated, and the analysis may know more.
+			const std::vector<uint32_t> output_sizes = instruction.get_output_sizes();
+			if (output_sizes.size() > 0 && output_sizes[0] == 1) {
+				range = range.store_byte();
+			}
+			ranges[this_node] = range.meet(instruction.get_base().known_range);
+			states[this_node] = 2;
+		}
+	}
+
+	return ranges;
+}
+
+std::map<Semantics::MIPSIO::Index, std::pair<uint64_t, std::vector<Semantics::MIPSIO::IOIndex>>> Semantics::MIPSIO::get_input_emission_orders() const {
+	std::map<Index, std::pair<uint64_t, std::vector<IOIndex>>> input_emission_orders;
+
+	// Post-order traversal computing each node's label and whether its
+	// subtree is pure.
+	std::map<Index, uint64_t> labels;
+	std::map<Index, bool>     pure_subtrees;
+	for (Index root = 0; root < instructions.size(); ++root) {
+		if (labels.find(root) != labels.cend()) {
+			continue;
+		}
+
+		std::vector<Index> stack;
+		std::set<Index>    on_stack;
+		stack.push_back(root);
+		on_stack.insert(root);
+		while (stack.size() > 0) {
+			const Index        this_node   = stack.back();
+			const Instruction &instruction = instructions.at(this_node);
+
+			// Visit unlabeled children first, including a node sequenced
+			// before this one.
+			std::vector<Index> child_nodes;
+			for (IOIndex input_index = 0; input_index < instruction.get_input_sizes().size(); ++input_index) {
+				std::map<IO, IO>::const_iterator connections_search = connections.find({this_node, input_index});
+				if (connections_search != connections.cend()) {
+					child_nodes.push_back(connections_search->second.first);
+				}
+			}
+			std::map<Index, Index>::const_iterator reversed_sequences_search = reversed_sequences.find(this_node);
+			if (reversed_sequences_search != reversed_sequences.cend()) {
+				child_nodes.push_back(reversed_sequences_search->second);
+			}
+			bool has_unlabeled_children = false;
+			for (const Index &child_node : std::as_const(child_nodes)) {
+				if (labels.find(child_node) == labels.cend() && on_stack.find(child_node) == on_stack.cend()) {
+					has_unlabeled_children = true;
+					stack.push_back(child_node);
+					on_stack.insert(child_node);
+				}
+			}
+			if (has_unlabeled_children) {
+				continue;
+			}
+			stack.pop_back();
+			on_stack.erase(this_node);
+
+			// Collect the children's labels.  (A child still on the stack
+			// means a cycle, which emit() reports; treat it as impure here.)
+			std::vector<std::pair<uint64_t, IOIndex>> child_labels;
+			bool children_pure = true;
+			for (IOIndex input_index = 0; input_index < instruction.get_input_sizes().size(); ++input_index) {
+				std::map<IO, IO>::const_iterator connections_search = connections.find({this_node, input_index});
+				if (connections_search != connections.cend()) {
+					const Index child_node = connections_search->second.first;
+					std::map<Index, uint64_t>::const_iterator labels_search = labels.find(child_node);
+					if (labels_search == labels.cend()) {
+						children_pure = false;
+						child_labels.push_back({1, input_index});
+					} else {
+						children_pure = children_pure && pure_subtrees.at(child_node);
+						child_labels.push_back({labels_search->second, input_index});
+					}
+				}
+			}
+
+			// need = max(label_i + i) over the emitted order, and at least
+			// enough to hold all inputs while the instruction's working
+			// storage and outputs are claimed.
+			const uint64_t base_need = std::max<uint64_t>(1, child_labels.size() + instruction.get_working_sizes().size() + instruction.get_output_sizes().size());
+			uint64_t label = base_need;
+			for (std::vector<std::pair<uint64_t, IOIndex>>::size_type child_index = 0; child_index < child_labels.size(); ++child_index) {
+				label = std::max<uint64_t>(label, child_labels[child_index].first + child_index);
+			}
+
+			// Heavier subtrees first, but only when it strictly lowers the
+			// need; otherwise keep the original order.
+			if (children_pure && child_labels.size() > 1) {
+				std::vector<std::pair<uint64_t, IOIndex>> sorted_child_labels(child_labels);
+				std::stable_sort(sorted_child_labels.begin(), sorted_child_labels.end(), [](const std::pair<uint64_t, IOIndex> &a, const std::pair<uint64_t, IOIndex> &b) -> bool { return a.first > b.first; });
+				uint64_t sorted_label = base_need;
+				std::vector<IOIndex> order;
+				for (std::vector<std::pair<uint64_t, IOIndex>>::size_type child_index = 0; child_index < sorted_child_labels.size(); ++child_index) {
+					sorted_label = std::max<uint64_t>(sorted_label, sorted_child_labels[child_index].first + child_index);
+					order.push_back(sorted_child_labels[child_index].second);
+				}
+				if (sorted_label < label) {
+					input_emission_orders.insert({this_node, {label, order}});
+					label = sorted_label;
+				}
+			}
+
+			bool pure_subtree = children_pure && is_reorderable_instruction(this_node);
+			if (reversed_sequences_search != reversed_sequences.cend()) {
+				std::map<Index, bool>::const_iterator pure_subtrees_search = pure_subtrees.find(reversed_sequences_search->second);
+				pure_subtree = pure_subtree && pure_subtrees_search != pure_subtrees.cend() && pure_subtrees_search->second;
+			}
+
+			labels.insert({this_node, label});
+			pure_subtrees.insert({this_node, pure_subtree});
+		}
+	}
+
+	return input_emission_orders;
+}
+
+std::vector<Semantics::Output::Line> Semantics::MIPSIO::emit(const std::map<IO, Storage> &input_storages, const std::vector<Storage> &working_storages, const std::map<IO, Storage> &capture_outputs, bool permit_uncaptured_outputs, std::optional<Index> back, architecture_t architecture) const {
+	std::map<Index, std::map<IOIndex, Storage>> expanded_capture_outputs = expand_map<Index, IOIndex, Storage>(capture_outputs);
+
+	std::vector<uint32_t> working_storage_sizes = Storage::get_sizes(working_storages);
+	std::map<IO, Storage::Index> reverse_claimed_working_storages;  // For a node's output, which working storage units is it using?
+	std::map<Storage::Index, IO> claimed_working_storages;          // Which output IO claims a working storage?
+
+	std::vector<Output::Line> output_lines;
+
+	std::vector<Storage> pushed_registers;
+	std::set<Storage> in_pushed_registers;
+
+	int32_t add_sp_total    = 0;  // Includes pushed_sp_total.
+	int32_t pushed_sp_total = 0;  // Applied even if no_sp_adjust.
+	int32_t add_sp_total_at_last_push = 0;
+
+	std::map<std::string, std::pair<int32_t, int32_t>> markers;  // marker name -> {top, bottom}, i.e. {add_sp_total before push, add_sp_total after push}
+
+	// Except for nosave_registers, only allow nosaves corresponding to these
+	// nodes.  This should only be storages used between "push_registers" and
+	// "jal" (TODO: double check this) that aren't re-used later on; only
+	// instructions between pushing saved registers and the jal that are *not*
+	// re-used later on.
+	//
+	// TODO: implement!  For now, just leave this empty to disable it, because
+	// nosaves is broken, and is unnecessary but prevents unnecessary saves.
+	//
+	// For calls, the arguments were being added to nosaves unconditionally,
+	// but this is only correct when the arguments are not used *after* the
+	// call.
+	std::set<Storage::Index> nosave_allowed;
+
+	// DFS from each output vertex.  Don't revisit instructions.  Write outputs
+	// to available working storage units.  After all of a given node's output
 	// index's connected input nodes are emitted, mark the working storage unit
 	// that that node's output index was stored to as available.
 	//
@@ -10020,6 +11473,7 @@ std::vector<Semantics::Output::Line> Semantics::MIPSIO::emit(const std::map<IO,
 	std::vector<Index> children_stack;
 	std::set<Index>    in_children_stack;
 	std::set<Index>    ancestors;  // Detect cycles: DFS can detect already visited notes (e.g. diamond) but not ancestors.
+	const std::map<Index, std::pair<uint64_t, std::vector<IOIndex>>> input_emission_orders = get_input_emission_orders();  // Sethi-Ullman order.
 	for (const std::map<Index, std::map<IOIndex, Storage>>::value_type &output_pair : std::as_const(expanded_capture_outputs)) {
 		root_stack.push_back(output_pair.first);
 	}
@@ -10048,9 +11502,21 @@ std::vector<Semantics::Output::Line> Semantics::MIPSIO::emit(const std::map<IO,
 		// and marking it as visited.
 		bool has_unvisited_children = false;
 
-		// Search connections.
-		for (IOIndex input_index_ = 0; input_index_ < instruction.get_input_sizes().size(); ++input_index_) {
-			const IOIndex input_index = instruction.get_input_sizes().size() - 1 - input_index_;
+		// Search connections.  Push in reverse so that the first input to
+		// emit ends up on top of the stack.  Emit the heavier inputs first
+		// when the inputs in their original order would need more working
+		// storage units than remain in the register budget.
+		std::vector<IOIndex> input_order;
+		std::map<Index, std::pair<uint64_t, std::vector<IOIndex>>>::const_iterator input_emission_orders_search = input_emission_orders.find(this_node);
+		if (input_emission_orders_search != input_emission_orders.cend() && claimed_working_storages.size() + input_emission_orders_search->second.first > register_budget) {
+			input_order = input_emission_orders_search->second.second;
+		} else {
+			for (IOIndex input_index = 0; input_index < instruction.get_input_sizes().size(); ++input_index) {
+				input_order.push_back(input_index);
+			}
+		}
+		for (std::vector<IOIndex>::size_type input_order_index_ = 0; input_order_index_ < input_order.size(); ++input_order_index_) {
+			const IOIndex input_index = input_order[input_order.size() - 1 - input_order_index_];
 			std::map<IO, IO>::const_iterator connections_search = connections.find({this_node, input_index});
 			if (connections_search != connections.cend()) {
 				const Index child_node = connections_search->second.first;
@@ -10591,7 +12057,7 @@ std::vector<Semantics::Output::Line> Semantics::MIPSIO::emit(const std::map<IO,
 		// Emit the instruction.
 		std::vector<Output::Line> instruction_output;
 		if (!instruction.is_call() || (!instruction.get_call().push_saved_registers && !instruction.get_call().pop_saved_registers)) {
-			instruction_output = alt_instruction.emit(instruction_storage);
+			instruction_output = alt_instruction.emit(instruction_storage, architecture);
 		} else {
 			// Instead of a call, just push or pop saved registers.
 			const Instruction::Call &call = instruction.get_call();
@@ -10858,6 +12324,30 @@ void Semantics::MIPSIO::optimize() {
 	// TODO
 }
 
+void Semantics::MIPSIO::remap_stack_slots(const std::map<int32_t, int32_t> &offsets) {
+	for (Instruction &instruction : instructions) {
+		if (!instruction.is_load_from()) {
+			continue;
+		}
+		Instruction::LoadFrom &load_from = instruction.get_load_from_mutable();
+
+		// Only direct accesses to a slot move; a slot whose address is
+		// taken is never remapped.
+		if (load_from.is_save_fixed && load_from.fixed_save_storage.is_register_dereference() && load_from.fixed_save_storage.register_ == "$sp" && !load_from.fixed_save_storage.no_sp_adjust) {
+			std::map<int32_t, int32_t>::const_iterator offsets_search = offsets.find(load_from.fixed_save_storage.offset);
+			if (offsets_search != offsets.cend()) {
+				load_from.fixed_save_storage.offset = offsets_search->second;
+			}
+		}
+		if (load_from.is_load_fixed && load_from.fixed_load_storage.is_register_dereference() && load_from.fixed_load_storage.register_ == "$sp" && !load_from.fixed_load_storage.no_sp_adjust) {
+			std::map<int32_t, int32_t>::const_iterator offsets_search = offsets.find(load_from.fixed_load_storage.offset);
+			if (offsets_search != offsets.cend()) {
+				load_from.fixed_load_storage.offset = offsets_search->second;
+			}
+		}
+	}
+}
+
 // | Straightforwardly add an instruction, optionally connecting its
 // first arguments with the first output of the instructions
 // corresponding to the input indices.
@@ -11119,7 +12609,7 @@ Semantics::MIPSIO::Index Semantics::LvalueSourceAnalysis::merge_expression(const
 	return merged_other_output_index;
 }
 
-Semantics::LvalueSourceAnalysis Semantics::analyze_lvalue_source(const Lvalue &lvalue, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, const IdentifierScope &var_scope, const IdentifierScope &combined_scope, const IdentifierScope &storage_scope, RoutineBlockState &routine_block_state, bool require_mutable) {
+Semantics::LvalueSourceAnalysis Semantics::analyze_lvalue_source(const Lvalue &lvalue, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, const IdentifierScope &var_scope, const IdentifierScope &combined_scope, const IdentifierScope &storage_scope, RoutineBlockState &routine_block_state, bool require_mutable, bool fold_dereference_offset) {
 	// Some type aliases to improve readability.
 	using M = Semantics::MIPSIO;
 	using I = Semantics::Instruction;
@@ -11183,6 +12673,27 @@ Semantics::LvalueSourceAnalysis Semantics::analyze_lvalue_source(const Lvalue &l
 	// Correct the order of the list.
 	std::reverse(lvalue_accessor_clauses.begin(), lvalue_accessor_clauses.end());
 
+	// Is it a field of a local record that was replaced by a variable per
+	// field?
+	const std::map<std::string, std::map<std::string, Var>>::const_iterator scalar_records_search = routine_block_state.scalar_records.find(lvalue_identifier.text);
+	if (scalar_records_search != routine_block_state.scalar_records.cend() && lvalue_accessor_clauses.size() == 1 && lvalue_accessor_clauses[0]->branch == LvalueAccessorClause::index_branch) {
+		const LvalueAccessorClause::Index &lvalue_accessor_clause_index = grammar.lvalue_accessor_clause_index_storage.at(lvalue_accessor_clauses[0]->data);
+		const Var                         &var                          = scalar_records_search->second.at(grammar.lexemes.at(lvalue_accessor_clause_index.identifier).get_identifier().text);
+
+		if (var.storage.is_register_direct()) {
+			lvalue_source_analysis.instructions.preserve_register(var.storage.register_);
+		}
+
+		lvalue_source_analysis.lexeme_end              = lvalue_accessor_clause_index.identifier + 1;
+		lvalue_source_analysis.is_mutable              = true;
+		lvalue_source_analysis.lvalue_type             = var.type;
+		lvalue_source_analysis.lvalue_fixed_storage    = var.storage;
+		lvalue_source_analysis.is_lvalue_fixed_storage = true;
+		lvalue_source_analysis.is_lvalue_primref       = false;
+		lvalue_source_analysis.lvalue_index            = lvalue_source_analysis.instructions.add_instruction({I::Ignore(B(), false, false)});
+		return lvalue_source_analysis;
+	}
+
 	// Lookup the lvalue.
 	if (!combined_scope.has(lvalue_identifier.text)) {
 		std::ostringstream sstr;
@@ -11204,8 +12715,9 @@ Semantics::LvalueSourceAnalysis Semantics::analyze_lvalue_source(const Lvalue &l
 		// First, if the variable refers to a direct register with no offset,
 		// e.g. $a0-$a3, we're accessing it, so calls will need to save this
 		// unless this is the last access.  TODO: optimization: calls after the
-		// last access don't need this backed up.
-		if (var.storage.is_register_direct()) {
+		// last access don't need this backed up.  The same goes for the
+		// address of a primitive ref parameter held in $a0-$a3.
+		if ((var.storage.is_register_direct() || var.storage.is_register_dereference()) && var.storage.register_ != "$gp" && var.storage.register_ != "$sp") {
 			lvalue_source_analysis.instructions.preserve_register(var.storage.register_);
 		}
 
@@ -11239,8 +12751,16 @@ Semantics::LvalueSourceAnalysis Semantics::analyze_lvalue_source(const Lvalue &l
 			lvalue_source_analysis.lvalue_index = lvalue_source_analysis.instructions.add_instruction({I::Ignore(B(), false, false)});
 		} else if (resolved_type.is_record() || resolved_type.is_array()) {
 			// Load the base address of the array or record.  Apply any provided accessors.
+			//
+			// Statically known parts of the address, i.e. record field
+			// offsets and constant array indices, are accumulated in
+			// static_offset rather than being added with instructions, so
+			// that they can be folded into the offset of the final load or
+			// store.
 			TypeIndex last_output_type  = type;
 			Index     last_output_index = lvalue_source_analysis.instructions.add_instruction({I::LoadFrom(B(), true, true, 0, false, true, Storage(), var.storage)});
+			int32_t   static_offset     = 0;
+			bool      is_static_address = true;
 
 			for (const LvalueAccessorClause *lvalue_accessor_clause_ : std::as_const(lvalue_accessor_clauses)) {
 				const LvalueAccessorClause &lvalue_accessor_clause = *lvalue_accessor_clause_;
@@ -11263,21 +12783,21 @@ Semantics::LvalueSourceAnalysis Semantics::analyze_lvalue_source(const Lvalue &l
 							throw SemanticsError(sstr.str());
 						}
 
-						// Find the field.
+						// Find the field.  The Type::Record constructor
+						// records where each field is laid out.
+						const Type::Record &record = storage_scope.type(last_output_type).resolve_type(storage_scope).get_record();
 						bool     found  = false;
 						uint32_t offset = 0;
-						for (const std::pair<std::string, TypeIndex> &field : std::as_const(storage_scope.type(last_output_type).resolve_type(storage_scope).get_record().fields)) {
+						for (const std::pair<std::string, TypeIndex> &field : std::as_const(record.fields)) {
 							const std::string &field_name = field.first;
 							const TypeIndex    field_type = field.second;
 
 							if (identifier.text == field_name) {
 								found = true;
+								offset = record.field_offsets.at(&field - &record.fields[0]);
 								last_output_type = field_type;
 								break;
 							}
-
-							offset = Instruction::AddSp::round_to_align(offset, storage_scope.type(field_type).get_size());
-							offset += storage_scope.type(field_type).get_size();
 						}
 						if (!found) {
 							std::ostringstream sstr;
@@ -11290,33 +12810,8 @@ Semantics::LvalueSourceAnalysis Semantics::analyze_lvalue_source(const Lvalue &l
 							throw SemanticsError(sstr.str());
 						}
 
-						// Get the address of the field.
-						const Index record_offset_index          = lvalue_source_analysis.instructions.add_instruction({I::LoadImmediate(B(), true, ConstantValue(static_cast<int32_t>(offset), 0, 0))});
-						const Index record_element_address_index = lvalue_source_analysis.instructions.add_instruction({I::AddFrom(B(), true)}, {last_output_index, record_offset_index});
-						// Dereference if the field type is primitive.  If the field type is another record or array, leave the address as is.
-						const Type &last_output_resolved_type = storage_scope.type(last_output_type).resolve_type(storage_scope);
-						if (true || !last_output_resolved_type.is_primitive()) {
-							last_output_index = record_element_address_index;
-						} else {
-							// Dereference.
-							const Type::Primitive &last_output_resolved_primitive_type = last_output_resolved_type.get_primitive();
-							const Index record_dereference_index = lvalue_source_analysis.instructions.add_instruction(
-								{I::LoadFrom(
-									B(),                                            // base
-									last_output_resolved_primitive_type.is_word(),  // is_word_save
-									last_output_resolved_primitive_type.is_word(),  // is_word_load
-									0,                                              // addition
-									false,                                          // is_save_fixed
-									false,                                          // is_load_fixed
-									{},                                             // fixed_save_storage
-									{},                                             // fixed_load_storage
-									false,                                          // dereference_save
-									true                                            // dereference_load
-								)},
-								{record_element_address_index}
-							);
-							last_output_index = record_dereference_index;
-						}
+						// The field is at a fixed offset from the record.
+						static_offset += static_cast<int32_t>(offset);
 
 						break;
 					}
@@ -11354,11 +12849,45 @@ Semantics::LvalueSourceAnalysis Semantics::analyze_lvalue_source(const Lvalue &l
 							throw SemanticsError(sstr.str());
 						}
 
-						const Type::Array &array_type = storage_scope.resolve_type(last_output_type).get_array();
-						const int32_t      min_index  = array_type.get_min_index();
+						const Type::Array &array_type   = storage_scope.resolve_type(last_output_type).get_array();
+						const int32_t      min_index    = array_type.get_min_index();
+						const int32_t      max_index    = array_type.get_max_index();
 
 						// | The last output type is now the base type.
 						last_output_type = array_type.base_type;
+						const int32_t      element_size = static_cast<int32_t>(storage_scope.type(last_output_type).get_size());
+
+						// Is the index known at compile time?  Then the
+						// element is at a fixed offset from the array.  So is
+						// it if the index has a single value and nothing to
+						// run, e.g. the iterator in a copy of a fully unrolled
+						// "for" loop.  (With bounds_check, an index out of
+						// bounds is left to trap at runtime.)
+						const ConstantValue    index_constant_value = is_expression_constant(expression0, constant_scope, var_scope);
+						const ValueRange       index_range          = value.get_value_range();
+						std::optional<int32_t> static_index;
+						if (index_constant_value.is_static()) {
+							if        (index_constant_value.is_integer()) {
+								static_index = index_constant_value.get_integer();
+							} else if (index_constant_value.is_char()) {
+								static_index = static_cast<int32_t>(static_cast<unsigned char>(index_constant_value.get_char()));
+							} else { //index_constant_value.is_boolean()
+								static_index = index_constant_value.get_boolean() ? 1 : 0;
+							}
+						} else if (optimize && index_range.is_constant()) {
+							bool is_pure = true;
+							for (Index instruction_index = 0; is_pure && instruction_index < value.instructions.instructions.size(); ++instruction_index) {
+								is_pure = value.instructions.is_reorderable_instruction(instruction_index);
+							}
+							if (is_pure) {
+								static_index = static_cast<int32_t>(index_range.min);
+							}
+						}
+						if (static_index.has_value() && (!bounds_check || (*static_index >= min_index && *static_index <= max_index))) {
+							static_offset += (*static_index - min_index) * element_size;
+							break;
+						}
+
 						// | Get the integer's index; make sure it's a word, as integers are.
 						assert(type_scope.resolve_type("integer").is_primitive() && type_scope.resolve_type("integer").get_primitive().is_word());
 						const Index presized_value_index                 = lvalue_source_analysis.merge_expression(value);
@@ -11367,21 +12896,53 @@ Semantics::LvalueSourceAnalysis Semantics::analyze_lvalue_source(const Lvalue &l
 							? presized_value_index
 							: lvalue_source_analysis.instructions.add_instruction({I::LoadFrom(B(), true, value_resolved_type.get_primitive().is_word(), 0)}, {presized_value_index});
 							;
-						Index shifted_value_index;
-						if (min_index == 0) {
-							shifted_value_index = value_index;
+
+						// With bounds_check, trap unless the index is in bounds,
+						// unless its range shows it always is: e.g. the iterator
+						// of a "for" loop whose bounds both lie within the
+						// array's, or an index variable that an earlier check in
+						// the same straight-line code already passed.  If either
+						// bound may lie outside, every access in the loop keeps
+						// its check; nothing is checked once before the loop.
+						Index checked_value_index = value_index;
+						if (bounds_check && !value.get_value_range().is_within(min_index, max_index)) {
+							// | The check leaves index - min_index, which is in 0 to max_index - min_index.
+							B check_base;
+							check_base.known_range = ValueRange(0, static_cast<int64_t>(max_index) - static_cast<int64_t>(min_index));
+							checked_value_index = lvalue_source_analysis.instructions.add_instruction({I::CheckBounds(check_base, min_index, max_index)}, {value_index});
+
+							// If the index is a variable that only assignments
+							// can change, later statements can rely on the check.
+							if (optimize && expression0.branch == ::Expression::lvalue_branch) {
+								const Lvalue                   &index_lvalue                      = grammar.lvalue_storage.at(grammar.expression_lvalue_storage.at(expression0.data).lvalue);
+								const std::string              &index_identifier                  = grammar.lexemes.at(index_lvalue.identifier).get_identifier().text;
+								const LvalueAccessorClauseList &index_lvalue_accessor_clause_list = grammar.lvalue_accessor_clause_list_storage.at(index_lvalue.lvalue_accessor_clause_list);
+								if (
+									   index_lvalue_accessor_clause_list.branch == LvalueAccessorClauseList::empty_branch
+									&& var_scope.has(index_identifier)
+									&& var_scope.get(index_identifier).is_var()
+									&& !var_scope.get(index_identifier).get_var().is_primitive_and_ref
+								) {
+									const ValueRange checked_range(min_index, max_index);
+									const std::map<std::string, ValueRange>::iterator pending_checked_ranges_search = routine_block_state.pending_checked_ranges.find(index_identifier);
+									if (pending_checked_ranges_search == routine_block_state.pending_checked_ranges.end()) {
+										routine_block_state.pending_checked_ranges.insert({index_identifier, checked_range});
+									} else {
+										pending_checked_ranges_search->second = pending_checked_ranges_search->second.meet(checked_range);
+									}
+								}
+							}
 						} else {
-							const Index load_min_index = lvalue_source_analysis.instructions.add_instruction({I::LoadImmediate(B(), true, ConstantValue(static_cast<int32_t>(min_index), 0, 0))});
-							shifted_value_index        = lvalue_source_analysis.instructions.add_instruction({I::SubFrom(B(), true)}, {value_index, load_min_index});
+							// | The minimum index is also static: element_size * (index - min_index) = element_size * index - element_size * min_index.
+							static_offset -= min_index * element_size;
 						}
 						// | Now dereference the array.
-						const Index load_element_size_index     = lvalue_source_analysis.instructions.add_instruction({I::LoadImmediate(B(), true, ConstantValue(static_cast<int32_t>(storage_scope.type(last_output_type).get_size()), 0, 0))});
-						//const Index array_element_offset_index  = lvalue_source_analysis.instructions.add_instruction({I::MultFrom(B(), true)}, {load_element_size_index, shifted_value_index});
-						//const Index ignore_index                = lvalue_source_analysis.instructions.add_instruction_indexed({I::Ignore(B())}, {{array_element_offset_index, 1}}, array_element_offset_index); (void) ignore_index;
-						const Index array_element_offset_index  = lvalue_source_analysis.instructions.add_instruction({I::MultFrom(B(), true, true)}, {load_element_size_index, shifted_value_index});
+						const Index load_element_size_index     = lvalue_source_analysis.instructions.add_instruction({I::LoadImmediate(B(), true, ConstantValue(static_cast<int32_t>(element_size), 0, 0))});
+						const Index array_element_offset_index  = lvalue_source_analysis.instructions.add_instruction({I::MultFrom(B(), true, true)}, {load_element_size_index, checked_value_index});
 						const Index array_element_address_index = lvalue_source_analysis.instructions.add_instruction({I::AddFrom(B(), true)}, {last_output_index, array_element_offset_index});
 						// Leave the base address.  In an expression context, the analyze_expression handler can dereference the array if needed.
 						last_output_index = array_element_address_index;
+						is_static_address = false;
 
 						break;
 					}
@@ -11394,11 +12955,45 @@ Semantics::LvalueSourceAnalysis Semantics::analyze_lvalue_source(const Lvalue &l
 				}
 			}
 
-			lvalue_source_analysis.is_mutable              = true;
-			lvalue_source_analysis.lvalue_type             = last_output_type;
-			lvalue_source_analysis.lvalue_index            = last_output_index;
-			lvalue_source_analysis.lvalue_fixed_storage    = Storage();
-			lvalue_source_analysis.is_lvalue_fixed_storage = false;
+			const Type &last_output_resolved_type = storage_scope.type(last_output_type).resolve_type(storage_scope);
+			const bool  is_primitive_element      = last_output_resolved_type.is_primitive() && !last_output_resolved_type.get_primitive().is_string();
+			if (is_primitive_element && is_static_address && var.storage.is_register_direct()) {
+				// The whole address is the base register plus a constant, e.g.
+				// "a.b.c[3].d" of a local record, so the element has a
+				// fixed storage of its own: off($sp).
+				Storage element_storage(std::as_const(var.storage));
+				element_storage.max_size    = last_output_resolved_type.get_primitive().is_word() ? 4 : 1;
+				element_storage.dereference = true;
+				element_storage.offset     += static_offset;
+
+				lvalue_source_analysis.instructions            = MIPSIO();
+				if (var.storage.register_ != "$gp") {
+					lvalue_source_analysis.instructions.preserve_register(var.storage.register_);
+				}
+				lvalue_source_analysis.is_mutable              = true;
+				lvalue_source_analysis.lvalue_type             = last_output_type;
+				lvalue_source_analysis.lvalue_fixed_storage    = element_storage;
+				lvalue_source_analysis.is_lvalue_fixed_storage = true;
+				lvalue_source_analysis.is_lvalue_primref       = false;
+
+				// To preserve registers, add an empty instruction, so that
+				// lvalue_source_analysis can always be merged.
+				lvalue_source_analysis.lvalue_index = lvalue_source_analysis.instructions.add_instruction({I::Ignore(B(), false, false)});
+			} else {
+				if (is_primitive_element && fold_dereference_offset) {
+					// Let the dereferencing load or store apply the offset.
+					lvalue_source_analysis.lvalue_dereference_offset = static_offset;
+				} else if (static_offset != 0) {
+					const Index static_offset_index = lvalue_source_analysis.instructions.add_instruction({I::LoadImmediate(B(), true, ConstantValue(static_cast<int32_t>(static_offset), 0, 0))});
+					last_output_index               = lvalue_source_analysis.instructions.add_instruction({I::AddFrom(B(), true)}, {last_output_index, static_offset_index});
+				}
+
+				lvalue_source_analysis.is_mutable              = true;
+				lvalue_source_analysis.lvalue_type             = last_output_type;
+				lvalue_source_analysis.lvalue_index            = last_output_index;
+				lvalue_source_analysis.lvalue_fixed_storage    = Storage();
+				lvalue_source_analysis.is_lvalue_fixed_storage = false;
+			}
 		} else {
 			std::ostringstream sstr;
 			sstr
@@ -11483,6 +13078,10 @@ Semantics::MIPSIO::Index Semantics::Expression::merge_lvalue_source_analysis(con
 	return merged_other_output_index;
 }
 
+Semantics::ValueRange Semantics::Expression::get_value_range() const {
+	return instructions.get_value_ranges().at(output_index);
+}
+
 Semantics::Expression Semantics::analyze_expression(uint64_t expression, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, const IdentifierScope &var_scope, const IdentifierScope &combined_scope, const IdentifierScope &storage_scope, RoutineBlockState &routine_block_state) {
 	return analyze_expression(grammar.expression_storage.at(expression), constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
 }
@@ -12334,8 +13933,19 @@ Semantics::Expression Semantics::analyze_expression(const ::Expression &expressi
 				}
 
 				// Apply division depending on the integer type.
+				//
+				// If the dividend can't be negative and the divisor is a
+				// constant power of 2, shift instead.
 				expression_semantics.output_type = left.output_type;
+				const ConstantValue           right_constant_value = is_expression_constant(expression1, constant_scope, var_scope);
+				const std::optional<uint32_t> divisor_power        = optimize && right_constant_value.is_static() && left.get_value_range().is_nonnegative() ? ValueRange(right_constant_value).get_power_of_2() : std::optional<uint32_t>();
 				const Index left_index   = expression_semantics.merge(left);
+				if (divisor_power) {
+					const Index load_power_index = expression_semantics.instructions.add_instruction({I::LoadImmediate(B(), left_type.is_word(), ConstantValue(static_cast<int32_t>(*divisor_power), 0, 0))});
+					const Index shift_index      = expression_semantics.instructions.add_instruction({I::DivFrom(B(), left_type.is_word(), true, false, true)}, {left_index, load_power_index});
+					expression_semantics.output_index = shift_index;
+					break;
+				}
 				const Index right_index  = expression_semantics.merge(right);
 				//const Index div_index    = expression_semantics.instructions.add_instruction({I::DivFrom(B(), left_type.is_word())}, {left_index, right_index});
 				//const Index ignore_index = expression_semantics.instructions.add_instruction_indexed({I::Ignore(B())}, {{div_index, 1}}, div_index); (void) ignore_index;
@@ -12409,8 +14019,19 @@ Semantics::Expression Semantics::analyze_expression(const ::Expression &expressi
 				}
 
 				// Apply mod depending on the integer type.
+				//
+				// If the dividend can't be negative and the divisor is a
+				// constant power of 2, mask instead.
 				expression_semantics.output_type = left.output_type;
+				const ConstantValue           right_constant_value = is_expression_constant(expression1, constant_scope, var_scope);
+				const std::optional<uint32_t> divisor_power        = optimize && right_constant_value.is_static() && left.get_value_range().is_nonnegative() ? ValueRange(right_constant_value).get_power_of_2() : std::optional<uint32_t>();
 				const Index left_index      = expression_semantics.merge(left);
+				if (divisor_power) {
+					const Index load_mask_index = expression_semantics.instructions.add_instruction({I::LoadImmediate(B(), left_type.is_word(), ConstantValue(static_cast<int32_t>((static_cast<uint32_t>(1) << *divisor_power) - 1), 0, 0))});
+					const Index mask_index      = expression_semantics.instructions.add_instruction({I::DivFrom(B(), left_type.is_word(), false, true, true)}, {left_index, load_mask_index});
+					expression_semantics.output_index = mask_index;
+					break;
+				}
 				const Index right_index     = expression_semantics.merge(right);
 				//const Index div_index       = expression_semantics.instructions.add_instruction({I::DivFrom(B(), left_type.is_word())}, {left_index, right_index});
 				//const Index ignore_index    = expression_semantics.instructions.add_instruction_indexed({I::Ignore(B())}, {{div_index, 0}}, div_index); (void) ignore_index;
@@ -12559,6 +14180,16 @@ Semantics::Expression Semantics::analyze_expression(const ::Expression &expressi
 				expression_semantics.lexeme_begin = call.identifier;
 				expression_semantics.lexeme_end   = call.rightparenthesis_operator0 + 1;
 
+				// Has the statement already computed this readonly call?
+				if (optimize && !routine_block_state.cached_calls.empty() && routine_block_state.cached_calls.find(get_call_key(call.identifier).first) != routine_block_state.cached_calls.cend()) {
+					const Storage   &call_result_storage    = routine_block_state.call_result_storages.at(get_call_key(call.identifier).first);
+					const TypeIndex  call_output_type_index = *routine_scope.get(call_identifier.text).get_routine_declaration().output;
+					const bool       is_word                = storage_scope.resolve_type(call_output_type_index).get_primitive().is_word();
+					expression_semantics.output_type  = call_output_type_index;
+					expression_semantics.output_index = expression_semantics.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, false, true, Storage(), call_result_storage)});
+					break;
+				}
+
 				// Analyze the call.
 				std::pair<Block, std::optional<std::pair<Index, TypeIndex>>> call_analysis = analyze_call(call_identifier, expression_sequence_opt, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
 				const Block &call_block                = call_analysis.first;
@@ -12838,7 +14469,7 @@ Semantics::Expression Semantics::analyze_expression(const ::Expression &expressi
 
 				// An lvalue in an expression corresponds a read / a LoadFrom.
 
-				LvalueSourceAnalysis lvalue_source_analysis = analyze_lvalue_source(lvalue_symbol, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state, false);
+				LvalueSourceAnalysis lvalue_source_analysis = analyze_lvalue_source(lvalue_symbol, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state, false, true);
 				expression_semantics.output_type  = lvalue_source_analysis.lvalue_type;
 				expression_semantics.lexeme_begin = lvalue_source_analysis.lexeme_begin;
 				expression_semantics.lexeme_end   = lvalue_source_analysis.lexeme_end;
@@ -12851,10 +14482,23 @@ Semantics::Expression Semantics::analyze_expression(const ::Expression &expressi
 					expression_semantics.output_index = expression_semantics.instructions.add_instruction({I::LoadImmediate(B(), lvalue_source_analysis.constant_value.get_static_primitive_type().is_word(), lvalue_source_analysis.constant_value)});
 				} else if (lvalue_source_analysis.is_lvalue_fixed_storage) {
 					const Index lvalue_source_analysis_index = expression_semantics.merge_lvalue_source_analysis(lvalue_source_analysis);
+
+					// Is this the iterator of a for loop whose body doesn't change it,
+					// or an index that an earlier bounds check passed?
+					B load_base;
+					const std::map<std::string, ValueRange>::const_iterator iterator_ranges_search = routine_block_state.iterator_ranges.find(lexeme_identifier.text);
+					if (iterator_ranges_search != routine_block_state.iterator_ranges.cend()) {
+						load_base.known_range = iterator_ranges_search->second;
+					}
+					const std::map<std::string, ValueRange>::const_iterator checked_ranges_search = routine_block_state.checked_ranges.find(lexeme_identifier.text);
+					if (checked_ranges_search != routine_block_state.checked_ranges.cend()) {
+						load_base.known_range = load_base.known_range.meet(checked_ranges_search->second);
+					}
+
 					if (!lvalue_source_analysis.is_lvalue_primref) {
 						// No accessors or instructions; just load from the storage.
 						const bool is_word = storage_scope.type(lvalue_source_analysis.lvalue_type).resolve_type(storage_scope).get_primitive().is_word();
-						const Index load_lvalue_index = expression_semantics.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, false, true, Storage(), lvalue_source_analysis.lvalue_fixed_storage)}, {}, {lvalue_source_analysis_index});
+						const Index load_lvalue_index = expression_semantics.instructions.add_instruction({I::LoadFrom(load_base, is_word, is_word, 0, false, true, Storage(), lvalue_source_analysis.lvalue_fixed_storage)}, {}, {lvalue_source_analysis_index});
 						expression_semantics.output_index = load_lvalue_index;
 					} else {
 						// No accessors or instructions, but it's a reference
@@ -12862,7 +14506,7 @@ Semantics::Expression Semantics::analyze_expression(const ::Expression &expressi
 						// and then dereference it.
 						const bool is_resolved_word = storage_scope.type(lvalue_source_analysis.lvalue_type).resolve_type(storage_scope).get_primitive().is_word();
 						const Index load_lvalue_index = expression_semantics.instructions.add_instruction({I::LoadFrom(B(), true, true, 0, false, true, Storage(), lvalue_source_analysis.lvalue_fixed_storage)});
-						const Index dereference_address_index = expression_semantics.instructions.add_instruction(I::LoadFrom({B(), is_resolved_word, false, 0, false, false, Storage(), Storage(), false, true}), {load_lvalue_index}, {lvalue_source_analysis_index});
+						const Index dereference_address_index = expression_semantics.instructions.add_instruction(I::LoadFrom({load_base, is_resolved_word, false, 0, false, false, Storage(), Storage(), false, true}), {load_lvalue_index}, {lvalue_source_analysis_index});
 						expression_semantics.output_index = dereference_address_index;
 					}
 				} else {
@@ -12874,9 +14518,9 @@ Semantics::Expression Semantics::analyze_expression(const ::Expression &expressi
 						// It's an array or record; output the address.
 						expression_semantics.output_index = load_address_index;
 					} else {
-						// It's a primitive.  Dereference.
+						// It's a primitive.  Dereference, applying any folded constant offset.
 						const bool is_word = storage_scope.type(lvalue_source_analysis.lvalue_type).resolve_type(storage_scope).get_primitive().is_word();
-						const Index dereference_address_index = expression_semantics.instructions.add_instruction(I::LoadFrom({B(), is_word, is_word, 0, false, false, Storage(), Storage(), false, true}), {load_address_index});
+						const Index dereference_address_index = expression_semantics.instructions.add_instruction(I::LoadFrom({B(), is_word, is_word, 0, false, false, Storage(), Storage(), false, true, false, 0, lvalue_source_analysis.lvalue_dereference_offset}), {load_address_index});
 						expression_semantics.output_index = dereference_address_index;
 					}
 				}
@@ -13333,9 +14977,9 @@ std::pair<Semantics::Block, std::optional<std::pair<Semantics::MIPSIO::Index, Se
 
 			// Manually put in our while loop.
 			// Analyze the "while" block condition.  Don't merge it yet.
-			const Symbol     while_symbol      = Symbol(labelify(routine_identifier.text, "memmove_while")     + "_arg_" + std::to_string(argument_expression_index + 1), "", expression_sequence_opt_index);
-			const Symbol     checkwhile_symbol = Symbol(labelify(routine_identifier.text, "memmove_checkwhile")+ "_arg_" + std::to_string(argument_expression_index + 1), "", expression_sequence_opt_index);
-			const Symbol     endwhile_symbol   = Symbol(labelify(routine_identifier.text, "memmove_endwhile")  + "_arg_" + std::to_string(argument_expression_index + 1), "", expression_sequence_opt_index);
+			const Symbol     while_symbol      = Symbol(labelify(routine_identifier.text, "memmove_while")     + "_arg_" + std::to_string(argument_expression_index + 1), routine_block_state.label_suffix, expression_sequence_opt_index);
+			const Symbol     checkwhile_symbol = Symbol(labelify(routine_identifier.text, "memmove_checkwhile")+ "_arg_" + std::to_string(argument_expression_index + 1), routine_block_state.label_suffix, expression_sequence_opt_index);
+			const Symbol     endwhile_symbol   = Symbol(labelify(routine_identifier.text, "memmove_endwhile")  + "_arg_" + std::to_string(argument_expression_index + 1), routine_block_state.label_suffix, expression_sequence_opt_index);
 
 			// First, jump to "checkwhile" to check the condition for the first time.
 			block.back = block.instructions.add_instruction({I::Jump(B(), checkwhile_symbol)}, {}, {block.back});
@@ -13604,8 +15248,60 @@ std::pair<Semantics::Block, std::optional<std::pair<Semantics::MIPSIO::Index, Se
 		}
 	}
 
+	// Find out which copy of the routine to call.  When optimizing, the
+	// first pass records the constant arguments of each call site, and the
+	// second pass calls the specialization that bakes in the most of them.
+	Symbol callee_location = callee_routine_declaration.location;
+	if (optimize) {
+		std::vector<ConstantValue> call_arguments;
+		for (const ::Expression * const &expression : std::as_const(expressions)) {
+			call_arguments.push_back(is_expression_constant(*expression, constant_scope, var_scope));
+		}
+
+		if (collect_call_sites) {
+			// An argument that just passes a parameter of a recursive routine
+			// back to itself unchanged is recorded as a passthrough.
+			std::vector<std::optional<ConstantValue>> call_site_arguments;
+			for (const ::Expression * const &expression : std::as_const(expressions)) {
+				const std::vector<const ::Expression *>::size_type expression_index = &expression - &expressions[0];
+
+				bool is_passthrough = false;
+				if (callee_routine_declaration.location == routine_block_state.routine_location && expression_index < routine_block_state.parameter_identifiers.size() && expression->branch == ::Expression::lvalue_branch) {
+					const ::Expression::Lvalue     &expression_lvalue           = grammar.expression_lvalue_storage.at(expression->data);
+					const Lvalue                   &lvalue                      = grammar.lvalue_storage.at(expression_lvalue.lvalue);
+					const LexemeIdentifier         &lexeme_identifier           = grammar.lexemes.at(lvalue.identifier).get_identifier();
+					const LvalueAccessorClauseList &lvalue_accessor_clause_list = grammar.lvalue_accessor_clause_list_storage.at(lvalue.lvalue_accessor_clause_list);
+					is_passthrough = lvalue_accessor_clause_list.branch == LvalueAccessorClauseList::empty_branch && lexeme_identifier.text == routine_block_state.parameter_identifiers[expression_index];
+				}
+
+				if (is_passthrough) {
+					call_site_arguments.push_back(std::nullopt);
+				} else {
+					call_site_arguments.push_back(call_arguments[expression_index]);
+				}
+			}
+
+			// Weigh the call site by how often it runs.
+			uint64_t weight = 1;
+			if (argument_expressions.size() > 0 && argument_expressions[0].lexeme_begin < lexeme_weights.size()) {
+				weight = lexeme_weights[argument_expressions[0].lexeme_begin];
+			}
+
+			call_sites[callee_routine_declaration.location].push_back({call_site_arguments, weight});
+		} else if (routine_specializations.count(callee_routine_declaration.location) > 0) {
+			// The original routine comes first, and every call site matches it.
+			std::optional<uint64_t> most_constants;
+			for (const RoutineSpecialization &specialization : std::as_const(routine_specializations.at(callee_routine_declaration.location))) {
+				if (specialization.matches(call_arguments) && (!most_constants.has_value() || specialization.count_constants() > *most_constants)) {
+					callee_location = specialization.location;
+					most_constants  = specialization.count_constants();
+				}
+			}
+		}
+	}
+
 	// Call the function.
-	const Index call_index = block.back = block.instructions.add_instruction({I::Call(B(), callee_routine_declaration.location)}, {}, block.back);
+	const Index call_index = block.back = block.instructions.add_instruction({I::Call(B(), callee_location)}, {}, block.back);
 
 	// Now we can reverse what we pushed.
 
@@ -13696,10 +15392,168 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 		block.front = block.back = block.instructions.add_instruction({I::Ignore(B(), false, false)});
 	}
 
+	// The end of an expression that ends a statement.
+	const auto get_expression_end = [this](uint64_t lexeme_index) -> uint64_t {
+		int64_t depth = 0;
+		for (; lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+			const Lexeme &lexeme = grammar.lexemes.at(lexeme_index);
+			if (lexeme.is_operator() && (lexeme.get_operator().operator_ == leftparenthesis_operator || lexeme.get_operator().operator_ == leftbracket_operator)) {
+				++depth;
+			} else if (lexeme.is_operator() && (lexeme.get_operator().operator_ == rightparenthesis_operator || lexeme.get_operator().operator_ == rightbracket_operator)) {
+				--depth;
+			} else if (depth <= 0 && lexeme.is_operator() && lexeme.get_operator().operator_ == semicolon_operator) {
+				break;
+			} else if (depth <= 0 && lexeme.is_keyword() && (lexeme.get_keyword().keyword == end_keyword || lexeme.get_keyword().keyword == else_keyword || lexeme.get_keyword().keyword == elseif_keyword || lexeme.get_keyword().keyword == until_keyword)) {
+				break;
+			}
+		}
+		return lexeme_index;
+	};
+
+	// With bounds_check, forget what earlier checks showed of the variables
+	// that the lexemes, if known, may change, directly or, for globals and
+	// ref parameters, through a ref parameter.
+	const bool track_checked_ranges = bounds_check && optimize;
+	const auto forget_checked_ranges = [this, &routine_scope, &routine_block_state](std::map<std::string, ValueRange> &checked_ranges, const std::optional<std::pair<uint64_t, uint64_t>> &lexemes) -> void {
+		for (std::map<std::string, ValueRange>::iterator checked_range = checked_ranges.begin(); checked_range != checked_ranges.end(); ) {
+			const bool is_local = routine_block_state.local_identifiers.find(checked_range->first) != routine_block_state.local_identifiers.cend();
+			if (!lexemes.has_value() || may_modify_variable(lexemes->first, lexemes->second, checked_range->first, !is_local, routine_scope) || (!is_local && may_modify_variable_alias(lexemes->first, lexemes->second, checked_range->first, routine_scope, routine_block_state))) {
+				checked_range = checked_ranges.erase(checked_range);
+			} else {
+				++checked_range;
+			}
+		}
+	};
+	const auto add_checked_ranges = [](std::map<std::string, ValueRange> &checked_ranges, const std::map<std::string, ValueRange> &other) -> void {
+		for (const std::pair<const std::string, ValueRange> &checked_range : std::as_const(other)) {
+			const std::map<std::string, ValueRange>::iterator checked_ranges_search = checked_ranges.find(checked_range.first);
+			if (checked_ranges_search == checked_ranges.end()) {
+				checked_ranges.insert(checked_range);
+			} else {
+				checked_ranges_search->second = checked_ranges_search->second.meet(checked_range.second);
+			}
+		}
+	};
+
+	// The checks pending in the enclosing statement, e.g. in an "if"
+	// condition, run before these statements, so they hold here for the
+	// variables that the enclosing statement doesn't change.
+	const std::map<std::string, ValueRange>            outer_checked_ranges         = routine_block_state.checked_ranges;
+	const std::map<std::string, ValueRange>            outer_pending_checked_ranges = routine_block_state.pending_checked_ranges;
+	const std::optional<std::pair<uint64_t, uint64_t>> outer_statement_lexemes      = routine_block_state.statement_lexemes;
+	if (track_checked_ranges) {
+		forget_checked_ranges(routine_block_state.pending_checked_ranges, routine_block_state.statement_lexemes);
+		add_checked_ranges(routine_block_state.checked_ranges, routine_block_state.pending_checked_ranges);
+		routine_block_state.pending_checked_ranges.clear();
+	}
+
 	// Handle each statement.
 	for (const uint64_t &statement_index : std::as_const(statements)) {
 		const Statement &statement = grammar.statement_storage.at(statement_index);
 
+		// Forget what earlier checks showed of the variables the statement
+		// may change.
+		if (track_checked_ranges) {
+			std::optional<std::pair<uint64_t, uint64_t>> statement_lexemes;
+			switch (statement.branch) {
+				case Statement::assignment_branch: {
+					const Assignment &assignment = grammar.assignment_storage.at(grammar.statement_assignment_storage.at(statement.data).assignment);
+					statement_lexemes = {grammar.lvalue_storage.at(assignment.lvalue).identifier, get_expression_end(assignment.colonequals_operator0)};
+					break;
+				} case Statement::if_branch: {
+					const IfStatement &if_statement = grammar.if_statement_storage.at(grammar.statement_if_storage.at(statement.data).if_statement);
+					statement_lexemes = {if_statement.if_keyword0, if_statement.end_keyword0 + 1};
+					break;
+				} case Statement::while_branch: {
+					const WhileStatement &while_statement = grammar.while_statement_storage.at(grammar.statement_while_storage.at(statement.data).while_statement);
+					statement_lexemes = {while_statement.while_keyword0, while_statement.end_keyword0 + 1};
+					break;
+				} case Statement::repeat_branch: {
+					const RepeatStatement &repeat_statement = grammar.repeat_statement_storage.at(grammar.statement_repeat_storage.at(statement.data).repeat_statement);
+					statement_lexemes = {repeat_statement.repeat_keyword0, get_expression_end(repeat_statement.until_keyword0 + 1)};
+					break;
+				} case Statement::for_branch: {
+					const ForStatement &for_statement = grammar.for_statement_storage.at(grammar.statement_for_storage.at(statement.data).for_statement);
+					statement_lexemes = {for_statement.for_keyword0, for_statement.end_keyword0 + 1};
+					break;
+				} case Statement::return_branch: {
+					const ReturnStatement &return_statement = grammar.return_statement_storage.at(grammar.statement_return_storage.at(statement.data).return_statement);
+					statement_lexemes = {return_statement.return_keyword0, get_expression_end(return_statement.return_keyword0 + 1)};
+					break;
+				} case Statement::read_branch: {
+					const ReadStatement &read_statement = grammar.read_statement_storage.at(grammar.statement_read_storage.at(statement.data).read_statement);
+					statement_lexemes = {read_statement.read_keyword0, read_statement.rightparenthesis_operator0 + 1};
+					break;
+				} case Statement::write_branch: {
+					const WriteStatement &write_statement = grammar.write_statement_storage.at(grammar.statement_write_storage.at(statement.data).write_statement);
+					statement_lexemes = {write_statement.write_keyword0, write_statement.rightparenthesis_operator0 + 1};
+					break;
+				} case Statement::call_branch: {
+					const ProcedureCall &procedure_call = grammar.procedure_call_storage.at(grammar.statement_call_storage.at(statement.data).procedure_call);
+					statement_lexemes = {procedure_call.identifier, procedure_call.rightparenthesis_operator0 + 1};
+					break;
+				} default: {
+					break;
+				}
+			}
+			routine_block_state.statement_lexemes = statement_lexemes;
+			forget_checked_ranges(routine_block_state.checked_ranges, statement_lexemes);
+			routine_block_state.pending_checked_ranges.clear();
+		}
+
+		// Compute readonly calls that the statement would repeat, or that a
+		// while condition would repeat on each iteration, once up front.
+		std::vector<std::string> cached_calls;
+		if (optimize && !routine_block_state.call_result_storages.empty()) {
+			// {head begin, head end, statement begin, statement end, is_loop}
+			std::optional<std::tuple<uint64_t, uint64_t, uint64_t, uint64_t, bool>> head;
+			switch (statement.branch) {
+				case Statement::assignment_branch: {
+					// The store follows both calls, so skip the assigned variable.
+					const Assignment &assignment = grammar.assignment_storage.at(grammar.statement_assignment_storage.at(statement.data).assignment);
+					const uint64_t    begin      = grammar.lvalue_storage.at(assignment.lvalue).identifier;
+					const uint64_t    end        = get_expression_end(assignment.colonequals_operator0);
+					head = {{begin, end, begin + 1, end, false}};
+					break;
+				} case Statement::if_branch: {
+					const IfStatement &if_statement = grammar.if_statement_storage.at(grammar.statement_if_storage.at(statement.data).if_statement);
+					head = {{if_statement.if_keyword0, if_statement.then_keyword0, if_statement.if_keyword0, if_statement.end_keyword0 + 1, false}};
+					break;
+				} case Statement::while_branch: {
+					const WhileStatement &while_statement = grammar.while_statement_storage.at(grammar.statement_while_storage.at(statement.data).while_statement);
+					head = {{while_statement.while_keyword0, while_statement.do_keyword0, while_statement.while_keyword0, while_statement.end_keyword0 + 1, true}};
+					break;
+				} case Statement::for_branch: {
+					const ForStatement &for_statement = grammar.for_statement_storage.at(grammar.statement_for_storage.at(statement.data).for_statement);
+					head = {{for_statement.for_keyword0, for_statement.do_keyword0, for_statement.for_keyword0, for_statement.end_keyword0 + 1, false}};
+					break;
+				} case Statement::return_branch: {
+					const ReturnStatement &return_statement = grammar.return_statement_storage.at(grammar.statement_return_storage.at(statement.data).return_statement);
+					const uint64_t         end              = get_expression_end(return_statement.return_keyword0 + 1);
+					head = {{return_statement.return_keyword0, end, return_statement.return_keyword0, end, false}};
+					break;
+				} case Statement::write_branch: {
+					const WriteStatement &write_statement = grammar.write_statement_storage.at(grammar.statement_write_storage.at(statement.data).write_statement);
+					head = {{write_statement.write_keyword0, write_statement.rightparenthesis_operator0 + 1, write_statement.write_keyword0, write_statement.rightparenthesis_operator0 + 1, false}};
+					break;
+				} case Statement::call_branch: {
+					const ProcedureCall &procedure_call = grammar.procedure_call_storage.at(grammar.statement_call_storage.at(statement.data).procedure_call);
+					head = {{procedure_call.identifier, procedure_call.rightparenthesis_operator0 + 1, procedure_call.identifier, procedure_call.rightparenthesis_operator0 + 1, false}};
+					break;
+				} default: {
+					break;
+				}
+			}
+
+			if (head.has_value()) {
+				const bool was_empty = block.instructions.instructions.size() <= 1;
+				cached_calls = cache_readonly_calls(block, std::get<0>(*head), std::get<1>(*head), std::get<2>(*head), std::get<3>(*head), std::get<4>(*head), constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
+				if (was_empty && !cached_calls.empty()) {
+					block.lexeme_begin = std::get<0>(*head);
+				}
+			}
+		}
+
 		switch (statement.branch) {
 			case Statement::assignment_branch: {
 				const Statement::Assignment &statement_assignment  = grammar.statement_assignment_storage.at(statement.data);
@@ -13716,7 +15570,7 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 				const std::string lexeme_identifier_text = grammar.lexemes.at(lvalue.identifier).get_identifier().text;
 
 				// Lookup the lvalue.
-				LvalueSourceAnalysis lvalue_source_analysis = analyze_lvalue_source(lvalue, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
+				LvalueSourceAnalysis lvalue_source_analysis = analyze_lvalue_source(lvalue, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state, true, true);
 
 				// Merge the lvalue lookup instructions if there was not a fixed storage found.
 				Index lvalue_index;
@@ -13752,7 +15606,7 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 					if (!lvalue_source_analysis.is_lvalue_fixed_storage) {
 						// We're writing a primitive value inside an array or record.
 						const bool is_word = storage_scope.type(value.output_type).resolve_type(storage_scope).get_primitive().is_word();
-						block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, false, false, Storage(), Storage(), false, false, true)}, {value_index, lvalue_index}, {block.back});
+						block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, false, false, Storage(), Storage(), false, false, true, lvalue_source_analysis.lvalue_dereference_offset)}, {value_index, lvalue_index}, {block.back});
 					} else {
 						// It's a primitive.  Write to it directly if it isn't a pointer; otherwise, dereference it (check is_lvalue_primref).
 						block.back = block.instructions.add_instruction({I::LoadFrom(B(), lvalue_source_analysis.lvalue_fixed_storage.max_size == 4, storage_scope.type(value.output_type).resolve_type(storage_scope).get_primitive().is_word(), 0, true, false, lvalue_source_analysis.lvalue_fixed_storage, Storage(), lvalue_source_analysis.is_lvalue_primref, false)}, {value_index}, {block.back});
@@ -13785,9 +15639,9 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 
 					// Manually put in our while loop.
 					// Analyze the "while" block condition.  Don't merge it yet.
-					const Symbol     while_symbol      = Symbol(labelify(lexeme_identifier_text, "memmove_while"),      "", assignment.lvalue);
-					const Symbol     checkwhile_symbol = Symbol(labelify(lexeme_identifier_text, "memmove_checkwhile"), "", assignment.lvalue);
-					const Symbol     endwhile_symbol   = Symbol(labelify(lexeme_identifier_text, "memmove_endwhile"),   "", assignment.lvalue);
+					const Symbol     while_symbol      = Symbol(labelify(lexeme_identifier_text, "memmove_while"),      routine_block_state.label_suffix, assignment.lvalue);
+					const Symbol     checkwhile_symbol = Symbol(labelify(lexeme_identifier_text, "memmove_checkwhile"), routine_block_state.label_suffix, assignment.lvalue);
+					const Symbol     endwhile_symbol   = Symbol(labelify(lexeme_identifier_text, "memmove_endwhile"),   routine_block_state.label_suffix, assignment.lvalue);
 
 					// First, jump to "checkwhile" to check the condition for the first time.
 					block.back = block.instructions.add_instruction({I::Jump(B(), checkwhile_symbol)}, {}, {block.back});
@@ -13901,8 +15755,8 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 
 				// Analyze the "if" block condition.  Don't merge it yet.
 				const Expression if_condition = analyze_expression(if_expression0, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
-				const Symbol     if_symbol    = Symbol(labelify(grammar.lexemes_text(if_condition.lexeme_begin, if_condition.lexeme_end), "if"), "", if_statement.then_keyword0);
-				const Symbol     endif_symbol = Symbol(labelify(grammar.lexemes_text(if_condition.lexeme_begin, if_condition.lexeme_end), "endif"), "", if_statement.end_keyword0);
+				const Symbol     if_symbol    = Symbol(labelify(grammar.lexemes_text(if_condition.lexeme_begin, if_condition.lexeme_end), "if"), routine_block_state.label_suffix, if_statement.then_keyword0);
+				const Symbol     endif_symbol = Symbol(labelify(grammar.lexemes_text(if_condition.lexeme_begin, if_condition.lexeme_end), "endif"), routine_block_state.label_suffix, if_statement.end_keyword0);
 
 				// Require the "if" block condition type to be a boolean.
 				if (!storage_scope.resolve_type(if_condition.output_type).matches(type_scope.type("boolean"), storage_scope)) {
@@ -13917,6 +15771,115 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 					throw SemanticsError(sstr.str());
 				}
 
+				// If every condition up to the first that is always true is
+				// always false, e.g. tests of a constant parameter in a
+				// specialized routine, only one arm can run: emit just it.
+				// folded_arm is the index of that arm, with the "else" arm
+				// (or nothing) after the "elseif" arms.
+				std::optional<std::vector<const ElseifClause *>::size_type> folded_arm;
+				if (optimize) {
+					std::vector<const ::Expression *> arm_conditions {&if_expression0};
+					for (const ElseifClause *next_elseif_clause : std::as_const(elseif_clauses)) {
+						arm_conditions.push_back(&grammar.expression_storage.at(next_elseif_clause->expression));
+					}
+					for (const ::Expression * const &arm_condition : std::as_const(arm_conditions)) {
+						const ConstantValue arm_constant_value = is_expression_constant(*arm_condition, constant_scope, var_scope);
+						if (!arm_constant_value.is_static() || !arm_constant_value.is_boolean()) {
+							break;
+						} else if (arm_constant_value.get_boolean()) {
+							folded_arm = &arm_condition - &arm_conditions[0];
+							break;
+						} else if (&arm_condition - &arm_conditions[0] + 1 == static_cast<std::ptrdiff_t>(arm_conditions.size())) {
+							folded_arm = arm_conditions.size();
+						}
+					}
+				}
+
+				// If-conversion: when each arm just assigns the same primitive
+				// variable a small expression that is safe to evaluate either
+				// way, as in "if a < b then m := a; else m := b; end" or
+				// "if x < 0 then x := -x; end", evaluate both values and select
+				// one with movn instead of branching, if the architecture has it.
+				if (optimize && architecture >= mips32_architecture && elseif_clauses.empty() && !folded_arm.has_value()) {
+					// (Bounds checks in what is analyzed but then not used never run.)
+					const std::map<std::string, ValueRange> pending_checked_ranges = routine_block_state.pending_checked_ranges;
+					const Assignment *if_assignment   = get_single_assignment(if_statement_sequence);
+					const Assignment *else_assignment = nullptr;
+					bool is_convertible = if_assignment != nullptr;
+
+					// The "if" arm must assign a variable without accessors.
+					if (is_convertible) {
+						const Lvalue &if_lvalue = grammar.lvalue_storage.at(if_assignment->lvalue);
+						is_convertible = grammar.lvalue_accessor_clause_list_storage.at(if_lvalue.lvalue_accessor_clause_list).branch == LvalueAccessorClauseList::empty_branch;
+					}
+
+					// The "else" arm, if any, must assign the same variable, also
+					// without accessors, so that analyzing the "if" arm's lvalue
+					// below checks both.  Anything else takes the branching path,
+					// which analyzes each arm on its own.
+					if (is_convertible && else_clause_opt.branch == ElseClauseOpt::value_branch) {
+						const ElseClauseOpt::Value &else_clause_opt_value = grammar.else_clause_opt_value_storage.at(else_clause_opt.data);
+						const ElseClause           &else_clause           = grammar.else_clause_storage.at(else_clause_opt_value.else_clause);
+						else_assignment = get_single_assignment(grammar.statement_sequence_storage.at(else_clause.statement_sequence));
+						if (else_assignment != nullptr) {
+							const Lvalue &if_lvalue   = grammar.lvalue_storage.at(if_assignment->lvalue);
+							const Lvalue &else_lvalue = grammar.lvalue_storage.at(else_assignment->lvalue);
+							is_convertible =
+								   grammar.lvalue_accessor_clause_list_storage.at(else_lvalue.lvalue_accessor_clause_list).branch == LvalueAccessorClauseList::empty_branch
+								&& grammar.lexemes.at(else_lvalue.identifier).get_identifier().text == grammar.lexemes.at(if_lvalue.identifier).get_identifier().text
+								;
+						} else {
+							is_convertible = false;
+						}
+					}
+
+					// The variable must be a primitive.
+					LvalueSourceAnalysis lvalue_source_analysis;
+					if (is_convertible) {
+						lvalue_source_analysis = analyze_lvalue_source(grammar.lvalue_storage.at(if_assignment->lvalue), constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state, true, true);
+						is_convertible = lvalue_source_analysis.is_lvalue_fixed_storage && !lvalue_source_analysis.is_lvalue_primref;
+					}
+
+					// Analyze the values assigned.
+					std::vector<Expression> arm_values;
+					for (const Assignment *arm_assignment : {if_assignment, else_assignment}) {
+						if (!is_convertible || arm_assignment == nullptr) {
+							continue;
+						}
+						const Expression arm_value = analyze_expression(arm_assignment->expression, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
+						is_convertible =
+							   storage_scope.type(arm_value.output_type).resolve_type(storage_scope).matches(storage_scope.type(lvalue_source_analysis.lvalue_type).resolve_type(storage_scope), storage_scope)
+							&& storage_scope.type(arm_value.output_type).resolve_type(storage_scope).is_primitive()
+							&& arm_value.instructions.instructions.size() <= max_if_conversion_arm_size
+							&& is_speculatable_expression(arm_value.lexeme_begin, arm_value.lexeme_end, routine_scope)
+							;
+						arm_values.push_back(arm_value);
+					}
+
+					if (is_convertible) {
+						const bool is_word = storage_scope.type(lvalue_source_analysis.lvalue_type).resolve_type(storage_scope).get_primitive().is_word();
+
+						// Condition, then the value of each arm.  Without an
+						// "else", the variable keeps its current value.
+						const Index if_condition_index = block.merge_expression(if_condition);
+						const Index true_value_index   = block.merge_expression(arm_values[0]);
+						Index false_value_index;
+						if (arm_values.size() >= 2) {
+							false_value_index = block.merge_expression(arm_values[1]);
+						} else {
+							false_value_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, false, true, Storage(), lvalue_source_analysis.lvalue_fixed_storage)}, {}, {block.back});
+						}
+
+						// Select and write the result.
+						const Index select_index = block.back = block.instructions.add_instruction({I::Select(B(), is_word)}, {if_condition_index, true_value_index, false_value_index}, {block.back});
+						block.back = block.instructions.add_instruction({I::LoadFrom(B(), lvalue_source_analysis.lvalue_fixed_storage.max_size == 4, is_word, 0, true, false, lvalue_source_analysis.lvalue_fixed_storage, Storage())}, {select_index}, {block.back});
+
+						// We're done.
+						break;
+					}
+					routine_block_state.pending_checked_ranges = pending_checked_ranges;
+				}
+
 				// Analyze the "if" block.
 				const Block      if_block     = analyze_statements(routine_declaration, if_statement_sequence, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, cleanup_symbol, routine_block_state);
 
@@ -13934,7 +15897,7 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 
 					// Analyze the "elseif" block condition.
 					const Expression elseif_condition = analyze_expression(elseif_expression0, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
-					const Symbol     elseif_symbol    = Symbol(labelify(grammar.lexemes_text(elseif_condition.lexeme_begin, elseif_condition.lexeme_end), "elseif"), "", next_elseif_clause->then_keyword0);
+					const Symbol     elseif_symbol    = Symbol(labelify(grammar.lexemes_text(elseif_condition.lexeme_begin, elseif_condition.lexeme_end), "elseif"), routine_block_state.label_suffix, next_elseif_clause->then_keyword0);
 
 					// Require the "elseif" block condition type to be a boolean.
 					if (!storage_scope.resolve_type(elseif_condition.output_type).matches(type_scope.type("boolean"), storage_scope)) {
@@ -13977,7 +15940,7 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 						const StatementSequence    &else_statement_sequence = grammar.statement_sequence_storage.at(else_clause.statement_sequence);
 
 						// Set the else symbol.
-						else_symbol= Symbol(labelify(grammar.lexemes_text(if_condition.lexeme_begin, if_condition.lexeme_end), "else"), "", else_clause.else_keyword0);
+						else_symbol= Symbol(labelify(grammar.lexemes_text(if_condition.lexeme_begin, if_condition.lexeme_end), "else"), routine_block_state.label_suffix, else_clause.else_keyword0);
 
 						// Analyze the "else" block.
 						else_block = analyze_statements(routine_declaration, else_statement_sequence, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, cleanup_symbol, routine_block_state);
@@ -13992,6 +15955,18 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 					}
 				}
 
+				// Only one arm can run?
+				if (folded_arm.has_value()) {
+					if (*folded_arm == 0) {
+						const Index if_block_index = block.merge_append(if_block); (void) if_block_index;
+					} else if (*folded_arm <= elseif_blocks.size()) {
+						const Index elseif_block_index = block.merge_append(elseif_blocks[*folded_arm - 1]); (void) elseif_block_index;
+					} else if (has_else) {
+						const Index else_block_index = block.merge_append(else_block); (void) else_block_index;
+					}
+					break;
+				}
+
 				// First, output the "if" clause.
 
 				// "if" label.  (Redundant and unused, but may aid in readability.)
@@ -14061,13 +16036,16 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 
 				// There are a few ways to do this.
 				//
-				// At the end of the block, branch back to the beginning of the block if the condition is met.
+				// The loop is rotated: check the condition once before the loop,
+				// skipping it if the condition is false, and then at the end of
+				// the block, branch back to the beginning of the block if the
+				// condition is met.  Each iteration then runs one branch.
 
 				// Analyze the "while" block condition.  Don't merge it yet.
 				const Expression while_condition   = analyze_expression(while_expression0, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
-				const Symbol     while_symbol      = Symbol(labelify(grammar.lexemes_text(while_condition.lexeme_begin, while_condition.lexeme_end), "while"), "", while_statement.do_keyword0);
-				const Symbol     checkwhile_symbol = Symbol(labelify(grammar.lexemes_text(while_condition.lexeme_begin, while_condition.lexeme_end), "checkwhile"), "", while_statement.end_keyword0);
-				const Symbol     endwhile_symbol   = Symbol(labelify(grammar.lexemes_text(while_condition.lexeme_begin, while_condition.lexeme_end), "endwhile"), "", while_statement.end_keyword0);
+				const Symbol     while_symbol      = Symbol(labelify(grammar.lexemes_text(while_condition.lexeme_begin, while_condition.lexeme_end), "while"), routine_block_state.label_suffix, while_statement.do_keyword0);
+				const Symbol     checkwhile_symbol = Symbol(labelify(grammar.lexemes_text(while_condition.lexeme_begin, while_condition.lexeme_end), "checkwhile"), routine_block_state.label_suffix, while_statement.end_keyword0);
+				const Symbol     endwhile_symbol   = Symbol(labelify(grammar.lexemes_text(while_condition.lexeme_begin, while_condition.lexeme_end), "endwhile"), routine_block_state.label_suffix, while_statement.end_keyword0);
 
 				// Require the "while" block condition type to be a boolean.
 				if (!storage_scope.resolve_type(while_condition.output_type).matches(type_scope.type("boolean"), storage_scope)) {
@@ -14085,8 +16063,23 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 				// Analyze the "while" block.
 				const Block while_block = analyze_statements(routine_declaration, while_statement_sequence, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, cleanup_symbol, routine_block_state);
 
-				// First, jump to "checkwhile" to check the condition for the first time.
-				block.back = block.instructions.add_instruction({I::Jump(B(), checkwhile_symbol)}, {}, {block.back});
+				// Analyze a second copy of the condition, with its own labels, to
+				// check before entering the loop, unless it's always true.
+				const ConstantValue while_constant_value = is_expression_constant(while_expression0, constant_scope, var_scope);
+				const bool          is_guarded           = !(while_constant_value.is_static() && while_constant_value.is_boolean() && while_constant_value.get_boolean());
+				Expression          guard_condition;
+				if (is_guarded) {
+					const std::string label_suffix = routine_block_state.label_suffix;
+					routine_block_state.label_suffix = label_suffix + "_guard";
+					guard_condition = analyze_expression(while_expression0, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
+					routine_block_state.label_suffix = label_suffix;
+				}
+
+				// First, skip the loop if the condition is false.
+				if (is_guarded) {
+					const Index guard_condition_index = block.merge_expression(guard_condition);
+					block.back = block.instructions.add_instruction({I::BranchZero(B(), false, endwhile_symbol)}, {guard_condition_index}, {block.back});
+				}
 
 				// "while" label.
 				block.back = block.instructions.add_instruction({I::Ignore(B(true, while_symbol), false, false)}, {}, {block.back});
@@ -14094,15 +16087,17 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 				// "while" block.
 				const Index while_block_index = block.merge_append(while_block);
 
-				// "checkwhile" label.
-				block.back = block.instructions.add_instruction({I::Ignore(B(true, checkwhile_symbol), false, false)}, {}, {block.back});
+				// "checkwhile" label.  We don't need the checkwhile label, and it is unused, but emit it anyway for readability.
+				if (emit_extra_redundant_labels) {
+					block.back = block.instructions.add_instruction({I::Ignore(B(true, checkwhile_symbol), false, false)}, {}, {block.back});
+				}
 
 				// "while" condition.  (BranchZero has the branch_non_zero flag set to true.)
 				const Index while_condition_index = block.merge_expression(while_condition);
 				block.back = block.instructions.add_instruction({I::BranchZero(B(), false, while_symbol, true)}, {while_condition_index}, {block.back});
 
-				// "endwhile label".  We don't need the endwhile label, and it is unused, but emit it anyway for readability.
-				if (emit_extra_redundant_labels) {
+				// "endwhile label".  Unless the loop is guarded, we don't need the endwhile label, and it is unused, but emit it anyway for readability.
+				if (is_guarded || emit_extra_redundant_labels) {
 					block.back = block.instructions.add_instruction({I::Ignore(B(true, endwhile_symbol), false, false)}, {}, {block.back});
 				}
 
@@ -14121,8 +16116,8 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 
 				// Analyze the "repeat" block condition.  Don't merge it yet.
 				const Expression repeat_condition   = analyze_expression(repeat_expression0, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
-				const Symbol     repeat_symbol      = Symbol(labelify(grammar.lexemes_text(repeat_condition.lexeme_begin, repeat_condition.lexeme_end), "repeat"), "", repeat_statement.repeat_keyword0);
-				const Symbol     endrepeat_symbol   = Symbol(labelify(grammar.lexemes_text(repeat_condition.lexeme_begin, repeat_condition.lexeme_end), "endrepeat"), "", repeat_statement.repeat_keyword0);
+				const Symbol     repeat_symbol      = Symbol(labelify(grammar.lexemes_text(repeat_condition.lexeme_begin, repeat_condition.lexeme_end), "repeat"), routine_block_state.label_suffix, repeat_statement.repeat_keyword0);
+				const Symbol     endrepeat_symbol   = Symbol(labelify(grammar.lexemes_text(repeat_condition.lexeme_begin, repeat_condition.lexeme_end), "endrepeat"), routine_block_state.label_suffix, repeat_statement.repeat_keyword0);
 
 				// Require the "repeat" block condition type to be a boolean.
 				if (!storage_scope.resolve_type(repeat_condition.output_type).matches(type_scope.type("boolean"), storage_scope)) {
@@ -14277,11 +16272,9 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 					}
 				}
 
-				// Analyze the first and last number expressions.  We can also merge them now.
+				// Analyze the first and last number expressions.  Don't merge them yet.
 				const Expression first_expression = analyze_expression(expression0, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
 				const Expression last_expression  = analyze_expression(expression1, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
-				const Index      first_index      = block.merge_expression(first_expression);
-				const Index      last_index       = block.merge_expression(last_expression);
 
 				if (!storage_scope.resolve_type(first_expression.output_type).is_primitive() || !storage_scope.resolve_type(first_expression.output_type).get_primitive().is_integer()) {
 					std::ostringstream sstr;
@@ -14306,16 +16299,108 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 
 				const int32_t addition = increasing ? 1 : -1;
 
-				const Index near_last_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, addition, false, false, Storage(), Storage())}, {last_index}, {block.back});
-
 				// Get the symbols.
-				const Symbol     for_symbol      = Symbol(labelify(grammar.lexemes_text(for_statement.identifier, last_expression.lexeme_end), "for"), "", for_statement.for_keyword0);
-				const Symbol     checkfor_symbol = Symbol(labelify(grammar.lexemes_text(for_statement.identifier, last_expression.lexeme_end), "checkfor"), "", for_statement.end_keyword0);
-				const Symbol     endfor_symbol   = Symbol(labelify(grammar.lexemes_text(for_statement.identifier, last_expression.lexeme_end), "endfor"), "", for_statement.end_keyword0);
+				const Symbol     for_symbol              = Symbol(labelify(grammar.lexemes_text(for_statement.identifier, last_expression.lexeme_end), "for"), routine_block_state.label_suffix, for_statement.for_keyword0);
+				const Symbol     checkfor_symbol         = Symbol(labelify(grammar.lexemes_text(for_statement.identifier, last_expression.lexeme_end), "checkfor"), routine_block_state.label_suffix, for_statement.end_keyword0);
+				const Symbol     endfor_symbol           = Symbol(labelify(grammar.lexemes_text(for_statement.identifier, last_expression.lexeme_end), "endfor"), routine_block_state.label_suffix, for_statement.end_keyword0);
+				const Symbol     unrolledfor_symbol      = Symbol(labelify(grammar.lexemes_text(for_statement.identifier, last_expression.lexeme_end), "unrolledfor"), routine_block_state.label_suffix, for_statement.for_keyword0);
+				const Symbol     endunrolledfor_symbol   = Symbol(labelify(grammar.lexemes_text(for_statement.identifier, last_expression.lexeme_end), "endunrolledfor"), routine_block_state.label_suffix, for_statement.end_keyword0);
+
+				// Only the loop itself may change the iterator variable.  Only the
+				// body's own statements can change a local variable, but any
+				// routine the body calls, or a store through a ref parameter,
+				// could also change a global or a ref parameter.
+				const bool is_local_var      = !var.is_primitive_and_ref && !var.storage.is_global && var.storage.register_ == "$sp";
+				const bool is_iterator_fixed =
+					   !may_modify_variable(for_statement.do_keyword0, for_statement.end_keyword0, identifier.text, !is_local_var, routine_scope)
+					&& (is_local_var || !may_modify_variable_alias(for_statement.do_keyword0, for_statement.end_keyword0, identifier.text, routine_scope, routine_block_state))
+					;
+
+				// If so, while the body runs, the iterator variable is between
+				// the bounds.
+				const std::map<std::string, ValueRange> outer_iterator_ranges = routine_block_state.iterator_ranges;
+				routine_block_state.iterator_ranges.erase(identifier.text);
+				if (optimize && is_iterator_fixed) {
+					const ValueRange first_range    = first_expression.get_value_range();
+					const ValueRange last_range     = last_expression.get_value_range();
+					const ValueRange iterator_range = increasing ? ValueRange(first_range.min, last_range.max) : ValueRange(last_range.min, first_range.max);
+					if (iterator_range.min <= iterator_range.max) {
+						routine_block_state.iterator_ranges.insert({identifier.text, iterator_range});
+					}
+				}
 
 				// Analyze the "for" block.
 				const Block for_block = analyze_statements(routine_declaration, statement_sequence, constant_scope, type_scope, routine_scope, for_var_scope, for_combined_scope, storage_scope, cleanup_symbol, routine_block_state);
 
+				// Decide whether to unroll the loop.
+				//
+				// If both bounds are constant and the copies of the body are
+				// small enough, unroll the loop completely.  Otherwise, if the
+				// body is small, run unroll_factor copies of it per check of the
+				// condition, and finish the remaining iterations in the normal
+				// loop.  Either costs space, so not when optimizing for size,
+				// nor, given a profile, for a loop that never ran, and only
+				// partially for one whose head ran more often than it was
+				// reached.
+				bool is_cold  = false;
+				bool is_short = false;
+				if (profile_guided && for_statement.for_keyword0 >= 1 && for_statement.for_keyword0 < lexeme_weights.size()) {
+					is_cold  = lexeme_weights[for_statement.for_keyword0] == 0;
+					is_short = lexeme_weights[for_statement.for_keyword0] <= lexeme_weights[for_statement.for_keyword0 - 1];
+				}
+				const bool          can_unroll           = optimize && !optimize_size && is_iterator_fixed && !is_cold;
+				const ConstantValue first_constant_value = is_expression_constant(expression0, constant_scope, var_scope);
+				const ConstantValue last_constant_value  = is_expression_constant(expression1, constant_scope, var_scope);
+				const bool          is_trip_count_static = first_constant_value.is_static() && first_constant_value.is_integer() && last_constant_value.is_static() && last_constant_value.is_integer();
+				const uint64_t      body_size            = std::max(static_cast<uint64_t>(for_block.instructions.instructions.size()), static_cast<uint64_t>(1));
+				int64_t trip_count = 0;
+				if (is_trip_count_static) {
+					trip_count = static_cast<int64_t>(addition) * (static_cast<int64_t>(last_constant_value.get_integer()) - static_cast<int64_t>(first_constant_value.get_integer())) + 1;
+					trip_count = std::max(trip_count, static_cast<int64_t>(0));
+				}
+				const bool full_unroll    = can_unroll && is_trip_count_static && static_cast<uint64_t>(trip_count) * body_size <= max_full_unroll_size;
+				const bool partial_unroll = can_unroll && !full_unroll && !is_short && unroll_factor >= 2 && body_size <= max_unroll_body_size && (!is_trip_count_static || trip_count >= static_cast<int64_t>(unroll_factor));
+
+				// Analyze the additional copies of the "for" block, each with its own labels.
+				// When unrolling completely, each copy, including the first,
+				// runs with a single value of the iterator variable, so e.g.
+				// its array indices can be fixed offsets.
+				const uint64_t     num_copies   = full_unroll ? static_cast<uint64_t>(trip_count) : (partial_unroll ? static_cast<uint64_t>(unroll_factor) + 1 : 1);
+				const std::string  label_suffix = routine_block_state.label_suffix;
+				std::vector<Block> for_block_copies;
+				for (uint64_t copy = full_unroll ? 0 : 1; copy < num_copies; ++copy) {
+					routine_block_state.label_suffix = copy == 0 ? label_suffix : label_suffix + "_u" + std::to_string(copy);
+					if (full_unroll) {
+						const int64_t iterator_value = static_cast<int64_t>(first_constant_value.get_integer()) + static_cast<int64_t>(copy) * addition;
+						routine_block_state.iterator_ranges[identifier.text] = ValueRange(iterator_value, iterator_value);
+					}
+					for_block_copies.push_back(analyze_statements(routine_declaration, statement_sequence, constant_scope, type_scope, routine_scope, for_var_scope, for_combined_scope, storage_scope, cleanup_symbol, routine_block_state));
+				}
+				routine_block_state.label_suffix = label_suffix;
+				routine_block_state.iterator_ranges = outer_iterator_ranges;
+
+				if (full_unroll) {
+					// Set the iterator variable to each value in turn, running a
+					// copy of the "for" block after each, and finally to the value
+					// the normal loop would leave it with.
+					for (int64_t iteration = 0; iteration <= trip_count; ++iteration) {
+						const int32_t iterator_value       = static_cast<int32_t>(static_cast<uint32_t>(first_constant_value.get_integer()) + static_cast<uint32_t>(iteration * addition));
+						const Index   load_iterator_index  = block.back = block.instructions.add_instruction({I::LoadImmediate(B(), is_word, ConstantValue(iterator_value, first_expression.lexeme_begin, last_expression.lexeme_end))}, {}, {block.back});
+						const Index   store_iterator_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, true, false, var.storage, Storage(), var.is_primitive_and_ref, false)}, {load_iterator_index}, {block.back}); (void) store_iterator_index;
+
+						if (iteration < trip_count) {
+							const Index for_block_index = block.merge_append(for_block_copies[iteration]); (void) for_block_index;
+						}
+					}
+
+					// We're done.
+					break;
+				}
+
+				// Merge the first and last number expressions.
+				const Index first_index = block.merge_expression(first_expression);
+				const Index last_index  = block.merge_expression(last_expression);
+
 				// First, initialize the iterator variable.
 				if (!var.is_primitive_and_ref) {
 					// Set the storage to first.
@@ -14325,30 +16410,104 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 					const Index initialize_iterator_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, true, false, var.storage, Storage(), true, false)}, {first_index}, {block.back}); (void) initialize_iterator_index;
 				}
 
-				// Jump to "checkfor" to check the condition for the first time.
-				block.back = block.instructions.add_instruction({I::Jump(B(), checkfor_symbol)}, {}, {block.back});
+				// The loops are rotated: the condition is checked once before
+				// entering a loop, to skip it entirely, and then at the bottom of
+				// each iteration by a single branch back to the top.  If the
+				// bounds are constant, the number of iterations is known, and the
+				// check before the loop can be omitted when it would always pass.
+
+				if (partial_unroll) {
+					// Run unroll_factor iterations at a time while at least that
+					// many remain, i.e. while the iterator variable is < last - unroll_factor + 2
+					// (or, if decreasing, last + unroll_factor - 2 < the iterator variable).
+					const int32_t unrolled_addition        = addition * (2 - static_cast<int32_t>(unroll_factor));
+					const Index   near_unrolled_last_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, unrolled_addition, false, false, Storage(), Storage())}, {last_index}, {block.back});
+
+					// Skip the unrolled loop unless at least unroll_factor iterations remain.
+					const bool is_unrolled_guarded = !is_trip_count_static;
+					if (is_unrolled_guarded) {
+						const Index get_iterator_value_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, false, true, Storage(), var.storage, false, var.is_primitive_and_ref)}, {}, {block.back});
+						const Index guard_condition_index    = block.back
+							= increasing
+							? block.instructions.add_instruction({I::LessThanFrom(B(), is_word, true)}, {get_iterator_value_index, near_unrolled_last_index}, {block.back})
+							: block.instructions.add_instruction({I::LessThanFrom(B(), is_word, true)}, {near_unrolled_last_index, get_iterator_value_index}, {block.back})
+							;
+						const Index guard_branch_index       = block.back = block.instructions.add_instruction({I::BranchZero(B(), false, endunrolledfor_symbol)}, {guard_condition_index}, {block.back}); (void) guard_branch_index;
+					}
 
-				// "for" label.
-				block.back = block.instructions.add_instruction({I::Ignore(B(true, for_symbol), false, false)}, {}, {block.back});
+					// "unrolledfor" label.
+					block.back = block.instructions.add_instruction({I::Ignore(B(true, unrolledfor_symbol), false, false)}, {}, {block.back});
 
-				// "for" block.
-				const Index for_block_index = block.merge_append(for_block);
+					// The copies of the "for" block, each followed by the increment or decrement.
+					for (const Block &for_block_copy : std::as_const(for_block_copies)) {
+						const Index for_block_copy_index = block.merge_append(for_block_copy); (void) for_block_copy_index;
+						const Index step_iterator_index  = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, addition, true, true, var.storage, var.storage, var.is_primitive_and_ref, var.is_primitive_and_ref)}, {}, {block.back}); (void) step_iterator_index;
+					}
 
-				// Increment or decrement the iterator variable.
-				if (!var.is_primitive_and_ref) {
-					// Set the storage to first.
-					const Index initialize_iterator_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, addition, true, true, var.storage, var.storage, false, false)}, {}, {block.back}); (void) initialize_iterator_index;
-				} else {
-					// Set the dereferenced storage's address to first.
+					// "unrolledfor" condition.
+					const Index get_iterator_value_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, false, true, Storage(), var.storage, false, var.is_primitive_and_ref)}, {}, {block.back});
+					const Index unrolled_condition_index = block.back
+						= increasing
+						? block.instructions.add_instruction({I::LessThanFrom(B(), is_word, true)}, {get_iterator_value_index, near_unrolled_last_index}, {block.back})
+						: block.instructions.add_instruction({I::LessThanFrom(B(), is_word, true)}, {near_unrolled_last_index, get_iterator_value_index}, {block.back})
+						;
+					const Index unrolled_branch_index    = block.back = block.instructions.add_instruction({I::BranchZero(B(), false, unrolledfor_symbol, true)}, {unrolled_condition_index}, {block.back}); (void) unrolled_branch_index;
+
+					// "endunrolledfor" label.
+					if (is_unrolled_guarded || emit_extra_redundant_labels) {
+						block.back = block.instructions.add_instruction({I::Ignore(B(true, endunrolledfor_symbol), false, false)}, {}, {block.back});
+					}
+
+					// With constant bounds, the unrolled loop may leave no
+					// iterations for the normal loop.
+					if (is_trip_count_static && trip_count % static_cast<int64_t>(unroll_factor) == 0) {
+						// We're done.
+						break;
+					}
+
+					// Fall through to the normal loop for the remaining iterations.
+				}
+
+				// How many iterations are left for the normal loop, if the bounds are constant?
+				const int64_t remaining_trip_count = !is_trip_count_static ? 0 : partial_unroll ? trip_count % static_cast<int64_t>(unroll_factor) : trip_count;
+				const bool    is_guarded           = remaining_trip_count <= 0;
+
+				// If increasing, iterate while the iterator variable is < last_index + 1.
+				// If decreasing, iterate while the iterator variable is > last_index - 1, i.e. last_index - 1 < the iterator variable.
+				const Index near_last_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, addition, false, false, Storage(), Storage())}, {last_index}, {block.back});
+
+				// Skip the loop if there are no iterations.
+				if (is_guarded) {
+					const Index get_iterator_value_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, false, true, Storage(), var.storage, false, var.is_primitive_and_ref)}, {}, {block.back});
+					const Index guard_condition_index    = block.back
+						= increasing
+						? block.instructions.add_instruction({I::LessThanFrom(B(), is_word, true)}, {get_iterator_value_index, near_last_index}, {block.back})
+						: block.instructions.add_instruction({I::LessThanFrom(B(), is_word, true)}, {near_last_index, get_iterator_value_index}, {block.back})
+						;
+					const Index guard_branch_index       = block.back = block.instructions.add_instruction({I::BranchZero(B(), false, endfor_symbol)}, {guard_condition_index}, {block.back}); (void) guard_branch_index;
+				}
+
+				// "for" label.
+				block.back = block.instructions.add_instruction({I::Ignore(B(true, for_symbol), false, false)}, {}, {block.back});
+
+				// "for" block.
+				const Index for_block_index = block.merge_append(for_block);
+
+				// Increment or decrement the iterator variable.
+				if (!var.is_primitive_and_ref) {
+					// Set the storage to first.
+					const Index initialize_iterator_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, addition, true, true, var.storage, var.storage, false, false)}, {}, {block.back}); (void) initialize_iterator_index;
+				} else {
+					// Set the dereferenced storage's address to first.
 					const Index initialize_iterator_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, addition, true, true, var.storage, var.storage, true, true)}, {}, {block.back}); (void) initialize_iterator_index;
 				}
 
-				// "checkfor" label.
-				block.back = block.instructions.add_instruction({I::Ignore(B(true, checkfor_symbol), false, false)}, {}, {block.back});
+				// "checkfor" label.  We don't need the checkfor label, and it is unused, but emit it anyway for readability.
+				if (emit_extra_redundant_labels) {
+					block.back = block.instructions.add_instruction({I::Ignore(B(true, checkfor_symbol), false, false)}, {}, {block.back});
+				}
 
 				// "for" condition.  (BranchZero has the branch_non_zero flag set to true.)
-				// If increasing, branch to repeat the loop if the iterator variable is < last_index + 1.
-				// If decreasing, branch to repeat the loop if the iterator variable is > last_index - 1, i.e. last_index - 1 < the iterator variable.
 				const Index get_iterator_value_index = block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, false, true, Storage(), var.storage, false, var.is_primitive_and_ref)}, {}, {block.back});
 				const Index for_condition_index      = block.back
 					= increasing
@@ -14357,8 +16516,8 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 					;
 				const Index for_branch_index         = block.back = block.instructions.add_instruction({I::BranchZero(B(), false, for_symbol, true)}, {for_condition_index}, {block.back});
 
-				// "endfor label".  We don't need the endfor label, and it is unused, but emit it anyway for readability.
-				if (emit_extra_redundant_labels) {
+				// "endfor" label.  Unless the loop is guarded, we don't need the endfor label, and it is unused, but emit it anyway for readability.
+				if (is_guarded || emit_extra_redundant_labels) {
 					block.back = block.instructions.add_instruction({I::Ignore(B(true, endfor_symbol), false, false)}, {}, {block.back});
 				}
 
@@ -14370,6 +16529,11 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 
 				const LexemeKeyword &stop_keyword0 = grammar.lexemes.at(stop_statement.stop_keyword0).get_keyword(); (void) stop_keyword;
 
+				// Print the profile first.
+				if (profile_generate) {
+					block.back = block.instructions.add_instruction({I::Custom(B(), {Output::Line("\tjal   ") + profile_dump_symbol})}, {}, {block.back});
+				}
+
 				// Syscall exit2(0).
 				//const Index load_17 = block.back = block.instructions.add_instruction({I::LoadImmediate(B(), true, ConstantValue(static_cast<int32_t>(17), 0, 0), Symbol())}, {}, {block.back});
 				//const Index set_v0  = block.back = block.instructions.add_instruction({I::LoadFrom(B(), true, true, 0, true, false, Storage("$v0"), Storage())}, {load_17}, {block.back});
@@ -14497,9 +16661,9 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 
 							// Manually put in our while loop.
 							// Analyze the "while" block condition.  Don't merge it yet.
-							const Symbol     while_symbol      = Symbol(labelify("return", "memmove_while"),      "", return_statement.return_keyword0);
-							const Symbol     checkwhile_symbol = Symbol(labelify("return", "memmove_checkwhile"), "", return_statement.return_keyword0);
-							const Symbol     endwhile_symbol   = Symbol(labelify("return", "memmove_endwhile"),   "", return_statement.return_keyword0);
+							const Symbol     while_symbol      = Symbol(labelify("return", "memmove_while"),      routine_block_state.label_suffix, return_statement.return_keyword0);
+							const Symbol     checkwhile_symbol = Symbol(labelify("return", "memmove_checkwhile"), routine_block_state.label_suffix, return_statement.return_keyword0);
+							const Symbol     endwhile_symbol   = Symbol(labelify("return", "memmove_endwhile"),   routine_block_state.label_suffix, return_statement.return_keyword0);
 
 							// First, jump to "checkwhile" to check the condition for the first time.
 							block.back = block.instructions.add_instruction({I::Jump(B(), checkwhile_symbol)}, {}, {block.back});
@@ -14972,8 +17136,28 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 				throw SemanticsError(sstr.str());
 			}
 		}
+
+		// The cached results are only valid within the statement.
+		for (const std::string &cached_call : std::as_const(cached_calls)) {
+			routine_block_state.cached_calls.erase(cached_call);
+		}
+
+		// The statement's checks ran before what follows, unless they were
+		// in a branch or loop that may have been skipped.
+		if (track_checked_ranges) {
+			if (statement.branch != Statement::if_branch && statement.branch != Statement::while_branch && statement.branch != Statement::repeat_branch && statement.branch != Statement::for_branch) {
+				forget_checked_ranges(routine_block_state.pending_checked_ranges, routine_block_state.statement_lexemes);
+				add_checked_ranges(routine_block_state.checked_ranges, routine_block_state.pending_checked_ranges);
+			}
+			routine_block_state.pending_checked_ranges.clear();
+		}
 	}
 
+	// What the statements' checks showed no longer holds after them.
+	routine_block_state.checked_ranges         = outer_checked_ranges;
+	routine_block_state.pending_checked_ranges = outer_pending_checked_ranges;
+	routine_block_state.statement_lexemes      = outer_statement_lexemes;
+
 	// Return the block;
 	return block;
 }
@@ -15038,554 +17222,5441 @@ Semantics::Block Semantics::analyze_statements(const IdentifierScope::Identifier
 	return analyze_statements(routine_declaration, statement_indices, constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, cleanup_symbol, routine_block_state);
 }
 
-// | Analyze a BEGIN [statement]... END block.
-std::vector<Semantics::Output::Line> Semantics::analyze_block(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const ::Block &block, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, IdentifierScope &var_scope, IdentifierScope &combined_scope, IdentifierScope &storage_scope, const std::map<std::string, TypeIndex> &local_variables, bool is_main) {
-	// Some type aliases to improve readability.
-	using M = Semantics::MIPSIO;
-	using I = Semantics::Instruction;
-	using B = Semantics::Instruction::Base;
-	using Index = M::Index;
-	using IO    = M::IO;
-	using ConstantValue = Semantics::ConstantValue;
-	using Output        = Semantics::Output;
-	using Storage       = Semantics::Storage;
-	using Symbol        = Semantics::Symbol;
-	const LexemeKeyword      &begin_keyword0     = grammar.lexemes.at(block.begin_keyword0).get_keyword(); (void) begin_keyword0;
-	const StatementSequence  &statement_sequence = grammar.statement_sequence_storage.at(block.statement_sequence);
-	const LexemeKeyword      &end_keyword0       = grammar.lexemes.at(block.end_keyword0).get_keyword(); (void) end_keyword0;
+// | Could the statements between these lexemes change the value of the
+// variable named by "identifier"?
+bool Semantics::may_modify_variable(uint64_t lexeme_begin, uint64_t lexeme_end, const std::string &identifier, bool check_calls, const IdentifierScope &routine_scope) const {
+	// Skip whitespace and comments.
+	std::vector<uint64_t> tokens;
+	for (uint64_t lexeme_index = lexeme_begin; lexeme_index < lexeme_end && lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+		const Lexeme &lexeme = grammar.lexemes.at(lexeme_index);
+		if (!lexeme.is_whitespace() && !lexeme.is_comment()) {
+			tokens.push_back(lexeme_index);
+		}
+	}
 
-	IdentifierScope local_var_scope(var_scope);
-	IdentifierScope local_combined_scope(combined_scope);
+	for (std::vector<uint64_t>::size_type token = 0; token < tokens.size(); ++token) {
+		const Lexeme &lexeme = grammar.lexemes.at(tokens[token]);
+		if (!lexeme.is_identifier()) {
+			continue;
+		}
 
-	// Initialize the routine block state.
-	RoutineBlockState routine_block_state;
+		const Lexeme     *previous          = token > 0                 ? &grammar.lexemes.at(tokens[token - 1]) : nullptr;
+		const Lexeme     *next              = token + 1 < tokens.size() ? &grammar.lexemes.at(tokens[token + 1]) : nullptr;
+		const keyword_t   previous_keyword  = previous && previous->is_keyword()  ? previous->get_keyword().keyword    : null_keyword;
+		const operator_t  previous_operator = previous && previous->is_operator() ? previous->get_operator().operator_ : null_operator;
+		const operator_t  next_operator     = next     && next->is_operator()     ? next->get_operator().operator_     : null_operator;
+
+		// Is this a call to a routine that could change a global or a ref parameter?
+		if (
+			   check_calls
+			&& next_operator == leftparenthesis_operator
+			&& routine_scope.has(lexeme.get_identifier().text)
+			&& !(routine_scope.get(lexeme.get_identifier().text).is_routine_declaration() && readonly_routines.find(routine_scope.get(lexeme.get_identifier().text).get_routine_declaration().location) != readonly_routines.cend())
+		) {
+			return true;
+		}
 
-	// Ensure routine_declaration.parameters has the same length as parameter_identifiers.
-	if (routine_declaration.parameters.size() != parameter_identifiers.size()) {
-		std::ostringstream sstr;
-		sstr
-			<< "Semantics::analyze_block: internal error: routine_declaration.parameters with length "
-			<< routine_declaration.parameters.size()
-			<< " has a different length than parameter_identifiers with length "
-			<< parameter_identifiers.size()
-			<< "."
+		if (lexeme.get_identifier().text != identifier) {
+			continue;
+		}
+
+		// Is the variable assigned to, or an element of it, or is it the
+		// variable of a nested "for" loop?
+		const bool is_statement_start =
+			   previous_operator == semicolon_operator
+			|| previous_keyword  == begin_keyword
+			|| previous_keyword  == then_keyword
+			|| previous_keyword  == else_keyword
+			|| previous_keyword  == do_keyword
+			|| previous_keyword  == repeat_keyword
 			;
-		throw SemanticsError(sstr.str());
+		if (next_operator == colonequals_operator || previous_keyword == for_keyword || (is_statement_start && (next_operator == leftbracket_operator || next_operator == dot_operator))) {
+			return true;
+		}
+
+		// Is the variable, or an element of it, an argument by itself?
+		if (
+			   (previous_operator == leftparenthesis_operator  || previous_operator == comma_operator)
+			&& (next_operator     == rightparenthesis_operator || next_operator     == comma_operator || next_operator == leftbracket_operator || next_operator == dot_operator)
+		) {
+			// Find what is being called: go back to the unmatched "(".
+			uint64_t depth = 0;
+			std::vector<uint64_t>::size_type open = token;
+			while (open > 0) {
+				--open;
+				const Lexeme &open_lexeme = grammar.lexemes.at(tokens[open]);
+				if (open_lexeme.is_operator() && open_lexeme.get_operator().operator_ == rightparenthesis_operator) {
+					++depth;
+				} else if (open_lexeme.is_operator() && open_lexeme.get_operator().operator_ == leftparenthesis_operator) {
+					if (depth <= 0) {
+						break;
+					}
+					--depth;
+				}
+			}
+
+			// "read" assigns its arguments, and a routine may take the
+			// argument by reference.  (If the call begins before lexeme_begin,
+			// assume the worst.)
+			if (open <= 0) {
+				return true;
+			}
+			const Lexeme &callee = grammar.lexemes.at(tokens[open - 1]);
+			if (callee.is_keyword() && callee.get_keyword().keyword == read_keyword) {
+				return true;
+			}
+			if (callee.is_identifier()) {
+				// Which argument is it?
+				uint64_t argument_index = 0;
+				depth = 0;
+				for (std::vector<uint64_t>::size_type between = open + 1; between < token; ++between) {
+					const Lexeme &between_lexeme = grammar.lexemes.at(tokens[between]);
+					if (between_lexeme.is_operator() && (between_lexeme.get_operator().operator_ == leftparenthesis_operator || between_lexeme.get_operator().operator_ == leftbracket_operator)) {
+						++depth;
+					} else if (between_lexeme.is_operator() && (between_lexeme.get_operator().operator_ == rightparenthesis_operator || between_lexeme.get_operator().operator_ == rightbracket_operator)) {
+						--depth;
+					} else if (depth <= 0 && between_lexeme.is_operator() && between_lexeme.get_operator().operator_ == comma_operator) {
+						++argument_index;
+					}
+				}
+
+				// A value parameter only gets a copy.
+				const std::string &callee_identifier = callee.get_identifier().text;
+				if (
+					   !routine_scope.has(callee_identifier)
+					|| !routine_scope.get(callee_identifier).is_routine_declaration()
+					|| argument_index >= routine_scope.get(callee_identifier).get_routine_declaration().parameters.size()
+					|| routine_scope.get(callee_identifier).get_routine_declaration().parameters[argument_index].first
+				) {
+					return true;
+				}
+			}
+		}
 	}
 
-	// Put parameter_identifiers in a set for lookup.
-	std::set<std::string> in_parameter_identifiers;
-	for (const std::string &parameter_identifier : std::as_const(parameter_identifiers)) {
-		in_parameter_identifiers.insert(parameter_identifier);
+	return false;
+}
+
+// | Could the statements between these lexemes change the global or ref
+// parameter named by "identifier" through another name for it?
+bool Semantics::may_modify_variable_alias(uint64_t lexeme_begin, uint64_t lexeme_end, const std::string &identifier, const IdentifierScope &routine_scope, const RoutineBlockState &routine_block_state) const {
+	// Only a ref parameter can give a global another name.
+	bool has_ref_parameters = false;
+	for (const std::string &parameter_identifier : std::as_const(routine_block_state.parameter_identifiers)) {
+		if (routine_block_state.local_identifiers.find(parameter_identifier) == routine_block_state.local_identifiers.cend()) {
+			has_ref_parameters = true;
+			break;
+		}
+	}
+	if (!has_ref_parameters) {
+		return false;
 	}
 
-	// Get cleanup symbol.
-	const Symbol cleanup_symbol(routine_declaration.location.prefix, routine_declaration.location.requested_suffix + "_cleanup", routine_declaration.location.unique_identifier);
+	// Collect the other globals and ref parameters named, other than as
+	// record fields.
+	std::set<std::string> others;
+	const Lexeme *previous = nullptr;
+	for (uint64_t lexeme_index = lexeme_begin; lexeme_index < lexeme_end && lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+		const Lexeme &lexeme = grammar.lexemes.at(lexeme_index);
+		if (lexeme.is_whitespace() || lexeme.is_comment()) {
+			continue;
+		}
+		if (
+			   lexeme.is_identifier()
+			&& lexeme.get_identifier().text != identifier
+			&& !(previous && previous->is_operator() && previous->get_operator().operator_ == dot_operator)
+			&& routine_block_state.local_identifiers.find(lexeme.get_identifier().text) == routine_block_state.local_identifiers.cend()
+		) {
+			others.insert(lexeme.get_identifier().text);
+		}
+		previous = &lexeme;
+	}
 
-	// Prepare output vector.
-	std::vector<Output::Line> output_lines;
+	// A store to any of them may be a store to the variable.  (Calls are
+	// left to may_modify_variable.)
+	for (const std::string &other : std::as_const(others)) {
+		if (may_modify_variable(lexeme_begin, lexeme_end, other, false, routine_scope)) {
+			return true;
+		}
+	}
 
-	// Get temporary registers we can use.
-	static const std::set<std::string> temporary_registers {
-		"$t0",
-		"$t1",
-		"$t2",
-		"$t3",
-		"$t4",
-		"$t5",
-		"$t6",
-		"$t7",
-	};
-	std::set<std::string> available_temporary_registers(temporary_registers);
+	return false;
+}
 
-	// Assign variables and working storage units to Storages and allocate
-	// sufficient space on the stack.
-	//
-	// Take into account that we will first push the return address.
-	const int32_t push_ra_allocated = Instruction::AddSp::round_to_align(4);
-	int32_t stack_allocated = 0;
+bool Semantics::may_fold_variable(uint64_t lexeme_begin, uint64_t lexeme_end, const std::string &identifier) const {
+	// Skip whitespace and comments.
+	std::vector<uint64_t> tokens;
+	for (uint64_t lexeme_index = lexeme_begin; lexeme_index < lexeme_end && lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+		const Lexeme &lexeme = grammar.lexemes.at(lexeme_index);
+		if (!lexeme.is_whitespace() && !lexeme.is_comment()) {
+			tokens.push_back(lexeme_index);
+		}
+	}
 
-	// Commented out: these are already copied on a call!  Instead, just add a binding to the appropriate storage.  We do that here.
-#if 0
-	// Normally, we'd handle parameters here, but calculate other sizes first.
-#endif /* #if 0 */
-	// Handle parameters.
-	uint32_t stack_argument_total_size = 0;
-	for (const std::pair<bool, TypeIndex> &parameter : std::as_const(routine_declaration.parameters)) {
-		const std::vector<std::pair<bool, TypeIndex>>::size_type   parameter_index      = &parameter - &routine_declaration.parameters[0];
-		const std::string                                         &parameter_identifier = parameter_identifiers[parameter_index];
+	const auto is_folding_operator = [&] (std::vector<uint64_t>::size_type token) -> bool {
+		const Lexeme &lexeme = grammar.lexemes.at(tokens[token]);
+		if (!lexeme.is_operator()) {
+			return false;
+		}
+		switch (lexeme.get_operator().operator_) {
+			case plus_operator:
+			case minus_operator:
+			case times_operator:
+			case slash_operator:
+			case percent_operator:
+			case ampersand_operator:
+			case pipe_operator:
+			case equals_operator:
+			case lt_or_gt_operator:
+			case lt_operator:
+			case le_operator:
+			case gt_operator:
+			case ge_operator:
+				return true;
+			default:
+				return false;
+		}
+	};
+	const auto is_literal = [&] (std::vector<uint64_t>::size_type token) -> bool {
+		const Lexeme &lexeme = grammar.lexemes.at(tokens[token]);
+		return lexeme.is_integer() || lexeme.is_char();
+	};
 
-		const bool      parameter_is_ref = parameter.first;
-		const TypeIndex parameter_type   = parameter.second;
+	for (std::vector<uint64_t>::size_type token = 0; token < tokens.size(); ++token) {
+		const Lexeme &lexeme = grammar.lexemes.at(tokens[token]);
+		if (!lexeme.is_identifier() || lexeme.get_identifier().text != identifier) {
+			continue;
+		}
 
-		// Fail if the parameter type is not fixed width.
-		if (!storage_scope.type(parameter_type).get_fixed_width()) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: parameter ``"
-				<< parameter_identifier
-				<< "\" has a non-fixed-width size in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"; non-fixed-width size parameters are currently unsupported."
-				;
-			throw SemanticsError(sstr.str());
+		const Lexeme     *previous          = token > 0                 ? &grammar.lexemes.at(tokens[token - 1]) : nullptr;
+		const Lexeme     *next              = token + 1 < tokens.size() ? &grammar.lexemes.at(tokens[token + 1]) : nullptr;
+		const keyword_t   previous_keyword  = previous && previous->is_keyword()  ? previous->get_keyword().keyword    : null_keyword;
+		const operator_t  previous_operator = previous && previous->is_operator() ? previous->get_operator().operator_ : null_operator;
+		const keyword_t   next_keyword      = next     && next->is_keyword()      ? next->get_keyword().keyword        : null_keyword;
+
+		// A whole condition or "for" bound.
+		if (
+			   ((previous_keyword == if_keyword || previous_keyword == elseif_keyword || previous_keyword == while_keyword) && (next_keyword == then_keyword || next_keyword == do_keyword))
+			|| ((previous_keyword == to_keyword || previous_keyword == downto_keyword) && next_keyword == do_keyword)
+			|| (previous_operator == colonequals_operator && (next_keyword == to_keyword || next_keyword == downto_keyword))
+		) {
+			return true;
 		}
 
-		// Make sure this variable doesn't shadow any top-level variables.
-		//
-		// (This check can safely be disabled if enabling shadowing.)
-		if (!permit_shadowing && var_scope.has(parameter_identifier)) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: parameter ``"
-				<< parameter_identifier
-				<< "\" would shadow a top-level variable in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"."
-				;
-			throw SemanticsError(sstr.str());
+		// An operand next to a literal.
+		if (token >= 2 && is_folding_operator(token - 1) && is_literal(token - 2)) {
+			return true;
+		}
+		if (token + 2 < tokens.size() && is_folding_operator(token + 1) && is_literal(token + 2)) {
+			return true;
 		}
+	}
 
-		// Make sure this variable doesn't shadow any top-level variables.
-		//
-		// (This check can safely be disabled if enabling shadowing.)
-		if (!permit_shadowing && combine_identifier_namespaces && combined_scope.has(parameter_identifier)) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: parameter ``"
-				<< parameter_identifier
-				<< "\" has an identifier that is already assigned in another namespace in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"."
-				<< "  Set combine_identifier_namespaces to false to isolate identifier namespaces"
-				<< " from each other and disable this check."
-				;
-			throw SemanticsError(sstr.str());
+	return false;
+}
+
+std::optional<std::set<std::string>> Semantics::get_routine_global_reads(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const Body &body, const IdentifierScope &var_scope, const IdentifierScope &routine_scope) const {
+	const ::Block &block = grammar.block_storage.at(body.block);
+
+	// A ref parameter may be stored through, and may alias a global.
+	for (const std::pair<bool, TypeIndex> &parameter : std::as_const(routine_declaration.parameters)) {
+		if (parameter.first) {
+			return std::nullopt;
 		}
+	}
 
-		// We've done checking, but don't add the variable bindings until we know how much stack space we will allocate.
-		const bool is_primitive_and_ref  = parameter_is_ref && storage_scope.resolve_type(parameter_type).is_primitive();
-		const bool is_resolved_type_word = !storage_scope.resolve_type(parameter_type).is_primitive() || storage_scope.resolve_type(parameter_type).get_primitive().is_word();
-		const bool is_nonprimitive = storage_scope.type(parameter_type).resolve_type(storage_scope).is_array() || storage_scope.type(parameter_type).resolve_type(storage_scope).is_record();
-		if (parameter_index < 4) {
-			const bool is_word = is_resolved_type_word || parameter_is_ref;
+	// Skip whitespace and comments.
+	std::vector<uint64_t> tokens;
+	for (uint64_t lexeme_index = block.begin_keyword0; lexeme_index <= block.end_keyword0 && lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+		const Lexeme &lexeme = grammar.lexemes.at(lexeme_index);
+		if (!lexeme.is_whitespace() && !lexeme.is_comment()) {
+			tokens.push_back(lexeme_index);
+		}
+	}
 
-			Storage parameter_storage
-				= !is_primitive_and_ref || is_nonprimitive
-				? Storage("$a" + std::to_string(parameter_index))                                    // Just use $a directly; don't dereference.  (Primitive Var.)
-				: Storage("$a" + std::to_string(parameter_index), is_resolved_type_word ? 4 : 1, 0)  // The variable should dereference an address.
-				;
+	std::set<std::string> global_reads;
+	for (std::vector<uint64_t>::size_type token = 0; token < tokens.size(); ++token) {
+		const Lexeme &lexeme = grammar.lexemes.at(tokens[token]);
 
-			if (!is_word) {
-				parameter_storage.max_size = 1;
+		// No I/O.
+		if (lexeme.is_keyword() && (lexeme.get_keyword().keyword == read_keyword || lexeme.get_keyword().keyword == write_keyword || lexeme.get_keyword().keyword == stop_keyword)) {
+			return std::nullopt;
+		}
+		if (!lexeme.is_identifier()) {
+			continue;
+		}
+		const std::string &identifier = lexeme.get_identifier().text;
+
+		const Lexeme     *previous          = token > 0                 ? &grammar.lexemes.at(tokens[token - 1]) : nullptr;
+		const Lexeme     *next              = token + 1 < tokens.size() ? &grammar.lexemes.at(tokens[token + 1]) : nullptr;
+		const keyword_t   previous_keyword  = previous && previous->is_keyword()  ? previous->get_keyword().keyword    : null_keyword;
+		const operator_t  previous_operator = previous && previous->is_operator() ? previous->get_operator().operator_ : null_operator;
+		const operator_t  next_operator     = next     && next->is_operator()     ? next->get_operator().operator_     : null_operator;
+
+		// Calls must be to readonly routines, or recursive.
+		if (next_operator == leftparenthesis_operator) {
+			if (!routine_scope.has(identifier) || !routine_scope.get(identifier).is_routine_declaration()) {
+				return std::nullopt;
+			}
+			const Symbol &callee_location = routine_scope.get(identifier).get_routine_declaration().location;
+			if (callee_location == routine_declaration.location) {
+				continue;
 			}
+			const std::map<Symbol, std::set<std::string>>::const_iterator readonly_routines_search = readonly_routines.find(callee_location);
+			if (readonly_routines_search == readonly_routines.cend()) {
+				return std::nullopt;
+			}
+			global_reads.insert(readonly_routines_search->second.cbegin(), readonly_routines_search->second.cend());
+			continue;
+		}
 
-			local_var_scope.insert({parameter_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(parameter_type, parameter_storage))});
-			local_combined_scope.insert({parameter_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(parameter_type, parameter_storage))});
-		} else {
-			const bool is_word = is_resolved_type_word || parameter_is_ref;
+		// Globals may be read but not written.  (Assume a local that shadows
+		// a global is the global.)
+		if (!var_scope.has(identifier) || std::find(parameter_identifiers.cbegin(), parameter_identifiers.cend(), identifier) != parameter_identifiers.cend()) {
+			continue;
+		}
+		const bool is_statement_start =
+			   previous_operator == semicolon_operator
+			|| previous_keyword  == begin_keyword
+			|| previous_keyword  == then_keyword
+			|| previous_keyword  == else_keyword
+			|| previous_keyword  == do_keyword
+			|| previous_keyword  == repeat_keyword
+			;
+		if (is_statement_start || previous_keyword == for_keyword || next_operator == colonequals_operator) {
+			return std::nullopt;
+		}
+		global_reads.insert(identifier);
+	}
 
-			stack_argument_total_size = Instruction::AddSp::round_to_align(stack_argument_total_size, is_word ? 4 : 1, 4);
+	return global_reads;
+}
 
-			// If it's an array, this storage dereferences the argument to get the real pointer to the beginning of the array.  (The first element involves 2 dereferences.)
-			const Storage parameter_storage
-				= !is_primitive_and_ref
-				? Storage(is_word ? 4 : 1, false, Symbol(), "$sp", true, stack_argument_total_size, false, false)
-				: Storage(is_word ? 4 : 1, false, Symbol(), "$sp", true, stack_argument_total_size, false, false)
-				;
+bool Semantics::is_readonly_call(uint64_t identifier_lexeme, const IdentifierScope &routine_scope) const {
+	const Lexeme &lexeme = grammar.lexemes.at(identifier_lexeme);
+	if (!lexeme.is_identifier() || !routine_scope.has(lexeme.get_identifier().text) || !routine_scope.get(lexeme.get_identifier().text).is_routine_declaration()) {
+		return false;
+	}
 
-			stack_argument_total_size += is_word ? 4 : 1;
+	// The next token must open the arguments.
+	uint64_t next = identifier_lexeme + 1;
+	while (next < grammar.lexemes.size() && (grammar.lexemes.at(next).is_whitespace() || grammar.lexemes.at(next).is_comment())) {
+		++next;
+	}
+	if (next >= grammar.lexemes.size() || !grammar.lexemes.at(next).is_operator() || grammar.lexemes.at(next).get_operator().operator_ != leftparenthesis_operator) {
+		return false;
+	}
 
-			local_var_scope.insert({parameter_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(parameter_type, parameter_storage, is_primitive_and_ref))});
-			local_combined_scope.insert({parameter_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(parameter_type, parameter_storage, is_primitive_and_ref))});
+	return readonly_routines.find(routine_scope.get(lexeme.get_identifier().text).get_routine_declaration().location) != readonly_routines.cend();
+}
+
+std::pair<std::string, uint64_t> Semantics::get_call_key(uint64_t identifier_lexeme) const {
+	std::string key;
+	uint64_t depth = 0;
+	uint64_t lexeme_index;
+	for (lexeme_index = identifier_lexeme; lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+		const Lexeme &lexeme = grammar.lexemes.at(lexeme_index);
+		if (lexeme.is_whitespace() || lexeme.is_comment()) {
+			continue;
+		}
+		key += lexeme.get_text() + " ";
+		if (lexeme.is_operator() && lexeme.get_operator().operator_ == leftparenthesis_operator) {
+			++depth;
+		} else if (lexeme.is_operator() && lexeme.get_operator().operator_ == rightparenthesis_operator) {
+			if (--depth <= 0) {
+				++lexeme_index;
+				break;
+			}
 		}
 	}
-	stack_argument_total_size = Instruction::AddSp::round_to_align(stack_argument_total_size);
+	return {key, lexeme_index};
+}
 
-	routine_block_state.last_stack_argument_total_size = stack_argument_total_size;
+std::vector<std::string> Semantics::cache_readonly_calls(Block &block, uint64_t head_begin, uint64_t head_end, uint64_t statement_begin, uint64_t statement_end, bool is_loop, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, const IdentifierScope &var_scope, const IdentifierScope &combined_scope, const IdentifierScope &storage_scope, RoutineBlockState &routine_block_state) {
+	using I = Semantics::Instruction;
+	using B = Semantics::Instruction::Base;
+	using Index = MIPSIO::Index;
 
-	// Handle local variables.
-	for (const std::pair<std::string, TypeIndex> &local_variable : std::as_const(local_variables)) {
-		const std::string &local_variable_identifier = local_variable.first;
-		const TypeIndex   &local_variable_type       = local_variable.second;
+	std::vector<std::string> cached;
+	if (!optimize || routine_block_state.call_result_storages.empty()) {
+		return cached;
+	}
 
-		// Fail if the variable type is not fixed width.
-		if (!storage_scope.type(local_variable_type).get_fixed_width()) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: local variable ``"
-				<< local_variable_identifier
-				<< "\" has a non-fixed-width size in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"; non-fixed-width size variables are currently unsupported."
-				;
-			throw SemanticsError(sstr.str());
+	// Count the readonly calls in the statement.
+	std::map<std::string, uint64_t> call_counts;
+	for (uint64_t lexeme_index = statement_begin; lexeme_index < statement_end && lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+		if (is_readonly_call(lexeme_index, routine_scope)) {
+			++call_counts[get_call_key(lexeme_index).first];
 		}
+	}
 
-		// Make sure this variable doesn't shadow any parameters.
-		//
-		// (This check can safely be disabled if enabling shadowing.)
-		if (!permit_shadowing && in_parameter_identifiers.find(local_variable_identifier) != in_parameter_identifiers.cend()) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: local variable ``"
-				<< local_variable_identifier
-				<< "\" would shadow a parameter in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"."
-				;
-			throw SemanticsError(sstr.str());
+	for (uint64_t lexeme_index = head_begin; lexeme_index < head_end && lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+		if (!is_readonly_call(lexeme_index, routine_scope)) {
+			continue;
 		}
-
-		// Make sure this variable doesn't shadow any top-level variables.
-		//
-		// (This check can safely be disabled if enabling shadowing.)
-		if (!permit_shadowing && var_scope.has(local_variable_identifier)) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: local variable ``"
-				<< local_variable_identifier
-				<< "\" would shadow a top-level variable in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"."
-				;
-			throw SemanticsError(sstr.str());
+		const std::pair<std::string, uint64_t> call_key = get_call_key(lexeme_index);
+		const std::string &key      = call_key.first;
+		const uint64_t     call_end = call_key.second;
+		const std::map<std::string, Storage>::const_iterator call_result_storages_search = routine_block_state.call_result_storages.find(key);
+		if (
+			   call_result_storages_search == routine_block_state.call_result_storages.cend()
+			|| routine_block_state.cached_calls.find(key) != routine_block_state.cached_calls.cend()
+			|| (!is_loop && call_counts[key] < 2)
+		) {
+			continue;
 		}
 
-		// Make sure this variable doesn't shadow any top-level variables.
-		//
-		// (This check can safely be disabled if enabling shadowing.)
-		if (!permit_shadowing && combine_identifier_namespaces && combined_scope.has(local_variable_identifier)) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: local variable ``"
-				<< local_variable_identifier
-				<< "\" has an identifier that is already assigned in another namespace in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"."
-				<< "  Set combine_identifier_namespaces to false to isolate identifier namespaces"
-				<< " from each other and disable this check."
-				;
-			throw SemanticsError(sstr.str());
+		// The arguments must only call readonly functions, and nothing in
+		// the statement may change what they or the functions read, not
+		// even through a ref parameter.
+		const IdentifierScope::IdentifierBinding::RoutineDeclaration &callee = routine_scope.get(grammar.lexemes.at(lexeme_index).get_identifier().text).get_routine_declaration();
+		std::set<std::string> reads(readonly_routines.at(callee.location));
+		std::set<std::string> argument_identifiers;
+		bool is_cacheable = true;
+		for (uint64_t argument_index = lexeme_index + 1; argument_index < call_end; ++argument_index) {
+			const Lexeme &argument_lexeme = grammar.lexemes.at(argument_index);
+			if (!argument_lexeme.is_identifier()) {
+				continue;
+			}
+			if (routine_scope.has(argument_lexeme.get_identifier().text) && routine_scope.get(argument_lexeme.get_identifier().text).is_routine_declaration()) {
+				if (!is_readonly_call(argument_index, routine_scope)) {
+					is_cacheable = false;
+					break;
+				}
+				const std::set<std::string> &callee_reads = readonly_routines.at(routine_scope.get(argument_lexeme.get_identifier().text).get_routine_declaration().location);
+				reads.insert(callee_reads.cbegin(), callee_reads.cend());
+			} else if (var_scope.has(argument_lexeme.get_identifier().text) || routine_block_state.scalar_records.find(argument_lexeme.get_identifier().text) != routine_block_state.scalar_records.cend()) {
+				argument_identifiers.insert(argument_lexeme.get_identifier().text);
+			}
+		}
+		for (const std::string &argument_identifier : std::as_const(argument_identifiers)) {
+			const bool is_local = routine_block_state.local_identifiers.find(argument_identifier) != routine_block_state.local_identifiers.cend();
+			if (!is_cacheable || may_modify_variable(statement_begin, statement_end, argument_identifier, !is_local, routine_scope) || (!is_local && may_modify_variable_alias(statement_begin, statement_end, argument_identifier, routine_scope, routine_block_state))) {
+				is_cacheable = false;
+				break;
+			}
+		}
+		for (const std::string &read : std::as_const(reads)) {
+			if (!is_cacheable || may_modify_variable(statement_begin, statement_end, read, true, routine_scope) || may_modify_variable_alias(statement_begin, statement_end, read, routine_scope, routine_block_state)) {
+				is_cacheable = false;
+				break;
+			}
+		}
+		if (!is_cacheable) {
+			continue;
 		}
 
-		// Add the variable.
-		if (available_temporary_registers.size() > 0 && (storage_scope.type(local_variable_type).get_size() == 4 || storage_scope.type(local_variable_type).get_size() == 1) && storage_scope.resolve_type(local_variable_type).is_primitive()) {
-			const std::string temporary_register = *available_temporary_registers.cbegin();
-			const bool is_word = !storage_scope.type(local_variable_type).is_primitive() || storage_scope.type(local_variable_type).get_primitive().is_word();
-			available_temporary_registers.erase(std::as_const(temporary_register));
-			Storage temporary_storage(is_word ? 4 : 1, false, Symbol(), std::as_const(temporary_register), false, 0, true, true);
-			local_var_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, temporary_storage))});
-			local_combined_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, temporary_storage))});
-		} else {
-			const uint32_t size = storage_scope.type(local_variable_type).get_size();
-			stack_allocated = Instruction::AddSp::round_to_align(stack_allocated + size, size, 4);
-			Storage stack_storage;
-			if (!storage_scope.type(local_variable_type).resolve_type(storage_scope).is_record() && !storage_scope.type(local_variable_type).resolve_type(storage_scope).is_array()) {
-				stack_storage = Storage(size, false, Symbol(), "$sp", true, -(stack_allocated + push_ra_allocated), false, false);
-			} else {
-				stack_storage = Storage(4, false, Symbol(), "$sp", false, -(stack_allocated + push_ra_allocated), false, false);
+		// Find the call in the grammar.
+		const ::Expression::Call *expression_call = nullptr;
+		for (const ::Expression::Call &call : std::as_const(grammar.expression_call_storage)) {
+			if (call.identifier == lexeme_index) {
+				expression_call = &call;
+				break;
 			}
-			local_var_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, stack_storage))});
-			local_combined_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, stack_storage))});
 		}
+		if (expression_call == nullptr) {
+			continue;
+		}
+
+		// Call it, and save the result.
+		const Storage &call_result_storage = call_result_storages_search->second;
+		const std::pair<Block, std::optional<std::pair<Index, TypeIndex>>> call_analysis = analyze_call(grammar.lexemes.at(lexeme_index).get_identifier(), grammar.expression_sequence_opt_storage.at(expression_call->expression_sequence_opt), constant_scope, type_scope, routine_scope, var_scope, combined_scope, storage_scope, routine_block_state);
+		const bool  is_word           = storage_scope.resolve_type(call_analysis.second->second).get_primitive().is_word();
+		const Index call_output_index = block.merge_append(call_analysis.first, call_analysis.second->first);
+		block.back = block.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, true, false, call_result_storage, Storage())}, {call_output_index}, {block.back});
+
+		routine_block_state.cached_calls.insert(key);
+		cached.push_back(key);
+
+		// Don't separately cache calls in its arguments.
+		lexeme_index = call_end - 1;
 	}
 
-	stack_allocated = Instruction::AddSp::round_to_align(stack_allocated);
+	return cached;
+}
 
-	// Analyze the statements in the block.
-	routine_block_state.dynamically_allocated = 0;
-	Block block_semantics = analyze_statements(routine_declaration, statement_sequence, constant_scope, type_scope, routine_scope, local_var_scope, local_combined_scope, storage_scope, cleanup_symbol, routine_block_state);
+std::optional<Semantics::MemoTable> Semantics::get_memo_table(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const Body &body, const std::string &identifier) const {
+	(void) parameter_identifiers;
+	const ::Block &block = grammar.block_storage.at(body.block);
 
-	// Make sure front and back are valid by making sure there is at least one instruction.
-	if (block_semantics.instructions.instructions.size() <= 0) {
-		block_semantics.front = block_semantics.back = block_semantics.instructions.add_instruction({I::Ignore(B(), false, false)});
+	// The result must depend only on the arguments.
+	const std::map<Symbol, std::set<std::string>>::const_iterator readonly_routines_search = readonly_routines.find(routine_declaration.location);
+	if (!auto_memoize || readonly_routines_search == readonly_routines.cend() || !readonly_routines_search->second.empty() || !routine_declaration.output.has_value()) {
+		return std::nullopt;
+	}
+	if (routine_declaration.parameters.size() < 1 || routine_declaration.parameters.size() > 2) {
+		return std::nullopt;
 	}
 
-	// Optimize.
-	if (optimize) {
-		block_semantics.instructions.optimize();
+	// Only recursive functions are worth it.
+	bool is_recursive = false;
+	for (uint64_t lexeme_index = block.begin_keyword0; lexeme_index < block.end_keyword0 && !is_recursive; ++lexeme_index) {
+		const Lexeme &lexeme = grammar.lexemes.at(lexeme_index);
+		is_recursive = lexeme.is_identifier() && lexeme.get_identifier().text == identifier && is_readonly_call(lexeme_index, top_level_routine_scope);
+	}
+	if (!is_recursive) {
+		return std::nullopt;
 	}
 
-	// Get working storage requirements.
-	std::pair<std::vector<uint32_t>, std::vector<uint64_t>> prepare_permutation = block_semantics.instructions.prepare_permutation(std::set<IO>(), {block_semantics.back});
-	const std::vector<uint32_t> &working_storage_requirements = prepare_permutation.first;
-	const std::vector<uint64_t> &permutation                  = prepare_permutation.second;
+	// Only integer, char, and boolean value parameters can index the table.
+	std::vector<uint32_t> type_extents;
+	std::vector<bool>     integer_parameters;
+	for (const std::pair<bool, TypeIndex> &parameter : std::as_const(routine_declaration.parameters)) {
+		const Type &resolved_type = storage_scope.resolve_type(parameter.second);
+		if (parameter.first || !resolved_type.is_primitive() || !(resolved_type.get_primitive().is_integer() || resolved_type.get_primitive().is_char() || resolved_type.get_primitive().is_boolean())) {
+			return std::nullopt;
+		}
+		type_extents.push_back(resolved_type.get_primitive().is_boolean() ? 2 : resolved_type.get_primitive().is_char() ? 256 : max_memo_table_entries);
+		integer_parameters.push_back(resolved_type.get_primitive().is_integer());
+	}
+
+	// Size the table from the parameters' types: first give each boolean
+	// and char parameter, smallest type first, as much as its type can hold
+	// (or an equal share of the entries, if they don't all fit), and then
+	// share what is left equally between the integer parameters.
+	std::vector<uint32_t> extents(type_extents.size(), 1);
+	uint32_t remaining_entries = max_memo_table_entries;
+	for (const bool is_integer_pass : {false, true}) {
+		std::vector<std::vector<uint32_t>::size_type> pass_parameters;
+		for (std::vector<uint32_t>::size_type parameter_index = 0; parameter_index < type_extents.size(); ++parameter_index) {
+			if (integer_parameters[parameter_index] == is_integer_pass) {
+				pass_parameters.push_back(parameter_index);
+			}
+		}
+		std::stable_sort(pass_parameters.begin(), pass_parameters.end(), [&type_extents](std::vector<uint32_t>::size_type a, std::vector<uint32_t>::size_type b) -> bool {
+			return type_extents[a] < type_extents[b];
+		});
+
+		for (const std::vector<uint32_t>::size_type &parameter_index : std::as_const(pass_parameters)) {
+			const uint64_t remaining_parameters = pass_parameters.size() - (&parameter_index - &pass_parameters[0]);
+
+			uint32_t extent = 1;
+			for (;;) {
+				uint64_t entries = 1;
+				for (uint64_t i = 0; i < remaining_parameters; ++i) {
+					entries *= 2 * extent;
+				}
+				if (entries > remaining_entries || 2 * extent > type_extents[parameter_index]) {
+					break;
+				}
+				extent *= 2;
+			}
+			extents[parameter_index] = extent;
+			remaining_entries /= extent;
+		}
+	}
 
-	// Handle Semantics::Block-local variables (there are none currently).
-	for (const std::pair<std::string, TypeIndex> &local_variable : std::as_const(block_semantics.local_variables)) {
-		const std::string &local_variable_identifier = local_variable.first;
-		const TypeIndex   &local_variable_type       = local_variable.second;
+	const Symbol &location = routine_declaration.location;
+	return MemoTable(
+		Symbol(location.prefix, location.requested_suffix + "_body", location.unique_identifier),
+		Symbol("memo_", location.requested_suffix, location.unique_identifier),
+		Symbol("memo_", location.requested_suffix + "_valid", location.unique_identifier),
+		extents,
+		storage_scope.resolve_type(*routine_declaration.output).get_primitive().is_word()
+	);
+}
 
-		// Fail if the variable type is not fixed width.
-		if (!storage_scope.type(local_variable_type).get_fixed_width()) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: local variable ``"
-				<< local_variable_identifier
-				<< "\" has a non-fixed-width size in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"; non-fixed-width size variables are currently unsupported."
-				;
-			throw SemanticsError(sstr.str());
-		}
+std::vector<Semantics::Output::Line> Semantics::get_memo_lines(const MemoTable &memo_table, uint64_t num_parameters) const {
+	std::vector<Output::Line> lines;
 
-		// This is a Semantics::Block variable.  Make sure this doesn't shadow any Body variables.
-		//
-		// Note: if enabling shadowing, the conflict here would need an
-		// alternative implementation to be handled correctly, or else both
-		// variables would refer to the same storage, not to different
-		// storages.
-		//
-		// (Actually, semantic block variables won't arise because they aren't
-		// introduced in statements.)
-		if (local_variables.find(local_variable_identifier) != local_variables.cend()) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: local variable ``"
-				<< local_variable_identifier
-				<< "\" would shadow an outer-level variable in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"."
-				;
-			if (permit_shadowing) {
-				sstr << std::endl << "TODO: implement shadowing of semantic block variables by variables in outer scopes.";
+	// The index of the arguments' entry, into $t9.  Each argument is in
+	// range and each extent is a power of 2, so with MIPS32 Release 2, "ins"
+	// can put each argument's bits in place.
+	const auto add_index_lines = [this, &lines, &memo_table]() -> void {
+		lines.push_back("\tla    $t9, ($a0)");
+		uint32_t shift = 0;
+		for (std::vector<uint32_t>::size_type parameter_index = 1; parameter_index < memo_table.extents.size(); ++parameter_index) {
+			for (uint32_t extent = memo_table.extents[parameter_index - 1]; extent > 1; extent /= 2) {
+				++shift;
+			}
+			uint32_t bits = 0;
+			for (uint32_t extent = memo_table.extents[parameter_index]; extent > 1; extent /= 2) {
+				++bits;
+			}
+			if        (architecture < mips32r2_architecture) {
+				lines.push_back("\tsll   $t8, $a" + std::to_string(parameter_index) + ", " + std::to_string(shift));
+				lines.push_back("\taddu  $t9, $t9, $t8");
+			} else if (bits > 0) {
+				lines.push_back("\tins   $t9, $a" + std::to_string(parameter_index) + ", " + std::to_string(shift) + ", " + std::to_string(bits));
 			}
-			throw SemanticsError(sstr.str());
 		}
+	};
 
-		// Make sure this variable doesn't shadow any parameters.
-		//
-		// (This check can safely be disabled if enabling shadowing.)
-		if (!permit_shadowing && in_parameter_identifiers.find(local_variable_identifier) != in_parameter_identifiers.cend()) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: local variable ``"
-				<< local_variable_identifier
-				<< "\" would shadow a parameter in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"."
-				;
-			throw SemanticsError(sstr.str());
+	const Symbol miss_symbol(memo_table.values_symbol.prefix, memo_table.values_symbol.requested_suffix + "_miss", memo_table.values_symbol.unique_identifier);
+	const int32_t frame_size = Instruction::AddSp::round_to_align(4 + 4 * static_cast<int32_t>(num_parameters));
+
+	// Are the arguments in the table?
+	for (std::vector<uint32_t>::size_type parameter_index = 0; parameter_index < memo_table.extents.size(); ++parameter_index) {
+		lines.push_back("\tsltiu $t9, $a" + std::to_string(parameter_index) + ", " + std::to_string(memo_table.extents[parameter_index]));
+		lines.push_back(Output::Line("\tbeq   $t9, $zero, ") + memo_table.body_location);
+	}
+
+	// Has the result been computed?
+	add_index_lines();
+	lines.push_back(Output::Line("\tla    $t8, ") + memo_table.valid_symbol);
+	lines.push_back("\taddu  $t8, $t8, $t9");
+	lines.push_back("\tlb    $t8, ($t8)");
+	lines.push_back(Output::Line("\tbeq   $t8, $zero, ") + miss_symbol);
+	if (memo_table.is_word) {
+		lines.push_back("\tsll   $t9, $t9, 2");
+	}
+	lines.push_back(Output::Line("\tla    $t8, ") + memo_table.values_symbol);
+	lines.push_back("\taddu  $t8, $t8, $t9");
+	lines.push_back(memo_table.is_word ? "\tlw    $v0, ($t8)" : "\tlb    $v0, ($t8)");
+	lines.push_back("\tjr    $ra");
+
+	// Otherwise, compute it and record it.
+	lines.push_back({":", miss_symbol});
+	lines.push_back("\taddiu $sp, $sp, " + std::to_string(-frame_size));
+	lines.push_back("\tsw    $ra, ($sp)");
+	for (uint64_t parameter_index = 0; parameter_index < num_parameters; ++parameter_index) {
+		lines.push_back("\tsw    $a" + std::to_string(parameter_index) + ", " + std::to_string(4 + 4 * parameter_index) + "($sp)");
+	}
+	lines.push_back(Output::Line("\tjal   ") + memo_table.body_location);
+	for (uint64_t parameter_index = 0; parameter_index < num_parameters; ++parameter_index) {
+		lines.push_back("\tlw    $a" + std::to_string(parameter_index) + ", " + std::to_string(4 + 4 * parameter_index) + "($sp)");
+	}
+	lines.push_back("\tlw    $ra, ($sp)");
+	lines.push_back("\taddiu $sp, $sp, " + std::to_string(frame_size));
+	add_index_lines();
+	if (memo_table.is_word) {
+		lines.push_back("\tsll   $t9, $t9, 2");
+	}
+	lines.push_back(Output::Line("\tla    $t8, ") + memo_table.values_symbol);
+	lines.push_back("\taddu  $t8, $t8, $t9");
+	lines.push_back(memo_table.is_word ? "\tsw    $v0, ($t8)" : "\tsb    $v0, ($t8)");
+	add_index_lines();
+	lines.push_back(Output::Line("\tla    $t8, ") + memo_table.valid_symbol);
+	lines.push_back("\taddu  $t8, $t8, $t9");
+	lines.push_back("\tli    $t9, 1");
+	lines.push_back("\tsb    $t9, ($t8)");
+	lines.push_back("\tjr    $ra");
+
+	return lines;
+}
+
+bool Semantics::may_scalarize_record(uint64_t lexeme_begin, uint64_t lexeme_end, const std::string &identifier, const Type::Record &record) const {
+	// Skip whitespace and comments.
+	std::vector<uint64_t> tokens;
+	for (uint64_t lexeme_index = lexeme_begin; lexeme_index < lexeme_end && lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+		const Lexeme &lexeme = grammar.lexemes.at(lexeme_index);
+		if (!lexeme.is_whitespace() && !lexeme.is_comment()) {
+			tokens.push_back(lexeme_index);
 		}
+	}
 
-		// Make sure this variable doesn't shadow any top-level variables.
-		//
-		// (This check can safely be disabled if enabling shadowing.)
-		if (!permit_shadowing && var_scope.has(local_variable_identifier)) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: local variable ``"
-				<< local_variable_identifier
-				<< "\" would shadow a top-level variable in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"."
-				;
-			throw SemanticsError(sstr.str());
+	for (std::vector<uint64_t>::size_type token = 0; token < tokens.size(); ++token) {
+		const Lexeme &lexeme = grammar.lexemes.at(tokens[token]);
+		if (!lexeme.is_identifier() || lexeme.get_identifier().text != identifier) {
+			continue;
 		}
 
-		// Make sure this variable doesn't shadow any top-level variables.
-		//
-		// (This check can safely be disabled if enabling shadowing.)
-		if (!permit_shadowing && combine_identifier_namespaces && combined_scope.has(local_variable_identifier)) {
-			std::ostringstream sstr;
-			sstr
-				<< "Semantics::analyze_block: error: local variable ``"
-				<< local_variable_identifier
-				<< "\" has an identifier that is already assigned in another namespace in function or procedure with requested symbol suffix ``"
-				<< routine_declaration.location.requested_suffix
-				<< "\"."
-				<< "  Set combine_identifier_namespaces to false to isolate identifier namespaces"
-				<< " from each other and disable this check."
-				;
-			throw SemanticsError(sstr.str());
+		// A field of another record with the same name?
+		const Lexeme *previous = token > 0 ? &grammar.lexemes.at(tokens[token - 1]) : nullptr;
+		if (previous && previous->is_operator() && previous->get_operator().operator_ == dot_operator) {
+			continue;
 		}
 
-		// Add the variable.
-		if (available_temporary_registers.size() > 0 && (storage_scope.type(local_variable_type).get_size() == 4 || storage_scope.type(local_variable_type).get_size() == 1)) {
-			const std::string temporary_register = *available_temporary_registers.cbegin();
-			const bool is_word = !storage_scope.type(local_variable_type).is_primitive() || storage_scope.type(local_variable_type).get_primitive().is_word();
-			available_temporary_registers.erase(std::as_const(temporary_register));
-			Storage temporary_storage(is_word ? 4 : 1, false, Symbol(), std::as_const(temporary_register), false, 0, true, true);
-			local_var_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, temporary_storage))});
-			local_combined_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, temporary_storage))});
-		} else {
-			const uint32_t size = storage_scope.type(local_variable_type).get_size();
-			stack_allocated = Instruction::AddSp::round_to_align(stack_allocated + size, size, 4);
-			Storage stack_storage;
-			if (!storage_scope.type(local_variable_type).resolve_type(storage_scope).is_record() && !storage_scope.type(local_variable_type).resolve_type(storage_scope).is_array()) {
-				stack_storage = Storage(size, false, Symbol(), "$sp", true, -(stack_allocated + push_ra_allocated), false, false);
-			} else {
-				stack_storage = Storage(4, false, Symbol(), "$sp", false, -(stack_allocated + push_ra_allocated), false, false);
+		// It must be followed by a primitive field.
+		const Lexeme *next  = token + 1 < tokens.size() ? &grammar.lexemes.at(tokens[token + 1]) : nullptr;
+		const Lexeme *field = token + 2 < tokens.size() ? &grammar.lexemes.at(tokens[token + 2]) : nullptr;
+		if (!next || !next->is_operator() || next->get_operator().operator_ != dot_operator || !field || !field->is_identifier()) {
+			return false;
+		}
+		bool is_primitive_field = false;
+		for (const std::pair<std::string, TypeIndex> &record_field : std::as_const(record.fields)) {
+			if (record_field.first == field->get_identifier().text) {
+				is_primitive_field = storage_scope.resolve_type(record_field.second).is_primitive();
+				break;
 			}
-			local_var_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, stack_storage))});
-			local_combined_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, stack_storage))});
+		}
+		if (!is_primitive_field) {
+			return false;
 		}
 	}
 
-	stack_allocated = Instruction::AddSp::round_to_align(stack_allocated);
+	return true;
+}
 
-	// Get working storages.
-	std::vector<Storage> working_storages;
-	for (const uint32_t &working_storage_requirement : std::as_const(working_storage_requirements)) {
-		const std::vector<uint32_t>::size_type working_storage_requirement_index = &working_storage_requirement - &working_storage_requirements[0]; (void) working_storage_requirement_index;
+bool Semantics::may_keep_record_fields_in_registers(uint64_t lexeme_begin, uint64_t lexeme_end, const std::string &identifier) const {
+	// Skip whitespace and comments.
+	std::vector<uint64_t> tokens;
+	for (uint64_t lexeme_index = lexeme_begin; lexeme_index < lexeme_end && lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+		const Lexeme &lexeme = grammar.lexemes.at(lexeme_index);
+		if (!lexeme.is_whitespace() && !lexeme.is_comment()) {
+			tokens.push_back(lexeme_index);
+		}
+	}
 
-		// Add the working storage.
-		if (available_temporary_registers.size() > 0 && (working_storage_requirement == 4 || working_storage_requirement == 1)) {
-			const std::string temporary_register = *available_temporary_registers.cbegin();
-			const bool is_word = working_storage_requirement == 4;
-			available_temporary_registers.erase(std::as_const(temporary_register));
-			Storage temporary_storage(is_word ? 4 : 1, false, Symbol(), std::as_const(temporary_register), false, 0, true, true);
-			working_storages.push_back(temporary_storage);
-		} else {
-			const uint32_t size = working_storage_requirement;
-			stack_allocated = Instruction::AddSp::round_to_align(stack_allocated + size, size, 4);
-			Storage stack_storage;
-			if (true) {
-				stack_storage = Storage(size, false, Symbol(), "$sp", true, -(stack_allocated + push_ra_allocated), false, false);
-			} else {
+	bool is_used_in_loop = false;
+	for (std::vector<uint64_t>::size_type token = 0; token < tokens.size(); ++token) {
+		const Lexeme &lexeme = grammar.lexemes.at(tokens[token]);
+		if (!lexeme.is_identifier() || lexeme.get_identifier().text != identifier) {
+			continue;
+		}
+		is_used_in_loop = is_used_in_loop || (tokens[token] < lexeme_loop_depths.size() && lexeme_loop_depths[tokens[token]] > 0);
+
+		// Is "identifier.field" an argument by itself, other than to "write"?
+		const Lexeme    *previous          = token > 0                 ? &grammar.lexemes.at(tokens[token - 1]) : nullptr;
+		const Lexeme    *after             = token + 3 < tokens.size() ? &grammar.lexemes.at(tokens[token + 3]) : nullptr;
+		const operator_t previous_operator = previous && previous->is_operator() ? previous->get_operator().operator_ : null_operator;
+		const operator_t after_operator    = after    && after->is_operator()    ? after->get_operator().operator_    : null_operator;
+		if (
+			   (previous_operator == leftparenthesis_operator  || previous_operator == comma_operator)
+			&& (after_operator    == rightparenthesis_operator || after_operator    == comma_operator)
+		) {
+			// Find what is being called: go back to the unmatched "(".
+			uint64_t depth = 0;
+			std::vector<uint64_t>::size_type open = token;
+			while (open > 0) {
+				--open;
+				const Lexeme &open_lexeme = grammar.lexemes.at(tokens[open]);
+				if (open_lexeme.is_operator() && open_lexeme.get_operator().operator_ == rightparenthesis_operator) {
+					++depth;
+				} else if (open_lexeme.is_operator() && open_lexeme.get_operator().operator_ == leftparenthesis_operator) {
+					if (depth <= 0) {
+						break;
+					}
+					--depth;
+				}
+			}
+			const Lexeme *callee = open > 0 ? &grammar.lexemes.at(tokens[open - 1]) : nullptr;
+			if (!callee || !callee->is_keyword() || callee->get_keyword().keyword != write_keyword) {
+				return false;
+			}
+		}
+	}
+
+	return is_used_in_loop;
+}
+
+// | If the statement sequence is a single assignment, possibly followed by
+// empty statements, return it; otherwise return nullptr.
+const Assignment *Semantics::get_single_assignment(const StatementSequence &statement_sequence) const {
+	const Assignment *assignment = nullptr;
+
+	// Collect the statements in the sequence.
+	std::vector<const Statement *> statements;
+	statements.push_back(&grammar.statement_storage.at(statement_sequence.statement));
+	for (const StatementPrefixedList *last_list = &grammar.statement_prefixed_list_storage.at(statement_sequence.statement_prefixed_list); last_list->branch == StatementPrefixedList::cons_branch; ) {
+		const StatementPrefixedList::Cons &last_statement_prefixed_list_cons = grammar.statement_prefixed_list_cons_storage.at(last_list->data);
+		statements.push_back(&grammar.statement_storage.at(last_statement_prefixed_list_cons.statement));
+		last_list = &grammar.statement_prefixed_list_storage.at(last_statement_prefixed_list_cons.statement_prefixed_list);
+	}
+
+	for (const Statement *statement : std::as_const(statements)) {
+		if        (statement->branch == Statement::null__branch) {
+			continue;
+		} else if (statement->branch != Statement::assignment_branch || assignment != nullptr) {
+			return nullptr;
+		}
+		const Statement::Assignment &statement_assignment = grammar.statement_assignment_storage.at(statement->data);
+		assignment = &grammar.assignment_storage.at(statement_assignment.assignment);
+	}
+
+	return assignment;
+}
+
+// | Can the expression between these lexemes be evaluated even when its
+// value isn't used?
+bool Semantics::is_speculatable_expression(uint64_t lexeme_begin, uint64_t lexeme_end, const IdentifierScope &routine_scope) const {
+	const Lexeme *previous = nullptr;
+	for (uint64_t lexeme_index = lexeme_begin; lexeme_index < lexeme_end && lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+		const Lexeme &lexeme = grammar.lexemes.at(lexeme_index);
+		if (lexeme.is_whitespace() || lexeme.is_comment()) {
+			continue;
+		}
+
+		if (lexeme.is_operator()) {
+			const operator_t operator_ = lexeme.get_operator().operator_;
+
+			// Array indices may be out of bounds, and divisors may be 0.
+			if (operator_ == leftbracket_operator || operator_ == slash_operator || operator_ == percent_operator) {
+				return false;
+			}
+
+			// Routine calls may have side effects.
+			if (operator_ == leftparenthesis_operator && previous && previous->is_identifier() && routine_scope.has(previous->get_identifier().text)) {
+				return false;
+			}
+		}
+
+		previous = &lexeme;
+	}
+
+	return true;
+}
+
+// | Analyze a BEGIN [statement]... END block.
+Semantics::MachineCode Semantics::analyze_block(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const ::Block &block, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, IdentifierScope &var_scope, IdentifierScope &combined_scope, IdentifierScope &storage_scope, const std::map<std::string, TypeIndex> &local_variables, bool is_main, const RoutineSpecialization &specialization) {
+	// Some type aliases to improve readability.
+	using M = Semantics::MIPSIO;
+	using I = Semantics::Instruction;
+	using B = Semantics::Instruction::Base;
+	using Index = M::Index;
+	using IO    = M::IO;
+	using ConstantValue = Semantics::ConstantValue;
+	using Output        = Semantics::Output;
+	using Storage       = Semantics::Storage;
+	using Symbol        = Semantics::Symbol;
+	const LexemeKeyword      &begin_keyword0     = grammar.lexemes.at(block.begin_keyword0).get_keyword(); (void) begin_keyword0;
+	const StatementSequence  &statement_sequence = grammar.statement_sequence_storage.at(block.statement_sequence);
+	const LexemeKeyword      &end_keyword0       = grammar.lexemes.at(block.end_keyword0).get_keyword(); (void) end_keyword0;
+
+	IdentifierScope local_constant_scope(constant_scope);
+	IdentifierScope local_var_scope(var_scope);
+	IdentifierScope local_combined_scope(combined_scope);
+
+	// Initialize the routine block state.
+	RoutineBlockState routine_block_state;
+	routine_block_state.label_suffix          = specialization.label_suffix;
+	routine_block_state.routine_location      = routine_declaration.location;
+	routine_block_state.parameter_identifiers = parameter_identifiers;
+
+	// Ensure routine_declaration.parameters has the same length as parameter_identifiers.
+	if (routine_declaration.parameters.size() != parameter_identifiers.size()) {
+		std::ostringstream sstr;
+		sstr
+			<< "Semantics::analyze_block: internal error: routine_declaration.parameters with length "
+			<< routine_declaration.parameters.size()
+			<< " has a different length than parameter_identifiers with length "
+			<< parameter_identifiers.size()
+			<< "."
+			;
+		throw SemanticsError(sstr.str());
+	}
+
+	// Put parameter_identifiers in a set for lookup.
+	std::set<std::string> in_parameter_identifiers;
+	for (const std::string &parameter_identifier : std::as_const(parameter_identifiers)) {
+		in_parameter_identifiers.insert(parameter_identifier);
+	}
+
+	// Get cleanup symbol.
+	const Symbol cleanup_symbol(routine_declaration.location.prefix, routine_declaration.location.requested_suffix + "_cleanup", routine_declaration.location.unique_identifier);
+
+	// Prepare output vector.
+	std::vector<Output::Line> output_lines;
+
+	// Get temporary registers we can use.
+	static const std::set<std::string> temporary_registers {
+		"$t0",
+		"$t1",
+		"$t2",
+		"$t3",
+		"$t4",
+		"$t5",
+		"$t6",
+		"$t7",
+	};
+	std::set<std::string> available_temporary_registers(temporary_registers);
+
+	// Assign variables and working storage units to Storages and allocate
+	// sufficient space on the stack.
+	//
+	// Take into account that we will first push the return address.
+	const int32_t push_ra_allocated = Instruction::AddSp::round_to_align(4);
+	int32_t stack_allocated = 0;
+
+	// Frame slots, by offset, to pack once the emission schedule is known.
+	std::map<int32_t, uint32_t>       stack_slot_sizes;
+	std::set<int32_t>                 fixed_stack_slots;  // Arrays and records, which are addressed.
+	std::map<Storage::Index, int32_t> working_storage_slots;
+
+	// Commented out: these are already copied on a call!  Instead, just add a binding to the appropriate storage.  We do that here.
+#if 0
+	// Normally, we'd handle parameters here, but calculate other sizes first.
+#endif /* #if 0 */
+	// Handle parameters.
+	uint32_t stack_argument_total_size = 0;
+	for (const std::pair<bool, TypeIndex> &parameter : std::as_const(routine_declaration.parameters)) {
+		const std::vector<std::pair<bool, TypeIndex>>::size_type   parameter_index      = &parameter - &routine_declaration.parameters[0];
+		const std::string                                         &parameter_identifier = parameter_identifiers[parameter_index];
+
+		const bool      parameter_is_ref = parameter.first;
+		const TypeIndex parameter_type   = parameter.second;
+
+		// Fail if the parameter type is not fixed width.
+		if (!storage_scope.type(parameter_type).get_fixed_width()) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: parameter ``"
+				<< parameter_identifier
+				<< "\" has a non-fixed-width size in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"; non-fixed-width size parameters are currently unsupported."
+				;
+			throw SemanticsError(sstr.str());
+		}
+
+		// Make sure this variable doesn't shadow any top-level variables.
+		//
+		// (This check can safely be disabled if enabling shadowing.)
+		if (!permit_shadowing && var_scope.has(parameter_identifier)) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: parameter ``"
+				<< parameter_identifier
+				<< "\" would shadow a top-level variable in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"."
+				;
+			throw SemanticsError(sstr.str());
+		}
+
+		// Make sure this variable doesn't shadow any top-level variables.
+		//
+		// (This check can safely be disabled if enabling shadowing.)
+		if (!permit_shadowing && combine_identifier_namespaces && combined_scope.has(parameter_identifier)) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: parameter ``"
+				<< parameter_identifier
+				<< "\" has an identifier that is already assigned in another namespace in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"."
+				<< "  Set combine_identifier_namespaces to false to isolate identifier namespaces"
+				<< " from each other and disable this check."
+				;
+			throw SemanticsError(sstr.str());
+		}
+
+		// Is this a specialized copy of the routine that bakes in a constant
+		// argument for this parameter?  Then bind the parameter as a
+		// constant; the caller still passes it, but it goes unread.
+		const bool is_constant_parameter =
+			   parameter_index < specialization.arguments.size()
+			&& specialization.arguments[parameter_index].has_value()
+			&& !parameter_is_ref
+			&& !var_scope.has(parameter_identifier)
+			&& !local_constant_scope.has(parameter_identifier)
+			&& local_variables.find(parameter_identifier) == local_variables.cend()
+			;
+		if (is_constant_parameter) {
+			local_constant_scope.insert({parameter_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Static(*specialization.arguments[parameter_index]))});
+			local_combined_scope.insert({parameter_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Static(*specialization.arguments[parameter_index]))});
+		}
+
+		// We've done checking, but don't add the variable bindings until we know how much stack space we will allocate.
+		const bool is_primitive_and_ref  = parameter_is_ref && storage_scope.resolve_type(parameter_type).is_primitive();
+		const bool is_resolved_type_word = !storage_scope.resolve_type(parameter_type).is_primitive() || storage_scope.resolve_type(parameter_type).get_primitive().is_word();
+		const bool is_nonprimitive = storage_scope.type(parameter_type).resolve_type(storage_scope).is_array() || storage_scope.type(parameter_type).resolve_type(storage_scope).is_record();
+		if (parameter_index < 4) {
+			const bool is_word = is_resolved_type_word || parameter_is_ref;
+
+			Storage parameter_storage
+				= !is_primitive_and_ref || is_nonprimitive
+				? Storage("$a" + std::to_string(parameter_index))                                    // Just use $a directly; don't dereference.  (Primitive Var.)
+				: Storage("$a" + std::to_string(parameter_index), is_resolved_type_word ? 4 : 1, 0)  // The variable should dereference an address.
+				;
+
+			if (!is_word) {
+				parameter_storage.max_size = 1;
+			}
+
+			if (!is_constant_parameter) {
+				local_var_scope.insert({parameter_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(parameter_type, parameter_storage))});
+				local_combined_scope.insert({parameter_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(parameter_type, parameter_storage))});
+			}
+		} else {
+			const bool is_word = is_resolved_type_word || parameter_is_ref;
+
+			stack_argument_total_size = Instruction::AddSp::round_to_align(stack_argument_total_size, is_word ? 4 : 1, 4);
+
+			// If it's an array, this storage dereferences the argument to get the real pointer to the beginning of the array.  (The first element involves 2 dereferences.)
+			const Storage parameter_storage
+				= !is_primitive_and_ref
+				? Storage(is_word ? 4 : 1, false, Symbol(), "$sp", true, stack_argument_total_size, false, false)
+				: Storage(is_word ? 4 : 1, false, Symbol(), "$sp", true, stack_argument_total_size, false, false)
+				;
+
+			stack_argument_total_size += is_word ? 4 : 1;
+
+			if (!is_constant_parameter) {
+				local_var_scope.insert({parameter_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(parameter_type, parameter_storage, is_primitive_and_ref))});
+				local_combined_scope.insert({parameter_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(parameter_type, parameter_storage, is_primitive_and_ref))});
+			}
+		}
+	}
+	stack_argument_total_size = Instruction::AddSp::round_to_align(stack_argument_total_size);
+
+	routine_block_state.last_stack_argument_total_size = stack_argument_total_size;
+
+	// Handle local variables.
+	for (const std::pair<std::string, TypeIndex> &local_variable : std::as_const(local_variables)) {
+		const std::string &local_variable_identifier = local_variable.first;
+		const TypeIndex   &local_variable_type       = local_variable.second;
+
+		// Fail if the variable type is not fixed width.
+		if (!storage_scope.type(local_variable_type).get_fixed_width()) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: local variable ``"
+				<< local_variable_identifier
+				<< "\" has a non-fixed-width size in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"; non-fixed-width size variables are currently unsupported."
+				;
+			throw SemanticsError(sstr.str());
+		}
+
+		// Make sure this variable doesn't shadow any parameters.
+		//
+		// (This check can safely be disabled if enabling shadowing.)
+		if (!permit_shadowing && in_parameter_identifiers.find(local_variable_identifier) != in_parameter_identifiers.cend()) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: local variable ``"
+				<< local_variable_identifier
+				<< "\" would shadow a parameter in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"."
+				;
+			throw SemanticsError(sstr.str());
+		}
+
+		// Make sure this variable doesn't shadow any top-level variables.
+		//
+		// (This check can safely be disabled if enabling shadowing.)
+		if (!permit_shadowing && var_scope.has(local_variable_identifier)) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: local variable ``"
+				<< local_variable_identifier
+				<< "\" would shadow a top-level variable in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"."
+				;
+			throw SemanticsError(sstr.str());
+		}
+
+		// Make sure this variable doesn't shadow any top-level variables.
+		//
+		// (This check can safely be disabled if enabling shadowing.)
+		if (!permit_shadowing && combine_identifier_namespaces && combined_scope.has(local_variable_identifier)) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: local variable ``"
+				<< local_variable_identifier
+				<< "\" has an identifier that is already assigned in another namespace in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"."
+				<< "  Set combine_identifier_namespaces to false to isolate identifier namespaces"
+				<< " from each other and disable this check."
+				;
+			throw SemanticsError(sstr.str());
+		}
+
+		// Replace a record that is only accessed a field at a time by a
+		// variable per field, which can then be kept in a register.
+		if (optimize && storage_scope.resolve_type(local_variable_type).is_record() && may_scalarize_record(block.begin_keyword0, block.end_keyword0, local_variable_identifier, storage_scope.resolve_type(local_variable_type).get_record())) {
+			std::map<std::string, IdentifierScope::IdentifierBinding::Var> &fields = routine_block_state.scalar_records[local_variable_identifier];
+			const bool may_keep_fields_in_registers = may_keep_record_fields_in_registers(block.begin_keyword0, block.end_keyword0, local_variable_identifier);
+
+
+			for (const std::pair<std::string, TypeIndex> &field : std::as_const(storage_scope.resolve_type(local_variable_type).get_record().fields)) {
+				if (!storage_scope.resolve_type(field.second).is_primitive()) {
+					continue;
+				}
+				const bool     is_word = storage_scope.resolve_type(field.second).get_primitive().is_word();
+				const uint32_t size    = is_word ? 4 : 1;
+				Storage field_storage;
+				if (may_keep_fields_in_registers && available_temporary_registers.size() > min_scalar_record_working_registers) {
+					const std::string temporary_register = *available_temporary_registers.cbegin();
+					available_temporary_registers.erase(std::as_const(temporary_register));
+					field_storage = Storage(size, false, Symbol(), std::as_const(temporary_register), false, 0, true, true);
+				} else {
+					stack_allocated = Instruction::AddSp::round_to_align(stack_allocated + size, size);
+					field_storage = Storage(size, false, Symbol(), "$sp", true, -(stack_allocated + push_ra_allocated), false, false);
+					stack_slot_sizes.insert({field_storage.offset, size});
+				}
+				fields.insert({field.first, IdentifierScope::IdentifierBinding::Var(field.second, field_storage)});
+			}
+			continue;
+		}
+
+		// Add the variable.
+		if (available_temporary_registers.size() > 0 && (storage_scope.type(local_variable_type).get_size() == 4 || storage_scope.type(local_variable_type).get_size() == 1) && storage_scope.resolve_type(local_variable_type).is_primitive()) {
+			const std::string temporary_register = *available_temporary_registers.cbegin();
+			const bool is_word = !storage_scope.type(local_variable_type).is_primitive() || storage_scope.type(local_variable_type).get_primitive().is_word();
+			available_temporary_registers.erase(std::as_const(temporary_register));
+			Storage temporary_storage(is_word ? 4 : 1, false, Symbol(), std::as_const(temporary_register), false, 0, true, true);
+			local_var_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, temporary_storage))});
+			local_combined_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, temporary_storage))});
+		} else {
+			const uint32_t size = storage_scope.type(local_variable_type).get_size();
+			stack_allocated = Instruction::AddSp::round_to_align(stack_allocated + size, storage_scope.type(local_variable_type).get_alignment());
+			Storage stack_storage;
+			if (!storage_scope.type(local_variable_type).resolve_type(storage_scope).is_record() && !storage_scope.type(local_variable_type).resolve_type(storage_scope).is_array()) {
+				stack_storage = Storage(size, false, Symbol(), "$sp", true, -(stack_allocated + push_ra_allocated), false, false);
+			} else {
+				stack_storage = Storage(4, false, Symbol(), "$sp", false, -(stack_allocated + push_ra_allocated), false, false);
+				fixed_stack_slots.insert(stack_storage.offset);
+			}
+			stack_slot_sizes.insert({stack_storage.offset, size});
+			local_var_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, stack_storage))});
+			local_combined_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, stack_storage))});
+		}
+	}
+
+	// Reserve a frame slot for the result of each readonly call that is
+	// repeated in the block or that appears in a while condition, so a
+	// statement can compute it once.
+	if (optimize) {
+		for (const std::pair<bool, TypeIndex> &parameter : std::as_const(routine_declaration.parameters)) {
+			if (!parameter.first) {
+				routine_block_state.local_identifiers.insert(parameter_identifiers.at(&parameter - &routine_declaration.parameters[0]));
+			}
+		}
+		for (const std::pair<const std::string, TypeIndex> &local_variable : std::as_const(local_variables)) {
+			routine_block_state.local_identifiers.insert(local_variable.first);
+		}
+
+		std::map<std::string, std::pair<uint64_t, bool>> call_keys;  // key -> {count, is_word}
+		bool is_while_condition = false;
+		for (uint64_t lexeme_index = block.begin_keyword0; lexeme_index < block.end_keyword0; ++lexeme_index) {
+			const Lexeme &lexeme = grammar.lexemes.at(lexeme_index);
+			if (lexeme.is_keyword() && lexeme.get_keyword().keyword == while_keyword) {
+				is_while_condition = true;
+			} else if (lexeme.is_keyword() && lexeme.get_keyword().keyword == do_keyword) {
+				is_while_condition = false;
+			} else if (is_readonly_call(lexeme_index, routine_scope)) {
+				const TypeIndex output_type = *routine_scope.get(lexeme.get_identifier().text).get_routine_declaration().output;
+				std::pair<uint64_t, bool> &call_key = call_keys[get_call_key(lexeme_index).first];
+				call_key.first  += is_while_condition ? 2 : 1;
+				call_key.second  = storage_scope.resolve_type(output_type).get_primitive().is_word();
+			}
+		}
+
+		for (const std::pair<const std::string, std::pair<uint64_t, bool>> &call_key : std::as_const(call_keys)) {
+			if (call_key.second.first < 2) {
+				continue;
+			}
+			const uint32_t size = call_key.second.second ? 4 : 1;
+			stack_allocated = Instruction::AddSp::round_to_align(stack_allocated + size, size);
+			const Storage stack_storage(size, false, Symbol(), "$sp", true, -(stack_allocated + push_ra_allocated), false, false);
+			stack_slot_sizes.insert({stack_storage.offset, size});
+			routine_block_state.call_result_storages.insert({call_key.first, stack_storage});
+		}
+	}
+
+	stack_allocated = Instruction::AddSp::round_to_align(stack_allocated);
+
+	// Analyze the statements in the block.
+	routine_block_state.dynamically_allocated = 0;
+	Block block_semantics = analyze_statements(routine_declaration, statement_sequence, local_constant_scope, type_scope, routine_scope, local_var_scope, local_combined_scope, storage_scope, cleanup_symbol, routine_block_state);
+
+	// Make sure front and back are valid by making sure there is at least one instruction.
+	if (block_semantics.instructions.instructions.size() <= 0) {
+		block_semantics.front = block_semantics.back = block_semantics.instructions.add_instruction({I::Ignore(B(), false, false)});
+	}
+
+	// Optimize.
+	if (optimize) {
+		block_semantics.instructions.optimize();
+	}
+
+	// Working storage units beyond the remaining temporaries are spilled.
+	block_semantics.instructions.register_budget = available_temporary_registers.size();
+
+	// Get working storage requirements.
+	MIPSIO::Schedule schedule;
+	std::pair<std::vector<uint32_t>, std::vector<uint64_t>> prepare_permutation = block_semantics.instructions.prepare_permutation(std::set<IO>(), {block_semantics.back}, &schedule);
+	const std::vector<uint32_t> &working_storage_requirements = prepare_permutation.first;
+	const std::vector<uint64_t> &permutation                  = prepare_permutation.second;
+
+	// Handle Semantics::Block-local variables (there are none currently).
+	for (const std::pair<std::string, TypeIndex> &local_variable : std::as_const(block_semantics.local_variables)) {
+		const std::string &local_variable_identifier = local_variable.first;
+		const TypeIndex   &local_variable_type       = local_variable.second;
+
+		// Fail if the variable type is not fixed width.
+		if (!storage_scope.type(local_variable_type).get_fixed_width()) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: local variable ``"
+				<< local_variable_identifier
+				<< "\" has a non-fixed-width size in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"; non-fixed-width size variables are currently unsupported."
+				;
+			throw SemanticsError(sstr.str());
+		}
+
+		// This is a Semantics::Block variable.  Make sure this doesn't shadow any Body variables.
+		//
+		// Note: if enabling shadowing, the conflict here would need an
+		// alternative implementation to be handled correctly, or else both
+		// variables would refer to the same storage, not to different
+		// storages.
+		//
+		// (Actually, semantic block variables won't arise because they aren't
+		// introduced in statements.)
+		if (local_variables.find(local_variable_identifier) != local_variables.cend()) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: local variable ``"
+				<< local_variable_identifier
+				<< "\" would shadow an outer-level variable in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"."
+				;
+			if (permit_shadowing) {
+				sstr << std::endl << "TODO: implement shadowing of semantic block variables by variables in outer scopes.";
+			}
+			throw SemanticsError(sstr.str());
+		}
+
+		// Make sure this variable doesn't shadow any parameters.
+		//
+		// (This check can safely be disabled if enabling shadowing.)
+		if (!permit_shadowing && in_parameter_identifiers.find(local_variable_identifier) != in_parameter_identifiers.cend()) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: local variable ``"
+				<< local_variable_identifier
+				<< "\" would shadow a parameter in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"."
+				;
+			throw SemanticsError(sstr.str());
+		}
+
+		// Make sure this variable doesn't shadow any top-level variables.
+		//
+		// (This check can safely be disabled if enabling shadowing.)
+		if (!permit_shadowing && var_scope.has(local_variable_identifier)) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: local variable ``"
+				<< local_variable_identifier
+				<< "\" would shadow a top-level variable in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"."
+				;
+			throw SemanticsError(sstr.str());
+		}
+
+		// Make sure this variable doesn't shadow any top-level variables.
+		//
+		// (This check can safely be disabled if enabling shadowing.)
+		if (!permit_shadowing && combine_identifier_namespaces && combined_scope.has(local_variable_identifier)) {
+			std::ostringstream sstr;
+			sstr
+				<< "Semantics::analyze_block: error: local variable ``"
+				<< local_variable_identifier
+				<< "\" has an identifier that is already assigned in another namespace in function or procedure with requested symbol suffix ``"
+				<< routine_declaration.location.requested_suffix
+				<< "\"."
+				<< "  Set combine_identifier_namespaces to false to isolate identifier namespaces"
+				<< " from each other and disable this check."
+				;
+			throw SemanticsError(sstr.str());
+		}
+
+		// Add the variable.
+		if (available_temporary_registers.size() > 0 && (storage_scope.type(local_variable_type).get_size() == 4 || storage_scope.type(local_variable_type).get_size() == 1)) {
+			const std::string temporary_register = *available_temporary_registers.cbegin();
+			const bool is_word = !storage_scope.type(local_variable_type).is_primitive() || storage_scope.type(local_variable_type).get_primitive().is_word();
+			available_temporary_registers.erase(std::as_const(temporary_register));
+			Storage temporary_storage(is_word ? 4 : 1, false, Symbol(), std::as_const(temporary_register), false, 0, true, true);
+			local_var_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, temporary_storage))});
+			local_combined_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, temporary_storage))});
+		} else {
+			const uint32_t size = storage_scope.type(local_variable_type).get_size();
+			stack_allocated = Instruction::AddSp::round_to_align(stack_allocated + size, storage_scope.type(local_variable_type).get_alignment());
+			Storage stack_storage;
+			if (!storage_scope.type(local_variable_type).resolve_type(storage_scope).is_record() && !storage_scope.type(local_variable_type).resolve_type(storage_scope).is_array()) {
+				stack_storage = Storage(size, false, Symbol(), "$sp", true, -(stack_allocated + push_ra_allocated), false, false);
+			} else {
+				stack_storage = Storage(4, false, Symbol(), "$sp", false, -(stack_allocated + push_ra_allocated), false, false);
+				fixed_stack_slots.insert(stack_storage.offset);
+			}
+			stack_slot_sizes.insert({stack_storage.offset, size});
+			local_var_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, stack_storage))});
+			local_combined_scope.insert({local_variable_identifier, IdentifierScope::IdentifierBinding(IdentifierScope::IdentifierBinding::Var(local_variable_type, stack_storage))});
+		}
+	}
+
+	stack_allocated = Instruction::AddSp::round_to_align(stack_allocated);
+
+	// Get working storages.
+	std::vector<Storage> working_storages;
+	for (const uint32_t &working_storage_requirement : std::as_const(working_storage_requirements)) {
+		const std::vector<uint32_t>::size_type working_storage_requirement_index = &working_storage_requirement - &working_storage_requirements[0]; (void) working_storage_requirement_index;
+
+		// Add the working storage.
+		if (available_temporary_registers.size() > 0 && (working_storage_requirement == 4 || working_storage_requirement == 1)) {
+			const std::string temporary_register = *available_temporary_registers.cbegin();
+			const bool is_word = working_storage_requirement == 4;
+			available_temporary_registers.erase(std::as_const(temporary_register));
+			Storage temporary_storage(is_word ? 4 : 1, false, Symbol(), std::as_const(temporary_register), false, 0, true, true);
+			working_storages.push_back(temporary_storage);
+		} else {
+			// A spill keeps its value's width even if its range fits in a
+			// byte; see MIPSIO::get_value_ranges.
+			const uint32_t size = working_storage_requirement;
+			stack_allocated = Instruction::AddSp::round_to_align(stack_allocated + size, size, 4);
+			Storage stack_storage;
+			if (true) {
+				stack_storage = Storage(size, false, Symbol(), "$sp", true, -(stack_allocated + push_ra_allocated), false, false);
+			} else {
 				stack_storage = Storage(4, false, Symbol(), "$sp", false, -(stack_allocated + push_ra_allocated), false, false);
 			}
-			working_storages.push_back(stack_storage);
+			stack_slot_sizes.insert({stack_storage.offset, size});
+			working_storage_slots.insert({working_storages.size(), stack_storage.offset});
+			working_storages.push_back(stack_storage);
+		}
+	}
+
+	// Let locals and spilled working storages with disjoint lifetimes share
+	// frame slots.
+	if (optimize) {
+		const std::map<int32_t, int32_t> stack_slot_offsets = share_stack_slots(block_semantics.instructions, schedule, stack_slot_sizes, fixed_stack_slots, working_storage_slots, push_ra_allocated, stack_allocated);
+		block_semantics.instructions.remap_stack_slots(stack_slot_offsets);
+		for (const std::pair<const Storage::Index, int32_t> &working_storage_slot : std::as_const(working_storage_slots)) {
+			std::map<int32_t, int32_t>::const_iterator stack_slot_offsets_search = stack_slot_offsets.find(working_storage_slot.second);
+			if (stack_slot_offsets_search != stack_slot_offsets.cend()) {
+				working_storages[working_storage_slot.first].offset = stack_slot_offsets_search->second;
+			}
+		}
+	}
+
+	stack_allocated = Instruction::AddSp::round_to_align(stack_allocated);
+
+	// Start our chain of sequenced intro instructions.
+	Index last_intro_index = block_semantics.instructions.add_instruction({I::Ignore(B(), false, false)});
+	const Index first_intro_index = last_intro_index;
+
+	// Give the cleanup routine a label.
+	block_semantics.back = block_semantics.instructions.add_instruction({I::Ignore(B(true, cleanup_symbol), false, false)}, {}, block_semantics.back);
+
+	// Set up intro and cleanup sections.
+
+	// $sp now points to the first argument.
+
+	// TODO: possible optimization: this is unnecessary if there are no calls or jumps.
+	// Push the return address.
+	last_intro_index     = block_semantics.instructions.add_instruction({I::AddSp(B(), -4)}, {}, last_intro_index);
+	last_intro_index     = block_semantics.instructions.add_instruction({I::LoadFrom(B(), true, true, 0, true, true, Storage("$sp", 4, 0, true), Storage("$ra"), false, false)}, {}, last_intro_index);
+
+	// Allocate space on the stack.
+	if (stack_allocated != 0) {
+		last_intro_index = block_semantics.instructions.add_instruction({I::AddSp(B(), -stack_allocated)}, {}, last_intro_index);
+	}
+
+	// Allocate the total dynamic allocations on the stack (known at compile-time) needed by the block after aligning it.
+	// Make a marker for it.
+	const int32_t dynamically_allocated = Instruction::AddSp::round_to_align(routine_block_state.dynamically_allocated);
+	if (routine_block_state.dynamically_allocated != 0) {
+		last_intro_index = block_semantics.instructions.add_instruction({I::AddSp(B(), Instruction::AddSp::round_to_align(-routine_block_state.dynamically_allocated), "dynamic")}, {}, last_intro_index);
+	}
+
+	// Commented out: these are already copied on a call!  Instead, just add a binding to the appropriate storage.  We do that above.
+#if 0
+	// Now load all arguments as copies.  This does not need to be reversed; callers push and pop arguments when calling.
+	uint32_t stack_argument_total_size = 0;
+	for (const std::pair<bool, TypeIndex> &parameter : std::as_const(routine_declaration.parameters)) {
+		const std::vector<std::pair<bool, TypeIndex>>::size_type   parameter_index      = &parameter - &routine_declaration.parameters[0];
+		const std::string                                         &parameter_identifier = parameter_identifiers[parameter_index];
+
+		const bool       parameter_is_ref = parameter.first;
+		const TypeIndex &parameter_type   = parameter.second;
+
+		if (parameter_index >= 4) {
+			if        (!all_arrays_records_are_refs && !parameter_is_ref && !storage_scope.type(parameter_type).resolve_type(storage_scope).is_primitive()) {
+				// TODO: copy arrays and records.
+				std::ostringstream sstr;
+				sstr << "Semantics::analyze_block: error: copying of arrays and records for non-Ref vars in arguments is currently not supported.";
+				throw SemanticsError(sstr.str());
+			} else if (!parameter_is_ref && !storage_scope.type(parameter_type).get_fixed_width()) {
+				std::ostringstream sstr;
+				sstr << "Semantics::analyze_block: error: loading non-fixed-width arguments is not supported.";
+				throw SemanticsError(sstr.str());
+			} else if (!parameter_is_ref && storage_scope.type(parameter_type).get_size() != 4 && storage_scope.type(parameter_type).get_size() != 1) {
+				std::ostringstream sstr;
+				sstr << "Semantics::analyze_block: error: loading fixed-width variable non-array/non-record arguments of size neither 4 nor 1 is currently not supported.";
+				throw SemanticsError(sstr.str());
+			} else {
+				const bool is_word = !storage_scope.type(parameter_type).is_primitive() || storage_scope.type(parameter_type).get_primitive().is_word();
+
+				// Lookup the identifier binding in var_scope for the argument.
+				if (!var_scope.has(parameter_identifier)) {
+					std::ostringstream sstr;
+					sstr << "Semantics::analyze_block: error: parameter identifier ``" << parameter_identifier << "\" was provided but the var scope that was provided does not contain it.";
+					throw SemanticsError(sstr.str());
+				}
+				const IdentifierScope::IdentifierBinding::Var &var = var_scope.get(parameter_identifier).get_var();
+
+				Storage source_storage(is_word ? 4 : 1, false, Symbol(), "$sp", true, stack_allocated + Instruction::AddSp::round_to_align(4) + stack_argument_total_size, true, false);
+				stack_argument_total_size += Instruction::AddSp::round_to_align(source_storage.max_size);
+
+				last_intro_index = block_semantics.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, true, true, var.storage, source_storage, false, false)}, {}, {last_intro_index});
+
+				// Note: "no_sp_adjust" is "false" here, and "stack_allocated" and the $ra push is removed.
+				Storage var_storage(is_word ? 4 : 1, false, Symbol(), "$sp", true, stack_argument_total_size, false, false);
+			}
+		}
+	}
+#endif /* #if 0 */
+
+	// Reverse what intro did.
+	if (routine_block_state.dynamically_allocated != 0) {
+		block_semantics.back = block_semantics.instructions.add_instruction({I::AddSp(B(), Instruction::AddSp::round_to_align(routine_block_state.dynamically_allocated))}, {}, block_semantics.back);
+		routine_block_state.dynamically_allocated = 0;
+	}
+	if (stack_allocated != 0) {
+		block_semantics.back = block_semantics.instructions.add_instruction({I::AddSp(B(), stack_allocated)}, {}, block_semantics.back);
+	}
+	block_semantics.back = block_semantics.instructions.add_instruction({I::LoadFrom(B(), true, true, 0, true, true, Storage("$ra"), Storage("$sp", 4, 0, true), false, false)}, {}, block_semantics.back);
+	block_semantics.back = block_semantics.instructions.add_instruction({I::AddSp(B(), 4)}, {}, block_semantics.back);
+
+	// Now either return or syscall exit.
+	if (!is_main) {
+		block_semantics.back = block_semantics.instructions.add_instruction({I::Return(B())}, {}, block_semantics.back);
+	} else {
+		std::vector<Output::Line> exit_lines;
+		if (profile_generate) {
+			exit_lines.push_back(Output::Line("\tjal   ") + profile_dump_symbol);
+		}
+		exit_lines.push_back("\t# exit2(0)");
+		exit_lines.push_back("\tli    $v0, 17");
+		exit_lines.push_back("\tli    $a0, 0");
+		exit_lines.push_back("\tsyscall");
+		block_semantics.back = block_semantics.instructions.add_instruction({I::Custom(B(), std::as_const(exit_lines))}, {}, block_semantics.back);
+	}
+
+	// Connect our chain of sequenced intro instructions.
+	block_semantics.instructions.add_sequence_connection(last_intro_index, block_semantics.front);
+	block_semantics.front = first_intro_index;
+
+	// Verify our working storage requirements have not changed.
+	std::vector<uint32_t> new_working_storage_requirements;
+	new_working_storage_requirements = block_semantics.instructions.prepare(std::set<IO>(), {block_semantics.back});
+	if (new_working_storage_requirements != working_storage_requirements) {
+		std::ostringstream sstr;
+		sstr
+			<< "Semantics::analyze_block: internal error: adding intro and cleanup sections to a block, with requested symbol suffix ``"
+			<< routine_declaration.location.requested_suffix
+			<< "\", should not have changed the working storage requirements, but it did."
+			;
+		throw SemanticsError(sstr.str());
+	}
+
+	// Sort the working storage units.
+	std::vector<Storage> sorted_working_storages;
+	for (const Storage &working_storage : std::as_const(working_storages)) {
+		const std::vector<Storage>::size_type working_storage_index = &working_storage - &working_storages[0];
+		sorted_working_storages.push_back(working_storages[permutation[working_storage_index]]);
+	}
+
+	// Emit the block, and parse it once for the passes that follow.
+	output_lines = block_semantics.instructions.emit({}, sorted_working_storages, {}, false, block_semantics.back, architecture);
+	MachineCode machine_code(output_lines);
+
+	// Keep scalars in registers across loops, remove redundant loads and
+	// dead stores, and then clean up the register copies this leaves, again
+	// after cleaning up the control flow and applying peephole rules.
+	if (optimize) {
+		promote_loop_scalars(machine_code, small_data_objects, profile_guided ? lexeme_weights : std::vector<uint64_t>());
+		eliminate_redundant_memory_accesses(machine_code, small_data_objects);
+		propagate_emitted_copies(machine_code);
+		thread_emitted_jumps(machine_code);
+		apply_peephole_rules(machine_code);
+		propagate_emitted_copies(machine_code);
+	}
+
+	// Reorder instructions to hide latency on the target CPU.
+	if (optimize && target_cpu.has_value()) {
+		schedule_machine_code(machine_code, *target_cpu);
+	}
+
+	// Return the output.
+	return machine_code;
+}
+
+Semantics::MemoryLocation::MemoryLocation()
+	{}
+
+Semantics::MemoryLocation::MemoryLocation(kind_t kind, const MachineInstruction::Operand &base, int32_t offset, uint32_t size, bool is_exact)
+	: kind(kind)
+	, base(base)
+	, offset(offset)
+	, size(size)
+	, is_exact(is_exact)
+	{}
+
+Semantics::MemoryLocation Semantics::MemoryLocation::get_inexact(const std::map<int32_t, uint32_t> &small_data_objects) const {
+	if (kind == unknown_kind || !is_exact) {
+		return *this;
+	}
+
+	// Find the small-data variable that contains the offset.
+	if (kind == small_global_kind) {
+		std::map<int32_t, uint32_t>::const_iterator small_data_object_search = small_data_objects.upper_bound(offset);
+		if (small_data_object_search != small_data_objects.cbegin()) {
+			--small_data_object_search;
+			if (offset < small_data_object_search->first + static_cast<int32_t>(small_data_object_search->second)) {
+				return MemoryLocation(kind, base, small_data_object_search->first, small_data_object_search->second, false);
+			}
+		}
+	}
+
+	// Otherwise, how far the object extends is unknown.
+	return MemoryLocation(kind, base, std::numeric_limits<int32_t>::min() / 2, std::numeric_limits<uint32_t>::max() / 2, false);
+}
+
+bool Semantics::MemoryLocation::may_alias(const MemoryLocation &other, bool locals_escape) const {
+	if (kind == unknown_kind || other.kind == unknown_kind) {
+		return true;
+	}
+
+	const bool overlaps = static_cast<int64_t>(offset) < static_cast<int64_t>(other.offset) + other.size && static_cast<int64_t>(other.offset) < static_cast<int64_t>(offset) + size;
+
+	if (kind == pointer_kind || other.kind == pointer_kind) {
+		if (kind == other.kind) {
+			// Two pointers are only known to be distinct when they are the same register.
+			return base != other.base || overlaps;
+		}
+
+		// A pointer can refer to any global, but only to locals whose address was taken.
+		const MemoryLocation &non_pointer = kind == pointer_kind ? other : *this;
+		return non_pointer.kind != local_kind || locals_escape;
+	}
+
+	// Locals, small-data globals, and distinct labels never overlap each other.
+	if (kind != other.kind || base != other.base) {
+		return false;
+	}
+
+	return overlaps;
+}
+
+bool Semantics::MemoryLocation::covers(const MemoryLocation &other) const {
+	if (kind == unknown_kind || !is_exact || kind != other.kind || base != other.base) {
+		return false;
+	}
+
+	return offset <= other.offset && static_cast<int64_t>(other.offset) + other.size <= static_cast<int64_t>(offset) + size;
+}
+
+bool Semantics::MemoryLocation::is_same(const MemoryLocation &other) const {
+	return kind != unknown_kind && is_exact && other.is_exact && kind == other.kind && base == other.base && offset == other.offset && size == other.size;
+}
+
+// | Split an emitted line into its mnemonic and operands.
+std::vector<std::string> Semantics::parse_emitted_line(const Output::Line &line, std::map<std::string, Symbol> &symbol_placeholders) {
+	// Substitute right-to-left so that earlier positions stay valid.
+	std::string text = line.line;
+	std::vector<std::pair<std::string::size_type, std::vector<std::pair<Symbol, std::pair<std::string::size_type, std::string::size_type>>>::size_type>> symbol_positions;
+	for (const std::pair<Symbol, std::pair<std::string::size_type, std::string::size_type>> &symbol : std::as_const(line.symbols)) {
+		symbol_positions.push_back({symbol.second.first, &symbol - &line.symbols[0]});
+	}
+	std::stable_sort(symbol_positions.begin(), symbol_positions.end());
+	std::reverse(symbol_positions.begin(), symbol_positions.end());
+	for (const std::pair<std::string::size_type, std::vector<std::pair<Symbol, std::pair<std::string::size_type, std::string::size_type>>>::size_type> &symbol_position : std::as_const(symbol_positions)) {
+		const std::pair<Symbol, std::pair<std::string::size_type, std::string::size_type>> &symbol = line.symbols[symbol_position.second];
+		const std::string placeholder = "{" + symbol.first.prefix + ":" + symbol.first.requested_suffix + ":" + std::to_string(symbol.first.unique_identifier) + "}";
+		symbol_placeholders.insert({placeholder, symbol.first});
+		text.replace(symbol.second.first, symbol.second.second, placeholder);
+	}
+
+	// Strip comments and surrounding whitespace.
+	const std::string::size_type comment_pos = text.find('#');
+	if (comment_pos != std::string::npos) {
+		text = text.substr(0, comment_pos);
+	}
+	const std::string::size_type begin = text.find_first_not_of(" \t");
+	const std::string::size_type end   = text.find_last_not_of(" \t");
+	text = begin == std::string::npos ? "" : text.substr(begin, end - begin + 1);
+
+	if        (text.empty()) {
+		return {};
+	} else if (text[text.size() - 1] == ':') {
+		return {":", text.substr(0, text.size() - 1)};
+	} else if (text[0] == '.') {
+		return {"."};
+	}
+
+	std::vector<std::string> instruction;
+	const std::string::size_type mnemonic_end = std::min(text.find_first_of(" \t"), text.size());
+	instruction.push_back(text.substr(0, mnemonic_end));
+	std::string rest = text.substr(mnemonic_end);
+	while (rest.find_first_not_of(" \t") != std::string::npos) {
+		const std::string::size_type comma_pos = rest.find(',');
+		std::string operand = rest.substr(0, comma_pos);
+		operand = operand.substr(operand.find_first_not_of(" \t"));
+		operand = operand.substr(0, operand.find_last_not_of(" \t") + 1);
+		instruction.push_back(operand);
+		rest = comma_pos == std::string::npos ? "" : rest.substr(comma_pos + 1);
+	}
+	return instruction;
+}
+
+Semantics::MemoryLocation Semantics::get_memory_location(const MachineInstruction::Operand &operand, uint32_t size, const std::map<MachineInstruction::register_id_t, MemoryLocation> &addresses) {
+	if        (operand.kind == MachineInstruction::Operand::memory_kind) {
+		const std::map<MachineInstruction::register_id_t, MemoryLocation>::const_iterator address_search = addresses.find(operand.register_);
+		const MachineInstruction::Operand base = MachineInstruction::Operand::make_register(operand.register_);
+		if        (address_search != addresses.cend()) {
+			const MemoryLocation &address = address_search->second;
+			if (!address.is_exact) {
+				return address;
+			}
+			return MemoryLocation(address.kind, address.base, address.offset + operand.immediate, size);
+		} else if (operand.register_ == MachineInstruction::sp_register) {
+			return MemoryLocation(MemoryLocation::local_kind, base, operand.immediate, size);
+		} else if (operand.register_ == MachineInstruction::gp_register) {
+			return MemoryLocation(MemoryLocation::small_global_kind, base, operand.immediate, size);
+		} else {
+			return MemoryLocation(MemoryLocation::pointer_kind, base, operand.immediate, size);
+		}
+	} else if (operand.kind == MachineInstruction::Operand::symbol_kind) {
+		return MemoryLocation(MemoryLocation::global_kind, operand, 0, size);
+	} else {
+		return MemoryLocation();
+	}
+}
+
+std::optional<Semantics::MemoryLocation> Semantics::get_computed_address(const MachineInstruction &instruction, const std::map<MachineInstruction::register_id_t, MemoryLocation> &addresses, const std::map<int32_t, uint32_t> &small_data_objects) {
+	using Operand = MachineInstruction::Operand;
+
+	const std::optional<MachineInstruction::register_id_t> destination = instruction.get_destination();
+	if (!destination.has_value() || *destination == MachineInstruction::sp_register) {
+		return std::optional<MemoryLocation>();
+	}
+	const MachineInstruction::opcode_t opcode = instruction.opcode;
+
+	// Adding a register to an address gives an address somewhere in the same object.
+	if (instruction.num_operands == 3 && (opcode == MachineInstruction::addu_opcode || opcode == MachineInstruction::add_opcode || opcode == MachineInstruction::subu_opcode || opcode == MachineInstruction::sub_opcode)) {
+		const std::map<MachineInstruction::register_id_t, MemoryLocation>::const_iterator left_search  = instruction.operands[1].kind == Operand::register_kind ? addresses.find(instruction.operands[1].register_) : addresses.cend();
+		const std::map<MachineInstruction::register_id_t, MemoryLocation>::const_iterator right_search = instruction.operands[2].kind == Operand::register_kind ? addresses.find(instruction.operands[2].register_) : addresses.cend();
+		if (left_search != addresses.cend() && right_search == addresses.cend()) {
+			return left_search->second.get_inexact(small_data_objects);
+		}
+		if (right_search != addresses.cend() && left_search == addresses.cend() && (opcode == MachineInstruction::addu_opcode || opcode == MachineInstruction::add_opcode)) {
+			return right_search->second.get_inexact(small_data_objects);
+		}
+		return std::optional<MemoryLocation>();
+	}
+
+	// Otherwise, look for "la $d, label", "la $d, off($r)", and "addiu $d, $r, off".
+	MachineInstruction::register_id_t register_;
+	int32_t                           offset;
+	if        (instruction.num_operands == 2 && opcode == MachineInstruction::la_opcode && instruction.operands[1].kind == Operand::memory_kind) {
+		register_ = instruction.operands[1].register_;
+		offset    = instruction.operands[1].immediate;
+	} else if (instruction.num_operands == 2 && opcode == MachineInstruction::la_opcode && instruction.operands[1].kind == Operand::symbol_kind) {
+		return MemoryLocation(MemoryLocation::global_kind, instruction.operands[1], 0, 0);
+	} else if (instruction.num_operands == 3 && opcode == MachineInstruction::addiu_opcode && instruction.operands[1].kind == Operand::register_kind && instruction.operands[2].kind == Operand::immediate_kind) {
+		register_ = instruction.operands[1].register_;
+		offset    = instruction.operands[2].immediate;
+	} else {
+		return std::optional<MemoryLocation>();
+	}
+
+	const std::map<MachineInstruction::register_id_t, MemoryLocation>::const_iterator address_search = addresses.find(register_);
+	if        (address_search != addresses.cend()) {
+		const MemoryLocation &address = address_search->second;
+		if (!address.is_exact) {
+			return address;
+		}
+		return MemoryLocation(address.kind, address.base, address.offset + offset, 0);
+	} else if (register_ == MachineInstruction::sp_register) {
+		return MemoryLocation(MemoryLocation::local_kind, Operand::make_register(register_), offset, 0);
+	} else if (register_ == MachineInstruction::gp_register) {
+		return MemoryLocation(MemoryLocation::small_global_kind, Operand::make_register(register_), offset, 0);
+	} else if (register_ != *destination && register_ != MachineInstruction::zero_register) {
+		return MemoryLocation(MemoryLocation::pointer_kind, Operand::make_register(register_), offset, 0);
+	} else {
+		return std::optional<MemoryLocation>();
+	}
+}
+
+bool Semantics::emitted_locals_escape(const MachineCode &code) {
+	for (const MachineInstruction &instruction : std::as_const(code.instructions)) {
+		if (instruction.opcode == MachineInstruction::line_opcode) {
+			// Lines kept verbatim might do anything with it.
+			if (code.lines[instruction.operands[0].immediate].line.find("$sp") != std::string::npos) {
+				return true;
+			}
+			continue;
+		}
+		if (!instruction.is_instruction() || instruction.get_load_size() != 0) {
+			continue;
+		}
+		const bool is_store = instruction.get_store_size() != 0;
+		if (!is_store && instruction.get_destination() == MachineInstruction::sp_register) {
+			// Adjusting "$sp".
+			continue;
+		}
+		for (uint8_t operand_index = 0; operand_index < instruction.num_operands; ++operand_index) {
+			const MachineInstruction::Operand &operand = instruction.operands[operand_index];
+			const bool reads_sp = (operand.kind == MachineInstruction::Operand::register_kind || operand.kind == MachineInstruction::Operand::memory_kind) && operand.register_ == MachineInstruction::sp_register;
+			if ((is_store ? operand_index == 0 : operand_index > 0) && reads_sp) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// | Within each basic block of emitted code, remove loads of values already
+// in a register and stores that are overwritten before anything could read
+// them.
+//
+// Labels, branches, jumps, calls, and syscalls end a basic block; nothing is
+// assumed across them.
+void Semantics::eliminate_redundant_memory_accesses(MachineCode &code, const std::map<int32_t, uint32_t> &small_data_objects) {
+	using Operand = MachineInstruction::Operand;
+
+	std::vector<MachineInstruction> &instructions  = code.instructions;
+	const bool                       locals_escape = emitted_locals_escape(code);
+
+	// | Registers known to hold the address of a location.
+	std::map<MachineInstruction::register_id_t, MemoryLocation> addresses;
+	// | Locations whose value is known to be in a register, and the load that
+	// would produce it: {location, {register, load opcode}}.
+	std::vector<std::pair<MemoryLocation, std::pair<MachineInstruction::register_id_t, MachineInstruction::opcode_t>>> values;
+	// | Stores that nothing has read yet: {location, index}.
+	std::vector<std::pair<MemoryLocation, std::vector<MachineInstruction>::size_type>> pending_stores;
+
+	for (std::vector<MachineInstruction>::size_type index = 0; index < instructions.size(); ++index) {
+		const MachineInstruction instruction = instructions[index];
+		if (instruction.opcode == MachineInstruction::null_opcode || instruction.opcode == MachineInstruction::comment_opcode) {
+			continue;
+		}
+
+		if (instruction.ends_block()) {
+			// Past a conditional branch, the registers and memory are
+			// unchanged, but stores may be read where it branches to.  (A
+			// label after it ends the block anyway.)
+			if (!instruction.is_conditional_branch()) {
+				addresses.clear();
+				values.clear();
+			}
+			pending_stores.clear();
+			continue;
+		}
+
+		const std::optional<MachineInstruction::register_id_t> destination = instruction.get_destination();
+		const uint32_t load_size  = instruction.get_load_size();
+		const uint32_t store_size = instruction.get_store_size();
+
+		MemoryLocation location;
+		if (load_size != 0 || store_size != 0) {
+			location = get_memory_location(instruction.operands[1], load_size != 0 ? load_size : store_size, addresses);
+		}
+		const std::optional<MemoryLocation> computed_address = get_computed_address(instruction, addresses, small_data_objects);
+
+		if (load_size != 0) {
+			// A load.  Is the value already in a register?
+			for (const std::pair<MemoryLocation, std::pair<MachineInstruction::register_id_t, MachineInstruction::opcode_t>> &value : std::as_const(values)) {
+				if (value.first.is_same(location) && value.second.second == instruction.opcode) {
+					if (value.second.first == *destination) {
+						instructions[index] = MachineInstruction();
+					} else {
+						instructions[index] = MachineInstruction(MachineInstruction::la_opcode, {Operand::make_register(*destination), Operand::make_memory(value.second.first, 0)});
+					}
+					break;
+				}
+			}
+
+			// Stores to anything this might read are no longer dead.
+			std::vector<std::pair<MemoryLocation, std::vector<MachineInstruction>::size_type>> unread_stores;
+			for (const std::pair<MemoryLocation, std::vector<MachineInstruction>::size_type> &pending_store : std::as_const(pending_stores)) {
+				if (!pending_store.first.may_alias(location, locals_escape)) {
+					unread_stores.push_back(pending_store);
+				}
+			}
+			pending_stores = std::move(unread_stores);
+		} else if (store_size != 0) {
+			// A store.  Does the location already hold this value?
+			bool is_redundant = false;
+			for (const std::pair<MemoryLocation, std::pair<MachineInstruction::register_id_t, MachineInstruction::opcode_t>> &value : std::as_const(values)) {
+				if (instruction.opcode == MachineInstruction::sw_opcode && value.first.is_same(location) && instruction.operands[0] == Operand::make_register(value.second.first) && value.second.second == MachineInstruction::lw_opcode) {
+					is_redundant = true;
+					break;
+				}
+			}
+			if (is_redundant) {
+				instructions[index] = MachineInstruction();
+				continue;
+			}
+
+			// Stores this one overwrites were never read.
+			std::vector<std::pair<MemoryLocation, std::vector<MachineInstruction>::size_type>> live_stores;
+			for (const std::pair<MemoryLocation, std::vector<MachineInstruction>::size_type> &pending_store : std::as_const(pending_stores)) {
+				if (location.covers(pending_store.first)) {
+					instructions[pending_store.second] = MachineInstruction();
+				} else {
+					live_stores.push_back(pending_store);
+				}
+			}
+			pending_stores = std::move(live_stores);
+
+			// Forget values this store might change.
+			std::vector<std::pair<MemoryLocation, std::pair<MachineInstruction::register_id_t, MachineInstruction::opcode_t>>> unchanged_values;
+			for (const std::pair<MemoryLocation, std::pair<MachineInstruction::register_id_t, MachineInstruction::opcode_t>> &value : std::as_const(values)) {
+				if (!value.first.may_alias(location, locals_escape)) {
+					unchanged_values.push_back(value);
+				}
+			}
+			values = std::move(unchanged_values);
+
+			if (location.kind != MemoryLocation::unknown_kind) {
+				pending_stores.push_back({location, index});
+				if (instruction.opcode == MachineInstruction::sw_opcode && location.is_exact && instruction.operands[0].kind == Operand::register_kind) {
+					values.push_back({location, {instruction.operands[0].register_, MachineInstruction::lw_opcode}});
+				}
+			}
+		}
+
+		// Forget everything that depends on the old value of the destination register.
+		if (destination.has_value()) {
+			const Operand destination_operand = Operand::make_register(*destination);
+
+			std::vector<std::pair<MemoryLocation, std::pair<MachineInstruction::register_id_t, MachineInstruction::opcode_t>>> unchanged_values;
+			for (const std::pair<MemoryLocation, std::pair<MachineInstruction::register_id_t, MachineInstruction::opcode_t>> &value : std::as_const(values)) {
+				if (value.first.base != destination_operand && value.second.first != *destination) {
+					unchanged_values.push_back(value);
+				}
+			}
+			values = std::move(unchanged_values);
+
+			std::vector<std::pair<MemoryLocation, std::vector<MachineInstruction>::size_type>> unchanged_stores;
+			for (const std::pair<MemoryLocation, std::vector<MachineInstruction>::size_type> &pending_store : std::as_const(pending_stores)) {
+				if (pending_store.first.base != destination_operand) {
+					unchanged_stores.push_back(pending_store);
+				}
+			}
+			pending_stores = std::move(unchanged_stores);
+
+			std::map<MachineInstruction::register_id_t, MemoryLocation> unchanged_addresses;
+			for (const std::pair<const MachineInstruction::register_id_t, MemoryLocation> &address : std::as_const(addresses)) {
+				if (address.first != *destination && address.second.base != destination_operand) {
+					unchanged_addresses.insert(address);
+				}
+			}
+			addresses = std::move(unchanged_addresses);
+
+			if (computed_address.has_value()) {
+				addresses.insert({*destination, *computed_address});
+			}
+			if (load_size != 0 && location.is_exact && location.kind != MemoryLocation::unknown_kind && location.base != destination_operand) {
+				values.push_back({location, {*destination, instruction.opcode}});
+			}
+		}
+	}
+
+	code.remove_null_instructions();
+}
+
+std::map<int32_t, int32_t> Semantics::share_stack_slots(const MIPSIO &instructions, const MIPSIO::Schedule &schedule, const std::map<int32_t, uint32_t> &stack_slot_sizes, const std::set<int32_t> &fixed_stack_slots, const std::map<Storage::Index, int32_t> &working_storage_slots, int32_t push_ra_allocated, int32_t &stack_allocated) {
+	using Index = MIPSIO::Index;
+	using I     = Instruction;
+
+	// Find each slot's accesses, whether its address is taken, and the
+	// loops: a label and a later branch back to it.
+	std::map<int32_t, std::pair<uint64_t, uint64_t>> lifetimes;  // offset -> {first, last}
+	std::set<int32_t>                                escaped_slots;
+	std::map<Symbol, uint64_t>                       label_positions;
+	std::vector<std::pair<uint64_t, uint64_t>>       loops;
+	for (const std::pair<Index, std::set<Storage::Index>> &scheduled : std::as_const(schedule)) {
+		const uint64_t     position    = &scheduled - &schedule[0];
+		const Instruction &instruction = instructions.instructions.at(scheduled.first);
+
+		std::vector<int32_t> accessed_slots;
+		for (const Storage::Index &working_storage_index : std::as_const(scheduled.second)) {
+			std::map<Storage::Index, int32_t>::const_iterator working_storage_slots_search = working_storage_slots.find(working_storage_index);
+			if (working_storage_slots_search != working_storage_slots.cend()) {
+				accessed_slots.push_back(working_storage_slots_search->second);
+			}
+		}
+		if (instruction.is_load_from()) {
+			const I::LoadFrom &load_from = instruction.get_load_from();
+			std::vector<Storage> fixed_storages;
+			if (load_from.is_save_fixed) {
+				fixed_storages.push_back(load_from.fixed_save_storage);
+			}
+			if (load_from.is_load_fixed) {
+				fixed_storages.push_back(load_from.fixed_load_storage);
+			}
+			for (const Storage &fixed_storage : std::as_const(fixed_storages)) {
+				if (fixed_storage.register_ != "$sp" || fixed_storage.no_sp_adjust || fixed_storage.is_global) {
+					continue;
+				}
+				if (fixed_storage.is_register_dereference()) {
+					accessed_slots.push_back(fixed_storage.offset);
+				} else {
+					// The address is taken; it may also be in "addition".
+					escaped_slots.insert(fixed_storage.offset);
+					escaped_slots.insert(fixed_storage.offset + load_from.addition);
+				}
+			}
+		}
+		for (const int32_t &accessed_slot : std::as_const(accessed_slots)) {
+			std::map<int32_t, std::pair<uint64_t, uint64_t>>::iterator lifetimes_search = lifetimes.find(accessed_slot);
+			if (lifetimes_search == lifetimes.end()) {
+				lifetimes.insert({accessed_slot, {position, position}});
+			} else {
+				lifetimes_search->second.second = position;
+			}
+		}
+
+		if (instruction.get_base().has_symbol) {
+			label_positions[instruction.get_base().symbol] = position;
+		}
+		if (instruction.is_jump() || instruction.is_branch_zero() || instruction.is_branch_nonnegative()) {
+			const Symbol &destination =
+				  instruction.is_jump()        ? instruction.get_jump().jump_destination
+				: instruction.is_branch_zero() ? instruction.get_branch_zero().branch_destination
+				:                                instruction.get_branch_nonnegative().branch_destination
+				;
+			std::map<Symbol, uint64_t>::const_iterator label_positions_search = label_positions.find(destination);
+			if (label_positions_search != label_positions.cend()) {
+				loops.push_back({label_positions_search->second, position});
+			}
+		}
+	}
+
+	// A slot used in a loop may carry its value around the loop.
+	for (std::pair<const int32_t, std::pair<uint64_t, uint64_t>> &lifetime : lifetimes) {
+		for (bool changed = true; changed; ) {
+			changed = false;
+			for (const std::pair<uint64_t, uint64_t> &loop : std::as_const(loops)) {
+				if (lifetime.second.first <= loop.second && loop.first <= lifetime.second.second && (loop.first < lifetime.second.first || lifetime.second.second < loop.second)) {
+					lifetime.second.first  = std::min(lifetime.second.first,  loop.first);
+					lifetime.second.second = std::max(lifetime.second.second, loop.second);
+					changed = true;
+				}
+			}
+		}
+	}
+
+	// Keep fixed and escaping slots where they are.
+	int32_t allocated = 0;
+	std::vector<std::pair<int32_t, uint32_t>> occupied_slots;  // {offset, size}
+	std::vector<std::pair<std::pair<uint64_t, uint64_t>, int32_t>> shared_slots;  // {lifetime, offset}, ordered by start.
+	for (const std::pair<const int32_t, uint32_t> &stack_slot : std::as_const(stack_slot_sizes)) {
+		if (fixed_stack_slots.find(stack_slot.first) != fixed_stack_slots.cend() || escaped_slots.find(stack_slot.first) != escaped_slots.cend()) {
+			allocated = std::max(allocated, -stack_slot.first - push_ra_allocated);
+			occupied_slots.push_back(stack_slot);
+		} else {
+			// A slot that is never accessed can go anywhere.
+			std::map<int32_t, std::pair<uint64_t, uint64_t>>::const_iterator lifetimes_search = lifetimes.find(stack_slot.first);
+			shared_slots.push_back({lifetimes_search != lifetimes.cend() ? lifetimes_search->second : std::pair<uint64_t, uint64_t>(0, 0), stack_slot.first});
+		}
+	}
+	std::stable_sort(shared_slots.begin(), shared_slots.end());
+
+	// Interval coloring: reuse the first slot of the same size that is free
+	// by the time this one starts, or else take the first gap that fits.
+	std::map<int32_t, int32_t> offsets;
+	std::vector<std::pair<std::pair<uint32_t, int32_t>, uint64_t>> packed_slots;  // {{size, offset}, last use}
+	for (const std::pair<std::pair<uint64_t, uint64_t>, int32_t> &shared_slot : std::as_const(shared_slots)) {
+		const uint32_t size = stack_slot_sizes.at(shared_slot.second);
+
+		bool found = false;
+		for (std::pair<std::pair<uint32_t, int32_t>, uint64_t> &packed_slot : packed_slots) {
+			if (packed_slot.first.first == size && packed_slot.second < shared_slot.first.first) {
+				offsets.insert({shared_slot.second, packed_slot.first.second});
+				packed_slot.second = shared_slot.first.second;
+				found = true;
+				break;
+			}
+		}
+		if (!found) {
+			int32_t slot_allocated = 0;
+			int32_t offset;
+			for (bool overlaps = true; overlaps; ) {
+				overlaps = false;
+				slot_allocated = Instruction::AddSp::round_to_align(slot_allocated + size, size, 4);
+				offset = -(slot_allocated + push_ra_allocated);
+				for (const std::pair<int32_t, uint32_t> &occupied_slot : std::as_const(occupied_slots)) {
+					if (offset < occupied_slot.first + static_cast<int32_t>(occupied_slot.second) && occupied_slot.first < offset + static_cast<int32_t>(size)) {
+						// Try again below it.
+						slot_allocated = -occupied_slot.first - push_ra_allocated;
+						overlaps = true;
+						break;
+					}
+				}
+			}
+			allocated = std::max(allocated, slot_allocated);
+			occupied_slots.push_back({offset, size});
+			offsets.insert({shared_slot.second, offset});
+			packed_slots.push_back({{size, offset}, shared_slot.first.second});
+		}
+	}
+
+	stack_allocated = allocated;
+	return offsets;
+}
+
+std::vector<Semantics::RoutineSpecialization> Semantics::get_routine_specializations(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const Body &body, const IdentifierScope &var_scope, const IdentifierScope &routine_scope) {
+	const ::Block &block = grammar.block_storage.at(body.block);
+
+	if (collect_call_sites) {
+		// Only value parameters of primitive type that the body never
+		// modifies can be replaced by a constant, and it's only worth it if
+		// some code would then fold.
+		std::vector<bool> parameters;
+		for (const std::pair<bool, TypeIndex> &parameter : std::as_const(routine_declaration.parameters)) {
+			const std::vector<std::pair<bool, TypeIndex>>::size_type parameter_index = &parameter - &routine_declaration.parameters[0];
+			const std::string &parameter_identifier = parameter_identifiers.at(parameter_index);
+			const Type        &resolved_type        = storage_scope.resolve_type(parameter.second);
+
+			parameters.push_back(
+				   !parameter.first
+				&& resolved_type.is_primitive()
+				&& (resolved_type.get_primitive().is_integer() || resolved_type.get_primitive().is_char() || resolved_type.get_primitive().is_boolean())
+				&& !var_scope.has(parameter_identifier)
+				&& !may_modify_variable(block.begin_keyword0, block.end_keyword0 + 1, parameter_identifier, false, routine_scope)
+				&& may_fold_variable(block.begin_keyword0, block.end_keyword0 + 1, parameter_identifier)
+				&& memo_tables.find(routine_declaration.location) == memo_tables.cend()
+			);
+		}
+		const bool is_small = block.end_keyword0 - block.begin_keyword0 <= max_specialized_routine_size;
+		specializable_parameters[routine_declaration.location] = {parameters, is_small};
+
+		return {RoutineSpecialization(routine_declaration.location, {})};
+	}
+
+	const std::map<Symbol, std::vector<RoutineSpecialization>>::const_iterator routine_specializations_search = routine_specializations.find(routine_declaration.location);
+	if (routine_specializations_search == routine_specializations.cend()) {
+		return {RoutineSpecialization(routine_declaration.location, {})};
+	}
+	return routine_specializations_search->second;
+}
+
+void Semantics::plan_routine_specializations() {
+	routine_specializations.clear();
+
+	// Is this argument a constant that could replace a parameter?
+	const auto is_replaceable = [] (const std::optional<ConstantValue> &argument) -> bool {
+		return argument.has_value() && (argument->is_integer() || argument->is_char() || argument->is_boolean());
+	};
+
+	for (const std::pair<const Symbol, std::pair<std::vector<bool>, bool>> &routine_parameters : std::as_const(specializable_parameters)) {
+		const Symbol            &location   = routine_parameters.first;
+		const std::vector<bool> &parameters = routine_parameters.second.first;
+		const bool               is_small   = routine_parameters.second.second;
+
+		static const std::vector<std::pair<std::vector<std::optional<ConstantValue>>, uint64_t>> no_call_sites;
+		const std::map<Symbol, std::vector<std::pair<std::vector<std::optional<ConstantValue>>, uint64_t>>>::const_iterator call_sites_search = call_sites.find(location);
+		const std::vector<std::pair<std::vector<std::optional<ConstantValue>>, uint64_t>> &sites = call_sites_search != call_sites.cend() ? call_sites_search->second : no_call_sites;
+
+		// First, bake into the routine itself each parameter that every call
+		// site passes the same constant (or recursively passes on unchanged).
+		std::vector<std::optional<ConstantValue>> baked(parameters.size());
+		for (std::vector<bool>::size_type parameter_index = 0; parameter_index < parameters.size(); ++parameter_index) {
+			if (!parameters[parameter_index]) {
+				continue;
+			}
+
+			std::optional<ConstantValue> agreed;
+			bool is_agreed = true;
+			for (const std::pair<std::vector<std::optional<ConstantValue>>, uint64_t> &site : std::as_const(sites)) {
+				if (parameter_index >= site.first.size()) {
+					is_agreed = false;
+					break;
+				}
+				const std::optional<ConstantValue> &argument = site.first[parameter_index];
+				if (!argument.has_value()) {
+					// Passthrough.
+					continue;
+				} else if (!is_replaceable(argument) || (agreed.has_value() && !agreed->matches(*argument))) {
+					is_agreed = false;
+					break;
+				}
+				agreed = argument;
+			}
+			if (is_agreed && agreed.has_value()) {
+				baked[parameter_index] = agreed;
+			}
+		}
+		std::vector<RoutineSpecialization> specializations {RoutineSpecialization(location, baked)};
+
+		// Next, group the other call sites by the constants they pass, and
+		// make a copy of the routine for the heaviest groups.
+		if (is_small) {
+			std::vector<std::pair<RoutineSpecialization, uint64_t>> groups;
+			for (const std::pair<std::vector<std::optional<ConstantValue>>, uint64_t> &site : std::as_const(sites)) {
+				RoutineSpecialization signature(location, std::vector<std::optional<ConstantValue>>(parameters.size()));
+				for (std::vector<bool>::size_type parameter_index = 0; parameter_index < parameters.size() && parameter_index < site.first.size(); ++parameter_index) {
+					if (parameters[parameter_index] && !baked[parameter_index].has_value() && is_replaceable(site.first[parameter_index])) {
+						signature.arguments[parameter_index] = site.first[parameter_index];
+					}
+				}
+				if (signature.count_constants() <= 0) {
+					continue;
+				}
+
+				bool found = false;
+				for (std::pair<RoutineSpecialization, uint64_t> &group : groups) {
+					bool is_same = true;
+					for (std::vector<bool>::size_type parameter_index = 0; parameter_index < parameters.size(); ++parameter_index) {
+						const std::optional<ConstantValue> &a = group.first.arguments[parameter_index];
+						const std::optional<ConstantValue> &b = signature.arguments[parameter_index];
+						if (a.has_value() != b.has_value() || (a.has_value() && !a->matches(*b))) {
+							is_same = false;
+							break;
+						}
+					}
+					if (is_same) {
+						group.second += site.second;
+						found = true;
+						break;
+					}
+				}
+				if (!found) {
+					groups.push_back({signature, site.second});
+				}
+			}
+
+			std::stable_sort(groups.begin(), groups.end(), [] (const std::pair<RoutineSpecialization, uint64_t> &a, const std::pair<RoutineSpecialization, uint64_t> &b) -> bool {
+				return a.second > b.second;
+			});
+			for (const std::pair<RoutineSpecialization, uint64_t> &group : std::as_const(groups)) {
+				if (specializations.size() > max_routine_specializations || group.second < min_specialization_weight) {
+					break;
+				}
+
+				const std::string label_suffix = "_spec" + std::to_string(specializations.size());
+				RoutineSpecialization specialization(Symbol(location.prefix, location.requested_suffix + label_suffix, location.unique_identifier), baked, label_suffix);
+				for (std::vector<bool>::size_type parameter_index = 0; parameter_index < parameters.size(); ++parameter_index) {
+					if (group.first.arguments[parameter_index].has_value()) {
+						specialization.arguments[parameter_index] = group.first.arguments[parameter_index];
+					}
+				}
+				specializations.push_back(specialization);
+			}
+		}
+
+		routine_specializations[location] = specializations;
+	}
+}
+
+std::vector<uint64_t> Semantics::get_lexeme_loop_depths() const {
+	std::vector<uint64_t> loop_depths;
+	std::vector<bool> nesting;  // Is each enclosing "...end" or "repeat...until" a loop?
+	uint64_t loop_depth = 0;
+	for (const Lexeme &lexeme : std::as_const(grammar.lexemes)) {
+		loop_depths.push_back(loop_depth);
+		if (lexeme.is_keyword()) {
+			switch (lexeme.get_keyword().keyword) {
+				case begin_keyword:
+				case if_keyword:
+				case record_keyword:
+					nesting.push_back(false);
+					break;
+				case while_keyword:
+				case for_keyword:
+				case repeat_keyword:
+					nesting.push_back(true);
+					++loop_depth;
+					break;
+				case end_keyword:
+				case until_keyword:
+					if (nesting.size() > 0) {
+						if (nesting.back()) {
+							--loop_depth;
+						}
+						nesting.pop_back();
+					}
+					break;
+				default:
+					break;
+			}
+		}
+	}
+	return loop_depths;
+}
+
+std::vector<uint64_t> Semantics::get_lexeme_loop_weights() const {
+	const std::vector<uint64_t> loop_depths = get_lexeme_loop_depths();
+	std::vector<uint64_t> weights;
+	for (const uint64_t &loop_depth : std::as_const(loop_depths)) {
+		weights.push_back(static_cast<uint64_t>(1) << (3 * std::min(loop_depth, static_cast<uint64_t>(20))));
+	}
+	return weights;
+}
+
+// | A block's weight applies from its label's lexeme up to where the next
+// block starts, or until the statement it is in ends, after which the
+// weight from before the statement applies again.  The labels of unrolled
+// and specialized copies share a lexeme, and their counts add up.  A label
+// that marks where a statement continues, e.g. "endwhile" at a "while"
+// statement's "end", applies only after the statement's "end" or "until",
+// e.g. "endrepeat" at its "repeat".
+std::vector<uint64_t> Semantics::get_lexeme_profile_weights() const {
+	// Find where each statement that "end" or "until" closes ends.
+	std::vector<uint64_t> closers(grammar.lexemes.size());
+	std::vector<bool>     is_closer(grammar.lexemes.size(), false);
+	std::vector<uint64_t> openers;
+	for (const Lexeme &lexeme : std::as_const(grammar.lexemes)) {
+		const std::vector<Lexeme>::size_type lexeme_index = &lexeme - &grammar.lexemes[0];
+		closers[lexeme_index] = lexeme_index;
+		if (lexeme.is_keyword()) {
+			switch (lexeme.get_keyword().keyword) {
+				case begin_keyword:
+				case if_keyword:
+				case record_keyword:
+				case while_keyword:
+				case for_keyword:
+				case repeat_keyword:
+					openers.push_back(lexeme_index);
+					break;
+				case end_keyword:
+				case until_keyword:
+					if (openers.size() > 0) {
+						closers[openers.back()] = lexeme_index;
+						is_closer[lexeme_index] = true;
+						openers.pop_back();
+					}
+					break;
+				default:
+					break;
+			}
+		}
+	}
+
+	std::map<uint64_t, uint64_t> block_starts;
+	for (const std::pair<const std::pair<std::string, std::string>, std::pair<uint64_t, bool>> &block_lexeme : std::as_const(profile_block_lexemes)) {
+		const Profile::const_iterator profile_search = profile.find(block_lexeme.first);
+		const uint64_t                lexeme         = block_lexeme.second.first;
+		if (profile_search == profile.cend() || lexeme >= closers.size()) {
+			continue;
+		}
+
+		const uint64_t start = !block_lexeme.second.second ? lexeme : (is_closer[lexeme] ? lexeme : closers[lexeme]) + 1;
+		block_starts[start] += profile_search->second;
+	}
+	if (block_starts.empty()) {
+		return {};
+	}
+
+	std::vector<uint64_t> weights;
+	std::vector<uint64_t> outer_weights;
+	uint64_t weight = 0;
+	for (std::vector<Lexeme>::size_type lexeme_index = 0; lexeme_index < grammar.lexemes.size(); ++lexeme_index) {
+		if (closers[lexeme_index] > lexeme_index) {
+			outer_weights.push_back(weight);
+		}
+		const std::map<uint64_t, uint64_t>::const_iterator block_start_search = block_starts.find(lexeme_index);
+		if (block_start_search != block_starts.cend()) {
+			weight = block_start_search->second;
+		}
+		weights.push_back(weight);
+		if (is_closer[lexeme_index] && outer_weights.size() > 0) {
+			weight = outer_weights.back();
+			outer_weights.pop_back();
+		}
+	}
+	return weights;
+}
+
+std::map<std::vector<Semantics::MachineInstruction>::size_type, std::string> Semantics::get_profile_block_ids(const MachineCode &code) {
+	static const MachineInstruction::RegisterSet counter_registers = (static_cast<MachineInstruction::RegisterSet>(1) << MachineInstruction::t8_register) | (static_cast<MachineInstruction::RegisterSet>(1) << MachineInstruction::t9_register);
+
+	const std::vector<MachineInstruction> &instructions = code.instructions;
+
+	// Find the first instruction at or after an index that isn't a blank
+	// line.
+	const auto get_next_index = [&instructions](std::vector<MachineInstruction>::size_type index) -> std::vector<MachineInstruction>::size_type {
+		while (index < instructions.size() && (instructions[index].opcode == MachineInstruction::null_opcode || instructions[index].opcode == MachineInstruction::comment_opcode)) {
+			++index;
+		}
+		return index;
+	};
+
+	// Group the labels by name.  A label before data starts no block.
+	std::map<std::string, std::vector<Symbol>> named_labels;
+	for (const MachineInstruction &instruction : std::as_const(instructions)) {
+		const std::vector<MachineInstruction>::size_type instruction_index = &instruction - &instructions[0];
+		if (instruction.opcode != MachineInstruction::label_opcode) {
+			continue;
+		}
+
+		const std::vector<MachineInstruction>::size_type next_index = get_next_index(instruction_index + 1);
+		if (next_index < instructions.size() && instructions[next_index].opcode == MachineInstruction::line_opcode) {
+			continue;
+		}
+
+		const Symbol &symbol = code.symbols[instruction.operands[0].symbol];
+		named_labels[symbol.prefix + symbol.requested_suffix].push_back(symbol);
+	}
+
+	// Labels of the same name differ only in their lexemes.
+	std::map<Symbol, std::string> label_ids;
+	for (std::pair<const std::string, std::vector<Symbol>> &named_label : named_labels) {
+		std::sort(named_label.second.begin(), named_label.second.end());
+		for (const Symbol &symbol : std::as_const(named_label.second)) {
+			label_ids.insert({symbol, named_label.first + "#" + std::to_string(&symbol - &named_label.second[0] + 1)});
+		}
+	}
+
+	// Code after a conditional branch that no label starts is numbered after
+	// the last block that one did, unless something there still reads "$t8"
+	// or "$t9", which counting it would overwrite.  Nothing runs after the
+	// routine's code, which is to say it returns.
+	MachineCode returning_code(code);
+	returning_code.instructions.push_back(MachineInstruction(MachineInstruction::jr_opcode, {MachineInstruction::Operand::make_register(MachineInstruction::ra_register)}));
+	const std::vector<MachineInstruction::RegisterSet> live_registers = returning_code.get_live_registers();
+	std::map<std::vector<MachineInstruction>::size_type, std::string> block_ids;
+	std::string label_id         = "entry";
+	uint64_t    num_fallthroughs = 0;
+	for (const MachineInstruction &instruction : std::as_const(instructions)) {
+		const std::vector<MachineInstruction>::size_type instruction_index = &instruction - &instructions[0];
+		if        (instruction.opcode == MachineInstruction::label_opcode) {
+			const std::map<Symbol, std::string>::const_iterator label_id_search = label_ids.find(code.symbols[instruction.operands[0].symbol]);
+			if (label_id_search != label_ids.cend()) {
+				label_id         = label_id_search->second;
+				num_fallthroughs = 0;
+				block_ids.insert({instruction_index, label_id});
+			}
+		} else if (instruction.is_conditional_branch()) {
+			const std::vector<MachineInstruction>::size_type next_index = get_next_index(instruction_index + 1);
+			if (next_index < instructions.size() && instructions[next_index].opcode != MachineInstruction::label_opcode && instructions[next_index].opcode != MachineInstruction::line_opcode && (live_registers[instruction_index] & counter_registers) == 0) {
+				block_ids.insert({instruction_index, label_id + "+" + std::to_string(++num_fallthroughs)});
+			}
+		}
+	}
+	return block_ids;
+}
+
+void Semantics::count_profile_blocks(const Symbol &routine_symbol, uint64_t entry_lexeme, MachineCode &code, std::vector<Output::Line> &table_lines) {
+	using Operand = MachineInstruction::Operand;
+
+	const std::string                                                       routine   = routine_symbol.prefix + routine_symbol.requested_suffix;
+	const std::map<std::vector<MachineInstruction>::size_type, std::string> block_ids = get_profile_block_ids(code);
+
+	// Record where the block starts, if it's a block of statements, and
+	// count it in the table: the address of the line to print before its
+	// count, and then the count.
+	const auto count_block = [&] (const std::string &block_id, const std::optional<std::pair<uint64_t, bool>> &location, std::vector<MachineInstruction> &counted_instructions) -> void {
+		if (location.has_value()) {
+			profile_block_lexemes[{routine, block_id}] = *location;
+		}
+		if (!profile_generate) {
+			return;
+		}
+
+		const Symbol counter_symbol("profile_count", "", num_profile_counters++);
+		std::ostringstream sline_count;
+		sline_count << "\t.word  " << std::right << std::setw(11) << "0";
+		table_lines.push_back(Output::Line("\t.word  ") + string_literal_symbol("profile " + routine + " " + block_id + " "));
+		table_lines.push_back({":", counter_symbol});
+		table_lines.push_back(sline_count.str());
+
+		// "$t8" and "$t9" are only used within an instruction's emitted
+		// lines, so they are free at the start of a block.
+		const Operand t8 = Operand::make_register(MachineInstruction::t8_register);
+		const Operand t9 = Operand::make_register(MachineInstruction::t9_register);
+		counted_instructions.push_back(MachineInstruction(MachineInstruction::la_opcode,    {t9, Operand::make_symbol(code.add_symbol(counter_symbol))}));
+		counted_instructions.push_back(MachineInstruction(MachineInstruction::lw_opcode,    {t8, Operand::make_memory(MachineInstruction::t9_register, 0)}));
+		counted_instructions.push_back(MachineInstruction(MachineInstruction::addiu_opcode, {t8, t8, Operand::make_immediate(1)}));
+		counted_instructions.push_back(MachineInstruction(MachineInstruction::sw_opcode,    {t8, Operand::make_memory(MachineInstruction::t9_register, 0)}));
+	};
+
+	std::vector<MachineInstruction> counted_instructions;
+	count_block("entry", std::pair<uint64_t, bool>(entry_lexeme, false), counted_instructions);
+
+	for (std::vector<MachineInstruction>::size_type index = 0; index < code.instructions.size(); ++index) {
+		const MachineInstruction instruction = code.instructions[index];
+		counted_instructions.push_back(instruction);
+
+		const std::map<std::vector<MachineInstruction>::size_type, std::string>::const_iterator block_id_search = block_ids.find(index);
+		if (block_id_search == block_ids.cend()) {
+			continue;
+		}
+
+		// Only labels say where in the source a block starts.  The loops
+		// that copy arrays and records run per word, not per statement.
+		// Labels named "end..." mark where their statement continues.
+		std::optional<std::pair<uint64_t, bool>> location;
+		if (instruction.opcode == MachineInstruction::label_opcode) {
+			const Symbol &symbol = code.symbols[instruction.operands[0].symbol];
+			if (symbol.prefix.compare(0, 8, "memmove_") != 0) {
+				location = std::pair<uint64_t, bool>(symbol.unique_identifier, symbol.prefix.compare(0, 3, "end") == 0);
+			}
+		}
+		count_block(block_id_search->second, location, counted_instructions);
+	}
+	code.instructions = std::move(counted_instructions);
+}
+
+std::vector<Semantics::Output::Line> Semantics::get_profile_dump_lines() {
+	static const Symbol loop_symbol("profile_", "dump_loop", 0);
+	static const Symbol done_symbol("profile_", "dump_done", 0);
+
+	std::vector<Output::Line> lines;
+	lines.push_back(Output::Line("\tla    $t0, ") + profile_table_symbol);
+	lines.push_back(Output::Line("\tla    $t1, ") + profile_table_end_symbol);
+	lines.push_back({":", loop_symbol});
+	lines.push_back(Output::Line("\tbeq   $t0, $t1, ") + done_symbol);
+	lines.push_back("\t# print_string(line)");
+	lines.push_back("\tlw    $a0, ($t0)");
+	lines.push_back("\tli    $v0, 4");
+	lines.push_back("\tsyscall");
+	lines.push_back("\t# print_int(count)");
+	lines.push_back("\tlw    $a0, 4($t0)");
+	lines.push_back("\tli    $v0, 1");
+	lines.push_back("\tsyscall");
+	lines.push_back("\t# print_char('\\n')");
+	lines.push_back("\tli    $a0, 10");
+	lines.push_back("\tli    $v0, 11");
+	lines.push_back("\tsyscall");
+	lines.push_back("\taddiu $t0, $t0, 8");
+	lines.push_back(Output::Line("\tj     ") + loop_symbol);
+	lines.push_back({":", done_symbol});
+	lines.push_back("\tjr    $ra");
+	return lines;
+}
+
+void Semantics::layout_emitted_blocks(MachineCode &code, const std::map<std::string, uint64_t> &block_counts, std::set<Symbol> &hot_symbols) {
+	using Operand = MachineInstruction::Operand;
+	using Index   = std::vector<MachineInstruction>::size_type;
+
+	// | Conditional branches and the branch testing the opposite condition.
+	static const std::map<MachineInstruction::opcode_t, MachineInstruction::opcode_t> inverted_branches {
+		{MachineInstruction::beq_opcode,  MachineInstruction::bne_opcode},
+		{MachineInstruction::bne_opcode,  MachineInstruction::beq_opcode},
+		{MachineInstruction::beqz_opcode, MachineInstruction::bnez_opcode},
+		{MachineInstruction::bnez_opcode, MachineInstruction::beqz_opcode},
+		{MachineInstruction::bgez_opcode, MachineInstruction::bltz_opcode},
+		{MachineInstruction::bltz_opcode, MachineInstruction::bgez_opcode},
+		{MachineInstruction::bgtz_opcode, MachineInstruction::blez_opcode},
+		{MachineInstruction::blez_opcode, MachineInstruction::bgtz_opcode},
+	};
+
+	const std::vector<MachineInstruction> &instructions = code.instructions;
+
+	// Add the symbols that instructions refer to, other than by being labels.
+	const auto add_hot_symbols = [&code, &instructions, &hot_symbols](Index begin, Index end) -> void {
+		for (Index instruction_index = begin; instruction_index < end; ++instruction_index) {
+			const MachineInstruction &instruction = instructions[instruction_index];
+			if (instruction.opcode == MachineInstruction::label_opcode) {
+				continue;
+			}
+			for (uint8_t operand_index = 0; operand_index < instruction.num_operands; ++operand_index) {
+				if (instruction.operands[operand_index].kind == Operand::symbol_kind) {
+					hot_symbols.insert(code.symbols[instruction.operands[operand_index].symbol]);
+				}
+			}
+		}
+	};
+	// Leave the code as it is.
+	const auto keep_code = [&instructions, &add_hot_symbols]() -> void {
+		add_hot_symbols(0, instructions.size());
+	};
+
+	// Split the code into blocks, each starting at a label or after a branch
+	// or jump, and note how control leaves each: "" to fall through to the
+	// next block, "j" and "branch" to a label, and "return" and "exit".
+	std::vector<Index>                 block_begins;
+	std::vector<std::vector<uint32_t>> block_labels;
+	std::vector<std::string>           block_exits;
+	std::vector<Index>                 block_exit_indices;
+	std::map<uint32_t, Index>          label_blocks;
+	bool                   is_split         = true;
+	bool                   has_instructions = false;
+	std::optional<int32_t> syscall_code;
+	for (const MachineInstruction &instruction : std::as_const(instructions)) {
+		const Index instruction_index = &instruction - &instructions[0];
+		if (is_split || (instruction.opcode == MachineInstruction::label_opcode && has_instructions)) {
+			block_begins.push_back(instruction_index);
+			block_labels.push_back({});
+			block_exits.push_back("");
+			block_exit_indices.push_back(instruction_index);
+			is_split         = false;
+			has_instructions = false;
+		}
+		if (instruction.opcode == MachineInstruction::null_opcode || instruction.opcode == MachineInstruction::comment_opcode) {
+			continue;
+		}
+
+		if        (instruction.opcode == MachineInstruction::line_opcode) {
+			return keep_code();
+		} else if (instruction.opcode == MachineInstruction::label_opcode) {
+			block_labels.back().push_back(instruction.operands[0].symbol);
+			label_blocks.insert({instruction.operands[0].symbol, block_labels.size() - 1});
+			syscall_code = std::nullopt;
+			continue;
+		}
+		has_instructions = true;
+
+		if (instruction.num_operands >= 1 && instruction.operands[0] == Operand::make_register(MachineInstruction::v0_register)) {
+			// | Track which syscall $v0 selects: "li $v0, n" or "la $v0, n($zero)".
+			const Operand &source = instruction.operands[1];
+			if        (instruction.opcode == MachineInstruction::li_opcode && instruction.num_operands == 2 && source.kind == Operand::immediate_kind) {
+				syscall_code = source.immediate;
+			} else if (instruction.opcode == MachineInstruction::la_opcode && instruction.num_operands == 2 && source.kind == Operand::memory_kind && source.register_ == MachineInstruction::zero_register) {
+				syscall_code = source.immediate;
+			} else {
+				syscall_code = std::nullopt;
+			}
+		}
+
+		if        ((instruction.opcode == MachineInstruction::j_opcode || instruction.opcode == MachineInstruction::b_opcode) && instruction.num_operands == 1) {
+			block_exits.back() = "j";
+		} else if (instruction.is_conditional_branch()) {
+			block_exits.back() = "branch";
+		} else if (instruction.opcode == MachineInstruction::jr_opcode) {
+			if (instruction.num_operands != 1 || instruction.operands[0] != Operand::make_register(MachineInstruction::ra_register)) {
+				return keep_code();
+			}
+			block_exits.back() = "return";
+		} else if (instruction.opcode == MachineInstruction::syscall_opcode && (syscall_code == 10 || syscall_code == 17)) {
+			block_exits.back() = "exit";
+		} else {
+			continue;
+		}
+		block_exit_indices.back() = instruction_index;
+		is_split = true;
+	}
+	const Index num_blocks = block_begins.size();
+	if (num_blocks < 2 || block_exits.back() == "" || block_exits.back() == "branch") {
+		return keep_code();
+	}
+
+	// Each block's successors.  Leave code that branches out of the routine
+	// or takes the address of its labels alone.
+	std::vector<std::optional<Index>> fallthroughs(num_blocks);
+	std::vector<std::optional<Index>> targets(num_blocks);
+	for (Index block_index = 0; block_index < num_blocks; ++block_index) {
+		if (block_exits[block_index] == "" || block_exits[block_index] == "branch") {
+			fallthroughs[block_index] = block_index + 1;
+		}
+		if (block_exits[block_index] == "j" || block_exits[block_index] == "branch") {
+			const MachineInstruction &exit = instructions[block_exit_indices[block_index]];
+			const Operand            &target = exit.operands[exit.num_operands - 1];
+			const std::map<uint32_t, Index>::const_iterator label_block_search = target.kind == Operand::symbol_kind ? label_blocks.find(target.symbol) : label_blocks.cend();
+			if (label_block_search == label_blocks.cend()) {
+				return keep_code();
+			}
+			targets[block_index] = label_block_search->second;
+		}
+	}
+	for (const MachineInstruction &instruction : std::as_const(instructions)) {
+		if (instruction.opcode == MachineInstruction::label_opcode) {
+			continue;
+		}
+		const bool is_branch = ((instruction.opcode == MachineInstruction::j_opcode || instruction.opcode == MachineInstruction::b_opcode) && instruction.num_operands == 1) || instruction.is_conditional_branch();
+		for (uint8_t operand_index = 0; operand_index < instruction.num_operands; ++operand_index) {
+			const Operand &operand = instruction.operands[operand_index];
+			if (is_branch && operand_index + 1 == instruction.num_operands) {
+				continue;
+			}
+			if (operand.kind == Operand::symbol_kind && label_blocks.find(operand.symbol) != label_blocks.cend()) {
+				return keep_code();
+			}
+		}
+	}
+
+	// Find how often each block runs, from the profile.  The code that a
+	// conditional branch falls through to and no counter counted runs at
+	// most as often as the branch, and as where it continues.
+	std::vector<uint64_t> frequencies(num_blocks, 0);
+	bool is_profiled = !block_counts.empty();
+	if (is_profiled) {
+		std::vector<bool> is_counted(num_blocks, true);
+		const std::map<Index, std::string> block_ids = get_profile_block_ids(code);
+		for (Index block_index = 0; is_profiled && block_index < num_blocks; ++block_index) {
+			std::optional<uint64_t> frequency;
+			const auto find_count = [&block_counts, &frequency](const std::string &block_id) -> void {
+				const std::map<std::string, uint64_t>::const_iterator block_count_search = block_counts.find(block_id);
+				if (block_count_search != block_counts.cend()) {
+					frequency = block_count_search->second;
+				}
+			};
+			if (block_index == 0) {
+				find_count("entry");
+			}
+
+			// The count after the last label, which every way in passes.
+			for (Index instruction_index = block_begins[block_index] > 0 ? block_begins[block_index] - 1 : 0; instruction_index < instructions.size(); ++instruction_index) {
+				const MachineInstruction &instruction = instructions[instruction_index];
+				if (instruction_index >= block_begins[block_index] && instruction.is_instruction()) {
+					break;
+				}
+				const std::map<Index, std::string>::const_iterator block_id_search = block_ids.find(instruction_index);
+				if (block_id_search != block_ids.cend()) {
+					find_count(block_id_search->second);
+				}
+			}
+
+			if        (frequency.has_value()) {
+				frequencies[block_index] = *frequency;
+			} else if (block_index == 0 || !block_labels[block_index].empty()) {
+				// The profile is of different code.
+				is_profiled = false;
+			} else if (block_exits[block_index - 1] == "branch") {
+				frequencies[block_index] = frequencies[block_index - 1];
+				is_counted[block_index]  = false;
+			}
+		}
+		for (Index block_index = 0; is_profiled && block_index < num_blocks; ++block_index) {
+			if (!is_counted[block_index] && block_exits[block_index] != "branch" && (fallthroughs[block_index].has_value() || targets[block_index].has_value())) {
+				frequencies[block_index] = std::min(frequencies[block_index], frequencies[fallthroughs[block_index].has_value() ? *fallthroughs[block_index] : *targets[block_index]]);
+			}
+		}
+	}
+	// Otherwise, which blocks can return, or reach the end, rather than
+	// only stop?  A branch from one that can to one that can't is taken not
+	// to be taken, and the blocks that only such branches reach not to run.
+	std::vector<bool> can_return(num_blocks, true);
+	if (!is_profiled) {
+		can_return.assign(num_blocks, false);
+		can_return[num_blocks - 1] = true;
+		for (bool changed = true; changed; ) {
+			changed = false;
+			for (Index block_index = num_blocks; block_index > 0; --block_index) {
+				const Index index = block_index - 1;
+				if (!can_return[index] && (block_exits[index] == "return" || (fallthroughs[index].has_value() && can_return[*fallthroughs[index]]) || (targets[index].has_value() && can_return[*targets[index]]))) {
+					can_return[index] = true;
+					changed = true;
+				}
+			}
+		}
+
+		std::vector<Index> reached_blocks {0};
+		frequencies.assign(num_blocks, 0);
+		frequencies[0] = 1;
+		while (!reached_blocks.empty()) {
+			const Index block_index = reached_blocks.back();
+			reached_blocks.pop_back();
+			for (const std::optional<Index> &successor : {fallthroughs[block_index], targets[block_index]}) {
+				if (successor.has_value() && frequencies[*successor] == 0 && !(can_return[block_index] && !can_return[*successor])) {
+					frequencies[*successor] = 1;
+					reached_blocks.push_back(*successor);
+				}
+			}
+		}
+	}
+
+	// Weigh each edge by how often it's taken.  Where a branch falls through
+	// to code only it reaches, how often it's taken is the difference.
+	std::map<std::pair<Index, Index>, uint64_t> edge_weights;
+	const auto add_edge = [&edge_weights, &can_return](Index source, Index destination, uint64_t weight) -> void {
+		if (can_return[source] && !can_return[destination]) {
+			weight = 0;
+		}
+		uint64_t &edge_weight = edge_weights[{source, destination}];
+		edge_weight = std::max(edge_weight, weight);
+	};
+	for (Index block_index = 0; block_index < num_blocks; ++block_index) {
+		const uint64_t frequency = frequencies[block_index];
+		if        (block_exits[block_index] == "branch") {
+			const Index fallthrough = *fallthroughs[block_index];
+			const Index target      = *targets[block_index];
+			const uint64_t fallthrough_weight = std::min(frequency, frequencies[fallthrough]);
+			add_edge(block_index, fallthrough, fallthrough_weight);
+			add_edge(block_index, target, std::min(is_profiled && block_labels[fallthrough].empty() ? frequency - fallthrough_weight : frequency, frequencies[target]));
+		} else if (fallthroughs[block_index].has_value()) {
+			add_edge(block_index, *fallthroughs[block_index], std::min(frequency, frequencies[*fallthroughs[block_index]]));
+		} else if (targets[block_index].has_value()) {
+			add_edge(block_index, *targets[block_index], std::min(frequency, frequencies[*targets[block_index]]));
+		}
+	}
+
+	// Chain the blocks along the heaviest forward edges first, and, of
+	// those that weigh the same, the ones that already fall through, so
+	// that without a reason to, nothing moves.  An edge joins the end of
+	// one chain to the start of another.  Each chain is numbered by the
+	// block it starts with.
+	//
+	// An edge that doesn't fall through yet only counts if it's taken more
+	// often than the ones that do and that it would displace, its source's
+	// and its destination's, which would need branches or jumps instead.
+	const auto get_edge_weight = [&edge_weights](Index source, Index destination) -> uint64_t {
+		const std::map<std::pair<Index, Index>, uint64_t>::const_iterator edge_weight_search = edge_weights.find({source, destination});
+		return edge_weight_search == edge_weights.cend() ? 0 : edge_weight_search->second;
+	};
+	std::vector<std::tuple<uint64_t, bool, Index, Index>> edges;
+	for (const std::pair<const std::pair<Index, Index>, uint64_t> &edge_weight : std::as_const(edge_weights)) {
+		const Index source      = edge_weight.first.first;
+		const Index destination = edge_weight.first.second;
+		if (destination <= source) {
+			continue;
+		}
+		const bool is_fallthrough = fallthroughs[source] == destination;
+		uint64_t displaced_weight = 0;
+		if (!is_fallthrough && fallthroughs[source].has_value()) {
+			displaced_weight += get_edge_weight(source, *fallthroughs[source]);
+		}
+		if (!is_fallthrough && fallthroughs[destination - 1] == destination) {
+			displaced_weight += get_edge_weight(destination - 1, destination);
+		}
+		if (edge_weight.second > displaced_weight) {
+			edges.push_back({edge_weight.second, is_fallthrough, source, destination});
+		}
+	}
+	std::stable_sort(edges.begin(), edges.end(), [](const std::tuple<uint64_t, bool, Index, Index> &a, const std::tuple<uint64_t, bool, Index, Index> &b) -> bool {
+		return std::get<0>(a) != std::get<0>(b) ? std::get<0>(a) > std::get<0>(b) : std::get<1>(a) > std::get<1>(b);
+	});
+	std::vector<std::vector<Index>> chains;
+	std::vector<Index>              block_chains;
+	for (Index block_index = 0; block_index < num_blocks; ++block_index) {
+		chains.push_back({block_index});
+		block_chains.push_back(block_index);
+	}
+	for (const std::tuple<uint64_t, bool, Index, Index> &edge : std::as_const(edges)) {
+		const Index source_chain      = block_chains[std::get<2>(edge)];
+		const Index destination_chain = block_chains[std::get<3>(edge)];
+		if (source_chain == destination_chain || chains[source_chain].back() != std::get<2>(edge) || chains[destination_chain].front() != std::get<3>(edge)) {
+			continue;
+		}
+		for (const Index block_index : std::as_const(chains[destination_chain])) {
+			chains[source_chain].push_back(block_index);
+			block_chains[block_index] = source_chain;
+		}
+		chains[destination_chain].clear();
+	}
+
+	// The entry's chain comes first, then the chains of blocks that run,
+	// and then the rest, each in their original order.
+	std::vector<Index> block_order;
+	for (int pass = 0; pass < 3; ++pass) {
+		for (const std::vector<Index> &chain : std::as_const(chains)) {
+			const std::vector<Index>::size_type chain_index = &chain - &chains[0];
+			if (chain.empty()) {
+				continue;
+			}
+			const bool runs = std::any_of(chain.cbegin(), chain.cend(), [&frequencies](Index block_index) -> bool { return frequencies[block_index] > 0; });
+			if ((pass == 0 && chain_index == 0) || (pass == 1 && chain_index != 0 && runs) || (pass == 2 && chain_index != 0 && !runs)) {
+				block_order.insert(block_order.end(), chain.cbegin(), chain.cend());
+			}
+		}
+	}
+	for (Index block_index = 0; block_index < num_blocks; ++block_index) {
+		if (frequencies[block_index] > 0) {
+			add_hot_symbols(block_begins[block_index], block_index + 1 < num_blocks ? block_begins[block_index + 1] : instructions.size());
+		}
+	}
+	bool is_reordered = false;
+	for (Index block_index = 0; block_index < num_blocks; ++block_index) {
+		is_reordered = is_reordered || block_order[block_index] != block_index;
+	}
+	if (!is_reordered) {
+		return;
+	}
+
+	// Fix up the control flow of each block for the one after it now: drop
+	// jumps to it, branch on the opposite condition instead of branching
+	// to it, and jump to where the block used to continue if that moved.
+	std::vector<bool> is_exit_deleted(num_blocks, false);
+	std::vector<bool> is_exit_inverted(num_blocks, false);
+	std::vector<bool> needs_jump(num_blocks, false);
+	std::vector<bool> needs_label(num_blocks, false);
+	for (const Index &block_index : std::as_const(block_order)) {
+		const std::vector<Index>::size_type position = &block_index - &block_order[0];
+		const std::optional<Index> next = position + 1 < block_order.size() ? std::optional<Index>(block_order[position + 1]) : std::nullopt;
+		if        (block_exits[block_index] == "j") {
+			is_exit_deleted[block_index] = next == targets[block_index];
+		} else if (fallthroughs[block_index].has_value() && next != fallthroughs[block_index]) {
+			if (block_exits[block_index] == "branch" && next == targets[block_index] && inverted_branches.find(instructions[block_exit_indices[block_index]].opcode) != inverted_branches.cend()) {
+				is_exit_inverted[block_index] = true;
+			} else {
+				needs_jump[block_index] = true;
+			}
+			needs_label[*fallthroughs[block_index]] = true;
+		}
+	}
+
+	// Label the blocks that now need one after the label that their branch
+	// targets.
+	std::map<Index, uint32_t> inserted_labels;
+	for (Index block_index = 0; block_index < num_blocks; ++block_index) {
+		if (!needs_label[block_index] || !block_labels[block_index].empty()) {
+			continue;
+		}
+		if (block_index == 0 || block_exits[block_index - 1] != "branch") {
+			std::ostringstream sstr;
+			sstr << "Semantics::layout_emitted_blocks: internal error: block " << block_index << " needs a label but doesn't follow a conditional branch.";
+			throw SemanticsError(sstr.str());
+		}
+		const MachineInstruction &branch        = instructions[block_exit_indices[block_index - 1]];
+		const Symbol              target_symbol = code.symbols[branch.operands[branch.num_operands - 1].symbol];
+		Symbol label_symbol(target_symbol.prefix, target_symbol.requested_suffix + "_fallthrough", target_symbol.unique_identifier);
+		for (uint64_t label_number = 2; code.has_symbol(label_symbol); ++label_number) {
+			label_symbol.requested_suffix = target_symbol.requested_suffix + "_fallthrough_" + std::to_string(label_number);
+		}
+		const uint32_t label = code.add_symbol(label_symbol);
+		block_labels[block_index].push_back(label);
+		inserted_labels.insert({block_index, label});
+	}
+
+	// Emit the blocks in their new order.
+	std::vector<MachineInstruction> laid_out_instructions;
+	for (const Index block_index : std::as_const(block_order)) {
+		const std::map<Index, uint32_t>::const_iterator inserted_label_search = inserted_labels.find(block_index);
+		if (inserted_label_search != inserted_labels.cend()) {
+			laid_out_instructions.push_back(MachineInstruction(MachineInstruction::label_opcode, {Operand::make_symbol(inserted_label_search->second)}));
+		}
+		const Index end = block_index + 1 < num_blocks ? block_begins[block_index + 1] : instructions.size();
+		for (Index instruction_index = block_begins[block_index]; instruction_index < end; ++instruction_index) {
+			if        (instruction_index == block_exit_indices[block_index] && is_exit_deleted[block_index]) {
+				continue;
+			} else if (instruction_index == block_exit_indices[block_index] && is_exit_inverted[block_index]) {
+				MachineInstruction inverted_branch = instructions[instruction_index];
+				inverted_branch.opcode = inverted_branches.at(inverted_branch.opcode);
+				inverted_branch.operands[inverted_branch.num_operands - 1] = Operand::make_symbol(block_labels[*fallthroughs[block_index]].front());
+				laid_out_instructions.push_back(inverted_branch);
+			} else {
+				laid_out_instructions.push_back(instructions[instruction_index]);
+			}
+		}
+		if (needs_jump[block_index]) {
+			laid_out_instructions.push_back(MachineInstruction(MachineInstruction::j_opcode, {Operand::make_symbol(block_labels[*fallthroughs[block_index]].front())}));
+		}
+	}
+	code.instructions = std::move(laid_out_instructions);
+}
+
+std::vector<std::vector<std::pair<std::string, Semantics::TypeIndex>>::size_type> Semantics::layout_globals(const std::vector<std::pair<std::string, TypeIndex>> &globals, const IdentifierScope &storage_scope) const {
+	std::vector<std::vector<std::pair<std::string, TypeIndex>>::size_type> layout;
+	for (const std::pair<std::string, TypeIndex> &global : std::as_const(globals)) {
+		layout.push_back(&global - &globals[0]);
+	}
+	if (!optimize) {
+		return layout;
+	}
+
+	// Estimate how often each global is used: count the references to its
+	// identifier, weighting those in loops by 8 per level of nesting, or by
+	// how often they ran given a profile.  Only the relative order matters,
+	// and a local that shadows a global just makes the estimate a little
+	// high.
+	std::map<std::string, uint64_t> references;
+	for (const std::pair<std::string, TypeIndex> &global : std::as_const(globals)) {
+		references.insert({global.first, 0});
+	}
+	for (const Lexeme &lexeme : std::as_const(grammar.lexemes)) {
+		const std::vector<Lexeme>::size_type lexeme_index = &lexeme - &grammar.lexemes[0];
+		if (lexeme.is_identifier() && lexeme_index < lexeme_weights.size()) {
+			std::map<std::string, uint64_t>::iterator references_search = references.find(lexeme.get_identifier().text);
+			if (references_search != references.end()) {
+				references_search->second += lexeme_weights[lexeme_index];
+			}
+		}
+	}
+
+	// Order by alignment class: aggregates, which the assembler aligns to
+	// 16 bytes, then words, then bytes.  Aggregates whose size keeps the
+	// next one aligned go first.
+	const auto alignment_class = [&] (std::vector<std::pair<std::string, TypeIndex>>::size_type global_index) -> uint32_t {
+		const Type     &type = storage_scope.type(globals[global_index].second);
+		const uint32_t  size = type.get_size();
+		if (type.resolve_type(storage_scope).is_array() || type.resolve_type(storage_scope).is_record()) {
+			return size % 16 == 0 ? 0 : 1;
+		} else {
+			return size == 4 ? 2 : 3;
+		}
+	};
+	std::stable_sort(layout.begin(), layout.end(), [&] (std::vector<std::pair<std::string, TypeIndex>>::size_type a, std::vector<std::pair<std::string, TypeIndex>>::size_type b) -> bool {
+		const uint32_t a_class = alignment_class(a);
+		const uint32_t b_class = alignment_class(b);
+		if (a_class != b_class) {
+			return a_class < b_class;
+		}
+		return references.at(globals[a].first) > references.at(globals[b].first);
+	});
+
+	return layout;
+}
+
+const std::vector<Semantics::MachineInstruction::register_id_t> Semantics::promotion_registers {
+	MachineInstruction::s0_register,
+	MachineInstruction::s1_register,
+	MachineInstruction::s2_register,
+	MachineInstruction::s3_register,
+	MachineInstruction::s4_register,
+	MachineInstruction::s5_register,
+	MachineInstruction::s6_register,
+	MachineInstruction::s7_register,
+	MachineInstruction::v1_register,
+};
+
+// | Keep globals and ref parameters that a loop without calls accesses in
+// registers for the whole loop.
+//
+// A loop is the code from a label to the last branch back to it.  It must
+// only be entered through the label or through a jump right before it into
+// the loop (how "for" and "while" loops are emitted), and must only leave
+// by falling through the last branch or with unconditional jumps, e.g. for
+// "return", or an exit syscall, for "stop".  A word is promoted if every
+// access to it in the loop is a plain word load or store and no other
+// access in the loop may alias it.
+//
+// Since emitted code leaves promotion_registers alone and the loop makes no
+// calls, a promoted register can't be clobbered while the loop runs.
+void Semantics::promote_loop_scalars(MachineCode &code, const std::map<int32_t, uint32_t> &small_data_objects, const std::vector<uint64_t> &lexeme_weights) {
+	using Operand = MachineInstruction::Operand;
+	using Index   = std::vector<MachineInstruction>::size_type;
+
+	std::set<uint32_t> visited_loops;
+
+	// Promote one loop at a time, innermost or hottest first.
+	for (bool changed = true; changed; ) {
+		changed = false;
+
+		const std::vector<MachineInstruction> &instructions  = code.instructions;
+		const std::map<uint32_t, Index>        labels        = code.get_label_indices();
+		const bool                             locals_escape = emitted_locals_escape(code);
+
+		// The label a branch or jump goes to, if any.
+		const auto get_target = [&labels](const MachineInstruction &instruction) -> std::optional<uint32_t> {
+			if (instruction.num_operands == 0 || instruction.operands[instruction.num_operands - 1].kind != Operand::symbol_kind) {
+				return std::nullopt;
+			}
+			return instruction.operands[instruction.num_operands - 1].symbol;
+		};
+
+		// Which promotion registers are free?
+		MachineInstruction::RegisterSet used_registers = 0;
+		for (const MachineInstruction &instruction : std::as_const(instructions)) {
+			used_registers |= instruction.get_mentioned_registers();
+		}
+		std::vector<MachineInstruction::register_id_t> free_registers;
+		for (const MachineInstruction::register_id_t &promotion_register : std::as_const(promotion_registers)) {
+			bool is_used = (used_registers & (static_cast<MachineInstruction::RegisterSet>(1) << promotion_register)) != 0;
+			for (const Output::Line &line : std::as_const(code.lines)) {
+				is_used = is_used || line.line.find(MachineInstruction::register_names[promotion_register]) != std::string::npos;
+			}
+			if (!is_used) {
+				free_registers.push_back(promotion_register);
+			}
+		}
+		if (free_registers.empty()) {
+			break;
+		}
+
+		// Innermost loops end first.  Given weights, rank loops by how often
+		// their headers run instead.
+		std::vector<Index> back_branch_indices;
+		for (Index instruction_index = 0; instruction_index < instructions.size(); ++instruction_index) {
+			back_branch_indices.push_back(instruction_index);
+		}
+		if (!lexeme_weights.empty()) {
+			const auto header_weight = [&] (Index instruction_index) -> uint64_t {
+				const std::optional<uint32_t> target = get_target(instructions[instruction_index]);
+				if (!target.has_value() || code.symbols[*target].unique_identifier >= lexeme_weights.size()) {
+					return 0;
+				}
+				return lexeme_weights[code.symbols[*target].unique_identifier];
+			};
+			std::stable_sort(back_branch_indices.begin(), back_branch_indices.end(), [&] (Index a, Index b) -> bool {
+				return header_weight(a) > header_weight(b);
+			});
+		}
+
+		for (const Index &back_branch_index : std::as_const(back_branch_indices)) {
+			const MachineInstruction &back_branch = instructions[back_branch_index];
+
+			// Find the next loop: a branch back to a label not yet visited.
+			const std::optional<uint32_t> header = get_target(back_branch);
+			if (!(back_branch.is_conditional_branch() || back_branch.opcode == MachineInstruction::b_opcode || back_branch.opcode == MachineInstruction::j_opcode) || !header.has_value()) {
+				continue;
+			}
+			const std::map<uint32_t, Index>::const_iterator header_search = labels.find(*header);
+			if (header_search == labels.cend() || header_search->second >= back_branch_index || visited_loops.find(*header) != visited_loops.cend()) {
+				continue;
+			}
+			visited_loops.insert(*header);
+
+			// The loop ends at the last branch back to the header.
+			const Index header_index = header_search->second;
+			Index       end_index    = back_branch_index;
+			for (const MachineInstruction &instruction : std::as_const(instructions)) {
+				const Index instruction_index = &instruction - &instructions[0];
+				if (instruction_index > end_index && (instruction.is_conditional_branch() || instruction.opcode == MachineInstruction::b_opcode || instruction.opcode == MachineInstruction::j_opcode) && get_target(instruction) == header) {
+					end_index = instruction_index;
+				}
+			}
+			const bool falls_through = instructions[end_index].opcode != MachineInstruction::j_opcode;
+
+			// Find the entry: a jump right before the header into the loop, or else the header itself.
+			Index entry_index = header_index;
+			for (Index previous_index = header_index; previous_index > 0; --previous_index) {
+				const MachineInstruction &previous = instructions[previous_index - 1];
+				if (previous.opcode == MachineInstruction::null_opcode || previous.opcode == MachineInstruction::comment_opcode) {
+					continue;
+				}
+				if (previous.opcode == MachineInstruction::j_opcode && previous.num_operands == 1) {
+					const std::optional<uint32_t> entry = get_target(previous);
+					const std::map<uint32_t, Index>::const_iterator entry_search = entry.has_value() ? labels.find(*entry) : labels.cend();
+					if (entry_search != labels.cend() && entry_search->second > header_index && entry_search->second <= end_index) {
+						entry_index = previous_index - 1;
+					}
+				}
+				break;
+			}
+
+			// Nothing outside may branch into the loop, and inside, there may
+			// be no calls or syscalls that could access memory, and no
+			// conditional branches out of the loop.
+			bool is_promotable = true;
+			for (const MachineInstruction &instruction : std::as_const(instructions)) {
+				const Index instruction_index = &instruction - &instructions[0];
+				const bool  is_inside         = instruction_index >= header_index && instruction_index <= end_index;
+				if (is_inside || instruction_index == entry_index || instruction.opcode == MachineInstruction::label_opcode) {
+					continue;
+				}
+				for (uint8_t operand_index = 0; operand_index < instruction.num_operands; ++operand_index) {
+					const Operand &operand = instruction.operands[operand_index];
+					const std::map<uint32_t, Index>::const_iterator label_search = operand.kind == Operand::symbol_kind ? labels.find(operand.symbol) : labels.cend();
+					if (label_search != labels.cend() && label_search->second >= header_index && label_search->second <= end_index) {
+						is_promotable = false;
+					}
+				}
+			}
+			std::vector<Index>     exit_indices;
+			std::optional<int32_t> syscall_code;
+			for (Index instruction_index = header_index + 1; is_promotable && instruction_index <= end_index; ++instruction_index) {
+				const MachineInstruction &instruction = instructions[instruction_index];
+				if (instruction.opcode == MachineInstruction::null_opcode || instruction.opcode == MachineInstruction::comment_opcode) {
+					continue;
+				}
+				if (instruction.opcode == MachineInstruction::label_opcode) {
+					syscall_code = std::nullopt;
+					continue;
+				}
+
+				if (instruction.num_operands >= 1 && instruction.operands[0] == Operand::make_register(MachineInstruction::v0_register)) {
+					// | Track which syscall $v0 selects: "li $v0, n" or "la $v0, n($zero)".
+					const Operand &source = instruction.operands[1];
+					if        (instruction.opcode == MachineInstruction::li_opcode && instruction.num_operands == 2 && source.kind == Operand::immediate_kind) {
+						syscall_code = source.immediate;
+					} else if (instruction.opcode == MachineInstruction::la_opcode && instruction.num_operands == 2 && source.kind == Operand::memory_kind && source.register_ == MachineInstruction::zero_register) {
+						syscall_code = source.immediate;
+					} else {
+						syscall_code = std::nullopt;
+					}
+				}
+
+				if        (instruction.opcode == MachineInstruction::syscall_opcode) {
+					if        (syscall_code == 10 || syscall_code == 17) {
+						exit_indices.push_back(instruction_index);
+					} else if (syscall_code != 1 && syscall_code != 4 && syscall_code != 5 && syscall_code != 11 && syscall_code != 12) {
+						is_promotable = false;
+					}
+				} else if (instruction.is_conditional_branch() || instruction.is_jump() || instruction.is_call()) {
+					const std::optional<uint32_t>                   target        = get_target(instruction);
+					const std::map<uint32_t, Index>::const_iterator target_search = target.has_value() ? labels.find(*target) : labels.cend();
+					if        (instruction.is_call() || instruction.opcode == MachineInstruction::jr_opcode || target_search == labels.cend()) {
+						is_promotable = false;
+					} else if (target_search->second < header_index || target_search->second > end_index) {
+						if (instruction.opcode == MachineInstruction::j_opcode) {
+							exit_indices.push_back(instruction_index);
+						} else {
+							is_promotable = false;
+						}
+					}
+				} else if (instruction.opcode == MachineInstruction::line_opcode) {
+					is_promotable = false;
+				}
+			}
+			if (!is_promotable) {
+				continue;
+			}
+
+			// Classify the memory accesses in the loop.
+			std::map<MachineInstruction::register_id_t, MemoryLocation> addresses;
+			MachineInstruction::RegisterSet                             destinations = 0;
+			std::vector<std::pair<MemoryLocation, Index>>               accesses;
+			for (Index instruction_index = header_index + 1; instruction_index <= end_index; ++instruction_index) {
+				const MachineInstruction &instruction = instructions[instruction_index];
+				if (instruction.ends_block()) {
+					addresses.clear();
+				}
+
+				const uint32_t load_size  = instruction.get_load_size();
+				const uint32_t store_size = instruction.get_store_size();
+				if (load_size != 0 || store_size != 0) {
+					accesses.push_back({get_memory_location(instruction.operands[1], load_size != 0 ? load_size : store_size, addresses), instruction_index});
+				}
+
+				const std::optional<MachineInstruction::register_id_t> destination = instruction.get_destination();
+				if (destination.has_value()) {
+					destinations |= static_cast<MachineInstruction::RegisterSet>(1) << *destination;
+					const std::optional<MemoryLocation> computed_address = get_computed_address(instruction, addresses, small_data_objects);
+					std::map<MachineInstruction::register_id_t, MemoryLocation> unchanged_addresses;
+					for (const std::pair<const MachineInstruction::register_id_t, MemoryLocation> &address : std::as_const(addresses)) {
+						if (address.first != *destination && address.second.base != Operand::make_register(*destination)) {
+							unchanged_addresses.insert(address);
+						}
+					}
+					addresses = std::move(unchanged_addresses);
+					if (computed_address.has_value()) {
+						addresses.insert({*destination, *computed_address});
+					}
+				}
+			}
+
+			// Pick the words to promote.
+			std::vector<std::pair<MemoryLocation, MachineInstruction::register_id_t>> promotions;  // {location, register}
+			std::vector<bool> is_stored;
+			for (const std::pair<MemoryLocation, Index> &access : std::as_const(accesses)) {
+				const MemoryLocation &location = access.first;
+				const bool is_unchanged_pointer = location.kind == MemoryLocation::pointer_kind && (destinations & (static_cast<MachineInstruction::RegisterSet>(1) << location.base.register_)) == 0;
+				if (promotions.size() >= free_registers.size() || !location.is_exact || location.size != 4 || !(location.kind == MemoryLocation::small_global_kind || location.kind == MemoryLocation::global_kind || is_unchanged_pointer)) {
+					continue;
+				}
+				bool is_candidate = true;
+				bool is_candidate_stored = false;
+				for (const std::pair<MemoryLocation, MachineInstruction::register_id_t> &promotion : std::as_const(promotions)) {
+					if (promotion.first.is_same(location)) {
+						is_candidate = false;
+					}
+				}
+				for (const std::pair<MemoryLocation, Index> &other_access : std::as_const(accesses)) {
+					if (other_access.first.is_same(location)) {
+						is_candidate_stored = is_candidate_stored || instructions[other_access.second].get_store_size() != 0;
+					} else if (other_access.first.may_alias(location, locals_escape)) {
+						is_candidate = false;
+					}
+				}
+				if (is_candidate) {
+					promotions.push_back({location, free_registers[promotions.size()]});
+					is_stored.push_back(is_candidate_stored);
+				}
+			}
+			if (promotions.empty()) {
+				continue;
+			}
+
+			// Instructions to load promoted words into their registers or store them back.
+			std::vector<MachineInstruction> preheader_instructions;
+			std::vector<MachineInstruction> exit_instructions;
+			for (const std::pair<MemoryLocation, MachineInstruction::register_id_t> &promotion : std::as_const(promotions)) {
+				const std::vector<std::pair<MemoryLocation, MachineInstruction::register_id_t>>::size_type promotion_index = &promotion - &promotions[0];
+				const MemoryLocation &location  = promotion.first;
+				const Operand         register_ = Operand::make_register(promotion.second);
+
+				if (location.kind == MemoryLocation::global_kind) {
+					// "$t9" is only used within an instruction's emitted lines, so it is free here.
+					const MachineInstruction load_address(MachineInstruction::la_opcode, {Operand::make_register(MachineInstruction::t9_register), location.base});
+					const Operand            address = Operand::make_memory(MachineInstruction::t9_register, location.offset);
+					preheader_instructions.push_back(load_address);
+					preheader_instructions.push_back(MachineInstruction(MachineInstruction::lw_opcode, {register_, address}));
+					if (is_stored[promotion_index]) {
+						exit_instructions.push_back(load_address);
+						exit_instructions.push_back(MachineInstruction(MachineInstruction::sw_opcode, {register_, address}));
+					}
+				} else {
+					const Operand address = Operand::make_memory(location.base.register_, location.offset);
+					preheader_instructions.push_back(MachineInstruction(MachineInstruction::lw_opcode, {register_, address}));
+					if (is_stored[promotion_index]) {
+						exit_instructions.push_back(MachineInstruction(MachineInstruction::sw_opcode, {register_, address}));
+					}
+				}
+			}
+
+			// Rewrite the loop.
+			std::map<Index, MachineInstruction> replaced;
+			for (const std::pair<MemoryLocation, Index> &access : std::as_const(accesses)) {
+				for (const std::pair<MemoryLocation, MachineInstruction::register_id_t> &promotion : std::as_const(promotions)) {
+					if (access.first.is_same(promotion.first)) {
+						const MachineInstruction &instruction = instructions[access.second];
+						if (instruction.get_load_size() != 0) {
+							replaced.insert({access.second, MachineInstruction(MachineInstruction::la_opcode, {instruction.operands[0], Operand::make_memory(promotion.second, 0)})});
+						} else {
+							replaced.insert({access.second, MachineInstruction(MachineInstruction::la_opcode, {Operand::make_register(promotion.second), Operand::make_memory(instruction.operands[0].register_, 0)})});
+						}
+					}
+				}
+			}
+
+			std::vector<MachineInstruction> rewritten_instructions;
+			for (const MachineInstruction &instruction : std::as_const(instructions)) {
+				const Index instruction_index = &instruction - &instructions[0];
+
+				if (instruction_index == entry_index) {
+					rewritten_instructions.insert(rewritten_instructions.end(), preheader_instructions.cbegin(), preheader_instructions.cend());
+				}
+				if (std::find(exit_indices.cbegin(), exit_indices.cend(), instruction_index) != exit_indices.cend()) {
+					rewritten_instructions.insert(rewritten_instructions.end(), exit_instructions.cbegin(), exit_instructions.cend());
+				}
+
+				const std::map<Index, MachineInstruction>::const_iterator replaced_search = replaced.find(instruction_index);
+				rewritten_instructions.push_back(replaced_search == replaced.cend() ? instruction : replaced_search->second);
+
+				if (instruction_index == end_index && falls_through) {
+					rewritten_instructions.insert(rewritten_instructions.end(), exit_instructions.cbegin(), exit_instructions.cend());
+				}
+			}
+			code.instructions = std::move(rewritten_instructions);
+
+			changed = true;
+			break;
+		}
+	}
+}
+
+// | Within each basic block of emitted code, read registers copied with
+// "la $d, ($r)" from the original register instead, and then remove
+// copies and other side-effect-free instructions whose results are never
+// read.
+void Semantics::propagate_emitted_copies(MachineCode &code) {
+	using Operand     = MachineInstruction::Operand;
+	using Index       = std::vector<MachineInstruction>::size_type;
+	using RegisterSet = MachineInstruction::RegisterSet;
+
+	// | Instructions with no effect but writing their destination.  (add,
+	// sub, and loads can trap.)
+	static const std::set<MachineInstruction::opcode_t> pure_instructions {
+		MachineInstruction::la_opcode,   MachineInstruction::li_opcode,   MachineInstruction::lui_opcode,  MachineInstruction::move_opcode,
+		MachineInstruction::addu_opcode, MachineInstruction::addiu_opcode, MachineInstruction::subu_opcode,
+		MachineInstruction::and_opcode,  MachineInstruction::andi_opcode, MachineInstruction::or_opcode,   MachineInstruction::ori_opcode,
+		MachineInstruction::xor_opcode,  MachineInstruction::xori_opcode, MachineInstruction::nor_opcode,
+		MachineInstruction::slt_opcode,  MachineInstruction::sltu_opcode, MachineInstruction::slti_opcode, MachineInstruction::sltiu_opcode,
+		MachineInstruction::sll_opcode,  MachineInstruction::srl_opcode,  MachineInstruction::sra_opcode,
+		MachineInstruction::sllv_opcode, MachineInstruction::srlv_opcode, MachineInstruction::srav_opcode,
+		MachineInstruction::mul_opcode,  MachineInstruction::mflo_opcode, MachineInstruction::mfhi_opcode, MachineInstruction::seb_opcode, MachineInstruction::seh_opcode,
+	};
+
+	std::vector<MachineInstruction> &instructions = code.instructions;
+
+	const auto get_register_bit = [](MachineInstruction::register_id_t register_) -> RegisterSet {
+		return static_cast<RegisterSet>(1) << register_;
+	};
+	// Is the instruction a copy, "la $d, ($r)"?
+	const auto is_copy = [](const MachineInstruction &instruction) -> bool {
+		return instruction.opcode == MachineInstruction::la_opcode && instruction.num_operands == 2 && instruction.operands[0].kind == Operand::register_kind && instruction.operands[1] == Operand::make_memory(instruction.operands[1].register_, 0);
+	};
+	// Is the instruction a blank line or one that was removed?
+	const auto is_blank = [](const MachineInstruction &instruction) -> bool {
+		return instruction.opcode == MachineInstruction::null_opcode || instruction.opcode == MachineInstruction::comment_opcode;
+	};
+	// Does the instruction read or pass registers implicitly, so that they
+	// can't be renamed?
+	const auto reads_implicitly = [](const MachineInstruction &instruction) -> bool {
+		return instruction.opcode == MachineInstruction::label_opcode || instruction.opcode == MachineInstruction::line_opcode || instruction.opcode == MachineInstruction::syscall_opcode || instruction.is_call() || instruction.opcode == MachineInstruction::jr_opcode;
+	};
+	// An instruction that both reads and writes its destination, like movn.
+	const auto reads_destination = [](const MachineInstruction &instruction) -> bool {
+		return instruction.opcode == MachineInstruction::movz_opcode || instruction.opcode == MachineInstruction::movn_opcode || instruction.opcode == MachineInstruction::ins_opcode;
+	};
+	// Rename the explicit reads of a register.
+	const auto rename_reads = [&reads_destination](MachineInstruction &instruction, MachineInstruction::register_id_t from, MachineInstruction::register_id_t to) -> void {
+		const bool has_destination = instruction.get_destination().has_value();
+		for (uint8_t operand_index = 0; operand_index < instruction.num_operands; ++operand_index) {
+			Operand &operand = instruction.operands[operand_index];
+			if (operand_index == 0 && has_destination && !reads_destination(instruction)) {
+				continue;
+			}
+			if ((operand.kind == Operand::register_kind || operand.kind == Operand::memory_kind) && operand.register_ == from) {
+				operand.register_ = to;
+			}
+		}
+	};
+
+	// Propagate copies forward.
+	for (const MachineInstruction &copy : std::as_const(instructions)) {
+		const Index copy_index = &copy - &instructions[0];
+		if (!is_copy(copy)) {
+			continue;
+		}
+		const MachineInstruction::register_id_t destination = copy.operands[0].register_;
+		const MachineInstruction::register_id_t source      = copy.operands[1].register_;
+		if (destination == source || destination == MachineInstruction::sp_register || destination == MachineInstruction::gp_register || destination == MachineInstruction::zero_register) {
+			continue;
+		}
+
+		for (Index instruction_index = copy_index + 1; instruction_index < instructions.size(); ++instruction_index) {
+			MachineInstruction &instruction = instructions[instruction_index];
+			if (is_blank(instruction)) {
+				continue;
+			}
+
+			// Registers read implicitly can't be renamed.
+			if (reads_implicitly(instruction)) {
+				break;
+			}
+
+			// An instruction that both reads and writes the destination, like
+			// movn, can't read from the source instead.
+			const std::optional<MachineInstruction::register_id_t> instruction_destination = instruction.get_destination();
+			if (reads_destination(instruction) && instruction_destination == destination) {
+				break;
+			}
+
+			// Rename explicit reads of the destination.
+			if ((instruction.get_uses() & get_register_bit(destination)) != 0) {
+				rename_reads(instruction, destination, source);
+			}
+
+			if ((instruction.ends_block() && !instruction.is_conditional_branch()) || instruction_destination == destination || instruction_destination == source) {
+				break;
+			}
+		}
+	}
+
+	// Coalesce copies with the instruction computing their source: in
+	// "addu $t3, $t1, $t2; la $t0, ($t3)", write $t0 directly if $t3 is read
+	// nowhere else.
+	//
+	// Liveness is computed once per sweep.  Coalescing a copy only changes
+	// whether its two registers are live from the computation to the last
+	// instruction it looked at, so a later copy whose analysis reads
+	// liveness there waits for the next sweep.
+	std::vector<RegisterSet> copy_live_out;
+	const std::map<uint32_t, Index> labels = code.get_label_indices();
+	for (bool changed = true; changed; ) {
+		changed = false;
+		copy_live_out = code.get_live_registers();
+		std::vector<bool> is_stale(instructions.size(), false);
+		Index coalesced_end = 0;
+		for (Index copy_index = 0; copy_index < instructions.size(); ++copy_index) {
+			if (!is_copy(instructions[copy_index])) {
+				continue;
+			}
+			const MachineInstruction::register_id_t destination = instructions[copy_index].operands[0].register_;
+			const MachineInstruction::register_id_t source      = instructions[copy_index].operands[1].register_;
+			if (destination == source || destination == MachineInstruction::sp_register || destination == MachineInstruction::gp_register || destination == MachineInstruction::zero_register || source == MachineInstruction::sp_register || source == MachineInstruction::gp_register) {
+				continue;
+			}
+			const RegisterSet source_bit      = get_register_bit(source);
+			const RegisterSet destination_bit = get_register_bit(destination);
+
+			// Find where the source was computed, in the same basic block, with
+			// neither register read nor the destination written in between.
+			std::optional<Index> computation_index;
+			for (Index instruction_index = copy_index; instruction_index > coalesced_end; --instruction_index) {
+				const Index               previous_index = instruction_index - 1;
+				const MachineInstruction &previous       = instructions[previous_index];
+				if (is_blank(previous)) {
+					continue;
+				}
+				const std::optional<MachineInstruction::register_id_t> previous_destination = previous.get_destination();
+				if (previous.ends_block() || previous_destination == destination) {
+					break;
+				}
+				if (previous_destination == source) {
+					if (pure_instructions.find(previous.opcode) != pure_instructions.cend()) {
+						computation_index = previous_index;
+					}
+					break;
+				}
+				if ((previous.get_uses() & (source_bit | destination_bit)) != 0) {
+					break;
+				}
+			}
+			if (!computation_index.has_value()) {
+				continue;
+			}
+
+			// If the source is still read after the copy, those reads can use
+			// the destination instead, as long as it keeps the same value until
+			// the source is no longer needed, within this basic block.
+			std::vector<Index> later_uses;
+			bool  is_coalescable    = true;
+			bool  reads_stale       = is_stale[copy_index];
+			Index instruction_index = copy_index;
+			while ((copy_live_out[instruction_index] & source_bit) != 0) {
+				++instruction_index;
+				if (instruction_index >= instructions.size()) {
+					is_coalescable = false;
+					break;
+				}
+				reads_stale = reads_stale || is_stale[instruction_index];
+				const MachineInstruction &instruction = instructions[instruction_index];
+				if (is_blank(instruction)) {
+					continue;
+				}
+				const std::optional<MachineInstruction::register_id_t> instruction_destination = instruction.get_destination();
+				const bool is_source_live = (copy_live_out[instruction_index] & source_bit) != 0;
+				if ((instruction.get_uses() & source_bit) != 0) {
+					if (reads_implicitly(instruction) || instruction_destination == source) {
+						is_coalescable = false;
+						break;
+					}
+					later_uses.push_back(instruction_index);
+				}
+				if (instruction_destination == source) {
+					break;
+				}
+
+				// Continue past a conditional branch if the source isn't needed where it branches to.
+				bool is_source_live_at_target = true;
+				if (instruction.is_conditional_branch()) {
+					const Operand &target = instruction.operands[instruction.num_operands - 1];
+					const std::map<uint32_t, Index>::const_iterator target_search = target.kind == Operand::symbol_kind ? labels.find(target.symbol) : labels.cend();
+					is_source_live_at_target = target_search == labels.cend() || (copy_live_out[target_search->second] & source_bit) != 0;
+					reads_stale = reads_stale || (target_search != labels.cend() && is_stale[target_search->second]);
+				}
+				if (is_source_live && ((instruction.ends_block() && is_source_live_at_target) || instruction_destination == destination)) {
+					is_coalescable = false;
+					break;
+				}
+			}
+			if (!is_coalescable || reads_stale) {
+				continue;
+			}
+
+			instructions[*computation_index].operands[0] = Operand::make_register(destination);
+			instructions[copy_index]                     = MachineInstruction();
+			coalesced_end                                = copy_index;
+			for (const Index later_use : std::as_const(later_uses)) {
+				rename_reads(instructions[later_use], source, destination);
+			}
+			std::fill(is_stale.begin() + *computation_index, is_stale.begin() + instruction_index + 1, true);
+			changed = true;
+		}
+	}
+
+	// A conditional move into a copy of a register that is then copied back,
+	// as in "la $t4, ($s7); movn $t4, $t5, $t6; la $s7, ($t4)", can move
+	// into the original register directly.  This only changes liveness from
+	// the copy in to the copy back, and each conditional move only reads the
+	// liveness after its own copy back, so one computation serves them all.
+	for (Index conditional_move_index = 0; conditional_move_index < instructions.size(); ++conditional_move_index) {
+		const MachineInstruction &conditional_move = instructions[conditional_move_index];
+		if (!(conditional_move.num_operands == 3 && (conditional_move.opcode == MachineInstruction::movn_opcode || conditional_move.opcode == MachineInstruction::movz_opcode) && conditional_move.operands[0].kind == Operand::register_kind)) {
+			continue;
+		}
+		const MachineInstruction::register_id_t copy = conditional_move.operands[0].register_;
+
+		// Find the copy into the destination.
+		std::optional<Index> copy_in_index;
+		for (Index instruction_index = conditional_move_index; instruction_index > 0; --instruction_index) {
+			const Index               previous_index = instruction_index - 1;
+			const MachineInstruction &previous       = instructions[previous_index];
+			if (is_blank(previous)) {
+				continue;
+			}
+			if (previous.ends_block()) {
+				break;
+			}
+			if (previous.get_destination() == copy) {
+				if (is_copy(previous)) {
+					copy_in_index = previous_index;
+				}
+				break;
+			}
+		}
+		if (!copy_in_index.has_value()) {
+			continue;
+		}
+		const MachineInstruction::register_id_t original = instructions[*copy_in_index].operands[1].register_;
+		if (original == copy || original == MachineInstruction::sp_register || original == MachineInstruction::gp_register || original == MachineInstruction::zero_register) {
+			continue;
+		}
+
+		// The original must keep its value until the conditional move, and
+		// the copy must be copied back right after it and then be dead.
+		bool is_coalescable = true;
+		for (Index instruction_index = *copy_in_index + 1; instruction_index < conditional_move_index; ++instruction_index) {
+			if (instructions[instruction_index].get_destination() == original) {
+				is_coalescable = false;
+				break;
+			}
+		}
+		Index copy_out_index = conditional_move_index + 1;
+		while (copy_out_index < instructions.size() && is_blank(instructions[copy_out_index])) {
+			++copy_out_index;
+		}
+		if (
+			   !is_coalescable
+			|| copy_out_index >= instructions.size()
+			|| instructions[copy_out_index] != MachineInstruction(MachineInstruction::la_opcode, {Operand::make_register(original), Operand::make_memory(copy, 0)})
+			|| (copy_live_out[copy_out_index] & get_register_bit(copy)) != 0
+		) {
+			continue;
+		}
+
+		for (uint8_t operand_index = 0; operand_index < instructions[conditional_move_index].num_operands; ++operand_index) {
+			Operand &operand = instructions[conditional_move_index].operands[operand_index];
+			if (operand == Operand::make_register(copy)) {
+				operand = Operand::make_register(original);
+			}
+		}
+		instructions[copy_out_index] = MachineInstruction();
+	}
+
+	// Remove results nothing reads, until there are none.
+	for (bool changed = true; changed; ) {
+		changed = false;
+		const std::vector<RegisterSet> live_out = code.get_live_registers();
+		for (MachineInstruction &instruction : instructions) {
+			const Index instruction_index = &instruction - &instructions[0];
+			const std::optional<MachineInstruction::register_id_t> destination = instruction.get_destination();
+			const bool is_self_copy = is_copy(instruction) && instruction.operands[1].register_ == instruction.operands[0].register_;
+			if (destination.has_value() && pure_instructions.find(instruction.opcode) != pure_instructions.cend() && (is_self_copy || (live_out[instruction_index] & get_register_bit(*destination)) == 0)) {
+				instruction = MachineInstruction();
+				changed = true;
+			}
+		}
+	}
+
+	code.remove_null_instructions();
+}
+
+// | Clean up the control flow of emitted code.
+void Semantics::thread_emitted_jumps(MachineCode &code) {
+	using Operand = MachineInstruction::Operand;
+	using Index   = std::vector<MachineInstruction>::size_type;
+
+	// | Conditional branches and the branch testing the opposite condition.
+	static const std::map<MachineInstruction::opcode_t, MachineInstruction::opcode_t> inverted_branches {
+		{MachineInstruction::beq_opcode,  MachineInstruction::bne_opcode},  {MachineInstruction::bne_opcode,  MachineInstruction::beq_opcode},
+		{MachineInstruction::beqz_opcode, MachineInstruction::bnez_opcode}, {MachineInstruction::bnez_opcode, MachineInstruction::beqz_opcode},
+		{MachineInstruction::bgez_opcode, MachineInstruction::bltz_opcode}, {MachineInstruction::bltz_opcode, MachineInstruction::bgez_opcode},
+		{MachineInstruction::bgtz_opcode, MachineInstruction::blez_opcode}, {MachineInstruction::blez_opcode, MachineInstruction::bgtz_opcode},
+	};
+	// | Instructions whose result depends only on their operands, so that
+	// computing one again from the same values gives the same value.
+	static const std::set<MachineInstruction::opcode_t> pure_instructions {
+		MachineInstruction::li_opcode,   MachineInstruction::la_opcode,   MachineInstruction::lui_opcode,
+		MachineInstruction::addu_opcode, MachineInstruction::addiu_opcode, MachineInstruction::subu_opcode,
+		MachineInstruction::and_opcode,  MachineInstruction::andi_opcode, MachineInstruction::or_opcode,   MachineInstruction::ori_opcode,
+		MachineInstruction::xor_opcode,  MachineInstruction::xori_opcode, MachineInstruction::nor_opcode,
+		MachineInstruction::slt_opcode,  MachineInstruction::sltu_opcode, MachineInstruction::slti_opcode, MachineInstruction::sltiu_opcode,
+		MachineInstruction::sll_opcode,  MachineInstruction::srl_opcode,  MachineInstruction::sra_opcode,
+		MachineInstruction::sllv_opcode, MachineInstruction::srlv_opcode, MachineInstruction::srav_opcode,
+		MachineInstruction::mul_opcode,  MachineInstruction::seb_opcode,  MachineInstruction::seh_opcode,
+	};
+	// | Registers syscalls can write.
+	static const std::vector<MachineInstruction::register_id_t> syscall_registers {MachineInstruction::v0_register, MachineInstruction::a0_register, MachineInstruction::a1_register};
+
+	std::vector<MachineInstruction> &instructions = code.instructions;
+
+	// Is the instruction a branch or jump to a label, and which?
+	const auto get_destination = [](const MachineInstruction &instruction) -> std::optional<uint32_t> {
+		if ((instruction.opcode == MachineInstruction::j_opcode || instruction.opcode == MachineInstruction::b_opcode || instruction.is_conditional_branch()) && instruction.num_operands >= 1 && instruction.operands[instruction.num_operands - 1].kind == Operand::symbol_kind) {
+			return instruction.operands[instruction.num_operands - 1].symbol;
+		}
+		return std::nullopt;
+	};
+	// Is the instruction "j label" or "b label"?
+	const auto is_jump_to_label = [&get_destination](const MachineInstruction &instruction) -> bool {
+		return (instruction.opcode == MachineInstruction::j_opcode || instruction.opcode == MachineInstruction::b_opcode) && get_destination(instruction).has_value();
+	};
+	// Does control never continue with the following instruction?
+	const auto is_unconditional = [](const MachineInstruction &instruction) -> bool {
+		return instruction.num_operands == 1 && (instruction.opcode == MachineInstruction::j_opcode || instruction.opcode == MachineInstruction::b_opcode || instruction.opcode == MachineInstruction::jr_opcode);
+	};
+	// Is the instruction a blank line or a comment?
+	const auto is_blank = [](const MachineInstruction &instruction) -> bool {
+		return instruction.opcode == MachineInstruction::null_opcode || instruction.opcode == MachineInstruction::comment_opcode;
+	};
+	// The symbols a verbatim line refers to.
+	const auto get_line_symbols = [&code](const MachineInstruction &instruction) -> std::set<uint32_t> {
+		std::set<uint32_t> line_symbols;
+		if (instruction.opcode == MachineInstruction::line_opcode) {
+			for (const std::pair<Symbol, std::pair<std::string::size_type, std::string::size_type>> &line_symbol : std::as_const(code.lines[instruction.operands[0].immediate].symbols)) {
+				if (code.has_symbol(line_symbol.first)) {
+					line_symbols.insert(code.add_symbol(line_symbol.first));
+				}
+			}
+		}
+		return line_symbols;
+	};
+
+	// Labels nothing but the branches and jumps in this code refer to, e.g.
+	// not routines, can be dropped along with the code after them once
+	// nothing jumps there anymore.
+	std::set<uint32_t> internal_labels;
+	for (const std::pair<const uint32_t, Index> &label : code.get_label_indices()) {
+		internal_labels.insert(label.first);
+	}
+	for (const MachineInstruction &instruction : std::as_const(instructions)) {
+		const std::optional<uint32_t> destination = get_destination(instruction);
+		for (uint8_t operand_index = 0; operand_index < instruction.num_operands; ++operand_index) {
+			const Operand &operand = instruction.operands[operand_index];
+			if (instruction.opcode != MachineInstruction::label_opcode && operand.kind == Operand::symbol_kind && !(operand_index == instruction.num_operands - 1 && destination.has_value())) {
+				internal_labels.erase(operand.symbol);
+			}
+		}
+		for (const uint32_t line_symbol : get_line_symbols(instruction)) {
+			internal_labels.erase(line_symbol);
+		}
+	}
+
+	// Apply one kind of cleanup at a time, looking at the result of each.
+	for (bool changed = true; changed; ) {
+		changed = false;
+
+		const std::map<uint32_t, Index> labels = code.get_label_indices();
+		std::vector<bool>         deleted(instructions.size(), false);
+		std::map<Index, uint32_t> inserted_labels;
+
+		// Find the first instruction at or after an index, past labels.
+		const auto get_next_instruction = [&instructions](Index index) -> std::optional<Index> {
+			for (; index < instructions.size(); ++index) {
+				const MachineInstruction &instruction = instructions[index];
+				if        (instruction.opcode == MachineInstruction::null_opcode || instruction.opcode == MachineInstruction::comment_opcode || instruction.opcode == MachineInstruction::label_opcode) {
+					continue;
+				} else if (instruction.opcode == MachineInstruction::line_opcode) {
+					break;
+				}
+				return index;
+			}
+			return std::nullopt;
+		};
+		// Is the label reached from an index by only passing labels?
+		const auto is_next = [&instructions, &labels](Index index, uint32_t label) -> bool {
+			const std::map<uint32_t, Index>::const_iterator label_search = labels.find(label);
+			if (label_search == labels.cend() || label_search->second < index) {
+				return false;
+			}
+			for (; index < label_search->second; ++index) {
+				const MachineInstruction &instruction = instructions[index];
+				if (instruction.opcode != MachineInstruction::null_opcode && instruction.opcode != MachineInstruction::comment_opcode && instruction.opcode != MachineInstruction::label_opcode) {
+					return false;
+				}
+			}
+			return true;
+		};
+
+		// Thread branches and jumps to a jump through to its destination, and
+		// a branch to the same branch through to that one's destination.  A
+		// jump to a return returns.
+		for (MachineInstruction &instruction : instructions) {
+			const std::optional<uint32_t> destination = get_destination(instruction);
+			if (!destination.has_value() || labels.find(*destination) == labels.cend()) {
+				continue;
+			}
+
+			uint32_t           threaded_destination = *destination;
+			std::set<uint32_t> visited_destinations {*destination};
+			bool               is_cycle             = false;
+			std::optional<Index> next_index = get_next_instruction(labels.at(*destination));
+			while (next_index.has_value()) {
+				const MachineInstruction &next = instructions[*next_index];
+				std::optional<uint32_t> further_destination;
+				if        (is_jump_to_label(next)) {
+					further_destination = get_destination(next);
+				} else if (instruction.is_conditional_branch() && next.opcode == instruction.opcode && next.num_operands == instruction.num_operands && std::equal(next.operands, next.operands + next.num_operands - 1, instruction.operands)) {
+					further_destination = get_destination(next);
+				}
+				if (!further_destination.has_value() || labels.find(*further_destination) == labels.cend()) {
+					break;
+				}
+				if (!visited_destinations.insert(*further_destination).second) {
+					is_cycle = true;
+					break;
+				}
+				threaded_destination = *further_destination;
+				next_index           = get_next_instruction(labels.at(*further_destination));
+			}
+			if (is_cycle) {
+				continue;
+			}
+
+			const MachineInstruction return_instruction(MachineInstruction::jr_opcode, {Operand::make_register(MachineInstruction::ra_register)});
+			if (instruction.opcode == MachineInstruction::j_opcode && next_index.has_value() && instructions[*next_index] == return_instruction) {
+				instruction = return_instruction;
+			} else if (threaded_destination != *destination) {
+				instruction.operands[instruction.num_operands - 1] = Operand::make_symbol(threaded_destination);
+			} else {
+				continue;
+			}
+			changed = true;
+		}
+
+		// Branch over a jump by branching on the opposite condition instead:
+		// "beq $t0, $zero, L1; j L2; L1:" is "bne $t0, $zero, L2".
+		if (!changed) {
+			for (MachineInstruction &instruction : instructions) {
+				const Index instruction_index = &instruction - &instructions[0];
+				const std::map<MachineInstruction::opcode_t, MachineInstruction::opcode_t>::const_iterator inverted_search = inverted_branches.find(instruction.opcode);
+				const std::optional<uint32_t> destination = get_destination(instruction);
+				if (inverted_search == inverted_branches.cend() || !destination.has_value() || deleted[instruction_index]) {
+					continue;
+				}
+				Index jump_index = instruction_index + 1;
+				while (jump_index < instructions.size() && is_blank(instructions[jump_index])) {
+					++jump_index;
+				}
+				if (jump_index >= instructions.size() || !is_jump_to_label(instructions[jump_index]) || !is_next(jump_index + 1, *destination)) {
+					continue;
+				}
+
+				instruction.opcode                                 = inverted_search->second;
+				instruction.operands[instruction.num_operands - 1] = instructions[jump_index].operands[0];
+				deleted[jump_index]                                = true;
+				changed = true;
+			}
+		}
+
+		// Remove branches and jumps to the next instruction.
+		if (!changed) {
+			for (const MachineInstruction &instruction : std::as_const(instructions)) {
+				const Index instruction_index = &instruction - &instructions[0];
+				const std::optional<uint32_t> destination = get_destination(instruction);
+				if (destination.has_value() && is_next(instruction_index + 1, *destination)) {
+					deleted[instruction_index] = true;
+					changed = true;
+				}
+			}
+		}
+
+		// Which labels are still referred to, and from where?
+		std::map<uint32_t, std::vector<Index>> label_references;
+		for (const MachineInstruction &instruction : std::as_const(instructions)) {
+			const Index instruction_index = &instruction - &instructions[0];
+			if (instruction.opcode == MachineInstruction::label_opcode) {
+				continue;
+			}
+			std::set<uint32_t> referenced_symbols = get_line_symbols(instruction);
+			for (uint8_t operand_index = 0; operand_index < instruction.num_operands; ++operand_index) {
+				if (instruction.operands[operand_index].kind == Operand::symbol_kind) {
+					referenced_symbols.insert(instruction.operands[operand_index].symbol);
+				}
+			}
+			for (const uint32_t referenced_symbol : std::as_const(referenced_symbols)) {
+				if (labels.find(referenced_symbol) != labels.cend()) {
+					label_references[referenced_symbol].push_back(instruction_index);
+				}
+			}
+		}
+
+		// Remove code after a jump up to the next label something refers to.
+		if (!changed) {
+			bool is_reachable = true;
+			for (const MachineInstruction &instruction : std::as_const(instructions)) {
+				const Index instruction_index = &instruction - &instructions[0];
+				if        (is_blank(instruction)) {
+					continue;
+				} else if (instruction.opcode == MachineInstruction::label_opcode) {
+					const uint32_t label = instruction.operands[0].symbol;
+					is_reachable = is_reachable || label_references.find(label) != label_references.cend() || internal_labels.find(label) == internal_labels.cend();
+				} else if (instruction.opcode == MachineInstruction::line_opcode) {
+					is_reachable = true;
+				} else if (!is_reachable) {
+					deleted[instruction_index] = true;
+					changed = true;
+				} else if (is_unconditional(instruction)) {
+					is_reachable = false;
+				}
+			}
+		}
+
+		// Resolve conditional branches whose outcome is already known, by
+		// numbering the values computed along straight-line code, continuing
+		// into labels reached only from one place.
+		if (!changed) {
+			EmittedValues                     values;
+			std::map<uint32_t, EmittedValues> destination_values;
+			uint64_t                          next_value     = 0;
+			bool                              falls_through  = true;
+
+			// Number a computation, e.g. "li 0", if it's new.
+			const auto get_computation_value = [&values, &next_value](const std::string &computation) -> uint64_t {
+				const std::map<std::string, uint64_t>::const_iterator computation_search = values.computations.find(computation);
+				if (computation_search != values.computations.cend()) {
+					return computation_search->second;
+				}
+				values.computations.insert({computation, next_value});
+				const std::string constant = computation.substr(3);
+				if (computation.substr(0, 3) == "li " && !constant.empty() && constant.find_first_not_of("-0123456789") == std::string::npos && constant.find_first_of("0123456789") != std::string::npos) {
+					values.is_nonzero.insert({next_value, constant.find_first_not_of("-0") != std::string::npos});
+				}
+				return next_value++;
+			};
+			const auto get_value = [&values, &next_value, &get_computation_value](MachineInstruction::register_id_t register_) -> uint64_t {
+				if (register_ == MachineInstruction::zero_register) {
+					return get_computation_value("li 0");
+				}
+				const std::map<MachineInstruction::register_id_t, uint64_t>::const_iterator register_search = values.registers.find(register_);
+				if (register_search != values.registers.cend()) {
+					return register_search->second;
+				}
+				values.registers.insert({register_, next_value});
+				return next_value++;
+			};
+			// The value an operand of a branch compares.
+			const auto get_operand_value = [&get_value, &get_computation_value](const Operand &operand) -> uint64_t {
+				return operand.kind == Operand::immediate_kind ? get_computation_value("li " + std::to_string(operand.immediate)) : get_value(operand.register_);
+			};
+			// Describe an operand by the values of the registers it reads.
+			const auto get_operand_key = [&get_value](const Operand &operand) -> std::string {
+				switch (operand.kind) {
+					case Operand::register_kind:
+						return "v" + std::to_string(get_value(operand.register_));
+					case Operand::memory_kind:
+						return std::to_string(operand.immediate) + "(v" + std::to_string(get_value(operand.register_)) + ")";
+					case Operand::symbol_kind:
+						return "{s" + std::to_string(operand.symbol) + "}";
+					case Operand::immediate_kind:
+					case Operand::null_kind:
+					default:
+						return std::to_string(operand.immediate);
+				}
+			};
+			const auto forget_loads = [&values]() {
+				for (std::map<std::string, uint64_t>::const_iterator computation = values.computations.cbegin(); computation != values.computations.cend(); ) {
+					computation = computation->first[0] == '@' ? values.computations.erase(computation) : std::next(computation);
+				}
+			};
+
+			for (MachineInstruction &instruction : instructions) {
+				const Index instruction_index = &instruction - &instructions[0];
+				if (is_blank(instruction)) {
+					continue;
+				}
+
+				// Continue past a label only if there is one way to reach it.
+				if (instruction.opcode == MachineInstruction::label_opcode || instruction.opcode == MachineInstruction::line_opcode) {
+					const bool is_label = instruction.opcode == MachineInstruction::label_opcode;
+					const std::map<uint32_t, std::vector<Index>>::const_iterator references_search = is_label ? label_references.find(instruction.operands[0].symbol) : label_references.cend();
+					const std::map<uint32_t, EmittedValues>::const_iterator destination_values_search = is_label ? destination_values.find(instruction.operands[0].symbol) : destination_values.cend();
+					const bool is_referenced = references_search != label_references.cend();
+					if        (is_label && !is_referenced && falls_through) {
+						// Only reached from the code before.
+					} else if (is_referenced && !falls_through && references_search->second.size() == 1 && references_search->second.front() < instruction_index && destination_values_search != destination_values.cend()) {
+						values = destination_values_search->second;
+					} else {
+						values = EmittedValues();
+					}
+					falls_through = true;
+					continue;
+				}
+
+				// Branches.
+				const std::optional<uint32_t> destination = get_destination(instruction);
+				if (instruction.is_conditional_branch() && destination.has_value()) {
+					const bool is_beq = instruction.opcode == MachineInstruction::beq_opcode || instruction.opcode == MachineInstruction::beqz_opcode;
+					const bool is_bne = instruction.opcode == MachineInstruction::bne_opcode || instruction.opcode == MachineInstruction::bnez_opcode;
+					if (!is_beq && !is_bne) {
+						destination_values[*destination] = values;
+						continue;
+					}
+
+					const uint64_t left_value  = get_operand_value(instruction.operands[0]);
+					const uint64_t right_value = instruction.num_operands == 3 ? get_operand_value(instruction.operands[1]) : get_value(MachineInstruction::zero_register);
+					const uint64_t zero_value  = get_value(MachineInstruction::zero_register);
+					std::optional<bool> is_equal;
+					if        (left_value == right_value) {
+						is_equal = true;
+					} else if (right_value == zero_value && values.is_nonzero.find(left_value) != values.is_nonzero.cend()) {
+						is_equal = !values.is_nonzero.at(left_value);
+					} else if (left_value == zero_value && values.is_nonzero.find(right_value) != values.is_nonzero.cend()) {
+						is_equal = !values.is_nonzero.at(right_value);
+					}
+
+					// Already decided?
+					if (is_equal.has_value()) {
+						if (*is_equal == is_beq) {
+							instruction                      = MachineInstruction(MachineInstruction::j_opcode, {Operand::make_symbol(*destination)});
+							destination_values[*destination] = values;
+							falls_through                    = false;
+						} else {
+							deleted[instruction_index] = true;
+						}
+						changed = true;
+						continue;
+					}
+
+					// Otherwise, record what either outcome shows.
+					destination_values[*destination] = values;
+					if (left_value == zero_value || right_value == zero_value) {
+						const uint64_t tested_value = right_value == zero_value ? left_value : right_value;
+						destination_values[*destination].is_nonzero[tested_value] = is_bne;
+						values.is_nonzero[tested_value]                           = is_beq;
+					}
+					continue;
+				} else if (destination.has_value()) {
+					destination_values[*destination] = values;
+				}
+				if (is_unconditional(instruction)) {
+					falls_through = false;
+					continue;
+				}
+
+				// Calls and syscalls.
+				if        (instruction.opcode == MachineInstruction::syscall_opcode) {
+					for (const MachineInstruction::register_id_t syscall_register : std::as_const(syscall_registers)) {
+						values.registers.erase(syscall_register);
+					}
+					forget_loads();
+					continue;
+				} else if (instruction.get_store_size() != 0) {
+					forget_loads();
+					continue;
+				}
+				if (instruction.ends_block()) {
+					values = EmittedValues();
+					continue;
+				}
+				const std::optional<MachineInstruction::register_id_t> instruction_destination = instruction.get_destination();
+				if (!instruction_destination.has_value() || *instruction_destination == MachineInstruction::zero_register) {
+					continue;
+				}
+
+				// Number the value computed.
+				std::optional<std::string> computation;
+				const bool is_address = instruction.opcode == MachineInstruction::la_opcode && instruction.num_operands == 2 && instruction.operands[1].kind == Operand::memory_kind;
+				if        (is_address && instruction.operands[1].immediate == 0) {
+					values.registers[*instruction_destination] = get_value(instruction.operands[1].register_);
+					continue;
+				} else if (is_address && instruction.operands[1].register_ == MachineInstruction::zero_register) {
+					computation = "li " + std::to_string(instruction.operands[1].immediate);
+				} else if (instruction.get_load_size() != 0) {
+					computation = "@" + MachineInstruction::mnemonics[instruction.opcode] + " " + get_operand_key(instruction.operands[1]);
+				} else if (pure_instructions.find(instruction.opcode) != pure_instructions.cend()) {
+					computation = MachineInstruction::mnemonics[instruction.opcode];
+					for (uint8_t operand_index = 1; operand_index < instruction.num_operands; ++operand_index) {
+						*computation += (operand_index > 1 ? ", " : " ") + get_operand_key(instruction.operands[operand_index]);
+					}
+				}
+				if (!computation.has_value()) {
+					values.registers[*instruction_destination] = next_value++;
+					continue;
+				}
+				values.registers[*instruction_destination] = get_computation_value(*computation);
+			}
+		}
+
+		// Merge the identical tails of blocks that jump to a label with the
+		// tail of the block falling into it, jumping into that tail instead.
+		if (!changed) {
+			// Can the instruction be part of a merged tail?
+			const auto is_mergeable = [](const MachineInstruction &instruction) -> bool {
+				return instruction.is_instruction() && instruction.opcode != MachineInstruction::line_opcode && (!instruction.ends_block() || instruction.opcode == MachineInstruction::syscall_opcode);
+			};
+
+			for (const std::pair<const uint32_t, Index> &label : std::as_const(labels)) {
+				const std::map<uint32_t, std::vector<Index>>::const_iterator references_search = label_references.find(label.first);
+				if (references_search == label_references.cend()) {
+					continue;
+				}
+
+				// Find the end of the block falling into the label.
+				Index fall_through_end = label.second;
+				while (fall_through_end > 0 && instructions[fall_through_end - 1].opcode == MachineInstruction::label_opcode) {
+					--fall_through_end;
+				}
+
+				for (const Index jump_index : std::as_const(references_search->second)) {
+					if (!is_jump_to_label(instructions[jump_index])) {
+						continue;
+					}
+
+					// How many instructions before each are the same?
+					Index tail_begin      = fall_through_end;
+					Index jump_tail_begin = jump_index;
+					while (tail_begin > 0 && jump_tail_begin > 0 && is_mergeable(instructions[tail_begin - 1]) && !deleted[tail_begin - 1] && !deleted[jump_tail_begin - 1] && instructions[jump_tail_begin - 1] == instructions[tail_begin - 1]) {
+						--tail_begin;
+						--jump_tail_begin;
+					}
+					if (jump_tail_begin == jump_index) {
+						continue;
+					}
+
+					// Label the tail, and jump to it instead.
+					std::map<Index, uint32_t>::const_iterator inserted_label_search = inserted_labels.find(tail_begin);
+					if (inserted_label_search == inserted_labels.cend()) {
+						const Symbol label_symbol = code.symbols[label.first];
+						Symbol tail_symbol(label_symbol.prefix, label_symbol.requested_suffix + "_tail", label_symbol.unique_identifier);
+						for (uint64_t tail_number = 2; code.has_symbol(tail_symbol); ++tail_number) {
+							tail_symbol.requested_suffix = label_symbol.requested_suffix + "_tail_" + std::to_string(tail_number);
+						}
+						inserted_label_search = inserted_labels.insert({tail_begin, code.add_symbol(tail_symbol)}).first;
+					}
+					for (Index instruction_index = jump_tail_begin; instruction_index < jump_index; ++instruction_index) {
+						deleted[instruction_index] = true;
+					}
+					instructions[jump_index].operands[0] = Operand::make_symbol(inserted_label_search->second);
+					changed = true;
+				}
+			}
+		}
+
+		if (changed) {
+			std::vector<MachineInstruction> rebuilt_instructions;
+			for (const MachineInstruction &instruction : std::as_const(instructions)) {
+				const Index instruction_index = &instruction - &instructions[0];
+				const std::map<Index, uint32_t>::const_iterator inserted_label_search = inserted_labels.find(instruction_index);
+				if (inserted_label_search != inserted_labels.cend()) {
+					rebuilt_instructions.push_back(MachineInstruction(MachineInstruction::label_opcode, {Operand::make_symbol(inserted_label_search->second)}));
+				}
+				if (!deleted[instruction_index] && instruction.opcode != MachineInstruction::null_opcode) {
+					rebuilt_instructions.push_back(instruction);
+				}
+			}
+			instructions = std::move(rebuilt_instructions);
+		}
+	}
+}
+
+const Semantics::MachineInstruction::RegisterSet Semantics::MachineInstruction::all_registers = (static_cast<RegisterSet>(1) << num_registers) - 1;
+
+const std::vector<std::string> Semantics::MachineInstruction::mnemonics {
+	"", ":", ".", "#",
+	"add", "addu", "addi", "addiu", "sub", "subu", "and", "andi", "or", "ori", "xor", "xori", "nor",
+	"slt", "sltu", "slti", "sltiu", "sll", "srl", "sra", "sllv", "srlv", "srav",
+	"lui", "li", "la", "move",
+	"lw", "lh", "lhu", "lb", "lbu", "sw", "sh", "sb",
+	"mult", "multu", "div", "divu", "mfhi", "mflo", "mthi", "mtlo",
+	"mul", "movn", "movz", "seb", "seh", "ins",
+	"j", "jal", "jr", "jalr", "b", "beq", "bne", "beqz", "bnez", "bgez", "bgtz", "blez", "bltz", "blt", "bge", "bgt", "ble",
+	"syscall", "nop", "tgeu", "tgeiu",
+};
+
+const std::vector<std::string> Semantics::MachineInstruction::register_names {
+	"$zero", "$at", "$v0", "$v1", "$a0", "$a1", "$a2", "$a3",
+	"$t0", "$t1", "$t2", "$t3", "$t4", "$t5", "$t6", "$t7",
+	"$s0", "$s1", "$s2", "$s3", "$s4", "$s5", "$s6", "$s7",
+	"$t8", "$t9", "$k0", "$k1", "$gp", "$sp", "$fp", "$ra",
+	"hi", "lo",
+};
+
+const std::map<std::string, Semantics::MachineInstruction::opcode_t> Semantics::MachineInstruction::opcodes_by_mnemonic = []() -> std::map<std::string, opcode_t> {
+	std::map<std::string, opcode_t> opcodes;
+	for (const std::string &mnemonic : std::as_const(mnemonics)) {
+		const std::vector<std::string>::size_type opcode = &mnemonic - &mnemonics[0];
+		if (opcode > comment_opcode) {
+			opcodes.insert({mnemonic, static_cast<opcode_t>(opcode)});
+		}
+	}
+	return opcodes;
+}();
+
+const std::map<std::string, Semantics::MachineInstruction::register_id_t> Semantics::MachineInstruction::registers_by_name = []() -> std::map<std::string, register_id_t> {
+	std::map<std::string, register_id_t> registers;
+	for (const std::string &name : std::as_const(register_names)) {
+		const std::vector<std::string>::size_type register_ = &name - &register_names[0];
+		if (register_ < hi_register) {
+			registers.insert({name, static_cast<register_id_t>(register_)});
+		}
+	}
+	return registers;
+}();
+
+Semantics::MachineInstruction::Operand::Operand()
+	{}
+
+Semantics::MachineInstruction::Operand::Operand(kind_t kind, register_id_t register_, int32_t immediate, uint32_t symbol)
+	: kind(kind)
+	, register_(register_)
+	, immediate(immediate)
+	, symbol(symbol)
+	{}
+
+Semantics::MachineInstruction::Operand Semantics::MachineInstruction::Operand::make_register(register_id_t register_) {
+	return Operand(register_kind, register_);
+}
+
+Semantics::MachineInstruction::Operand Semantics::MachineInstruction::Operand::make_immediate(int32_t immediate) {
+	return Operand(immediate_kind, zero_register, immediate);
+}
+
+Semantics::MachineInstruction::Operand Semantics::MachineInstruction::Operand::make_symbol(uint32_t symbol) {
+	return Operand(symbol_kind, zero_register, 0, symbol);
+}
+
+Semantics::MachineInstruction::Operand Semantics::MachineInstruction::Operand::make_memory(register_id_t register_, int32_t offset) {
+	return Operand(memory_kind, register_, offset);
+}
+
+bool Semantics::MachineInstruction::Operand::operator==(const Operand &other) const {
+	return kind == other.kind && register_ == other.register_ && immediate == other.immediate && symbol == other.symbol && variable == other.variable && variable2 == other.variable2 && is_negated == other.is_negated;
+}
+
+bool Semantics::MachineInstruction::Operand::operator!=(const Operand &other) const {
+	return !(*this == other);
+}
+
+Semantics::MachineInstruction::MachineInstruction()
+	{}
+
+Semantics::MachineInstruction::MachineInstruction(opcode_t opcode, const std::vector<Operand> &operands)
+	: opcode(opcode)
+	, num_operands(static_cast<uint8_t>(std::min<std::vector<Operand>::size_type>(operands.size(), 4)))
+{
+	for (uint8_t operand_index = 0; operand_index < num_operands; ++operand_index) {
+		this->operands[operand_index] = operands[operand_index];
+	}
+}
+
+bool Semantics::MachineInstruction::operator==(const MachineInstruction &other) const {
+	if (opcode != other.opcode || num_operands != other.num_operands) {
+		return false;
+	}
+	for (uint8_t operand_index = 0; operand_index < num_operands; ++operand_index) {
+		if (operands[operand_index] != other.operands[operand_index]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Semantics::MachineInstruction::operator!=(const MachineInstruction &other) const {
+	return !(*this == other);
+}
+
+bool Semantics::MachineInstruction::is_instruction() const {
+	return opcode > comment_opcode;
+}
+
+uint32_t Semantics::MachineInstruction::get_load_size() const {
+	if (num_operands != 2) {
+		return 0;
+	}
+	switch (opcode) {
+		case lw_opcode:
+			return 4;
+		case lh_opcode:
+		case lhu_opcode:
+			return 2;
+		case lb_opcode:
+		case lbu_opcode:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+uint32_t Semantics::MachineInstruction::get_store_size() const {
+	if (num_operands != 2) {
+		return 0;
+	}
+	switch (opcode) {
+		case sw_opcode:
+			return 4;
+		case sh_opcode:
+			return 2;
+		case sb_opcode:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+bool Semantics::MachineInstruction::is_conditional_branch() const {
+	return opcode >= beq_opcode && opcode <= ble_opcode;
+}
+
+bool Semantics::MachineInstruction::is_jump() const {
+	return opcode == j_opcode || opcode == jr_opcode || opcode == b_opcode;
+}
+
+bool Semantics::MachineInstruction::is_call() const {
+	return opcode == jal_opcode || opcode == jalr_opcode;
+}
+
+bool Semantics::MachineInstruction::is_trap() const {
+	return opcode == tgeu_opcode || opcode == tgeiu_opcode;
+}
+
+bool Semantics::MachineInstruction::ends_block() const {
+	return opcode == label_opcode || opcode == line_opcode || is_conditional_branch() || is_jump() || is_call() || opcode == syscall_opcode;
+}
+
+std::optional<Semantics::MachineInstruction::register_id_t> Semantics::MachineInstruction::get_destination() const {
+	if (num_operands < 1 || operands[0].kind != Operand::register_kind) {
+		return std::nullopt;
+	}
+	if        (opcode >= add_opcode && opcode <= move_opcode) {
+		return operands[0].register_;
+	} else if (get_load_size() != 0) {
+		return operands[0].register_;
+	} else if ((opcode == div_opcode || opcode == divu_opcode) && num_operands == 3) {
+		return operands[0].register_;
+	} else if (opcode == mfhi_opcode || opcode == mflo_opcode || (opcode >= mul_opcode && opcode <= ins_opcode)) {
+		return operands[0].register_;
+	} else {
+		return std::nullopt;
+	}
+}
+
+Semantics::MachineInstruction::RegisterSet Semantics::MachineInstruction::get_uses() const {
+	// | Returning leaves everything but temporaries to the caller.
+	static const RegisterSet return_registers = all_registers & ~(
+		  (static_cast<RegisterSet>(1) << at_register)
+		| (static_cast<RegisterSet>(0xff) << t0_register)
+		| (static_cast<RegisterSet>(1) << t8_register)
+		| (static_cast<RegisterSet>(1) << t9_register)
+		| (static_cast<RegisterSet>(1) << k0_register)
+		| (static_cast<RegisterSet>(1) << k1_register)
+		| (static_cast<RegisterSet>(1) << hi_register)
+		| (static_cast<RegisterSet>(1) << lo_register)
+	);
+	static const RegisterSet argument_registers = static_cast<RegisterSet>(0xf) << a0_register;
+
+	RegisterSet uses = 0;
+	switch (opcode) {
+		case null_opcode:
+		case label_opcode:
+		case comment_opcode:
+			return 0;
+		case line_opcode:
+			return all_registers;
+		case jr_opcode:
+			if (num_operands == 1 && operands[0] == Operand::make_register(ra_register)) {
+				return return_registers;
+			}
+			break;
+		case jal_opcode:
+		case jalr_opcode:
+			uses = argument_registers | (static_cast<RegisterSet>(1) << sp_register) | (static_cast<RegisterSet>(1) << gp_register);
+			break;
+		case syscall_opcode:
+			uses = argument_registers | (static_cast<RegisterSet>(1) << v0_register);
+			break;
+		case mfhi_opcode:
+			uses = static_cast<RegisterSet>(1) << hi_register;
+			break;
+		case mflo_opcode:
+			uses = static_cast<RegisterSet>(1) << lo_register;
+			break;
+		default:
+			break;
+	}
+
+	const bool reads_destination = opcode == movn_opcode || opcode == movz_opcode || opcode == ins_opcode;
+	const bool has_destination   = get_destination().has_value();
+	for (uint8_t operand_index = 0; operand_index < num_operands; ++operand_index) {
+		const Operand &operand = operands[operand_index];
+		if (operand_index == 0 && has_destination && !reads_destination) {
+			continue;
+		}
+		if (operand.kind == Operand::register_kind || operand.kind == Operand::memory_kind) {
+			uses |= static_cast<RegisterSet>(1) << operand.register_;
+		}
+	}
+	return uses;
+}
+
+Semantics::MachineInstruction::RegisterSet Semantics::MachineInstruction::get_definitions() const {
+	// | What a call may overwrite.
+	static const RegisterSet call_registers =
+		  (static_cast<RegisterSet>(1) << at_register)
+		| (static_cast<RegisterSet>(0x3f) << v0_register)
+		| (static_cast<RegisterSet>(0xff) << t0_register)
+		| (static_cast<RegisterSet>(1) << t8_register)
+		| (static_cast<RegisterSet>(1) << t9_register)
+		| (static_cast<RegisterSet>(1) << ra_register)
+		| (static_cast<RegisterSet>(1) << hi_register)
+		| (static_cast<RegisterSet>(1) << lo_register);
+	static const RegisterSet hi_lo_registers = (static_cast<RegisterSet>(1) << hi_register) | (static_cast<RegisterSet>(1) << lo_register);
+
+	RegisterSet definitions = 0;
+	switch (opcode) {
+		case null_opcode:
+		case label_opcode:
+		case comment_opcode:
+			return 0;
+		case line_opcode:
+			return all_registers;
+		case jal_opcode:
+		case jalr_opcode:
+			return call_registers;
+		case syscall_opcode:
+			return (static_cast<RegisterSet>(1) << v0_register) | (static_cast<RegisterSet>(1) << a0_register) | (static_cast<RegisterSet>(1) << a1_register);
+		case mult_opcode:
+		case multu_opcode:
+		case div_opcode:
+		case divu_opcode:
+		case mul_opcode:
+			definitions = hi_lo_registers;
+			break;
+		case mthi_opcode:
+			return static_cast<RegisterSet>(1) << hi_register;
+		case mtlo_opcode:
+			return static_cast<RegisterSet>(1) << lo_register;
+		default:
+			break;
+	}
+
+	const std::optional<register_id_t> destination = get_destination();
+	if (destination.has_value()) {
+		definitions |= static_cast<RegisterSet>(1) << *destination;
+	}
+	return definitions;
+}
+
+Semantics::MachineInstruction::RegisterSet Semantics::MachineInstruction::get_mentioned_registers() const {
+	RegisterSet registers = 0;
+	for (uint8_t operand_index = 0; operand_index < num_operands; ++operand_index) {
+		const Operand &operand = operands[operand_index];
+		if (operand.kind == Operand::register_kind || operand.kind == Operand::memory_kind) {
+			registers |= static_cast<RegisterSet>(1) << operand.register_;
+		}
+	}
+	return registers & ~static_cast<RegisterSet>(1);
+}
+
+Semantics::MachineCode::MachineCode()
+	{}
+
+Semantics::MachineCode::MachineCode(const std::vector<Output::Line> &lines) {
+	std::map<std::string, Symbol> symbol_placeholders;
+
+	// Parse an integer that fits in 32 bits.
+	const auto parse_integer = [](const std::string &text) -> std::optional<int32_t> {
+		const std::string digits = text.size() > 0 && text[0] == '-' ? text.substr(1) : text;
+		if (digits.empty() || digits.size() > 10 || digits.find_first_not_of("0123456789") != std::string::npos) {
+			return std::nullopt;
+		}
+		const int64_t value = text[0] == '-' ? -std::stoll(digits) : std::stoll(digits);
+		if (value < std::numeric_limits<int32_t>::min() || value > std::numeric_limits<int32_t>::max()) {
+			return std::nullopt;
+		}
+		return static_cast<int32_t>(value);
+	};
+
+	// Parse an operand: a register, a symbol, "offset($register)", or an
+	// integer.
+	const auto parse_operand = [this, &symbol_placeholders, &parse_integer](const std::string &text) -> std::optional<MachineInstruction::Operand> {
+		const std::map<std::string, MachineInstruction::register_id_t>::const_iterator register_search = MachineInstruction::registers_by_name.find(text);
+		if (register_search != MachineInstruction::registers_by_name.cend()) {
+			return MachineInstruction::Operand::make_register(register_search->second);
+		}
+		const std::map<std::string, Symbol>::const_iterator placeholder_search = symbol_placeholders.find(text);
+		if (placeholder_search != symbol_placeholders.cend()) {
+			return MachineInstruction::Operand::make_symbol(add_symbol(placeholder_search->second));
+		}
+		const std::string::size_type paren_pos = text.find('(');
+		if (paren_pos != std::string::npos && text[text.size() - 1] == ')') {
+			const std::map<std::string, MachineInstruction::register_id_t>::const_iterator base_search = MachineInstruction::registers_by_name.find(text.substr(paren_pos + 1, text.size() - paren_pos - 2));
+			const std::optional<int32_t> offset = paren_pos == 0 ? std::optional<int32_t>(0) : parse_integer(text.substr(0, paren_pos));
+			if (base_search == MachineInstruction::registers_by_name.cend() || !offset.has_value()) {
+				return std::nullopt;
+			}
+			return MachineInstruction::Operand::make_memory(base_search->second, *offset);
+		}
+		const std::optional<int32_t> immediate = parse_integer(text);
+		if (!immediate.has_value()) {
+			return std::nullopt;
+		}
+		return MachineInstruction::Operand::make_immediate(*immediate);
+	};
+
+	for (const Output::Line &line : std::as_const(lines)) {
+		const std::vector<std::string> tokens = parse_emitted_line(line, symbol_placeholders);
+
+		MachineInstruction instruction(MachineInstruction::line_opcode);
+		if        (tokens.empty()) {
+			instruction.opcode = MachineInstruction::comment_opcode;
+		} else if (tokens[0] == ":") {
+			const std::map<std::string, Symbol>::const_iterator placeholder_search = symbol_placeholders.find(tokens[1]);
+			if (placeholder_search != symbol_placeholders.cend()) {
+				instruction = MachineInstruction(MachineInstruction::label_opcode, {MachineInstruction::Operand::make_symbol(add_symbol(placeholder_search->second))});
+			}
+		} else if (tokens[0] != "." && tokens.size() <= 5 && line.line.find('#') == std::string::npos) {
+			// Keep lines with comments as they are, so that nothing is lost.
+			const std::map<std::string, MachineInstruction::opcode_t>::const_iterator opcode_search = MachineInstruction::opcodes_by_mnemonic.find(tokens[0]);
+			if (opcode_search != MachineInstruction::opcodes_by_mnemonic.cend()) {
+				MachineInstruction parsed(opcode_search->second);
+				for (const std::string &token : std::as_const(tokens)) {
+					const std::vector<std::string>::size_type token_index = &token - &tokens[0];
+					if (token_index == 0) {
+						continue;
+					}
+					const std::optional<MachineInstruction::Operand> operand = parse_operand(token);
+					if (!operand.has_value()) {
+						break;
+					}
+					parsed.operands[parsed.num_operands++] = *operand;
+				}
+				if (static_cast<std::vector<std::string>::size_type>(parsed.num_operands) + 1 == tokens.size()) {
+					instruction = parsed;
+				}
+			}
+		}
+
+		if (instruction.opcode == MachineInstruction::line_opcode || instruction.opcode == MachineInstruction::comment_opcode) {
+			instruction.operands[0]  = MachineInstruction::Operand::make_immediate(static_cast<int32_t>(this->lines.size()));
+			instruction.num_operands = 1;
+			this->lines.push_back(line);
+		}
+		instructions.push_back(instruction);
+	}
+}
+
+uint32_t Semantics::MachineCode::add_symbol(const Symbol &symbol) {
+	const std::map<Symbol, uint32_t>::const_iterator symbol_index_search = symbol_indices.find(symbol);
+	if (symbol_index_search != symbol_indices.cend()) {
+		return symbol_index_search->second;
+	}
+	const uint32_t symbol_index = static_cast<uint32_t>(symbols.size());
+	symbols.push_back(symbol);
+	symbol_indices.insert({symbol, symbol_index});
+	return symbol_index;
+}
+
+bool Semantics::MachineCode::has_symbol(const Symbol &symbol) const {
+	return symbol_indices.find(symbol) != symbol_indices.cend();
+}
+
+void Semantics::MachineCode::add_line(const Output::Line &line) {
+	append(MachineCode(std::vector<Output::Line> {line}));
+}
+
+void Semantics::MachineCode::append(const MachineCode &other) {
+	for (const MachineInstruction &instruction : std::as_const(other.instructions)) {
+		if (instruction.opcode == MachineInstruction::null_opcode) {
+			continue;
+		}
+		MachineInstruction appended(instruction);
+		if (appended.opcode == MachineInstruction::line_opcode || appended.opcode == MachineInstruction::comment_opcode) {
+			appended.operands[0] = MachineInstruction::Operand::make_immediate(static_cast<int32_t>(lines.size()));
+			lines.push_back(other.lines[instruction.operands[0].immediate]);
+		} else {
+			for (uint8_t operand_index = 0; operand_index < appended.num_operands; ++operand_index) {
+				MachineInstruction::Operand &operand = appended.operands[operand_index];
+				if (operand.kind == MachineInstruction::Operand::symbol_kind) {
+					operand.symbol = add_symbol(other.symbols[operand.symbol]);
+				}
+			}
+		}
+		instructions.push_back(appended);
+	}
+}
+
+void Semantics::MachineCode::remove_null_instructions() {
+	instructions.erase(std::remove_if(instructions.begin(), instructions.end(), [](const MachineInstruction &instruction) -> bool {
+		return instruction.opcode == MachineInstruction::null_opcode;
+	}), instructions.end());
+}
+
+Semantics::Output::Line Semantics::MachineCode::render(const MachineInstruction &instruction) const {
+	switch (instruction.opcode) {
+		case MachineInstruction::null_opcode:
+			return Output::Line();
+		case MachineInstruction::label_opcode:
+			return {":", symbols[instruction.operands[0].symbol]};
+		case MachineInstruction::line_opcode:
+		case MachineInstruction::comment_opcode:
+			return lines[instruction.operands[0].immediate];
+		default:
+			break;
+	}
+
+	const std::string &mnemonic = MachineInstruction::mnemonics[instruction.opcode];
+	std::string text = "\t" + mnemonic;
+	std::vector<std::pair<Symbol, std::pair<std::string::size_type, std::string::size_type>>> line_symbols;
+	if (instruction.num_operands > 0) {
+		text += std::string(mnemonic.size() < 6 ? 6 - mnemonic.size() : 1, ' ');
+	}
+	for (uint8_t operand_index = 0; operand_index < instruction.num_operands; ++operand_index) {
+		const MachineInstruction::Operand &operand = instruction.operands[operand_index];
+		if (operand_index > 0) {
+			text += ", ";
+		}
+		switch (operand.kind) {
+			case MachineInstruction::Operand::register_kind:
+				text += MachineInstruction::register_names[operand.register_];
+				break;
+			case MachineInstruction::Operand::immediate_kind:
+				text += std::to_string(operand.immediate);
+				break;
+			case MachineInstruction::Operand::symbol_kind:
+				line_symbols.push_back({symbols[operand.symbol], {text.size(), 0}});
+				break;
+			case MachineInstruction::Operand::memory_kind:
+				text += (operand.immediate != 0 ? std::to_string(operand.immediate) : "") + "(" + MachineInstruction::register_names[operand.register_] + ")";
+				break;
+			case MachineInstruction::Operand::null_kind:
+			default: {
+				std::ostringstream sstr;
+				sstr << "Semantics::MachineCode::render: internal error: invalid operand kind: " << operand.kind;
+				throw SemanticsError(sstr.str());
+			}
+		}
+	}
+	return Output::Line(text, std::move(line_symbols));
+}
+
+std::vector<Semantics::Output::Line> Semantics::MachineCode::render() const {
+	std::vector<Output::Line> rendered_lines;
+	for (const MachineInstruction &instruction : std::as_const(instructions)) {
+		if (instruction.opcode != MachineInstruction::null_opcode) {
+			rendered_lines.push_back(render(instruction));
+		}
+	}
+	return rendered_lines;
+}
+
+uint64_t Semantics::MachineCode::get_num_instructions() const {
+	uint64_t num_instructions = 0;
+	for (const MachineInstruction &instruction : std::as_const(instructions)) {
+		if (instruction.is_instruction()) {
+			++num_instructions;
+		} else if (instruction.opcode == MachineInstruction::line_opcode) {
+			// Count verbatim instructions, but not directives.
+			std::map<std::string, Symbol> symbol_placeholders;
+			const std::vector<std::string> tokens = parse_emitted_line(lines[instruction.operands[0].immediate], symbol_placeholders);
+			if (!tokens.empty() && tokens[0] != "." && tokens[0] != ":") {
+				++num_instructions;
+			}
+		}
+	}
+	return num_instructions;
+}
+
+std::map<uint32_t, std::vector<Semantics::MachineInstruction>::size_type> Semantics::MachineCode::get_label_indices() const {
+	std::map<uint32_t, std::vector<MachineInstruction>::size_type> label_indices;
+	for (const MachineInstruction &instruction : std::as_const(instructions)) {
+		if (instruction.opcode == MachineInstruction::label_opcode) {
+			label_indices.insert({instruction.operands[0].symbol, &instruction - &instructions[0]});
+		}
+	}
+	return label_indices;
+}
+
+std::vector<Semantics::MachineInstruction::RegisterSet> Semantics::MachineCode::get_live_registers() const {
+	const std::map<uint32_t, std::vector<MachineInstruction>::size_type> label_indices = get_label_indices();
+
+	// What's live on entry to an instruction, or past the end.
+	std::vector<MachineInstruction::RegisterSet> live_in(instructions.size() + 1, 0);
+	live_in[instructions.size()] = MachineInstruction::all_registers;
+	const auto get_label_live_in = [&label_indices, &live_in](const MachineInstruction::Operand &operand) -> MachineInstruction::RegisterSet {
+		if (operand.kind != MachineInstruction::Operand::symbol_kind) {
+			return MachineInstruction::all_registers;
+		}
+		const std::map<uint32_t, std::vector<MachineInstruction>::size_type>::const_iterator label_index_search = label_indices.find(operand.symbol);
+		return label_index_search == label_indices.cend() ? MachineInstruction::all_registers : live_in[label_index_search->second];
+	};
+
+	std::vector<MachineInstruction::RegisterSet> live_out(instructions.size(), 0);
+	for (bool changed = true; changed; ) {
+		changed = false;
+		for (std::vector<MachineInstruction>::size_type index = instructions.size(); index-- > 0; ) {
+			const MachineInstruction &instruction = instructions[index];
+			MachineInstruction::RegisterSet out = 0;
+			if        (instruction.is_conditional_branch()) {
+				out = get_label_live_in(instruction.operands[instruction.num_operands - 1]) | live_in[index + 1];
+			} else if (instruction.opcode == MachineInstruction::j_opcode || instruction.opcode == MachineInstruction::b_opcode) {
+				out = get_label_live_in(instruction.operands[0]);
+			} else if (instruction.opcode != MachineInstruction::jr_opcode) {
+				out = live_in[index + 1];
+			}
+			const MachineInstruction::RegisterSet in = instruction.get_uses() | (out & ~instruction.get_definitions());
+			if (out != live_out[index] || in != live_in[index]) {
+				live_out[index] = out;
+				live_in[index]  = in;
+				changed = true;
+			}
+		}
+	}
+	return live_out;
+}
+
+const std::vector<Semantics::PeepholeRule> Semantics::peephole_rules {
+	// Copies to the same register.
+	{{{"la", "%r1", "(%r1)"}}, {}},
+	{{{"move", "%r1", "%r1"}}, {}},
+
+	// Operations with no effect but copying a register.
+	{{{"addiu", "%r1", "%r2", "0"}},       {{"la", "%r1", "(%r2)"}}},
+	{{{"addu",  "%r1", "%r2", "$zero"}},   {{"la", "%r1", "(%r2)"}}},
+	{{{"addu",  "%r1", "$zero", "%r2"}},   {{"la", "%r1", "(%r2)"}}},
+	{{{"subu",  "%r1", "%r2", "$zero"}},   {{"la", "%r1", "(%r2)"}}},
+	{{{"or",    "%r1", "%r2", "$zero"}},   {{"la", "%r1", "(%r2)"}}},
+	{{{"or",    "%r1", "$zero", "%r2"}},   {{"la", "%r1", "(%r2)"}}},
+	{{{"xor",   "%r1", "%r2", "$zero"}},   {{"la", "%r1", "(%r2)"}}},
+	{{{"xor",   "%r1", "$zero", "%r2"}},   {{"la", "%r1", "(%r2)"}}},
+	{{{"sll",   "%r1", "%r2", "0"}},       {{"la", "%r1", "(%r2)"}}},
+	{{{"srl",   "%r1", "%r2", "0"}},       {{"la", "%r1", "(%r2)"}}},
+	{{{"sra",   "%r1", "%r2", "0"}},       {{"la", "%r1", "(%r2)"}}},
+
+	// Read $zero rather than a register loaded with 0.
+	{{{"li", "%r1", "0"}, {"addu", "%r2", "%r3", "%r1"}}, {{"li", "%r1", "0"}, {"addu", "%r2", "%r3", "$zero"}}},
+	{{{"li", "%r1", "0"}, {"addu", "%r2", "%r1", "%r3"}}, {{"li", "%r1", "0"}, {"addu", "%r2", "$zero", "%r3"}}},
+	{{{"li", "%r1", "0"}, {"subu", "%r2", "%r3", "%r1"}}, {{"li", "%r1", "0"}, {"subu", "%r2", "%r3", "$zero"}}},
+	{{{"li", "%r1", "0"}, {"subu", "%r2", "%r1", "%r3"}}, {{"li", "%r1", "0"}, {"subu", "%r2", "$zero", "%r3"}}},
+	{{{"li", "%r1", "0"}, {"slt",  "%r2", "%r3", "%r1"}}, {{"li", "%r1", "0"}, {"slt",  "%r2", "%r3", "$zero"}}},
+	{{{"li", "%r1", "0"}, {"slt",  "%r2", "%r1", "%r3"}}, {{"li", "%r1", "0"}, {"slt",  "%r2", "$zero", "%r3"}}},
+	{{{"li", "%r1", "0"}, {"sltu", "%r2", "%r3", "%r1"}}, {{"li", "%r1", "0"}, {"sltu", "%r2", "%r3", "$zero"}}},
+	{{{"li", "%r1", "0"}, {"sltu", "%r2", "%r1", "%r3"}}, {{"li", "%r1", "0"}, {"sltu", "%r2", "$zero", "%r3"}}},
+	{{{"li", "%r1", "0"}, {"or",   "%r2", "%r3", "%r1"}}, {{"li", "%r1", "0"}, {"or",   "%r2", "%r3", "$zero"}}},
+	{{{"li", "%r1", "0"}, {"or",   "%r2", "%r1", "%r3"}}, {{"li", "%r1", "0"}, {"or",   "%r2", "$zero", "%r3"}}},
+	{{{"li", "%r1", "0"}, {"nor",  "%r2", "%r3", "%r1"}}, {{"li", "%r1", "0"}, {"nor",  "%r2", "%r3", "$zero"}}},
+	{{{"li", "%r1", "0"}, {"nor",  "%r2", "%r1", "%r3"}}, {{"li", "%r1", "0"}, {"nor",  "%r2", "$zero", "%r3"}}},
+	{{{"li", "%r1", "0"}, {"movn", "%r2", "%r3", "%r1"}}, {{"li", "%r1", "0"}}},
+	{{{"li", "%r1", "0"}, {"movz", "%r2", "%r3", "%r1"}}, {{"li", "%r1", "0"}, {"la", "%r2", "(%r3)"}}},
+	{{{"li", "%r1", "0"}, {"sw",   "%r1", "%o1"}},        {{"li", "%r1", "0"}, {"sw",   "$zero", "%o1"}}},
+	{{{"li", "%r1", "0"}, {"sh",   "%r1", "%o1"}},        {{"li", "%r1", "0"}, {"sh",   "$zero", "%o1"}}},
+	{{{"li", "%r1", "0"}, {"sb",   "%r1", "%o1"}},        {{"li", "%r1", "0"}, {"sb",   "$zero", "%o1"}}},
+
+	// Use the immediate form of an operation on a register loaded with a
+	// constant, if the constant fits.
+	{{{"li", "%r1", "%i1"}, {"la",   "%r2", "(%r1)"}},        {{"li", "%r1", "%i1"}, {"li",    "%r2", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"addu", "%r2", "%r3", "%r1"}},   {{"li", "%r1", "%i1"}, {"addiu", "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"addu", "%r2", "%r1", "%r3"}},   {{"li", "%r1", "%i1"}, {"addiu", "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"subu", "%r2", "%r3", "%r1"}},   {{"li", "%r1", "%i1"}, {"addiu", "%r2", "%r3", "-%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"slt",  "%r2", "%r3", "%r1"}},   {{"li", "%r1", "%i1"}, {"slti",  "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"sltu", "%r2", "%r3", "%r1"}},   {{"li", "%r1", "%i1"}, {"sltiu", "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"and",  "%r2", "%r3", "%r1"}},   {{"li", "%r1", "%i1"}, {"andi",  "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"and",  "%r2", "%r1", "%r3"}},   {{"li", "%r1", "%i1"}, {"andi",  "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"or",   "%r2", "%r3", "%r1"}},   {{"li", "%r1", "%i1"}, {"ori",   "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"or",   "%r2", "%r1", "%r3"}},   {{"li", "%r1", "%i1"}, {"ori",   "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"xor",  "%r2", "%r3", "%r1"}},   {{"li", "%r1", "%i1"}, {"xori",  "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"xor",  "%r2", "%r1", "%r3"}},   {{"li", "%r1", "%i1"}, {"xori",  "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"sllv", "%r2", "%r3", "%r1"}},   {{"li", "%r1", "%i1"}, {"sll",   "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"srlv", "%r2", "%r3", "%r1"}},   {{"li", "%r1", "%i1"}, {"srl",   "%r2", "%r3", "%i1"}}},
+	{{{"li", "%r1", "%i1"}, {"srav", "%r2", "%r3", "%r1"}},   {{"li", "%r1", "%i1"}, {"sra",   "%r2", "%r3", "%i1"}}},
+
+	// Stores and loads of the same word.
+	{{{"sw", "%r1", "%o1"}, {"lw", "%r2", "%o1"}}, {{"sw", "%r1", "%o1"}, {"la", "%r2", "(%r1)"}}},
+	{{{"lw", "%r1", "%o1"}, {"lw", "%r2", "%o1"}}, {{"lw", "%r1", "%o1"}, {"la", "%r2", "(%r1)"}}},
+	{{{"lw", "%r1", "%o1"}, {"sw", "%r1", "%o1"}}, {{"lw", "%r1", "%o1"}}},
+	{{{"sw", "%r1", "%o1"}, {"sw", "%r2", "%o1"}}, {{"sw", "%r2", "%o1"}}},
+	{{{"sh", "%r1", "%o1"}, {"sh", "%r2", "%o1"}}, {{"sh", "%r2", "%o1"}}},
+	{{{"sb", "%r1", "%o1"}, {"sb", "%r2", "%o1"}}, {{"sb", "%r2", "%o1"}}},
+
+	// Compare with 0 without a pseudo-instruction.
+	{{{"bge", "%r1", "$zero", "%o1"}}, {{"bgez", "%r1", "%o1"}}},
+	{{{"blt", "%r1", "$zero", "%o1"}}, {{"bltz", "%r1", "%o1"}}},
+
+	// Copies back and forth, and stack adjustments that add up.
+	{{{"la", "%r1", "(%r2)"}, {"la", "%r2", "(%r1)"}}, {{"la", "%r1", "(%r2)"}}},
+	{{{"addiu", "$sp", "$sp", "%i1"}, {"addiu", "$sp", "$sp", "%i2"}}, {{"addiu", "$sp", "$sp", "%i1+%i2"}}},
+};
+
+// | Apply peephole rules to emitted code.
+void Semantics::apply_peephole_rules(MachineCode &code) {
+	// | Pattern variables are numbered by kind: "%r1" is 1, "%i1" 11, and "%o1" 21.
+	static const std::map<char, uint8_t> variable_bases {{'r', 0}, {'i', 10}, {'o', 20}};
+	static const uint8_t num_variables = 30;
+
+	// Compile the rules' text into instructions, once.
+	static const std::vector<std::pair<std::vector<MachineInstruction>, std::vector<MachineInstruction>>> compiled_rules = []() -> std::vector<std::pair<std::vector<MachineInstruction>, std::vector<MachineInstruction>>> {
+		const auto compile_operand = [](const std::string &text) -> MachineInstruction::Operand {
+			const std::string::size_type variable_pos = text.find('%');
+			const std::string::size_type paren_pos    = text.find('(');
+			MachineInstruction::Operand operand;
+			if        (paren_pos != std::string::npos) {
+				operand.kind      = MachineInstruction::Operand::memory_kind;
+				operand.immediate = paren_pos == 0 ? 0 : std::stoi(text.substr(0, paren_pos));
+				if (variable_pos == std::string::npos) {
+					operand.register_ = MachineInstruction::registers_by_name.at(text.substr(paren_pos + 1, text.size() - paren_pos - 2));
+				} else {
+					operand.variable  = variable_bases.at(text[variable_pos + 1]) + (text[variable_pos + 2] - '0');
+				}
+			} else if (variable_pos == std::string::npos) {
+				operand = text[0] == '$' ? MachineInstruction::Operand::make_register(MachineInstruction::registers_by_name.at(text)) : MachineInstruction::Operand::make_immediate(std::stoi(text));
+			} else {
+				const char kind = text[variable_pos + 1];
+				operand.kind       = kind == 'r' ? MachineInstruction::Operand::register_kind : kind == 'i' ? MachineInstruction::Operand::immediate_kind : MachineInstruction::Operand::null_kind;
+				operand.variable   = variable_bases.at(kind) + (text[variable_pos + 2] - '0');
+				operand.is_negated = text[0] == '-';
+				if (text.size() == 7 && text[3] == '+') {
+					operand.variable2 = variable_bases.at(text[5]) + (text[6] - '0');
+				}
+			}
+			return operand;
+		};
+		const auto compile_instructions = [&compile_operand](const std::vector<std::vector<std::string>> &text) -> std::vector<MachineInstruction> {
+			std::vector<MachineInstruction> instructions;
+			for (const std::vector<std::string> &instruction_text : std::as_const(text)) {
+				MachineInstruction instruction(MachineInstruction::opcodes_by_mnemonic.at(instruction_text[0]));
+				for (const std::string &operand_text : std::as_const(instruction_text)) {
+					if (&operand_text != &instruction_text[0]) {
+						instruction.operands[instruction.num_operands++] = compile_operand(operand_text);
+					}
+				}
+				instructions.push_back(instruction);
+			}
+			return instructions;
+		};
+
+		std::vector<std::pair<std::vector<MachineInstruction>, std::vector<MachineInstruction>>> rules;
+		for (const PeepholeRule &rule : std::as_const(peephole_rules)) {
+			rules.push_back({compile_instructions(rule.pattern), compile_instructions(rule.replacement)});
+		}
+		return rules;
+	}();
+
+	// Match an operand against a pattern operand, binding its variable.
+	const auto match_operand = [](const MachineInstruction::Operand &pattern_operand, const MachineInstruction::Operand &operand, std::vector<std::optional<MachineInstruction::Operand>> &bindings) -> bool {
+		if (pattern_operand.variable == 0) {
+			return operand == pattern_operand;
+		}
+		MachineInstruction::Operand value = operand;
+		if        (pattern_operand.kind == MachineInstruction::Operand::memory_kind) {
+			if (operand.kind != MachineInstruction::Operand::memory_kind || operand.immediate != pattern_operand.immediate) {
+				return false;
+			}
+			value = MachineInstruction::Operand::make_register(operand.register_);
+		} else if (pattern_operand.kind != MachineInstruction::Operand::null_kind && operand.kind != pattern_operand.kind) {
+			return false;
+		}
+		std::optional<MachineInstruction::Operand> &binding = bindings[pattern_operand.variable];
+		if (binding.has_value()) {
+			return *binding == value;
+		}
+		binding = value;
+		return true;
+	};
+	const auto match_instruction = [&match_operand](const MachineInstruction &pattern_instruction, const MachineInstruction &instruction, std::vector<std::optional<MachineInstruction::Operand>> &bindings) -> bool {
+		if (instruction.opcode != pattern_instruction.opcode || instruction.num_operands != pattern_instruction.num_operands) {
+			return false;
+		}
+		for (uint8_t operand_index = 0; operand_index < instruction.num_operands; ++operand_index) {
+			if (!match_operand(pattern_instruction.operands[operand_index], instruction.operands[operand_index], bindings)) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// Fill in a replacement instruction, if its immediates fit.
+	const auto substitute = [](const MachineInstruction &replacement_instruction, const std::vector<std::optional<MachineInstruction::Operand>> &bindings) -> std::optional<MachineInstruction> {
+		MachineInstruction instruction = replacement_instruction;
+		for (uint8_t operand_index = 0; operand_index < instruction.num_operands; ++operand_index) {
+			const MachineInstruction::Operand &replacement_operand = replacement_instruction.operands[operand_index];
+			MachineInstruction::Operand       &operand             = instruction.operands[operand_index];
+			if        (replacement_operand.variable == 0) {
+				continue;
+			} else if (replacement_operand.kind == MachineInstruction::Operand::memory_kind) {
+				operand = MachineInstruction::Operand::make_memory(bindings[replacement_operand.variable]->register_, replacement_operand.immediate);
+			} else if (replacement_operand.is_negated || replacement_operand.variable2 != 0) {
+				const int64_t value = (replacement_operand.is_negated ? -static_cast<int64_t>(bindings[replacement_operand.variable]->immediate) : bindings[replacement_operand.variable]->immediate) + (replacement_operand.variable2 != 0 ? bindings[replacement_operand.variable2]->immediate : 0);
+				if (value < std::numeric_limits<int32_t>::min() || value > std::numeric_limits<int32_t>::max()) {
+					return std::nullopt;
+				}
+				operand = MachineInstruction::Operand::make_immediate(static_cast<int32_t>(value));
+			} else {
+				operand = *bindings[replacement_operand.variable];
+			}
+		}
+
+		// Check that immediates fit their instruction.
+		const MachineInstruction::Operand &last = instruction.operands[instruction.num_operands - 1];
+		switch (instruction.opcode) {
+			case MachineInstruction::addiu_opcode:
+			case MachineInstruction::slti_opcode:
+			case MachineInstruction::sltiu_opcode:
+				if (last.kind != MachineInstruction::Operand::immediate_kind || last.immediate < -32768 || last.immediate > 32767) {
+					return std::nullopt;
+				}
+				break;
+			case MachineInstruction::andi_opcode:
+			case MachineInstruction::ori_opcode:
+			case MachineInstruction::xori_opcode:
+				if (last.kind != MachineInstruction::Operand::immediate_kind || last.immediate < 0 || last.immediate > 65535) {
+					return std::nullopt;
+				}
+				break;
+			case MachineInstruction::sll_opcode:
+			case MachineInstruction::srl_opcode:
+			case MachineInstruction::sra_opcode:
+				if (last.kind != MachineInstruction::Operand::immediate_kind || last.immediate < 0 || last.immediate > 31) {
+					return std::nullopt;
+				}
+				break;
+			default:
+				break;
+		}
+		return instruction;
+	};
+
+	// Apply rules until none match.
+	std::vector<MachineInstruction> &instructions = code.instructions;
+	for (bool changed = true; changed; ) {
+		changed = false;
+		for (const MachineInstruction &first : std::as_const(instructions)) {
+			const std::vector<MachineInstruction>::size_type first_index = &first - &instructions[0];
+			if (!first.is_instruction()) {
+				continue;
+			}
+
+			for (const std::pair<std::vector<MachineInstruction>, std::vector<MachineInstruction>> &rule : std::as_const(compiled_rules)) {
+				const std::vector<MachineInstruction> &pattern = rule.first;
+				std::vector<std::optional<MachineInstruction::Operand>> bindings(num_variables);
+				if (!match_instruction(pattern[0], first, bindings)) {
+					continue;
+				}
+
+				// Find the second instruction within the window, past others that
+				// don't interfere.
+				std::vector<std::vector<MachineInstruction>::size_type> matched_indices {first_index};
+				if (pattern.size() >= 2) {
+					const MachineInstruction::RegisterSet        first_registers   = first.get_mentioned_registers();
+					const bool                                   accesses_memory   = std::any_of(pattern.cbegin(), pattern.cend(), [](const MachineInstruction &pattern_instruction) -> bool { return pattern_instruction.get_load_size() != 0 || pattern_instruction.get_store_size() != 0; });
+					const std::optional<MachineInstruction::register_id_t> first_destination = first.get_destination();
+					uint32_t                                     window_size       = 1;
+					if (accesses_memory && first_destination.has_value() && (first.get_uses() & (static_cast<MachineInstruction::RegisterSet>(1) << *first_destination)) != 0) {
+						continue;
+					}
+					for (std::vector<MachineInstruction>::size_type second_index = first_index + 1; second_index < instructions.size() && window_size < peephole_window; ++second_index) {
+						const MachineInstruction &second = instructions[second_index];
+						if (second.opcode == MachineInstruction::null_opcode || second.opcode == MachineInstruction::comment_opcode) {
+							continue;
+						}
+						++window_size;
+						std::vector<std::optional<MachineInstruction::Operand>> second_bindings(bindings);
+						if (match_instruction(pattern[1], second, second_bindings)) {
+							bindings = std::move(second_bindings);
+							matched_indices.push_back(second_index);
+							break;
+						}
+
+						if (second.ends_block() || (accesses_memory && (second.get_load_size() != 0 || second.get_store_size() != 0)) || ((second.get_uses() | second.get_definitions()) & first_registers) != 0) {
+							break;
+						}
+					}
+					if (matched_indices.size() < pattern.size()) {
+						continue;
+					}
+				}
+
+				// Replace the matched instructions, the last ones first.
+				std::vector<MachineInstruction> replacement;
+				for (const MachineInstruction &replacement_instruction : std::as_const(rule.second)) {
+					const std::optional<MachineInstruction> instruction = substitute(replacement_instruction, bindings);
+					if (!instruction.has_value()) {
+						break;
+					}
+					replacement.push_back(*instruction);
+				}
+				if (replacement.size() < rule.second.size()) {
+					continue;
+				}
+				bool is_replaced = false;
+				for (const std::vector<MachineInstruction>::size_type &matched_index : std::as_const(matched_indices)) {
+					const std::vector<MachineInstruction>::size_type from_end = matched_indices.size() - (&matched_index - &matched_indices[0]);
+					if (from_end > replacement.size()) {
+						instructions[matched_index] = MachineInstruction();
+						is_replaced = true;
+					} else if (instructions[matched_index] != replacement[replacement.size() - from_end]) {
+						instructions[matched_index] = replacement[replacement.size() - from_end];
+						is_replaced = true;
+					}
+				}
+				if (is_replaced) {
+					changed = true;
+					break;
+				}
+			}
+		}
+	}
+
+	code.remove_null_instructions();
+}
+
+Semantics::LatencyModel::LatencyModel()
+	{}
+
+Semantics::LatencyModel::LatencyModel(uint32_t alu_latency, uint32_t load_latency, uint32_t mult_latency, uint32_t div_latency)
+	: alu_latency(alu_latency)
+	, load_latency(load_latency)
+	, mult_latency(mult_latency)
+	, div_latency(div_latency)
+	{}
+
+uint32_t Semantics::LatencyModel::get_latency(const MachineInstruction &instruction) const {
+	switch (instruction.opcode) {
+		case MachineInstruction::mult_opcode:
+		case MachineInstruction::multu_opcode:
+		case MachineInstruction::mul_opcode:
+			return mult_latency;
+		case MachineInstruction::div_opcode:
+		case MachineInstruction::divu_opcode:
+			return div_latency;
+		default:
+			return instruction.get_load_size() != 0 ? load_latency : alu_latency;
+	}
+}
+
+// | List schedule each basic block of emitted code.
+void Semantics::schedule_machine_code(MachineCode &code, const LatencyModel &latency_model) {
+	// | Writing $zero does nothing, so it orders nothing.
+	static const MachineInstruction::RegisterSet ignored_registers = static_cast<MachineInstruction::RegisterSet>(1) << MachineInstruction::zero_register;
+
+	const std::vector<MachineInstruction> &instructions = code.instructions;
+	std::vector<MachineInstruction>        scheduled_instructions;
+
+	// Schedule the block of instructions from block_begin to block_end, which
+	// ends the block, if it's an instruction, or else isn't included.
+	const auto schedule_block = [&instructions, &scheduled_instructions, &latency_model](std::vector<MachineInstruction>::size_type block_begin, std::vector<MachineInstruction>::size_type block_end) -> void {
+		const std::vector<MachineInstruction>::size_type num_nodes = block_end - block_begin;
+		if (num_nodes <= 2) {
+			scheduled_instructions.insert(scheduled_instructions.end(), instructions.cbegin() + block_begin, instructions.cbegin() + block_end);
+			return;
+		}
+
+		// Describe each node's memory access: the base register, how many
+		// earlier nodes wrote it, and the bytes accessed.  Accesses not
+		// relative to a register may overlap anything.
+		std::vector<MachineInstruction::RegisterSet> uses;
+		std::vector<MachineInstruction::RegisterSet> definitions;
+		std::vector<std::optional<std::pair<std::pair<MachineInstruction::register_id_t, uint32_t>, std::pair<int64_t, int64_t>>>> accesses;
+		std::vector<uint32_t> register_writes(MachineInstruction::num_registers, 0);
+		for (std::vector<MachineInstruction>::size_type node = 0; node < num_nodes; ++node) {
+			const MachineInstruction &instruction = instructions[block_begin + node];
+			uses.push_back(instruction.get_uses() & ~ignored_registers);
+			definitions.push_back(instruction.get_definitions() & ~ignored_registers);
+
+			const uint32_t                     size    = std::max(instruction.get_load_size(), instruction.get_store_size());
+			const MachineInstruction::Operand &address = instruction.operands[1];
+			if (size != 0 && address.kind == MachineInstruction::Operand::memory_kind) {
+				accesses.push_back({{{address.register_, register_writes[address.register_]}, {address.immediate, static_cast<int64_t>(address.immediate) + size}}});
+			} else {
+				accesses.push_back(std::nullopt);
+			}
+
+			for (uint32_t register_ = 0; register_ < MachineInstruction::num_registers; ++register_) {
+				if ((definitions.back() & (static_cast<MachineInstruction::RegisterSet>(1) << register_)) != 0) {
+					++register_writes[register_];
+				}
+			}
+		}
+
+		// Could two memory accesses overlap?
+		const auto may_overlap = [&accesses](std::vector<MachineInstruction>::size_type a, std::vector<MachineInstruction>::size_type b) -> bool {
+			if (!accesses[a].has_value() || !accesses[b].has_value()) {
+				return true;
+			}
+			const MachineInstruction::register_id_t base_a = accesses[a]->first.first;
+			const MachineInstruction::register_id_t base_b = accesses[b]->first.first;
+			if (base_a != base_b) {
+				// The stack and the small-data section are apart.
+				return !((base_a == MachineInstruction::sp_register && base_b == MachineInstruction::gp_register) || (base_a == MachineInstruction::gp_register && base_b == MachineInstruction::sp_register));
+			}
+			if (accesses[a]->first.second != accesses[b]->first.second) {
+				return true;
+			}
+			return accesses[a]->second.first < accesses[b]->second.second && accesses[b]->second.first < accesses[a]->second.second;
+		};
+
+		// Find the dependencies, with the cycles each must wait for.  The last
+		// node, if it ends the block or traps, depends on every other.
+		const bool has_end = instructions[block_end - 1].ends_block() || instructions[block_end - 1].is_trap();
+		std::vector<std::map<std::vector<MachineInstruction>::size_type, uint32_t>> successors(num_nodes);
+		std::vector<uint32_t> num_predecessors(num_nodes, 0);
+		for (std::vector<MachineInstruction>::size_type later = 1; later < num_nodes; ++later) {
+			const MachineInstruction &later_instruction = instructions[block_begin + later];
+			const bool later_loads  = later_instruction.get_load_size()  != 0;
+			const bool later_stores = later_instruction.get_store_size() != 0;
+			for (std::vector<MachineInstruction>::size_type earlier = 0; earlier < later; ++earlier) {
+				const MachineInstruction &earlier_instruction = instructions[block_begin + earlier];
+				const bool earlier_loads  = earlier_instruction.get_load_size()  != 0;
+				const bool earlier_stores = earlier_instruction.get_store_size() != 0;
+
+				std::optional<uint32_t> latency;
+				if ((definitions[earlier] & uses[later]) != 0) {
+					latency = latency_model.get_latency(earlier_instruction);
+				} else if ((definitions[earlier] & definitions[later]) != 0) {
+					latency = 1;
+				} else if ((uses[earlier] & definitions[later]) != 0 || (has_end && later == num_nodes - 1)) {
+					latency = 0;
+				} else if (((earlier_stores && (later_loads || later_stores)) || (earlier_loads && later_stores)) && may_overlap(earlier, later)) {
+					latency = 0;
+				}
+				if (latency.has_value()) {
+					successors[earlier].insert({later, *latency});
+					++num_predecessors[later];
+				}
+			}
+		}
+
+		// Prefer the nodes with the longest paths of latencies to the end.
+		std::vector<uint64_t> priorities(num_nodes, 0);
+		for (std::vector<MachineInstruction>::size_type node = num_nodes; node-- > 0; ) {
+			priorities[node] = latency_model.get_latency(instructions[block_begin + node]);
+			for (const std::pair<const std::vector<MachineInstruction>::size_type, uint32_t> &successor : std::as_const(successors[node])) {
+				priorities[node] = std::max(priorities[node], successor.second + priorities[successor.first]);
+			}
+		}
+
+		// Issue one node per cycle, waiting only if nothing is ready.
+		std::vector<bool>     is_scheduled(num_nodes, false);
+		std::vector<uint64_t> ready_cycles(num_nodes, 0);
+		uint64_t              cycle = 0;
+		for (std::vector<MachineInstruction>::size_type num_scheduled = 0; num_scheduled < num_nodes; ++num_scheduled) {
+			std::optional<std::vector<MachineInstruction>::size_type> best;
+			for (std::vector<MachineInstruction>::size_type node = 0; node < num_nodes; ++node) {
+				if (is_scheduled[node] || num_predecessors[node] != 0) {
+					continue;
+				}
+				if (!best.has_value()) {
+					best = node;
+					continue;
+				}
+				const bool is_ready      = ready_cycles[node]  <= cycle;
+				const bool is_best_ready = ready_cycles[*best] <= cycle;
+				if        (is_ready != is_best_ready) {
+					if (is_ready) {
+						best = node;
+					}
+				} else if (!is_ready && ready_cycles[node] != ready_cycles[*best]) {
+					if (ready_cycles[node] < ready_cycles[*best]) {
+						best = node;
+					}
+				} else if (priorities[node] > priorities[*best]) {
+					best = node;
+				}
+			}
+
+			const std::vector<MachineInstruction>::size_type node = *best;
+			cycle = std::max(cycle, ready_cycles[node]);
+			is_scheduled[node] = true;
+			scheduled_instructions.push_back(instructions[block_begin + node]);
+			for (const std::pair<const std::vector<MachineInstruction>::size_type, uint32_t> &successor : std::as_const(successors[node])) {
+				ready_cycles[successor.first] = std::max(ready_cycles[successor.first], cycle + successor.second);
+				--num_predecessors[successor.first];
+			}
+			++cycle;
+		}
+	};
+
+	std::vector<MachineInstruction>::size_type block_begin = 0;
+	for (const MachineInstruction &instruction : std::as_const(instructions)) {
+		const std::vector<MachineInstruction>::size_type index = &instruction - &instructions[0];
+		if        (!instruction.is_instruction()) {
+			schedule_block(block_begin, index);
+			scheduled_instructions.push_back(instruction);
+			block_begin = index + 1;
+		} else if (instruction.ends_block() || instruction.is_trap()) {
+			schedule_block(block_begin, index + 1);
+			block_begin = index + 1;
+		}
+	}
+	schedule_block(block_begin, instructions.size());
+
+	code.instructions = std::move(scheduled_instructions);
+}
+
+// | Fill the delay slots of emitted branches and jumps.
+void Semantics::fill_delay_slots(MachineCode &code) {
+	static const MachineInstruction::RegisterSet ra_registers = static_cast<MachineInstruction::RegisterSet>(1) << MachineInstruction::ra_register;
+
+	const std::vector<MachineInstruction>             instructions = code.instructions;
+	const std::vector<MachineInstruction::RegisterSet> live_out     = code.get_live_registers();
+
+	const auto get_live_in = [&instructions, &live_out](std::vector<MachineInstruction>::size_type index) -> MachineInstruction::RegisterSet {
+		if (index >= instructions.size()) {
+			return MachineInstruction::all_registers;
 		}
-	}
+		return instructions[index].get_uses() | (live_out[index] & ~instructions[index].get_definitions());
+	};
 
-	stack_allocated = Instruction::AddSp::round_to_align(stack_allocated);
+	const std::map<uint32_t, std::vector<MachineInstruction>::size_type> label_indices = code.get_label_indices();
 
-	// Start our chain of sequenced intro instructions.
-	Index last_intro_index = block_semantics.instructions.add_instruction({I::Ignore(B(), false, false)});
-	const Index first_intro_index = last_intro_index;
+	// Can an instruction be run where it wasn't, on a path that doesn't need
+	// what it writes?  Memory accesses can't, since the address might not be
+	// valid there, and neither can traps.
+	const auto is_speculable = [](const MachineInstruction &instruction, MachineInstruction::RegisterSet live) -> bool {
+		return instruction.is_instruction() && !instruction.ends_block() && !instruction.is_trap() && instruction.opcode != MachineInstruction::nop_opcode && instruction.get_load_size() == 0 && instruction.get_store_size() == 0 && (instruction.get_definitions() & live) == 0;
+	};
 
-	// Give the cleanup routine a label.
-	block_semantics.back = block_semantics.instructions.add_instruction({I::Ignore(B(true, cleanup_symbol), false, false)}, {}, block_semantics.back);
+	// The filled code, with the index of each instruction in "instructions",
+	// and any labels to add after an instruction.
+	std::vector<std::pair<MachineInstruction, std::optional<std::vector<MachineInstruction>::size_type>>> filled;
+	std::map<std::vector<MachineInstruction>::size_type, uint32_t> labels_after;
+	// | Instructions moved into a delay slot, and those a new label follows.
+	std::set<std::vector<MachineInstruction>::size_type> moved;
+	std::set<std::vector<MachineInstruction>::size_type> pinned;
+	std::vector<std::pair<MachineInstruction, std::optional<std::vector<MachineInstruction>::size_type>>>::size_type block_begin = 0;
+	for (std::vector<MachineInstruction>::size_type index = 0; index < instructions.size(); ++index) {
+		const MachineInstruction &instruction = instructions[index];
+		if (moved.find(index) != moved.cend()) {
+			continue;
+		}
+		const bool has_delay_slot = instruction.is_conditional_branch() || instruction.is_jump() || instruction.is_call();
+		if (!has_delay_slot) {
+			// Verbatim branches and jumps get a nop.
+			std::map<std::string, Symbol> symbol_placeholders;
+			const std::vector<std::string> tokens = instruction.opcode == MachineInstruction::line_opcode ? parse_emitted_line(code.lines[instruction.operands[0].immediate], symbol_placeholders) : std::vector<std::string>();
+			filled.push_back({instruction, index});
+			if (!tokens.empty() && (tokens[0][0] == 'b' || tokens[0][0] == 'j') && tokens[0] != "break") {
+				filled.push_back({MachineInstruction(MachineInstruction::nop_opcode), std::nullopt});
+			}
+			// Nothing moves past a trap.
+			if (!instruction.is_instruction() || instruction.ends_block() || instruction.is_trap()) {
+				block_begin = filled.size();
+			}
+			continue;
+		}
 
-	// Set up intro and cleanup sections.
+		// Look back through the block for an instruction to move into the
+		// slot, past the ones after it.
+		const MachineInstruction::RegisterSet branch_reads = instruction.get_mentioned_registers();
+		std::optional<MachineInstruction> slot;
+		MachineInstruction::RegisterSet later_uses        = 0;
+		MachineInstruction::RegisterSet later_definitions = 0;
+		bool                            later_accesses    = false;
+		bool                            later_stores      = false;
+		for (std::vector<std::pair<MachineInstruction, std::optional<std::vector<MachineInstruction>::size_type>>>::size_type filled_index = filled.size(); filled_index-- > block_begin; ) {
+			const MachineInstruction &candidate = filled[filled_index].first;
+			const bool candidate_accesses = candidate.get_load_size() != 0 || candidate.get_store_size() != 0;
+			const bool candidate_stores   = candidate.get_store_size() != 0;
+			if (
+				   candidate.is_instruction()
+				&& candidate.opcode != MachineInstruction::nop_opcode
+				&& !(filled[filled_index].second.has_value() && pinned.find(*filled[filled_index].second) != pinned.cend())
+				&& (candidate.get_definitions() & (branch_reads | later_uses | later_definitions)) == 0
+				&& (candidate.get_uses() & later_definitions) == 0
+				&& !(candidate_accesses && later_stores)
+				&& !(candidate_stores && later_accesses)
+				&& !(instruction.is_call() && ((candidate.get_uses() | candidate.get_definitions()) & ra_registers) != 0)
+			) {
+				slot = candidate;
+				if (filled[filled_index].second.has_value()) {
+					moved.insert(*filled[filled_index].second);
+				}
+				filled.erase(filled.begin() + filled_index);
+				break;
+			}
+			later_uses        |= candidate.get_uses();
+			later_definitions |= candidate.get_definitions();
+			later_accesses    |= candidate_accesses;
+			later_stores      |= candidate_stores;
+		}
 
-	// $sp now points to the first argument.
+		// Otherwise, take the next instruction, if the branch target doesn't
+		// need what it writes.
+		MachineInstruction branch = instruction;
+		const MachineInstruction::Operand &target = instruction.operands[instruction.num_operands - 1];
+		const std::map<uint32_t, std::vector<MachineInstruction>::size_type>::const_iterator target_search = target.kind == MachineInstruction::Operand::symbol_kind ? label_indices.find(target.symbol) : label_indices.cend();
+		if (!slot.has_value() && instruction.is_conditional_branch() && index + 1 < instructions.size() && target_search != label_indices.cend()) {
+			const MachineInstruction &next = instructions[index + 1];
+			if (is_speculable(next, live_out[target_search->second]) && pinned.find(index + 1) == pinned.cend()) {
+				slot = next;
+				moved.insert(index + 1);
+			}
+		}
 
-	// TODO: possible optimization: this is unnecessary if there are no calls or jumps.
-	// Push the return address.
-	last_intro_index     = block_semantics.instructions.add_instruction({I::AddSp(B(), -4)}, {}, last_intro_index);
-	last_intro_index     = block_semantics.instructions.add_instruction({I::LoadFrom(B(), true, true, 0, true, true, Storage("$sp", 4, 0, true), Storage("$ra"), false, false)}, {}, last_intro_index);
+		// Otherwise, copy the first instruction at the target, and branch past
+		// it, if the other path doesn't need what it writes.
+		if (!slot.has_value() && (instruction.is_conditional_branch() || instruction.opcode == MachineInstruction::j_opcode || instruction.opcode == MachineInstruction::b_opcode) && target_search != label_indices.cend()) {
+			std::vector<MachineInstruction>::size_type first_index = target_search->second;
+			while (first_index < instructions.size() && (instructions[first_index].opcode == MachineInstruction::label_opcode || instructions[first_index].opcode == MachineInstruction::comment_opcode)) {
+				++first_index;
+			}
+			if (first_index < instructions.size() && moved.find(first_index) == moved.cend() && first_index != index) {
+				const MachineInstruction &first = instructions[first_index];
+				const bool is_safe = instruction.is_conditional_branch() ? is_speculable(first, get_live_in(index + 1)) : first.is_instruction() && !first.ends_block() && !first.is_trap() && first.opcode != MachineInstruction::nop_opcode;
+				if (is_safe) {
+					slot = first;
+					pinned.insert(first_index);
+					std::map<std::vector<MachineInstruction>::size_type, uint32_t>::const_iterator label_after_search = labels_after.find(first_index);
+					if (label_after_search == labels_after.cend()) {
+						const Symbol &target_symbol = code.symbols[target.symbol];
+						label_after_search = labels_after.insert({first_index, code.add_symbol(Symbol(target_symbol.prefix, target_symbol.requested_suffix + "_delay", target_symbol.unique_identifier))}).first;
+					}
+					branch.operands[branch.num_operands - 1] = MachineInstruction::Operand::make_symbol(label_after_search->second);
+				}
+			}
+		}
 
-	// Allocate space on the stack.
-	if (stack_allocated != 0) {
-		last_intro_index = block_semantics.instructions.add_instruction({I::AddSp(B(), -stack_allocated)}, {}, last_intro_index);
+		filled.push_back({branch, index});
+		filled.push_back({slot.value_or(MachineInstruction(MachineInstruction::nop_opcode)), std::nullopt});
+		block_begin = filled.size();
 	}
 
-	// Allocate the total dynamic allocations on the stack (known at compile-time) needed by the block after aligning it.
-	// Make a marker for it.
-	const int32_t dynamically_allocated = Instruction::AddSp::round_to_align(routine_block_state.dynamically_allocated);
-	if (routine_block_state.dynamically_allocated != 0) {
-		last_intro_index = block_semantics.instructions.add_instruction({I::AddSp(B(), Instruction::AddSp::round_to_align(-routine_block_state.dynamically_allocated), "dynamic")}, {}, last_intro_index);
+	// Add the new labels.
+	std::vector<MachineInstruction> filled_instructions;
+	for (const std::pair<MachineInstruction, std::optional<std::vector<MachineInstruction>::size_type>> &filled_instruction : std::as_const(filled)) {
+		filled_instructions.push_back(filled_instruction.first);
+		if (filled_instruction.second.has_value()) {
+			const std::map<std::vector<MachineInstruction>::size_type, uint32_t>::const_iterator label_after_search = labels_after.find(*filled_instruction.second);
+			if (label_after_search != labels_after.cend()) {
+				filled_instructions.push_back(MachineInstruction(MachineInstruction::label_opcode, {MachineInstruction::Operand::make_symbol(label_after_search->second)}));
+			}
+		}
 	}
+	code.instructions = std::move(filled_instructions);
+}
 
-	// Commented out: these are already copied on a call!  Instead, just add a binding to the appropriate storage.  We do that above.
-#if 0
-	// Now load all arguments as copies.  This does not need to be reversed; callers push and pop arguments when calling.
-	uint32_t stack_argument_total_size = 0;
-	for (const std::pair<bool, TypeIndex> &parameter : std::as_const(routine_declaration.parameters)) {
-		const std::vector<std::pair<bool, TypeIndex>>::size_type   parameter_index      = &parameter - &routine_declaration.parameters[0];
-		const std::string                                         &parameter_identifier = parameter_identifiers[parameter_index];
+Semantics::MachineCode Semantics::share_epilogues(std::vector<MachineCode> &routines, bool delayed_branches) {
+	using Operand = MachineInstruction::Operand;
+	using Index   = std::vector<MachineInstruction>::size_type;
 
-		const bool       parameter_is_ref = parameter.first;
-		const TypeIndex &parameter_type   = parameter.second;
+	const MachineInstruction load_ra(MachineInstruction::lw_opcode, {Operand::make_register(MachineInstruction::ra_register), Operand::make_memory(MachineInstruction::sp_register, 0)});
+	const MachineInstruction return_(MachineInstruction::jr_opcode, {Operand::make_register(MachineInstruction::ra_register)});
 
-		if (parameter_index >= 4) {
-			if        (!all_arrays_records_are_refs && !parameter_is_ref && !storage_scope.type(parameter_type).resolve_type(storage_scope).is_primitive()) {
-				// TODO: copy arrays and records.
-				std::ostringstream sstr;
-				sstr << "Semantics::analyze_block: error: copying of arrays and records for non-Ref vars in arguments is currently not supported.";
-				throw SemanticsError(sstr.str());
-			} else if (!parameter_is_ref && !storage_scope.type(parameter_type).get_fixed_width()) {
-				std::ostringstream sstr;
-				sstr << "Semantics::analyze_block: error: loading non-fixed-width arguments is not supported.";
-				throw SemanticsError(sstr.str());
-			} else if (!parameter_is_ref && storage_scope.type(parameter_type).get_size() != 4 && storage_scope.type(parameter_type).get_size() != 1) {
-				std::ostringstream sstr;
-				sstr << "Semantics::analyze_block: error: loading fixed-width variable non-array/non-record arguments of size neither 4 nor 1 is currently not supported.";
-				throw SemanticsError(sstr.str());
-			} else {
-				const bool is_word = !storage_scope.type(parameter_type).is_primitive() || storage_scope.type(parameter_type).get_primitive().is_word();
+	// Is the instruction "addiu $sp, $sp, N" popping a frame?
+	const auto is_pop = [](const MachineInstruction &instruction) -> bool {
+		return
+			   instruction.opcode == MachineInstruction::addiu_opcode
+			&& instruction.operands[0] == Operand::make_register(MachineInstruction::sp_register)
+			&& instruction.operands[1] == Operand::make_register(MachineInstruction::sp_register)
+			&& instruction.operands[2].kind == Operand::immediate_kind
+			&& instruction.operands[2].immediate > 0
+			;
+	};
 
-				// Lookup the identifier binding in var_scope for the argument.
-				if (!var_scope.has(parameter_identifier)) {
-					std::ostringstream sstr;
-					sstr << "Semantics::analyze_block: error: parameter identifier ``" << parameter_identifier << "\" was provided but the var scope that was provided does not contain it.";
-					throw SemanticsError(sstr.str());
+	// Find the epilogues, by frame size: "lw $ra, ($sp); addiu $sp, $sp, N;
+	// jr $ra", or, with delay slots filled, "lw $ra, ($sp); jr $ra; addiu
+	// $sp, $sp, N", unless the load fills the slot of a branch before it.
+	// Filling the slots of jumps to the epilogue may have labeled the
+	// return, after the load they copied.  Each site is recorded by the
+	// index of its load and of its return.
+	std::map<int32_t, std::vector<std::tuple<std::vector<MachineCode>::size_type, Index, Index>>> epilogues;
+	for (const MachineCode &code : std::as_const(routines)) {
+		const std::vector<MachineInstruction> &instructions = code.instructions;
+		for (Index index = 0; index + 2 < instructions.size(); ++index) {
+			if (instructions[index] != load_ra) {
+				continue;
+			}
+			if (!delayed_branches) {
+				if (is_pop(instructions[index + 1]) && instructions[index + 2] == return_) {
+					epilogues[instructions[index + 1].operands[2].immediate].push_back({&code - &routines[0], index, index + 2});
 				}
-				const IdentifierScope::IdentifierBinding::Var &var = var_scope.get(parameter_identifier).get_var();
+				continue;
+			}
+			if (index > 0 && (instructions[index - 1].is_conditional_branch() || instructions[index - 1].is_jump() || instructions[index - 1].is_call())) {
+				continue;
+			}
+			Index return_index = index + 1;
+			while (return_index < instructions.size() && instructions[return_index].opcode == MachineInstruction::label_opcode) {
+				++return_index;
+			}
+			if (return_index + 1 < instructions.size() && instructions[return_index] == return_ && is_pop(instructions[return_index + 1])) {
+				epilogues[instructions[return_index + 1].operands[2].immediate].push_back({&code - &routines[0], index, return_index});
+			}
+		}
+	}
 
-				Storage source_storage(is_word ? 4 : 1, false, Symbol(), "$sp", true, stack_allocated + Instruction::AddSp::round_to_align(4) + stack_argument_total_size, true, false);
-				stack_argument_total_size += Instruction::AddSp::round_to_align(source_storage.max_size);
+	// A stub of 3 instructions saves 2 in each routine that jumps to it.
+	// With delay slots, the load moves into the slot of the jump to the
+	// stub, past any labels, where loading $ra again is harmless, so a stub
+	// of 2 saves 1 in each.
+	MachineCode shared;
+	for (const std::pair<const int32_t, std::vector<std::tuple<std::vector<MachineCode>::size_type, Index, Index>>> &epilogue : std::as_const(epilogues)) {
+		if (epilogue.second.size() < (delayed_branches ? 3 : 2)) {
+			continue;
+		}
 
-				last_intro_index = block_semantics.instructions.add_instruction({I::LoadFrom(B(), is_word, is_word, 0, true, true, var.storage, source_storage, false, false)}, {}, {last_intro_index});
+		const Symbol stub_symbol("restore_frame_", std::to_string(epilogue.first));
+		const MachineInstruction pop(MachineInstruction::addiu_opcode, {Operand::make_register(MachineInstruction::sp_register), Operand::make_register(MachineInstruction::sp_register), Operand::make_immediate(epilogue.first)});
+		for (const std::tuple<std::vector<MachineCode>::size_type, Index, Index> &site : std::as_const(epilogue.second)) {
+			MachineCode &code         = routines[std::get<0>(site)];
+			const Index  load_index   = std::get<1>(site);
+			const Index  return_index = std::get<2>(site);
+			const MachineInstruction jump(MachineInstruction::j_opcode, {Operand::make_symbol(code.add_symbol(stub_symbol))});
+			if (delayed_branches) {
+				code.instructions[load_index]       = MachineInstruction();
+				code.instructions[return_index]     = jump;
+				code.instructions[return_index + 1] = load_ra;
+			} else {
+				code.instructions[load_index]       = jump;
+				code.instructions[load_index + 1]   = MachineInstruction();
+				code.instructions[return_index]     = MachineInstruction();
+			}
+		}
 
-				// Note: "no_sp_adjust" is "false" here, and "stack_allocated" and the $ra push is removed.
-				Storage var_storage(is_word ? 4 : 1, false, Symbol(), "$sp", true, stack_argument_total_size, false, false);
+		shared.instructions.push_back(MachineInstruction(MachineInstruction::label_opcode, {Operand::make_symbol(shared.add_symbol(stub_symbol))}));
+		if (delayed_branches) {
+			shared.instructions.push_back(return_);
+			shared.instructions.push_back(pop);
+		} else {
+			shared.instructions.push_back(load_ra);
+			shared.instructions.push_back(pop);
+			shared.instructions.push_back(return_);
+		}
+		shared.add_line("");
+	}
+
+	for (MachineCode &code : routines) {
+		code.remove_null_instructions();
+	}
+	return shared;
+}
+
+Semantics::MachineCode Semantics::outline_machine_code(std::vector<MachineCode> &routines, bool delayed_branches) {
+	using Operand  = MachineInstruction::Operand;
+	using Position = std::vector<uint64_t>::size_type;
+	static const MachineInstruction::RegisterSet ra_registers = static_cast<MachineInstruction::RegisterSet>(1) << MachineInstruction::ra_register;
+	// | Values in the sequence at or above this separate the instructions
+	// that can be outlined, and each is unique, so repeats can't span them.
+	static const uint64_t first_separator = static_cast<uint64_t>(1) << 32;
+
+	// Number the instructions of all the routines, identical ones alike,
+	// into one sequence.
+	std::vector<MachineCode>                                                                   &codes = routines;
+	std::vector<uint64_t>                                                                       sequence;
+	std::vector<std::pair<std::vector<MachineCode>::size_type, std::vector<MachineInstruction>::size_type>> locations;
+	std::map<std::string, uint64_t>                                                             instruction_numbers;
+	for (const MachineCode &code : std::as_const(codes)) {
+		const std::vector<MachineInstruction::RegisterSet> live_out = code.get_live_registers();
+		for (const MachineInstruction &instruction : std::as_const(code.instructions)) {
+			const std::vector<MachineInstruction>::size_type index = &instruction - &code.instructions[0];
+			const bool is_in_delay_slot = delayed_branches && index > 0 && (code.instructions[index - 1].is_conditional_branch() || code.instructions[index - 1].is_jump() || code.instructions[index - 1].is_call());
+			if (
+				   !instruction.is_instruction()
+				|| instruction.ends_block()
+				|| instruction.is_trap()
+				|| instruction.opcode == MachineInstruction::nop_opcode
+				|| ((instruction.get_uses() | instruction.get_definitions()) & ra_registers) != 0
+				|| (live_out[index] & ra_registers) != 0
+				|| is_in_delay_slot
+			) {
+				sequence.push_back(first_separator + sequence.size());
+			} else {
+				// Identify the instruction by its text and symbols.
+				const Output::Line line = code.render(instruction);
+				std::ostringstream skey;
+				skey << line.line;
+				for (const std::pair<Symbol, std::pair<std::string::size_type, std::string::size_type>> &symbol : std::as_const(line.symbols)) {
+					skey << "\n" << symbol.first.prefix << "\n" << symbol.first.requested_suffix << "\n" << symbol.first.unique_identifier << "\n" << symbol.second.first;
+				}
+				sequence.push_back(instruction_numbers.insert({skey.str(), instruction_numbers.size()}).first->second);
 			}
+			locations.push_back({&code - &codes[0], index});
+		}
+		sequence.push_back(first_separator + sequence.size());
+		locations.push_back({&code - &codes[0], code.instructions.size()});
+	}
+	const Position size = sequence.size();
+
+	// Sort the suffixes, doubling the length of the prefixes they're ranked
+	// by each time.
+	std::vector<Position> suffixes(size);
+	std::vector<uint64_t> ranks(sequence);
+	std::vector<uint64_t> next_ranks(size);
+	for (Position position = 0; position < size; ++position) {
+		suffixes[position] = position;
+	}
+	for (Position length = 1; size > 0; length *= 2) {
+		const auto get_key = [&ranks, &size, &length](Position position) -> std::pair<uint64_t, uint64_t> {
+			return {ranks[position], position + length < size ? ranks[position + length] + 1 : 0};
+		};
+		std::sort(suffixes.begin(), suffixes.end(), [&get_key](Position a, Position b) -> bool {
+			return get_key(a) < get_key(b);
+		});
+		next_ranks[suffixes[0]] = 0;
+		for (Position index = 1; index < size; ++index) {
+			next_ranks[suffixes[index]] = next_ranks[suffixes[index - 1]] + (get_key(suffixes[index - 1]) < get_key(suffixes[index]) ? 1 : 0);
+		}
+		ranks = next_ranks;
+		if (ranks[suffixes[size - 1]] == size - 1 || length >= size) {
+			break;
 		}
 	}
-#endif /* #if 0 */
 
-	// Reverse what intro did.
-	if (routine_block_state.dynamically_allocated != 0) {
-		block_semantics.back = block_semantics.instructions.add_instruction({I::AddSp(B(), Instruction::AddSp::round_to_align(routine_block_state.dynamically_allocated))}, {}, block_semantics.back);
-		routine_block_state.dynamically_allocated = 0;
-	}
-	if (stack_allocated != 0) {
-		block_semantics.back = block_semantics.instructions.add_instruction({I::AddSp(B(), stack_allocated)}, {}, block_semantics.back);
+	// How long a prefix does each suffix share with the one before it?
+	std::vector<Position> shared_lengths(size + 1, 0);
+	for (Position position = 0, shared_length = 0; position < size; ++position) {
+		if (ranks[position] == 0) {
+			shared_length = 0;
+			continue;
+		}
+		const Position previous = suffixes[ranks[position] - 1];
+		while (position + shared_length < size && previous + shared_length < size && sequence[position + shared_length] == sequence[previous + shared_length]) {
+			++shared_length;
+		}
+		shared_lengths[ranks[position]] = shared_length;
+		if (shared_length > 0) {
+			--shared_length;
+		}
 	}
-	block_semantics.back = block_semantics.instructions.add_instruction({I::LoadFrom(B(), true, true, 0, true, true, Storage("$ra"), Storage("$sp", 4, 0, true), false, false)}, {}, block_semantics.back);
-	block_semantics.back = block_semantics.instructions.add_instruction({I::AddSp(B(), 4)}, {}, block_semantics.back);
 
-	// Now either return or syscall exit.
-	if (!is_main) {
-		block_semantics.back = block_semantics.instructions.add_instruction({I::Return(B())}, {}, block_semantics.back);
-	} else {
-		std::vector<Output::Line> exit_lines;
-		exit_lines.push_back("\t# exit2(0)");
-		exit_lines.push_back("\tli    $v0, 17");
-		exit_lines.push_back("\tli    $a0, 0");
-		exit_lines.push_back("\tsyscall");
-		block_semantics.back = block_semantics.instructions.add_instruction({I::Custom(B(), std::as_const(exit_lines))}, {}, block_semantics.back);
+	// Each interval of suffixes that share a prefix of at least 2
+	// instructions, longer than those around it share, is an internal node
+	// of the suffix tree: a sequence that repeats.  Record its length and the
+	// first and last suffix.
+	std::vector<std::tuple<Position, Position, Position>> repeats;
+	std::vector<std::pair<Position, Position>> open_intervals {{0, 0}};
+	for (Position index = 1; index <= size; ++index) {
+		Position interval_begin = index - 1;
+		while (shared_lengths[index] < open_intervals.back().first) {
+			const std::pair<Position, Position> interval = open_intervals.back();
+			open_intervals.pop_back();
+			if (interval.first >= 2) {
+				repeats.push_back({interval.first, interval.second, index - 1});
+			}
+			interval_begin = interval.second;
+		}
+		if (shared_lengths[index] > open_intervals.back().first) {
+			open_intervals.push_back({shared_lengths[index], interval_begin});
+		}
 	}
 
-	// Connect our chain of sequenced intro instructions.
-	block_semantics.instructions.add_sequence_connection(last_intro_index, block_semantics.front);
-	block_semantics.front = first_intro_index;
+	// Where can a repeat be outlined, without overlapping itself or what has
+	// already been outlined, and how many instructions would that save?  The
+	// calls take an instruction each, or 2 with a delay slot, in which the
+	// first instruction of the sequence stays; the outlined sequence adds a
+	// return, whose delay slot the last instruction of the sequence fills.
+	std::vector<bool> is_outlined(size, false);
+	const auto get_occurrences = [&suffixes, &is_outlined](const std::tuple<Position, Position, Position> &repeat) -> std::vector<Position> {
+		const Position length = std::get<0>(repeat);
+		std::vector<Position> starts(suffixes.cbegin() + std::get<1>(repeat), suffixes.cbegin() + std::get<2>(repeat) + 1);
+		std::sort(starts.begin(), starts.end());
+		std::vector<Position> occurrences;
+		for (const Position &start : std::as_const(starts)) {
+			if (!occurrences.empty() && start < occurrences.back() + length) {
+				continue;
+			}
+			if (std::find(is_outlined.cbegin() + start, is_outlined.cbegin() + start + length, true) == is_outlined.cbegin() + start + length) {
+				occurrences.push_back(start);
+			}
+		}
+		return occurrences;
+	};
+	const auto get_savings = [&delayed_branches](Position length, Position num_occurrences) -> int64_t {
+		const int64_t call_size = delayed_branches ? 2 : 1;
+		const int64_t body_size = static_cast<int64_t>(length) + (delayed_branches ? 0 : 1);
+		return static_cast<int64_t>(num_occurrences * length) - static_cast<int64_t>(num_occurrences) * call_size - body_size;
+	};
 
-	// Verify our working storage requirements have not changed.
-	std::vector<uint32_t> new_working_storage_requirements;
-	new_working_storage_requirements = block_semantics.instructions.prepare(std::set<IO>(), {block_semantics.back});
-	if (new_working_storage_requirements != working_storage_requirements) {
-		std::ostringstream sstr;
-		sstr
-			<< "Semantics::analyze_block: internal error: adding intro and cleanup sections to a block, with requested symbol suffix ``"
-			<< routine_declaration.location.requested_suffix
-			<< "\", should not have changed the working storage requirements, but it did."
-			;
-		throw SemanticsError(sstr.str());
+	// Outline the repeats that save the most first.
+	std::vector<std::pair<int64_t, std::vector<std::tuple<Position, Position, Position>>::size_type>> ranked_repeats;
+	for (const std::tuple<Position, Position, Position> &repeat : std::as_const(repeats)) {
+		const int64_t savings = get_savings(std::get<0>(repeat), get_occurrences(repeat).size());
+		if (savings > 0) {
+			ranked_repeats.push_back({-savings, &repeat - &repeats[0]});
+		}
 	}
+	std::sort(ranked_repeats.begin(), ranked_repeats.end());
 
-	// Sort the working storage units.
-	std::vector<Storage> sorted_working_storages;
-	for (const Storage &working_storage : std::as_const(working_storages)) {
-		const std::vector<Storage>::size_type working_storage_index = &working_storage - &working_storages[0];
-		sorted_working_storages.push_back(working_storages[permutation[working_storage_index]]);
-	}
+	MachineCode outlined;
+	uint64_t num_outlined = 0;
+	for (const std::pair<int64_t, std::vector<std::tuple<Position, Position, Position>>::size_type> &ranked_repeat : std::as_const(ranked_repeats)) {
+		const std::tuple<Position, Position, Position> &repeat      = repeats[ranked_repeat.second];
+		const Position                                  length      = std::get<0>(repeat);
+		const std::vector<Position>                     occurrences = get_occurrences(repeat);
+		if (get_savings(length, occurrences.size()) <= 0) {
+			continue;
+		}
 
-	// Emit the block.
-	output_lines = block_semantics.instructions.emit({}, sorted_working_storages, {}, false, block_semantics.back);
+		// Emit the subroutine.
+		const Symbol       outlined_symbol("outlined_", std::to_string(++num_outlined));
+		const MachineCode &first_code  = codes[locations[occurrences[0]].first];
+		const std::vector<MachineInstruction>::size_type first_index = locations[occurrences[0]].second;
+		const std::vector<MachineInstruction> body(first_code.instructions.cbegin() + first_index, first_code.instructions.cbegin() + first_index + length);
+		const MachineInstruction return_(MachineInstruction::jr_opcode, {Operand::make_register(MachineInstruction::ra_register)});
+		MachineCode subroutine(first_code);
+		subroutine.instructions = {MachineInstruction(MachineInstruction::label_opcode, {Operand::make_symbol(subroutine.add_symbol(outlined_symbol))})};
+		for (const MachineInstruction &instruction : std::as_const(body)) {
+			const Position body_index = &instruction - &body[0];
+			if (delayed_branches && body_index == 0) {
+				continue;
+			}
+			if (delayed_branches && body_index + 1 == length) {
+				subroutine.instructions.push_back(return_);
+			}
+			subroutine.instructions.push_back(instruction);
+		}
+		if (!delayed_branches) {
+			subroutine.instructions.push_back(return_);
+		}
+		outlined.append(subroutine);
+		outlined.add_line("");
+
+		// Call it instead.
+		for (const Position &occurrence : std::as_const(occurrences)) {
+			MachineCode &code = codes[locations[occurrence].first];
+			const std::vector<MachineInstruction>::size_type index = locations[occurrence].second;
+			const MachineInstruction first = code.instructions[index];
+			for (Position offset = 0; offset < length; ++offset) {
+				code.instructions[index + offset] = MachineInstruction();
+				is_outlined[occurrence + offset] = true;
+			}
+			code.instructions[index] = MachineInstruction(MachineInstruction::jal_opcode, {Operand::make_symbol(code.add_symbol(outlined_symbol))});
+			if (delayed_branches) {
+				code.instructions[index + 1] = first;
+			}
+		}
+	}
 
-	// Return the output.
-	return output_lines;
+	for (MachineCode &code : codes) {
+		code.remove_null_instructions();
+	}
+	return outlined;
 }
 
 // | Analyze a routine definition.
 //
 // "analyze_block" but look for additional types, constants, and variables.
-std::vector<Semantics::Output::Line> Semantics::analyze_routine(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const Body &body, IdentifierScope &constant_scope, IdentifierScope &type_scope, const IdentifierScope &routine_scope, IdentifierScope &var_scope, IdentifierScope &combined_scope, IdentifierScope &storage_scope) {
+Semantics::MachineCode Semantics::analyze_routine(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const Body &body, IdentifierScope &constant_scope, IdentifierScope &type_scope, const IdentifierScope &routine_scope, IdentifierScope &var_scope, IdentifierScope &combined_scope, IdentifierScope &storage_scope, const RoutineSpecialization &specialization) {
 	IdentifierScope local_constant_scope(constant_scope);
 	IdentifierScope local_type_scope(type_scope);
 	//IdentifierScope local_var_scope(var_scope);
@@ -16037,7 +23108,7 @@ std::vector<Semantics::Output::Line> Semantics::analyze_routine(const Identifier
 
 	// We've finished handling extra constants, types, and variables.
 	// Proceed to analyze_block.
-	return analyze_block(routine_declaration, parameter_identifiers, block, local_constant_scope, local_type_scope, routine_scope, var_scope, local_combined_scope, storage_scope, local_variables, false);
+	return analyze_block(routine_declaration, parameter_identifiers, block, local_constant_scope, local_type_scope, routine_scope, var_scope, local_combined_scope, storage_scope, local_variables, false, specialization);
 }
 
 // | Get the symbol to a string literal, tracking it if this is the first time encountering it.
@@ -16219,6 +23290,15 @@ void Semantics::reset_output() {
 	top_level_vars.clear();
 	string_constants.clear();
 	routine_definitions.clear();
+	small_data_size = 0;
+	small_data_objects.clear();
+	readonly_routines.clear();
+	memo_tables.clear();
+	memoized_functions.clear();
+	size_report.clear();
+	num_bounds_checks = 0;
+	profile_block_lexemes.clear();
+	num_profile_counters = 0;
 
 	// Reset.
 
@@ -16267,8 +23347,56 @@ void Semantics::reset_output() {
 	}
 }
 
+const Semantics::Symbol Semantics::small_data_symbol("global_", "small_data", 0);
+const Semantics::Symbol Semantics::profile_dump_symbol("profile_", "dump", 0);
+const Semantics::Symbol Semantics::profile_table_symbol("profile_", "table", 0);
+const Semantics::Symbol Semantics::profile_table_end_symbol("profile_", "table_end", 0);
+
 // | Force a re-analysis of the semantics data.
 void Semantics::analyze() {
+	lexeme_loop_depths = get_lexeme_loop_depths();
+	lexeme_weights     = get_lexeme_loop_weights();
+	profile_guided     = false;
+
+	analyze_program_specialized();
+
+	// Given a profile, the analysis so far, which is the one the profiled
+	// program was compiled with, shows where the blocks it counted are in
+	// the source.  Analyze again, weighing each lexeme as often as it ran.
+	if (!profile.empty()) {
+		const std::vector<uint64_t> profile_weights = get_lexeme_profile_weights();
+		if (!profile_weights.empty()) {
+			lexeme_weights = profile_weights;
+			profile_guided = true;
+			analyze_program_specialized();
+		}
+	}
+}
+
+void Semantics::analyze_program_specialized() {
+	call_sites.clear();
+	specializable_parameters.clear();
+	routine_specializations.clear();
+
+	// When optimizing, analyze the program once just to see which constants
+	// each routine is called with, and then again with the routines
+	// specialized accordingly.  Copies of routines cost space, though.
+	if (optimize && !optimize_size) {
+		collect_call_sites = true;
+		try {
+			analyze_program();
+		} catch (...) {
+			collect_call_sites = false;
+			throw;
+		}
+		collect_call_sites = false;
+		plan_routine_specializations();
+	}
+
+	analyze_program();
+}
+
+void Semantics::analyze_program() {
 	// It's possible the grammar was reset.  Clear caches and outputs just in
 	// case.
 	reset_output();
@@ -16570,6 +23698,12 @@ void Semantics::analyze() {
 			// Correct the order of the list.
 			std::reverse(typed_identifier_sequences.begin() + 1, typed_identifier_sequences.end());
 
+			// Collect the globals before laying any of them out, so that the
+			// data section can be ordered as a whole: identifier and type, in
+			// declaration order.
+			std::vector<std::pair<std::string, TypeIndex>> globals;
+			std::set<std::string> global_identifiers;
+
 			// Handle the typed identifier sequences.
 			for (const TypedIdentifierSequence *next_typed_identifier_sequence : std::as_const(typed_identifier_sequences)) {
 				const IdentList      &ident_list          = grammar.ident_list_storage.at(next_typed_identifier_sequence->ident_list);
@@ -16654,7 +23788,7 @@ void Semantics::analyze() {
 				// Handle the identifiers.
 				for (const LexemeIdentifier *next_identifier : std::as_const(identifiers)) {
 					// Duplicate variable definition?
-					if (top_level_var_scope.has(next_identifier->text)) {
+					if (top_level_var_scope.has(next_identifier->text) || global_identifiers.find(next_identifier->text) != global_identifiers.cend()) {
 						std::ostringstream sstr;
 						sstr
 							<< "Semantics::analyze: error (line "
@@ -16685,24 +23819,8 @@ void Semantics::analyze() {
 						output.add_line(Output::global_vars_section, sline.str());
 					}
 
-					// Add the variable binding.
-
-					// Use the Var index as its symbol unique identifier.
-					const std::string next_identifier_text = std::as_const(next_identifier->text);
-					const Symbol var_symbol("global_var_", next_identifier_text, top_level_vars.size());
-					Storage var_storage;
-					if (!storage_scope.type(next_semantics_type).resolve_type(storage_scope).is_array() && !storage_scope.type(next_semantics_type).resolve_type(storage_scope).is_record()) {
-						var_storage = Storage(var_symbol, true, storage_scope.type(next_semantics_type).get_size(), 0);
-					} else {
-						var_storage = Storage(var_symbol, false, 4, 0);
-					}
-					const IdentifierScope::IdentifierBinding::Var var(next_semantics_type, var_storage);
-					top_level_vars.push_back(var);
-					top_level_var_scope.insert({next_identifier_text, IdentifierScope::IdentifierBinding(var)});
-					top_level_scope.insert({next_identifier_text, IdentifierScope::IdentifierBinding(var)});
-
 					// Global variable-width variables are currently unsupported.
-					if (!storage_scope.type(var.type).get_fixed_width()) {
+					if (!storage_scope.type(next_semantics_type).get_fixed_width()) {
 						std::ostringstream sstr;
 						sstr
 							<< "Semantics::analyze: error (line "
@@ -16712,27 +23830,116 @@ void Semantics::analyze() {
 						throw SemanticsError(sstr.str());
 					}
 
-					// Compile the variable references.
-					output.add_line(Output::global_vars_section, ":", var_storage.global_address);
-					if        (storage_scope.type(var.type).get_size() == 4) {
+					globals.push_back({next_identifier->text, next_semantics_type});
+					global_identifiers.insert(next_identifier->text);
+				}
+			}
+
+			// Lay out the data section: the order in which to emit the
+			// globals.
+			const std::vector<std::vector<std::pair<std::string, TypeIndex>>::size_type> global_layout = layout_globals(globals, storage_scope);
+
+			// Globals that don't fit in the small-data section are emitted
+			// after it.
+			std::vector<Output::Line> large_global_lines;
+
+			std::vector<Storage> global_storages(globals.size());
+			for (const std::vector<std::pair<std::string, TypeIndex>>::size_type &global_index : std::as_const(global_layout)) {
+				const std::string &next_identifier_text = globals[global_index].first;
+				const TypeIndex    next_semantics_type  = globals[global_index].second;
+
+				// Use the Var index as its symbol unique identifier.
+				const Symbol var_symbol("global_var_", next_identifier_text, top_level_vars.size() + global_index);
+				const bool     is_aggregate = storage_scope.type(next_semantics_type).resolve_type(storage_scope).is_array() || storage_scope.type(next_semantics_type).resolve_type(storage_scope).is_record();
+				const uint32_t var_size     = storage_scope.type(next_semantics_type).get_size();
+
+				// Can this variable go in the small-data section?  If so,
+				// its offset from $gp is known now, so accesses can be
+				// lowered to off($gp) rather than going through its label.
+				//
+				// Mirror the alignment the assembler would apply: words
+				// are aligned to 4, bytes are unaligned, and everything
+				// else is preceded by ".align 4" (16 bytes).
+				const uint32_t small_data_alignment = (!is_aggregate && var_size == 4) ? 4 : (!is_aggregate && var_size == 1) ? 1 : 16;
+				const uint32_t small_data_offset    = static_cast<uint32_t>(Instruction::AddSp::round_to_align(small_data_size, small_data_alignment));
+				const bool     is_small_data        = optimize && var_size <= small_data_threshold && small_data_offset + var_size <= small_data_max_size;
+
+				Storage &var_storage = global_storages[global_index];
+				if (is_small_data) {
+					if (!is_aggregate) {
+						var_storage = Storage("$gp", var_size, static_cast<int32_t>(small_data_offset), true);
+					} else {
+						// The address is $gp plus the offset; LoadFrom applies
+						// the offset of a direct register as an addition.
+						var_storage = Storage(4, false, Symbol(), "$gp", false, static_cast<int32_t>(small_data_offset), true);
+					}
+				} else if (!is_aggregate) {
+					var_storage = Storage(var_symbol, true, var_size, 0);
+				} else {
+					var_storage = Storage(var_symbol, false, 4, 0);
+				}
+
+				// Compile the variable references.
+				if (is_small_data) {
+					// The small-data section comes first in .data, so the
+					// offsets computed above are exact.
+					if (small_data_size == 0) {
+						output.add_line(Output::global_vars_section, ":", small_data_symbol);
+					}
+					if (small_data_offset != small_data_size) {
+						std::ostringstream sline_align;
+						sline_align << "\t.align " << std::right << std::setw(11) << (small_data_alignment == 4 ? "2" : "4");
+						output.add_line(Output::global_vars_section, sline_align.str());
+					}
+					output.add_line(Output::global_vars_section, ":", var_symbol);
+					if        (!is_aggregate && var_size == 4) {
 						std::ostringstream sline;
 						sline << "\t.word  " << std::right << std::setw(11) << "0";
 						output.add_line(Output::global_vars_section, sline.str());
-					} else if (storage_scope.type(var.type).get_size() == 1) {
+					} else if (!is_aggregate && var_size == 1) {
 						std::ostringstream sline;
 						sline << "\t.byte  " << std::right << std::setw(11) << "0";
 						output.add_line(Output::global_vars_section, sline.str());
 					} else {
-						std::ostringstream sline_align;
-						sline_align << "\t.align " << std::right << std::setw(11) << "4";
-						output.add_line(Output::global_vars_section, sline_align.str());
 						std::ostringstream sline;
-						sline << "\t.space " << std::right << std::setw(11) << storage_scope.type(var.type).get_size();
+						sline << "\t.space " << std::right << std::setw(11) << var_size;
 						output.add_line(Output::global_vars_section, sline.str());
 					}
+					small_data_size = small_data_offset + var_size;
+					small_data_objects.insert({static_cast<int32_t>(small_data_offset), var_size});
+					continue;
+				}
+
+				large_global_lines.push_back({":", var_symbol});
+				if        (var_size == 4) {
+					std::ostringstream sline;
+					sline << "\t.word  " << std::right << std::setw(11) << "0";
+					large_global_lines.push_back(sline.str());
+				} else if (var_size == 1) {
+					std::ostringstream sline;
+					sline << "\t.byte  " << std::right << std::setw(11) << "0";
+					large_global_lines.push_back(sline.str());
+				} else {
+					std::ostringstream sline_align;
+					sline_align << "\t.align " << std::right << std::setw(11) << "4";
+					large_global_lines.push_back(sline_align.str());
+					std::ostringstream sline;
+					sline << "\t.space " << std::right << std::setw(11) << var_size;
+					large_global_lines.push_back(sline.str());
 				}
 			}
 
+			// Add the variable bindings in declaration order.
+			for (const std::pair<std::string, TypeIndex> &global : std::as_const(globals)) {
+				const IdentifierScope::IdentifierBinding::Var var(global.second, global_storages[&global - &globals[0]]);
+				top_level_vars.push_back(var);
+				top_level_var_scope.insert({global.first, IdentifierScope::IdentifierBinding(var)});
+				top_level_scope.insert({global.first, IdentifierScope::IdentifierBinding(var)});
+			}
+
+			// Globals outside the small-data section follow it.
+			output.add_lines(Output::global_vars_section, large_global_lines);
+
 			// We're done handling the top-level variable declarations.
 			break;
 		}
@@ -16760,8 +23967,15 @@ void Semantics::analyze() {
 	// 
 	output.add_line(Output::text_section, "start:");
 	output.add_line(Output::text_section, "\tj    main");
+	if (delayed_branches) {
+		output.add_line(Output::text_section, "\tnop");
+	}
 	output.add_line(Output::text_section, "");
 
+	// The code of each routine, as the lines that label it and its body, to
+	// be added to the text section once they're all analyzed.
+	std::vector<std::pair<std::vector<Output::Line>, MachineCode>> routine_code;
+
 	// Collect the procedure_decl_or_function_decls in the list.
 	std::vector<const ProcedureDeclOrFunctionDecl *> procedure_decl_or_function_decls;
 	bool reached_end = false;
@@ -17288,12 +24502,16 @@ void Semantics::analyze() {
 							routine_definitions.insert(identifier.text);
 						}
 
-						// Emit procedure definition.
-						std::vector<Output::Line> routine_definition_lines;
-						routine_definition_lines = analyze_routine(routine_declaration, parameter_names, body, top_level_constant_scope, top_level_type_scope, top_level_routine_scope, top_level_var_scope, top_level_scope, storage_scope);
-						output.add_line(Output::text_section, ":", routine_symbol);
-						output.add_lines(Output::text_section, routine_definition_lines);
-						output.add_line(Output::text_section, "");
+						// Emit procedure definition, followed by any copies of it
+						// specialized for constant arguments.
+						for (const RoutineSpecialization &specialization : get_routine_specializations(routine_declaration, parameter_names, body, top_level_var_scope, top_level_routine_scope)) {
+							IdentifierScope::IdentifierBinding::RoutineDeclaration specialized_routine_declaration(routine_declaration);
+							specialized_routine_declaration.location = specialization.location;
+
+							MachineCode routine_definition_code;
+							routine_definition_code = analyze_routine(specialized_routine_declaration, parameter_names, body, top_level_constant_scope, top_level_type_scope, top_level_routine_scope, top_level_var_scope, top_level_scope, storage_scope, specialization);
+							routine_code.push_back({{{":", specialization.location}}, routine_definition_code});
+						}
 
 						// We're done handling the procedure definition.
 						break;
@@ -17809,12 +25027,58 @@ void Semantics::analyze() {
 							routine_definitions.insert(identifier.text);
 						}
 
-						// Emit function definition.
-						std::vector<Output::Line> routine_definition_lines;
-						routine_definition_lines = analyze_routine(routine_declaration, parameter_names, body, top_level_constant_scope, top_level_type_scope, top_level_routine_scope, top_level_var_scope, top_level_scope, storage_scope);
-						output.add_line(Output::text_section, ":", routine_symbol);
-						output.add_lines(Output::text_section, routine_definition_lines);
-						output.add_line(Output::text_section, "");
+						// Functions that only compute a primitive value from
+						// their arguments and globals may have their calls
+						// reused.
+						if ((optimize || auto_memoize) && storage_scope.resolve_type(output_type).is_primitive()) {
+							const std::optional<std::set<std::string>> global_reads = get_routine_global_reads(routine_declaration, parameter_names, body, top_level_var_scope, top_level_routine_scope);
+							if (global_reads.has_value()) {
+								readonly_routines[routine_declaration.location] = *global_reads;
+							}
+						}
+
+						// Memoize it?  Then its label looks up the table, and
+						// its body gets a label of its own.
+						const std::optional<MemoTable> memo_table = get_memo_table(routine_declaration, parameter_names, body, identifier.text);
+						if (memo_table.has_value()) {
+							memo_tables[routine_declaration.location] = *memo_table;
+
+							std::ostringstream sreport;
+							sreport << "memoizing function ``" << identifier.text << "\" in a table of " << memo_table->get_num_entries() << " results, for arguments";
+							for (const uint32_t &extent : std::as_const(memo_table->extents)) {
+								sreport << (&extent == &memo_table->extents[0] ? " " : ", ") << "0 to " << extent - 1;
+							}
+							sreport << ".";
+							memoized_functions.push_back(sreport.str());
+
+							if (output.is_section_empty(Output::global_vars_section)) {
+								output.add_line(Output::global_vars_section, ".data");
+							}
+							std::ostringstream sline_align;
+							sline_align << "\t.align " << std::right << std::setw(11) << "2";
+							std::ostringstream sline_values;
+							sline_values << "\t.space " << std::right << std::setw(11) << memo_table->get_num_entries() * (memo_table->is_word ? 4 : 1);
+							std::ostringstream sline_valid;
+							sline_valid << "\t.space " << std::right << std::setw(11) << memo_table->get_num_entries();
+							output.add_line(Output::global_vars_section, sline_align.str());
+							output.add_line(Output::global_vars_section, ":", memo_table->values_symbol);
+							output.add_line(Output::global_vars_section, sline_values.str());
+							output.add_line(Output::global_vars_section, ":", memo_table->valid_symbol);
+							output.add_line(Output::global_vars_section, sline_valid.str());
+
+							routine_code.push_back({{{":", routine_declaration.location}}, MachineCode(get_memo_lines(*memo_table, routine_declaration.parameters.size()))});
+						}
+
+						// Emit function definition, followed by any copies of it
+						// specialized for constant arguments.
+						for (const RoutineSpecialization &specialization : get_routine_specializations(routine_declaration, parameter_names, body, top_level_var_scope, top_level_routine_scope)) {
+							IdentifierScope::IdentifierBinding::RoutineDeclaration specialized_routine_declaration(routine_declaration);
+							specialized_routine_declaration.location = memo_table.has_value() ? memo_table->body_location : specialization.location;
+
+							MachineCode routine_definition_code;
+							routine_definition_code = analyze_routine(specialized_routine_declaration, parameter_names, body, top_level_constant_scope, top_level_type_scope, top_level_routine_scope, top_level_var_scope, top_level_scope, storage_scope, specialization);
+							routine_code.push_back({{{":", specialized_routine_declaration.location}}, routine_definition_code});
+						}
 
 						// We're done handling the function definition.
 						break;
@@ -17870,10 +25134,148 @@ void Semantics::analyze() {
 	Symbol main_routine_symbol("", "main", 0);
 	std::vector<std::pair<bool, TypeIndex >> main_parameters;
 	IdentifierScope::IdentifierBinding::RoutineDeclaration main_routine_declaration(main_routine_symbol, main_parameters, std::optional<TypeIndex >());
-	std::vector<Output::Line> main_routine_definition_lines;
-	main_routine_definition_lines = analyze_block(main_routine_declaration, {}, block, top_level_constant_scope, top_level_type_scope, top_level_routine_scope, top_level_var_scope, top_level_scope, storage_scope, {}, true);
-	output.add_line(Output::text_section, ":", main_routine_symbol);
-	output.add_lines(Output::text_section, main_routine_definition_lines);
+	MachineCode main_routine_definition_code;
+	main_routine_definition_code = analyze_block(main_routine_declaration, {}, block, top_level_constant_scope, top_level_type_scope, top_level_routine_scope, top_level_var_scope, top_level_scope, storage_scope, {}, true);
+	std::vector<Output::Line> main_label_lines {{":", main_routine_symbol}};
+	if (small_data_size > 0) {
+		// Point $gp at the small-data section before anything accesses it.
+		main_label_lines.push_back(Output::Line("\tla    $gp, ") + small_data_symbol);
+	}
+	routine_code.push_back({main_label_lines, main_routine_definition_code});
+
+	// Find where each block starts in the source, to read a profile, and,
+	// to write one, count each block and add the routine that prints the
+	// counts, which follows the table of counts and what to print with
+	// each.
+	if (profile_generate || !profile.empty()) {
+		std::vector<Output::Line> table_lines;
+		for (std::pair<std::vector<Output::Line>, MachineCode> &routine : routine_code) {
+			const Symbol &routine_symbol = routine.first[0].symbols[0].first;
+			count_profile_blocks(routine_symbol, routine_symbol == main_routine_symbol ? block.begin_keyword0 : routine_symbol.unique_identifier, routine.second, table_lines);
+		}
+
+		if (profile_generate) {
+			if (output.is_section_empty(Output::global_vars_section)) {
+				output.add_line(Output::global_vars_section, ".data");
+			}
+			std::ostringstream sline_align;
+			sline_align << "\t.align " << std::right << std::setw(11) << "2";
+			output.add_line(Output::global_vars_section, sline_align.str());
+			output.add_line(Output::global_vars_section, ":", profile_table_symbol);
+			output.add_lines(Output::global_vars_section, table_lines);
+			output.add_line(Output::global_vars_section, ":", profile_table_end_symbol);
+
+			routine_code.push_back({{{":", profile_dump_symbol}}, MachineCode(get_profile_dump_lines())});
+		}
+	}
+
+	// When optimizing for speed, lay out the blocks of each routine so that
+	// the likely path falls through and the code that doesn't run comes
+	// last, and then put the routines that run ahead of those that don't:
+	// those the profile never counted entering, or, without one, those that
+	// no code that runs calls.  Code counted for a profile keeps its order.
+	if (optimize && !optimize_size && !profile_generate) {
+		std::vector<std::set<Symbol>> routine_hot_symbols(routine_code.size());
+		for (std::pair<std::vector<Output::Line>, MachineCode> &routine : routine_code) {
+			const std::vector<std::pair<std::vector<Output::Line>, MachineCode>>::size_type routine_index = &routine - &routine_code[0];
+			const Symbol      &routine_symbol = routine.first[0].symbols[0].first;
+			const std::string  routine_name   = routine_symbol.prefix + routine_symbol.requested_suffix;
+			std::map<std::string, uint64_t> block_counts;
+			for (Profile::const_iterator count = profile.lower_bound({routine_name, ""}); count != profile.cend() && count->first.first == routine_name; ++count) {
+				block_counts.insert({count->first.second, count->second});
+			}
+			layout_emitted_blocks(routine.second, block_counts, routine_hot_symbols[routine_index]);
+		}
+
+		std::vector<bool> runs(routine_code.size(), false);
+		for (const std::pair<std::vector<Output::Line>, MachineCode> &routine : std::as_const(routine_code)) {
+			const std::vector<std::pair<std::vector<Output::Line>, MachineCode>>::size_type routine_index = &routine - &routine_code[0];
+			const Symbol &routine_symbol = routine.first[0].symbols[0].first;
+			const Profile::const_iterator entry_count_search = profile.find({routine_symbol.prefix + routine_symbol.requested_suffix, "entry"});
+			runs[routine_index] = routine_symbol == main_routine_symbol || (!profile.empty() && (entry_count_search == profile.cend() || entry_count_search->second > 0));
+		}
+		for (bool changed = profile.empty(); changed; ) {
+			changed = false;
+			for (const std::pair<std::vector<Output::Line>, MachineCode> &routine : std::as_const(routine_code)) {
+				const std::vector<std::pair<std::vector<Output::Line>, MachineCode>>::size_type routine_index = &routine - &routine_code[0];
+				if (runs[routine_index]) {
+					continue;
+				}
+				for (const std::set<Symbol> &hot_symbols : std::as_const(routine_hot_symbols)) {
+					if (runs[&hot_symbols - &routine_hot_symbols[0]] && hot_symbols.find(routine.first[0].symbols[0].first) != hot_symbols.cend()) {
+						runs[routine_index] = true;
+						changed = true;
+						break;
+					}
+				}
+			}
+		}
+
+		std::vector<std::pair<std::vector<Output::Line>, MachineCode>> grouped_routine_code;
+		for (bool is_running : {true, false}) {
+			for (const std::pair<std::vector<Output::Line>, MachineCode> &routine : std::as_const(routine_code)) {
+				if (runs[&routine - &routine_code[0]] == is_running) {
+					grouped_routine_code.push_back(routine);
+				}
+			}
+		}
+		routine_code = std::move(grouped_routine_code);
+	}
+
+	// Add the code of each routine to the text section, filling any delay
+	// slots first.  When optimizing for size, then share epilogues and
+	// outline sequences that repeat.  The code is rendered only here.
+	std::vector<MachineCode> routine_bodies;
+	std::vector<uint64_t>    routine_sizes;
+	for (const std::pair<std::vector<Output::Line>, MachineCode> &routine : std::as_const(routine_code)) {
+		routine_bodies.push_back(routine.second);
+		if (delayed_branches) {
+			fill_delay_slots(routine_bodies.back());
+		}
+		routine_sizes.push_back(routine_bodies.back().get_num_instructions());
+	}
+	MachineCode shared_code;
+	if (optimize && optimize_size) {
+		shared_code = share_epilogues(routine_bodies, delayed_branches);
+		shared_code.append(outline_machine_code(routine_bodies, delayed_branches));
+	}
+	for (const std::pair<std::vector<Output::Line>, MachineCode> &routine : std::as_const(routine_code)) {
+		const std::vector<MachineCode>::size_type routine_index = &routine - &routine_code[0];
+		output.add_lines(Output::text_section, routine.first);
+		output.add_lines(Output::text_section, routine_bodies[routine_index].render());
+		if (routine_index + 1 < routine_code.size() || !shared_code.instructions.empty()) {
+			output.add_line(Output::text_section, "");
+		}
+
+		// Report the size of the routine.
+		if (optimize && optimize_size) {
+			const Symbol &routine_symbol = routine.first[0].symbols[0].first;
+			std::ostringstream sreport;
+			sreport
+				<< "size of " << routine_symbol.prefix << routine_symbol.requested_suffix << ": "
+				<< routine_sizes[routine_index] << " instructions, "
+				<< routine_bodies[routine_index].get_num_instructions() << " after sharing code."
+				;
+			size_report.push_back(sreport.str());
+		}
+	}
+	output.add_lines(Output::text_section, shared_code.render());
+	if (optimize && optimize_size) {
+		std::ostringstream sreport;
+		sreport << "size of shared code: " << shared_code.get_num_instructions() << " instructions.";
+		size_report.push_back(sreport.str());
+	}
+
+	// Count the bounds checks that are left, as their traps.
+	if (bounds_check) {
+		std::vector<MachineCode> checked_code(routine_bodies);
+		checked_code.push_back(shared_code);
+		for (const MachineCode &code : std::as_const(checked_code)) {
+			num_bounds_checks += std::count_if(code.instructions.cbegin(), code.instructions.cend(), [](const MachineInstruction &instruction) -> bool {
+				return instruction.is_trap();
+			});
+		}
+	}
 
 	// The string literals have been analyzed by this point.
 	// Add the string literal declarations.
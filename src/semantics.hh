@@ -45,6 +45,19 @@ public:
 #define CPSL_CC_SEMANTICS_EMIT_SOME_REDUNDANT_LABELS               true
 #define CPSL_CC_SEMANTICS_EMIT_EXTRA_REDUNDANT_LABELS              false
 #define CPSL_CC_SEMANTICS_PERMIT_UNUSED_FUNCTION_OUTPUTS           true
+#define CPSL_CC_SEMANTICS_SMALL_DATA_THRESHOLD                     64
+#define CPSL_CC_SEMANTICS_SMALL_DATA_MAX_SIZE                      32768
+#define CPSL_CC_SEMANTICS_DEFAULT_UNROLL_FACTOR                    4
+#define CPSL_CC_SEMANTICS_MAX_UNROLL_BODY_SIZE                     32
+#define CPSL_CC_SEMANTICS_MAX_FULL_UNROLL_SIZE                     128
+#define CPSL_CC_SEMANTICS_MAX_IF_CONVERSION_ARM_SIZE               8
+#define CPSL_CC_SEMANTICS_MAX_ROUTINE_SPECIALIZATIONS              2
+#define CPSL_CC_SEMANTICS_MIN_SPECIALIZATION_WEIGHT                8
+#define CPSL_CC_SEMANTICS_MAX_SPECIALIZED_ROUTINE_SIZE             512
+#define CPSL_CC_SEMANTICS_MAX_MEMO_TABLE_ENTRIES                   1024
+#define CPSL_CC_SEMANTICS_MIN_SCALAR_RECORD_WORKING_REGISTERS      5
+#define CPSL_CC_SEMANTICS_PEEPHOLE_WINDOW                          8
+#define CPSL_CC_SEMANTICS_DEFAULT_ARCHITECTURE                     mips32_architecture
 
 class Semantics {
 public:
@@ -53,6 +66,42 @@ public:
 	static const bool emit_some_redundant_labels;
 	static const bool emit_extra_redundant_labels;
 	static const bool permit_unused_function_outputs;
+	// | Globals no larger than this many bytes are placed in the small-data
+	// section and addressed relative to $gp.
+	static const uint32_t small_data_threshold;
+	// | The small-data section must remain addressable with a signed 16-bit
+	// offset from $gp.
+	static const uint32_t small_data_max_size;
+	// | How many copies of a small "for" loop body to run per check of the
+	// loop condition, unless set_unroll_factor is called.
+	static const uint32_t default_unroll_factor;
+	// | "for" loop bodies of at most this many instructions are unrolled.
+	static const uint32_t max_unroll_body_size;
+	// | "for" loops with constant bounds are unrolled completely if the
+	// copies of the body total at most this many instructions.
+	static const uint32_t max_full_unroll_size;
+	// | "if" statements whose arms each assign a variable an expression of at
+	// most this many instructions may be lowered to a branchless select.
+	static const uint32_t max_if_conversion_arm_size;
+	// | At most this many copies of a routine are specialized for constant
+	// arguments that only some of its call sites pass.
+	static const uint32_t max_routine_specializations;
+	// | A combination of constant arguments is only worth a specialized copy
+	// if its call sites weigh at least this much, where a call site weighs
+	// 1, times 8 per enclosing loop, or, with a profile, how often it ran.
+	static const uint64_t min_specialization_weight;
+	// | Routines whose bodies span more than this many lexemes aren't copied.
+	static const uint64_t max_specialized_routine_size;
+	// | With --auto-memoize, a memoized function's table covers at most this
+	// many combinations of arguments.
+	static const uint32_t max_memo_table_entries;
+	// | The fields of a local record replaced by scalars only take temporary
+	// registers if it is used in a loop, and while more than this many
+	// remain for working storage.
+	static const uint32_t min_scalar_record_working_registers;
+	// | The instructions a peephole rule matches must lie within this many
+	// instructions of each other.
+	static const uint32_t peephole_window;
 
 	// | In the assembled output, locations marked as symbols will be replaced
 	// with a unique and consistent substring.
@@ -200,15 +249,17 @@ public:
 		class Base {
 		public:
 			Base();
-			Base(const std::string  &identifier, bool fixed_width = true, uint32_t size = 0);
-			Base(std::string       &&identifier, bool fixed_width = true, uint32_t size = 0);
+			Base(const std::string  &identifier, bool fixed_width = true, uint32_t size = 0, uint32_t alignment = 0);
+			Base(std::string       &&identifier, bool fixed_width = true, uint32_t size = 0, uint32_t alignment = 0);
 			std::string identifier;  // In the scope in which this type is visible, which identifier refers to this type?
 			bool fixed_width;        // Are values of this type constrained to a fixed size?
 			uint32_t size;           // How many bytes do values of this type occupy in memory?  Ignored if !fixed_width.
+			uint32_t alignment = 1;  // To how many bytes must values of this type be aligned?  If 0 is given to the constructor, this is the size, up to a word.
 
 			const std::string &get_identifier()  const;
 			bool               get_fixed_width() const;
 			uint32_t           get_size()        const;
+			uint32_t           get_alignment()   const;
 		};
 
 		class Primitive : public Base {
@@ -279,6 +330,11 @@ public:
 			Record(const std::string &identifier, std::vector<std::pair<std::string, TypeIndex>> &&fields, const IdentifierScope &storage_scope);
 			// | Ordered list of identifier, type pairs.
 			std::vector<std::pair<std::string, TypeIndex>> fields;
+			// | The offset of each field in "fields".  The program can't
+			// observe the layout, so fields are placed in decreasing order
+			// of alignment rather than in declaration order, which avoids
+			// padding between them.
+			std::vector<uint32_t> field_offsets;
 
 			// | Used for comparison and equality checking.
 			std::vector<std::pair<std::string, Type>> get_dereferenced_fields(const IdentifierScope &storage_scope) const;
@@ -341,6 +397,7 @@ public:
 		std::string get_identifier_copy() const;
 		bool        get_fixed_width() const;
 		uint32_t    get_size() const;
+		uint32_t    get_alignment() const;
 
 		explicit Type(const Primitive &primitive);
 		explicit Type(const Simple    &simple);
@@ -536,6 +593,10 @@ public:
 		static std::string get_tag_repr(tag_t tag);
 		std::string get_tag_repr() const;
 
+		// | Do both values hold the same static integer, char, or boolean?
+		// (Strings and dynamic values never match.)
+		bool matches(const ConstantValue &other) const;
+
 		// | Get the primitive type of the constant value, which must be static.
 		//
 		// Raise an error if it's not static.
@@ -556,6 +617,60 @@ public:
 		static std::vector<Output::Line> data_string(const std::string &string);
 	};
 
+	// | An inclusive interval that an integer, char, or boolean value is
+	// known to lie in.  The default range is every word value.
+	//
+	// Operations that might overflow give every word value, since MIPS
+	// arithmetic wraps.
+	class ValueRange {
+	public:
+		ValueRange();
+		ValueRange(int64_t min, int64_t max);
+		// | A single value if the constant is a static integer, char, or
+		// boolean; otherwise every word value.
+		explicit ValueRange(const ConstantValue &constant_value);
+		int64_t min;
+		int64_t max;
+
+		static const ValueRange word_range;
+		static const ValueRange byte_range;
+		static const ValueRange boolean_range;
+
+		bool operator==(const ValueRange &other) const;
+		bool operator!=(const ValueRange &other) const;
+
+		bool is_constant() const;
+		bool is_within(int64_t min, int64_t max) const;
+		bool is_within(const ValueRange &other) const;
+		bool is_nonnegative() const;
+		// | If the range is a single power of 2, its base-2 logarithm.
+		std::optional<uint32_t> get_power_of_2() const;
+
+		// | The smallest range containing both.
+		ValueRange join(const ValueRange &other) const;
+		// | The values in both, or this range if there are none, which can
+		// only happen in code that never runs.
+		ValueRange meet(const ValueRange &other) const;
+
+		ValueRange add(const ValueRange &other) const;
+		ValueRange subtract(const ValueRange &other) const;
+		ValueRange multiply(const ValueRange &other) const;
+		// | "div" truncates toward 0, and the remainder takes the sign of the
+		// dividend.  Ranges that might include a divisor of 0 give every word
+		// value.
+		ValueRange divide(const ValueRange &other) const;
+		ValueRange remainder(const ValueRange &other) const;
+		ValueRange bitwise_and(const ValueRange &other) const;
+		ValueRange bitwise_or(const ValueRange &other) const;
+		// | A value written to a byte may be held in a register untruncated,
+		// or stored and loaded back sign-extended.
+		ValueRange store_byte() const;
+
+	protected:
+		// | Every word value if the bounds don't fit in a word.
+		static ValueRange wrap(int64_t min, int64_t max);
+	};
+
 	// | Objects represent a collection of identifiers in scope and what they refer to.
 	class IdentifierScope {
 	public:
@@ -701,6 +816,51 @@ public:
 	void set_grammar(const Grammar &grammar);
 	void set_grammar(Grammar &&grammar);
 
+	// | Set how many copies of a small "for" loop body to run per check of
+	// the loop condition.  1 disables partial unrolling.
+	void set_unroll_factor(uint32_t unroll_factor);
+
+	// | Set whether to memoize pure recursive functions of small integer
+	// arguments.
+	void set_auto_memoize(bool auto_memoize);
+
+	// | A description of each function memoized by the last analysis.
+	const std::vector<std::string> &get_memoized_functions() const;
+
+	// | Set whether to optimize for code size rather than speed.
+	void set_optimize_size(bool optimize_size);
+
+	// | When optimizing for size, how many instructions each routine took
+	// before and after sharing code between routines, and how many the
+	// shared code takes.
+	const std::vector<std::string> &get_size_report() const;
+
+	// | Set whether to trap on array indices out of bounds.  Checks that
+	// value ranges or earlier checks prove always pass are left out.
+	void set_bounds_check(bool bounds_check);
+
+	// | How many bounds checks the emitted code of the last analysis kept.
+	uint64_t get_num_bounds_checks() const;
+
+	// | How often each block ran, by the name of its routine's label and the
+	// block's ID; see get_profile_block_ids.
+	typedef std::map<std::pair<std::string, std::string>, uint64_t> Profile;
+
+	// | Set whether to count how often each block runs, and print the counts
+	// when the program stops.
+	void set_profile_generate(bool profile_generate);
+
+	// | Set the counts, from a run of the program compiled with
+	// set_profile_generate, that routine specialization, loop unrolling,
+	// promotion to registers, and the layout of globals and code should
+	// follow.
+	void set_profile(const Profile &profile);
+
+	// | Read the counts printed by a program compiled with
+	// set_profile_generate, skipping its other output.  Counts from several
+	// runs add up.
+	static Profile parse_profile(const std::vector<std::string> &lines);
+
 	// | Determine whether the expression in the grammar tree is a constant expression.
 	ConstantValue is_expression_constant(
 		// | Reference to the expression in the grammar tree.
@@ -724,6 +884,22 @@ public:
 	// IdentifierScope passed to this method.
 	Type analyze_type(const std::string &identifier, const ::Type &type, const IdentifierScope &type_constant_scope, const IdentifierScope &type_type_scope, IdentifierScope &storage_scope);
 
+	// | The instruction set revisions code can be emitted for.  Each has the
+	// instructions of those before it.  MIPS32 adds "mul", "movn", and
+	// "movz"; MIPS32 Release 2 adds "seb", "seh", "ext", and "ins".
+	enum architecture_e {
+		null_architecture     = 0,
+		mips1_architecture    = 1,
+		mips32_architecture   = 2,
+		mips32r2_architecture = 3,
+		num_architectures     = 3,
+	};
+	typedef enum architecture_e architecture_t;
+	// | The architectures --march can name.
+	static const std::map<std::string, architecture_t> architectures;
+	// | The architecture to emit code for, unless set_architecture is called.
+	static const architecture_t default_architecture;
+
 	// | An intermediate unit representation of MIPS instructions.
 	//
 	// "Registers" may be registers or other types of storage, e.g. offsets on the stack.  Which type they are can be analyzed afterward.
@@ -755,11 +931,15 @@ public:
 			return_tag             = 18,
 			branch_zero_tag        = 19,
 			branch_nonnegative_tag = 20,
-			num_tags               = 20,
+			select_tag             = 21,
+			check_bounds_tag       = 22,
+			num_tags               = 22,
 		};
 		typedef enum tag_e tag_t;
 
 		static std::vector<Output::Line> emit_binary_operation(const Instruction &instruction, const Output::Line &binary_operation, bool is_word_save, bool is_word_load, const std::vector<Storage> &storages);
+		// | Append the lines that load a source storage unit's value into a register.
+		static void emit_load(std::vector<Output::Line> &lines, const Storage &source_storage, const std::string &destination_register, bool is_word);
 
 		class Base {
 		public:
@@ -768,6 +948,9 @@ public:
 			// | Does this instruction have a label at the beginning of this instruction?
 			bool has_symbol;
 			Symbol symbol;
+			// | What is known of the first output's value besides what the
+			// instruction computes, e.g. that it is a for loop's iterator.
+			ValueRange known_range;
 
 			std::vector<uint32_t> get_input_sizes() const;
 			std::vector<uint32_t> get_working_sizes() const;
@@ -881,7 +1064,7 @@ public:
 		class LoadFrom : public Base {
 		public:
 			LoadFrom();
-			LoadFrom(const Base &base, bool is_word_save, bool is_word_load, int32_t addition, bool is_save_fixed, bool is_load_fixed, const Storage &fixed_save_storage, const Storage &fixed_load_storage, bool dereference_save = false, bool dereference_load = false, bool get_dest_address_from_input = false);
+			LoadFrom(const Base &base, bool is_word_save, bool is_word_load, int32_t addition, bool is_save_fixed, bool is_load_fixed, const Storage &fixed_save_storage, const Storage &fixed_load_storage, bool dereference_save = false, bool dereference_load = false, bool get_dest_address_from_input = false, int32_t dereference_save_offset = 0, int32_t dereference_load_offset = 0);
 			// Specialized constructors: load from and save to dynamic storage units.
 			LoadFrom(const Base &base, bool is_word_save, bool is_word_load, int32_t addition = 0);
 			LoadFrom(const Base &base, bool is_word, int32_t addition = 0);
@@ -909,6 +1092,12 @@ public:
 			//
 			// Ignored if is_saved_fixed is true.
 			bool get_dest_address_from_input = false;
+			// | When saving to what the storage unit points to, add this to the
+			// address first, e.g. "sw $t0, 8($t1)".
+			int32_t dereference_save_offset = 0;
+			// | When loading from what the storage unit points to, add this to
+			// the address first, e.g. "lw $t0, 8($t1)".
+			int32_t dereference_load_offset = 0;
 
 			std::vector<uint32_t> get_input_sizes() const;
 			std::vector<uint32_t> get_working_sizes() const;
@@ -1038,20 +1227,26 @@ public:
 			std::vector<uint32_t> get_output_sizes() const;
 			std::vector<uint32_t> get_all_sizes() const;
 
-			std::vector<Output::Line> emit(const std::vector<Storage> &storages) const;
+			// | With "mul", if the architecture has it and only Lo is wanted.
+			std::vector<Output::Line> emit(const std::vector<Storage> &storages, architecture_t architecture) const;
 		};
 
 		// | Divide two storage units into two others: quotient (Lo), then remainder (Hi).
 		class DivFrom : public Base {
 		public:
 			DivFrom();
-			DivFrom(const Base &base, bool is_word, bool ignore_hi = false, bool ignore_lo = false);
+			DivFrom(const Base &base, bool is_word, bool ignore_hi = false, bool ignore_lo = false, bool is_shift = false);
 			// | Are we loading a byte or a word?
 			bool is_word;
 			// | Ignore the upper 32 bits of the result (remainder / Hi)?
 			bool ignore_hi = false;
 			// | Ignore the lower 32 bits of the result (quotient / Lo)?
 			bool ignore_lo = false;
+			// | Is the dividend known to be nonnegative and the divisor a
+			// power of 2?  Then exactly one result is kept, and the second
+			// input is instead the power, to shift by for the quotient, or the
+			// divisor less 1, to mask with for the remainder.
+			bool is_shift = false;
 
 			std::vector<uint32_t> get_input_sizes() const;
 			std::vector<uint32_t> get_working_sizes() const;
@@ -1164,6 +1359,49 @@ public:
 			std::vector<Output::Line> emit(const std::vector<Storage> &storages) const;
 		};
 
+		// | Select without branching: if the first input is non-zero, write the
+		// second input to the output, else write the third input to the output.
+		//
+		// Emitted with "movn" where possible.
+		class Select : public Base {
+		public:
+			Select();
+			Select(const Base &base, bool is_word, bool is_condition_word = false);
+			// | Are we loading a byte or a word?
+			bool is_word;
+			// | Is the condition a byte (boolean) or a word?
+			bool is_condition_word = false;
+
+			std::vector<uint32_t> get_input_sizes() const;
+			std::vector<uint32_t> get_working_sizes() const;
+			std::vector<uint32_t> get_output_sizes() const;
+			std::vector<uint32_t> get_all_sizes() const;
+
+			// | The architecture must have "movn".
+			std::vector<Output::Line> emit(const std::vector<Storage> &storages, architecture_t architecture) const;
+		};
+
+		// | Trap unless the input is an index between min_index and
+		// max_index, and write the index minus min_index to the output.
+		//
+		// Emitted as an unsigned compare-and-trap, "tgeiu" or "tgeu", so a
+		// single comparison catches indices on either side.
+		class CheckBounds : public Base {
+		public:
+			CheckBounds();
+			CheckBounds(const Base &base, int32_t min_index, int32_t max_index);
+			int32_t min_index = 0;
+			int32_t max_index = 0;
+
+			std::vector<uint32_t> get_input_sizes() const;
+			std::vector<uint32_t> get_working_sizes() const;
+			std::vector<uint32_t> get_output_sizes() const;
+			std::vector<uint32_t> get_all_sizes() const;
+
+			// | The architecture must have trap instructions.
+			std::vector<Output::Line> emit(const std::vector<Storage> &storages, architecture_t architecture) const;
+		};
+
 		using data_t = std::variant<
 			std::monostate,
 			Ignore,
@@ -1185,7 +1423,9 @@ public:
 			Call,
 			Return,
 			BranchZero,
-			BranchNonnegative
+			BranchNonnegative,
+			Select,
+			CheckBounds
 		>;
 
 		Instruction();
@@ -1218,6 +1458,8 @@ public:
 		Instruction(const Return            &return_);
 		Instruction(const BranchZero        &branch_zero);
 		Instruction(const BranchNonnegative &branch_nonnegative);
+		Instruction(const Select            &select);
+		Instruction(const CheckBounds       &check_bounds);
 
 		bool is_ignore()             const;
 		bool is_custom()             const;
@@ -1239,6 +1481,8 @@ public:
 		bool is_return()             const;
 		bool is_branch_zero()        const;
 		bool is_branch_nonnegative() const;
+		bool is_select()             const;
+		bool is_check_bounds()       const;
 
 		// | The tags must be correct, or else an exception will be thrown, including for set_*.
 		const Ignore            &get_ignore()             const;
@@ -1261,6 +1505,8 @@ public:
 		const Return            &get_return()             const;
 		const BranchZero        &get_branch_zero()        const;
 		const BranchNonnegative &get_branch_nonnegative() const;
+		const Select            &get_select()             const;
+		const CheckBounds       &get_check_bounds()       const;
 
 		Ignore            &&get_ignore();
 		Custom            &&get_custom();
@@ -1282,6 +1528,8 @@ public:
 		Return            &&get_return();
 		BranchZero        &&get_branch_zero();
 		BranchNonnegative &&get_branch_nonnegative();
+		Select            &&get_select();
+		CheckBounds       &&get_check_bounds();
 
 		Ignore            &get_ignore_mutable();
 		Custom            &get_custom_mutable();
@@ -1303,6 +1551,8 @@ public:
 		Return            &get_return_mutable();
 		BranchZero        &get_branch_zero_mutable();
 		BranchNonnegative &get_branch_nonnegative_mutable();
+		Select            &get_select_mutable();
+		CheckBounds       &get_check_bounds_mutable();
 
 		// | Return "ignore", "custom", "syscall", "add_sp", "load_immediate", "less_than_from", "load_from", or "nor_from", etc.
 		static std::string get_tag_repr(tag_t tag);
@@ -1313,7 +1563,7 @@ public:
 		std::vector<uint32_t> get_output_sizes() const;
 		std::vector<uint32_t> get_all_sizes() const;
 
-		std::vector<Output::Line> emit(const std::vector<Storage> &storages) const;
+		std::vector<Output::Line> emit(const std::vector<Storage> &storages, architecture_t architecture) const;
 	};
 
 	class MIPSIO {
@@ -1324,6 +1574,9 @@ public:
 		using IOIndex = std::vector<uint32_t>::size_type;
 		// | Reference to an instruction and one of its inputs or outputs, depending on the context.
 		using IO = std::pair<Index, Index>;
+		// | The order prepare emits instructions in, with the working storage
+		// units each one reads or claims.
+		using Schedule = std::vector<std::pair<Index, std::set<Storage::Index>>>;
 
 		// | Vertices.
 		//
@@ -1349,7 +1602,7 @@ public:
 		// | In order to emit these MIPSIO instructions that write these outputs, how many working storages are needed?
 		std::vector<uint32_t> prepare(const std::set<IO>          &capture_outputs, std::optional<Index> back = std::optional<Index>()) const;
 		std::vector<uint32_t> prepare(const std::map<IO, Storage> &capture_outputs, std::optional<Index> back = std::optional<Index>()) const;
-		std::pair<std::vector<uint32_t>, std::vector<uint64_t>> prepare_permutation(const std::set<IO>          &capture_outputs, std::optional<Index> back = std::optional<Index>()) const;
+		std::pair<std::vector<uint32_t>, std::vector<uint64_t>> prepare_permutation(const std::set<IO>          &capture_outputs, std::optional<Index> back = std::optional<Index>(), Schedule *schedule = nullptr) const;
 		std::pair<std::vector<uint32_t>, std::vector<uint64_t>> prepare_permutation(const std::map<IO, Storage> &capture_outputs, std::optional<Index> back = std::optional<Index>()) const;
 		// | Emit the collections of instructions using the provided storages.
 		//
@@ -1360,7 +1613,33 @@ public:
 		// Uncaptured outputs should be consumed with another connection.  If
 		// it is unused, use the Ignore instruction to consume it.  To disable
 		// this restriction, pass permit_uncaptured_outputs = true.
-		std::vector<Output::Line> emit(const std::map<IO, Storage> &input_storages, const std::vector<Storage> &working_storages, const std::map<IO, Storage> &capture_outputs, bool permit_uncaptured_outputs = false, std::optional<Index> back = std::optional<Index>()) const;
+		std::vector<Output::Line> emit(const std::map<IO, Storage> &input_storages, const std::vector<Storage> &working_storages, const std::map<IO, Storage> &capture_outputs, bool permit_uncaptured_outputs = false, std::optional<Index> back = std::optional<Index>(), architecture_t architecture = default_architecture) const;
+		// | For each instruction whose connected inputs are cheaper to emit in
+		// another order, the working storage units its subtree needs in the
+		// original order, and the cheaper order.
+		//
+		// Each node is labeled with its Sethi-Ullman (Ershov) number, the
+		// number of working storage units needed to evaluate its subtree, so
+		// that the heavier operand is emitted first and the lighter operand's
+		// result is held for a shorter span.  Only inputs whose subtrees are
+		// pure (no labels, stores, calls, or other side effects) are
+		// reordered; otherwise the inputs are emitted left to right.
+		std::map<Index, std::pair<uint64_t, std::vector<IOIndex>>> get_input_emission_orders() const;
+		// | Can this instruction be freely reordered relative to its siblings?
+		bool is_reorderable_instruction(Index index) const;
+		// | The range of each instruction's first output, from the constants
+		// and operations that produce it.  Inputs provided by storage units
+		// may hold any value.
+		//
+		// Word values that fit in a byte still get word loads, stores and
+		// working storage: lb and sb cost the same as lw and sw, and byte
+		// spill slots would only save padding in a frame that is rounded to
+		// 8 bytes anyway.
+		std::vector<ValueRange> get_value_ranges() const;
+
+		// | Move the "$sp"-relative frame slots at the keys of "offsets" (as
+		// allocated, before any "$sp" adjustment) to the mapped offsets.
+		void remap_stack_slots(const std::map<int32_t, int32_t> &offsets);
 
 		// | Apply a selection of optimizations, e.g. a linear chain of
 		// LoadFrom(a, b) and LoadFrom(b, c), where a, b, and c are dynamic,
@@ -1432,6 +1711,11 @@ public:
 
 		// | Used by optimize for emit.
 		uint64_t num_deleted = 0;
+
+		// | How many working storage units can be registers.  prepare and
+		// emit only reorder an instruction's inputs when keeping their
+		// original order could exceed this.
+		uint64_t register_budget = 0;
 	};
 
 	// | Accumulated state before merging.
@@ -1448,6 +1732,85 @@ public:
 
 		// | The total stack argument size for the current routine block.
 		int32_t last_stack_argument_total_size = 0;
+
+		// | Appended to the labels of the statements being analyzed, so that
+		// each copy of an unrolled loop body gets its own labels.
+		std::string label_suffix;
+
+		// | The routine being analyzed and the names of its parameters, so
+		// that a recursive call can tell when it passes a parameter along
+		// unchanged.
+		Symbol routine_location;
+		std::vector<std::string> parameter_identifiers;
+
+		// | The local variables and value parameters: only assignments in the
+		// routine itself can change them.
+		std::set<std::string> local_identifiers;
+
+		// | The frame slot reserved for the result of each call to a readonly
+		// function that may be computed once and reused, by get_call_key, and
+		// the calls whose result the slot currently holds.
+		std::map<std::string, Storage> call_result_storages;
+		std::set<std::string>          cached_calls;
+
+		// | Local records replaced by a variable per field, by record and
+		// field identifier.
+		std::map<std::string, std::map<std::string, IdentifierScope::IdentifierBinding::Var>> scalar_records;
+
+		// | The iterators of the enclosing for loops that their bodies don't
+		// change, and the values they take.
+		std::map<std::string, ValueRange> iterator_ranges;
+
+		// | With bounds_check, the ranges that earlier checks of an index
+		// variable showed it to be in, while no statement changes it since.
+		// Checks in the statement being analyzed are pending until its
+		// code is known to run before what follows.
+		std::map<std::string, ValueRange> checked_ranges;
+		std::map<std::string, ValueRange> pending_checked_ranges;
+		// | The lexemes of the statement being analyzed, if known.
+		std::optional<std::pair<uint64_t, uint64_t>> statement_lexemes;
+	};
+
+	// | A copy of a routine that has some of its value parameters replaced
+	// by constants, so that they can be folded into its body.
+	class RoutineSpecialization {
+	public:
+		RoutineSpecialization();
+		RoutineSpecialization(const Symbol &location, const std::vector<std::optional<ConstantValue>> &arguments, const std::string &label_suffix = "");
+
+		// | The label of the copy.  This is the routine's own label if every
+		// call site passes the constants.
+		Symbol location;
+		// | For each parameter, the constant it is replaced by, if any.
+		std::vector<std::optional<ConstantValue>> arguments;
+		// | Appended to the labels in the copy to keep them unique.
+		std::string label_suffix;
+
+		// | Can a call with these arguments use this copy?
+		bool matches(const std::vector<ConstantValue> &call_arguments) const;
+		// | How many parameters are replaced by constants?
+		uint64_t count_constants() const;
+	};
+
+	// | The results of a memoized function, indexed by its arguments, each
+	// of which must be less than its extent, as unsigned.  Only arguments
+	// that are in range are looked up; others just call the body.
+	class MemoTable {
+	public:
+		MemoTable();
+		MemoTable(const Symbol &body_location, const Symbol &values_symbol, const Symbol &valid_symbol, const std::vector<uint32_t> &extents, bool is_word);
+
+		// | The label of the function's own body, which the function's label
+		// now guards.
+		Symbol body_location;
+		// | The results, and whether each has been computed yet.
+		Symbol values_symbol;
+		Symbol valid_symbol;
+		// | For each parameter, a power of 2.
+		std::vector<uint32_t> extents;
+		bool is_word = true;
+
+		uint32_t get_num_entries() const;
 	};
 
 // TODO: inline support.
@@ -1484,10 +1847,11 @@ public:
 		uint64_t                lexeme_end   = 0;
 		bool                    is_mutable   = true;  // Does it not refer to a constant?
 		ConstantValue           constant_value;       // If !is_mutable, this is the constant value.
+		int32_t                 lvalue_dereference_offset = 0;  // Ignored if is_lvalue_fixed_storage.  If fold_dereference_offset was requested, add this to the address at lvalue_index when dereferencing it.
 
 		MIPSIO::Index merge_expression(const Expression &other);
 	};
-	LvalueSourceAnalysis analyze_lvalue_source(const Lvalue &lvalue, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, const IdentifierScope &var_scope, const IdentifierScope &combined_scope, const IdentifierScope &storage_scope, RoutineBlockState &routine_block_state, bool require_mutable = true);
+	LvalueSourceAnalysis analyze_lvalue_source(const Lvalue &lvalue, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, const IdentifierScope &var_scope, const IdentifierScope &combined_scope, const IdentifierScope &storage_scope, RoutineBlockState &routine_block_state, bool require_mutable = true, bool fold_dereference_offset = false);
 
 	class Block;
 	class Expression {
@@ -1511,6 +1875,9 @@ public:
 		MIPSIO::Index merge_block(const Block &other, MIPSIO::Index other_output_index = 0);
 		MIPSIO::Index merge_lvalue_source_analysis(const LvalueSourceAnalysis &other);
 
+		// | The range of the output value.
+		ValueRange get_value_range() const;
+
 // TODO: inline support.
 #if 0
 		Expression();  // (No instructions; null type.)
@@ -1601,6 +1968,264 @@ public:
 		MIPSIO::Index merge_lvalue_source_analysis(const LvalueSourceAnalysis &other);
 	};
 
+	// | An emitted instruction in structured form: an opcode and up to 4
+	// operands, with registers and immediates as numbers and symbols as
+	// indices into the MachineCode holding it, so that passes can inspect and
+	// rewrite instructions without parsing and formatting text.
+	class MachineInstruction {
+	public:
+		enum opcode_e {
+			null_opcode    = 0,
+			// | A label, whose symbol is the first operand.
+			label_opcode   = 1,
+			// | Any other line, e.g. a directive, kept verbatim; the
+			// first operand's immediate indexes MachineCode::lines.
+			line_opcode    = 2,
+			// | A blank or comment line, kept verbatim the same way.
+			comment_opcode = 3,
+			add_opcode     = 4,
+			addu_opcode    = 5,
+			addi_opcode    = 6,
+			addiu_opcode   = 7,
+			sub_opcode     = 8,
+			subu_opcode    = 9,
+			and_opcode     = 10,
+			andi_opcode    = 11,
+			or_opcode      = 12,
+			ori_opcode     = 13,
+			xor_opcode     = 14,
+			xori_opcode    = 15,
+			nor_opcode     = 16,
+			slt_opcode     = 17,
+			sltu_opcode    = 18,
+			slti_opcode    = 19,
+			sltiu_opcode   = 20,
+			sll_opcode     = 21,
+			srl_opcode     = 22,
+			sra_opcode     = 23,
+			sllv_opcode    = 24,
+			srlv_opcode    = 25,
+			srav_opcode    = 26,
+			lui_opcode     = 27,
+			li_opcode      = 28,
+			la_opcode      = 29,
+			move_opcode    = 30,
+			lw_opcode      = 31,
+			lh_opcode      = 32,
+			lhu_opcode     = 33,
+			lb_opcode      = 34,
+			lbu_opcode     = 35,
+			sw_opcode      = 36,
+			sh_opcode      = 37,
+			sb_opcode      = 38,
+			mult_opcode    = 39,
+			multu_opcode   = 40,
+			div_opcode     = 41,
+			divu_opcode    = 42,
+			mfhi_opcode    = 43,
+			mflo_opcode    = 44,
+			mthi_opcode    = 45,
+			mtlo_opcode    = 46,
+			mul_opcode     = 47,
+			movn_opcode    = 48,
+			movz_opcode    = 49,
+			seb_opcode     = 50,
+			seh_opcode     = 51,
+			ins_opcode     = 52,
+			j_opcode       = 53,
+			jal_opcode     = 54,
+			jr_opcode      = 55,
+			jalr_opcode    = 56,
+			b_opcode       = 57,
+			beq_opcode     = 58,
+			bne_opcode     = 59,
+			beqz_opcode    = 60,
+			bnez_opcode    = 61,
+			bgez_opcode    = 62,
+			bgtz_opcode    = 63,
+			blez_opcode    = 64,
+			bltz_opcode    = 65,
+			blt_opcode     = 66,
+			bge_opcode     = 67,
+			bgt_opcode     = 68,
+			ble_opcode     = 69,
+			syscall_opcode = 70,
+			nop_opcode     = 71,
+			tgeu_opcode    = 72,
+			tgeiu_opcode   = 73,
+			num_opcodes    = 73,
+		};
+		typedef enum opcode_e opcode_t;
+
+		// | General-purpose registers by number, and hi and lo.
+		enum register_id_e {
+			zero_register = 0,
+			at_register   = 1,
+			v0_register   = 2,
+			v1_register   = 3,
+			a0_register   = 4,
+			a1_register   = 5,
+			a2_register   = 6,
+			a3_register   = 7,
+			t0_register   = 8,
+			t1_register   = 9,
+			t2_register   = 10,
+			t3_register   = 11,
+			t4_register   = 12,
+			t5_register   = 13,
+			t6_register   = 14,
+			t7_register   = 15,
+			s0_register   = 16,
+			s1_register   = 17,
+			s2_register   = 18,
+			s3_register   = 19,
+			s4_register   = 20,
+			s5_register   = 21,
+			s6_register   = 22,
+			s7_register   = 23,
+			t8_register   = 24,
+			t9_register   = 25,
+			k0_register   = 26,
+			k1_register   = 27,
+			gp_register   = 28,
+			sp_register   = 29,
+			fp_register   = 30,
+			ra_register   = 31,
+			hi_register   = 32,
+			lo_register   = 33,
+			num_registers = 34,
+		};
+		typedef enum register_id_e register_id_t;
+
+		// | Bitmasks of registers, one bit per register_id_t.
+		typedef uint64_t RegisterSet;
+		static const RegisterSet all_registers;
+
+		static const std::vector<std::string> mnemonics;
+		static const std::vector<std::string> register_names;
+		static const std::map<std::string, opcode_t>   opcodes_by_mnemonic;
+		static const std::map<std::string, register_id_t> registers_by_name;
+
+		class Operand {
+		public:
+			enum kind_e {
+				null_kind      = 0,
+				register_kind  = 1,
+				immediate_kind = 2,
+				symbol_kind    = 3,
+				// | "offset($register)".
+				memory_kind    = 4,
+				num_kinds      = 4,
+			};
+			typedef enum kind_e kind_t;
+
+			Operand();
+			Operand(kind_t kind, register_id_t register_ = zero_register, int32_t immediate = 0, uint32_t symbol = 0);
+			static Operand make_register(register_id_t register_);
+			static Operand make_immediate(int32_t immediate);
+			static Operand make_symbol(uint32_t symbol);
+			static Operand make_memory(register_id_t register_, int32_t offset);
+
+			kind_t     kind      = null_kind;
+			// | The register, or the base of a memory operand.
+			register_id_t register_ = zero_register;
+			// | The immediate, or the offset of a memory operand.
+			int32_t    immediate = 0;
+			uint32_t   symbol    = 0;
+
+			// | In peephole patterns only: the variable this operand binds, if
+			// nonzero (for memory operands, its base), the one to add to it, and
+			// whether to negate it.
+			uint8_t    variable    = 0;
+			uint8_t    variable2   = 0;
+			bool       is_negated  = false;
+
+			bool operator==(const Operand &other) const;
+			bool operator!=(const Operand &other) const;
+		};
+
+		MachineInstruction();
+		MachineInstruction(opcode_t opcode, const std::vector<Operand> &operands = {});
+
+		opcode_t     opcode = null_opcode;
+		uint8_t      num_operands = 0;
+		Operand      operands[4];
+
+		bool operator==(const MachineInstruction &other) const;
+		bool operator!=(const MachineInstruction &other) const;
+
+		bool is_instruction() const;
+		uint32_t get_load_size() const;
+		uint32_t get_store_size() const;
+		bool is_conditional_branch() const;
+		// | Branches and jumps other than calls.
+		bool is_jump() const;
+		bool is_call() const;
+		// | Conditional traps, which bounds checks use.  Passes that move
+		// instructions keep them in place.
+		bool is_trap() const;
+		// | Does control flow other than to the next instruction, or is it not
+		// an instruction?
+		bool ends_block() const;
+		// | The general-purpose register written, if any, other than by a call.
+		std::optional<register_id_t> get_destination() const;
+		// | All registers an instruction might read or write, including hi, lo,
+		// and those calls and syscalls pass.  Returning reads everything
+		// but temporaries.
+		RegisterSet get_uses() const;
+		RegisterSet get_definitions() const;
+		// | Registers that appear as operands, other than $zero.
+		RegisterSet get_mentioned_registers() const;
+	};
+
+	// | A routine's emitted code as MachineInstructions.
+	//
+	// The Instruction classes still emit Output::Lines, which analyze_block
+	// parses once, as MIPSIO::emit returns them; every later pass works on
+	// the MachineCode of a routine, and it is rendered back to lines only
+	// when it is added to the output.
+	class MachineCode {
+	public:
+		MachineCode();
+		// | Lines that aren't a label or an instruction whose operands are all
+		// registers, integers, symbols, and "offset($register)" are kept as
+		// line_opcode instructions.
+		explicit MachineCode(const std::vector<Output::Line> &lines);
+
+		std::vector<MachineInstruction> instructions;
+		std::vector<Symbol>             symbols;
+		std::vector<Output::Line>       lines;
+
+		uint32_t add_symbol(const Symbol &symbol);
+		// | Has the symbol been added, e.g. to make a new label unique?
+		bool has_symbol(const Symbol &symbol) const;
+		// | Parse a line and add it after these instructions.
+		void add_line(const Output::Line &line);
+		// | Add another routine's instructions after these.
+		void append(const MachineCode &other);
+		// | Drop null_opcode instructions, which passes leave in place of the
+		// ones they remove.
+		void remove_null_instructions();
+
+		// | Format an instruction the way Instruction::emit does, e.g.
+		// "\tlw    $t0, 4($gp)".
+		Output::Line render(const MachineInstruction &instruction) const;
+		// | Render every instruction, leaving out null_opcode ones.
+		std::vector<Output::Line> render() const;
+
+		// | How many instructions, as opposed to labels, directives, and
+		// comments, are there?
+		uint64_t get_num_instructions() const;
+		// | The index of each label, by symbol.
+		std::map<uint32_t, std::vector<MachineInstruction>::size_type> get_label_indices() const;
+		// | Which registers each instruction's successors might read, given
+		// that code past the end, or at labels defined elsewhere, reads any.
+		std::vector<MachineInstruction::RegisterSet> get_live_registers() const;
+
+	protected:
+		std::map<Symbol, uint32_t> symbol_indices;
+	};
+
 	// | Analyze a call and return a block that performs a call.  If the
 	// function returns a value, return the index to the instruction that
 	// retrieves the output too; otherwise, the second value is empty.
@@ -1617,13 +2242,370 @@ public:
 	Block analyze_statements(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<uint64_t> &statements, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, const IdentifierScope &var_scope, const IdentifierScope &combined_scope, const IdentifierScope &storage_scope, const Symbol &cleanup_symbol, RoutineBlockState &routine_block_state);
 	Block analyze_statements(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const StatementSequence &statement_sequence, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, const IdentifierScope &var_scope, const IdentifierScope &combined_scope, const IdentifierScope &storage_scope, const Symbol &cleanup_symbol, RoutineBlockState &routine_block_state);
 
+	// | Could the statements between these lexemes change the value of the
+	// variable named by "identifier"?
+	//
+	// This is a conservative check of the source rather than of the analyzed
+	// code: assignments to the variable or its elements, nested "for" loops
+	// and "read" on the variable count, as does passing the variable or an
+	// element of it by itself as an argument to a routine that takes it by
+	// reference.  If "check_calls" is true, as for globals and ref
+	// parameters, any call to a routine that isn't readonly counts as well.
+	bool may_modify_variable(uint64_t lexeme_begin, uint64_t lexeme_end, const std::string &identifier, bool check_calls, const IdentifierScope &routine_scope) const;
+
+	// | Could the statements between these lexemes change the global or ref
+	// parameter named by "identifier" through another name for it?
+	//
+	// Within a routine that takes ref parameters, a ref parameter may refer
+	// to a global or to what another ref parameter refers to, so a store to
+	// any global or ref parameter, as may_modify_variable sees it, counts.
+	bool may_modify_variable_alias(uint64_t lexeme_begin, uint64_t lexeme_end, const std::string &identifier, const IdentifierScope &routine_scope, const RoutineBlockState &routine_block_state) const;
+
+	// | Would replacing the variable named by "identifier" with a constant
+	// let some code between these lexemes fold?
+	//
+	// Also a check of the source: the variable must be a whole "if",
+	// "elseif" or "while" condition or "for" bound, or an operand of an
+	// arithmetic or comparison operator whose other operand is a literal.
+	bool may_fold_variable(uint64_t lexeme_begin, uint64_t lexeme_end, const std::string &identifier) const;
+
+	// | If the routine only reads its value parameters, its locals and
+	// globals, and calls only readonly routines (or itself), return the
+	// globals that it and its callees may read; otherwise return nothing.
+	//
+	// A readonly routine has no ref parameters and performs no I/O and no
+	// assignments to globals.
+	std::optional<std::set<std::string>> get_routine_global_reads(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const Body &body, const IdentifierScope &var_scope, const IdentifierScope &routine_scope) const;
+
+	// | Is the identifier at this lexeme a call of a readonly function with
+	// a primitive result?
+	bool is_readonly_call(uint64_t identifier_lexeme, const IdentifierScope &routine_scope) const;
+
+	// | The source of the call beginning with the identifier at this
+	// lexeme, without whitespace and comments, and the lexeme after it.
+	std::pair<std::string, uint64_t> get_call_key(uint64_t identifier_lexeme) const;
+
+	// | Call the readonly functions in the "head" of a statement, the part
+	// that always runs first, e.g. an "if" condition, whose results can be
+	// reused elsewhere in the statement: calls that appear more than once,
+	// or in a "while" condition, which runs every iteration.  The results
+	// are stored in the slots reserved for them, and analyze_expression
+	// loads them instead of calling again until the statement is done.
+	//
+	// Only calls whose arguments are unchanged everywhere in the statement
+	// are cached.  Return the calls cached.
+	std::vector<std::string> cache_readonly_calls(Block &block, uint64_t head_begin, uint64_t head_end, uint64_t statement_begin, uint64_t statement_end, bool is_loop, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, const IdentifierScope &var_scope, const IdentifierScope &combined_scope, const IdentifierScope &storage_scope, RoutineBlockState &routine_block_state);
+
+	// | With auto_memoize, if the function is readonly, reads no globals,
+	// calls itself, and has 1 or 2 value parameters of type integer, char,
+	// or boolean, plan a table for its results.
+	std::optional<MemoTable> get_memo_table(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const Body &body, const std::string &identifier) const;
+
+	// | The function's entry: look its arguments up in the table, or else
+	// call its body and record the result.
+	std::vector<Output::Line> get_memo_lines(const MemoTable &memo_table, uint64_t num_parameters) const;
+
+	// | Can this local record be replaced by a variable per field?  Only if
+	// every use of it in the block accesses a primitive field: it is never
+	// copied or passed as a whole.
+	bool may_scalarize_record(uint64_t lexeme_begin, uint64_t lexeme_end, const std::string &identifier, const Type::Record &record) const;
+
+	// | Should the fields of a scalarized record get registers?  Only if it
+	// is used in a loop, and no field is passed as an argument, which might
+	// be by reference and would then need a copy on the stack.
+	bool may_keep_record_fields_in_registers(uint64_t lexeme_begin, uint64_t lexeme_end, const std::string &identifier) const;
+
+	// | If the statement sequence is a single assignment, possibly followed by
+	// empty statements, return it; otherwise return nullptr.
+	const Assignment *get_single_assignment(const StatementSequence &statement_sequence) const;
+
+	// | Can the expression between these lexemes be evaluated even when its
+	// value isn't used?  It must not call a routine, index an array, which
+	// may be out of bounds, or divide, which may be by zero.
+	bool is_speculatable_expression(uint64_t lexeme_begin, uint64_t lexeme_end, const IdentifierScope &routine_scope) const;
+
 	// | Analyze a BEGIN [statement]... END block.
-	std::vector<Output::Line> analyze_block(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const ::Block &block, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, IdentifierScope &var_scope, IdentifierScope &combined_scope, IdentifierScope &storage_scope, const std::map<std::string, TypeIndex> &local_variables = {}, bool is_main = false);
+	MachineCode analyze_block(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const ::Block &block, const IdentifierScope &constant_scope, const IdentifierScope &type_scope, const IdentifierScope &routine_scope, IdentifierScope &var_scope, IdentifierScope &combined_scope, IdentifierScope &storage_scope, const std::map<std::string, TypeIndex> &local_variables = {}, bool is_main = false, const RoutineSpecialization &specialization = RoutineSpecialization());
 
 	// | Analyze a routine definition.
 	//
 	// "analyze_block" but look for additional types, constants, and variables.
-	std::vector<Output::Line> analyze_routine(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const Body &body, IdentifierScope &constant_scope, IdentifierScope &type_scope, const IdentifierScope &routine_scope, IdentifierScope &var_scope, IdentifierScope &combined_scope, IdentifierScope &storage_scope);
+	MachineCode analyze_routine(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const Body &body, IdentifierScope &constant_scope, IdentifierScope &type_scope, const IdentifierScope &routine_scope, IdentifierScope &var_scope, IdentifierScope &combined_scope, IdentifierScope &storage_scope, const RoutineSpecialization &specialization = RoutineSpecialization());
+
+	// | Which copies of a routine to emit: the routine itself, with any
+	// parameter that every call site passes the same constant for replaced
+	// by it, followed by copies specialized for the hottest combinations of
+	// constant arguments.
+	//
+	// While call sites are being collected, this instead records which
+	// parameters could be replaced, and returns just the routine itself.
+	std::vector<RoutineSpecialization> get_routine_specializations(const IdentifierScope::IdentifierBinding::RoutineDeclaration &routine_declaration, const std::vector<std::string> &parameter_identifiers, const Body &body, const IdentifierScope &var_scope, const IdentifierScope &routine_scope);
+
+	// | Decide, from the call sites collected, how to specialize each routine.
+	void plan_routine_specializations();
+
+	// | For each lexeme, how many loops it is nested in.
+	std::vector<uint64_t> get_lexeme_loop_depths() const;
+
+	// | For each lexeme, about how often it runs: 8 per enclosing loop.
+	std::vector<uint64_t> get_lexeme_loop_weights() const;
+
+	// | For each lexeme, how often the block it starts in ran according to
+	// the profile, or nothing if none of the profile's blocks were found.
+	std::vector<uint64_t> get_lexeme_profile_weights() const;
+
+	// | An ID for each block of a routine's emitted code, by the index of the
+	// line it starts after.  A label starts a block named for the label,
+	// before it is made unique, and which of the labels with that name in
+	// the routine it is, in source order; unlike the final label, this
+	// doesn't change when code elsewhere does.  The code a conditional
+	// branch falls through to is numbered after that, e.g. "endif_x#2+1".
+	static std::map<std::vector<MachineInstruction>::size_type, std::string> get_profile_block_ids(const MachineCode &code);
+
+	// | Record where each block of a routine starts in the source, and, with
+	// profile_generate, count in the profile table each time the routine is
+	// entered and each time a block starts.
+	void count_profile_blocks(const Symbol &routine_symbol, uint64_t entry_lexeme, MachineCode &code, std::vector<Output::Line> &table_lines);
+
+	// | A routine that prints each counter in the profile table, for the
+	// exits of a program compiled with profile_generate to call.
+	static std::vector<Output::Line> get_profile_dump_lines();
+
+	// | Order the blocks of a routine's emitted code so that control usually
+	// falls through: chain each block to the successor it most often
+	// continues with, inverting or adding branches as needed, and move the
+	// blocks that never run to the end.  block_counts, by the IDs of
+	// get_profile_block_ids, say how often each block runs; without them, a
+	// block is taken not to run if it is only reached on the way to a stop
+	// from code that could otherwise return.  Only forward edges are
+	// chained, so that loops stay rotated.
+	//
+	// hot_symbols gets the symbols that the blocks that run refer to, e.g.
+	// the routines they call.
+	static void layout_emitted_blocks(MachineCode &code, const std::map<std::string, uint64_t> &block_counts, std::set<Symbol> &hot_symbols);
+
+	// | Run analyze_program, once to collect call sites and plan routine
+	// specializations when optimizing for speed, and then for the output.
+	void analyze_program_specialized();
+
+	// | Analyze the program once; see analyze().
+	void analyze_program();
+
+	// | A memory operand of an emitted load or store, classified by what it
+	// can refer to, for alias analysis of emitted code.
+	class MemoryLocation {
+	public:
+		enum kind_e {
+			unknown_kind      = 0,  // Anything.
+			local_kind        = 1,  // $sp-relative: a local, spill slot, or argument.
+			small_global_kind = 2,  // $gp-relative: a global in the small-data section.
+			global_kind       = 3,  // Relative to a global label.
+			pointer_kind      = 4,  // Relative to any other register, e.g. a ref parameter.
+			num_kinds         = 4,
+		};
+		typedef enum kind_e kind_t;
+
+		MemoryLocation();
+		MemoryLocation(kind_t kind, const MachineInstruction::Operand &base, int32_t offset, uint32_t size, bool is_exact = true);
+
+		kind_t                      kind = unknown_kind;
+		// | $sp, $gp, the label's symbol, or the pointer register.
+		MachineInstruction::Operand base;
+		int32_t                     offset = 0;
+		uint32_t                    size   = 0;
+		// | If false, the access is somewhere within offset and size, e.g. an
+		// array element with a computed index.
+		bool                        is_exact = true;
+
+		// | The same object, but anywhere within it.
+		MemoryLocation get_inexact(const std::map<int32_t, uint32_t> &small_data_objects) const;
+
+		// | Could accesses to this location and "other" touch the same bytes?
+		//
+		// Pointers can only refer to locals if the address of a local has
+		// been taken, which is what locals_escape indicates.
+		bool may_alias(const MemoryLocation &other, bool locals_escape) const;
+		// | Does this location certainly contain every byte of "other"?
+		bool covers(const MemoryLocation &other) const;
+		// | Are both exactly the same bytes?
+		bool is_same(const MemoryLocation &other) const;
+	};
+
+	// | Split an emitted line into its mnemonic and operands.  Symbols are
+	// expanded to unique placeholders, recorded in symbol_placeholders, so
+	// that operands referring to them can be compared.
+	//
+	// Comments and blank lines are empty; labels are {":", label}, and
+	// directives {"."}.
+	static std::vector<std::string> parse_emitted_line(const Output::Line &line, std::map<std::string, Symbol> &symbol_placeholders);
+	// | Classify the memory operand of a load or store.  "addresses" holds
+	// registers known to contain addresses.
+	static MemoryLocation get_memory_location(const MachineInstruction::Operand &operand, uint32_t size, const std::map<MachineInstruction::register_id_t, MemoryLocation> &addresses);
+	// | If the instruction computes an address from a known one, e.g.
+	// "la $t0, 8($gp)", return it.
+	static std::optional<MemoryLocation> get_computed_address(const MachineInstruction &instruction, const std::map<MachineInstruction::register_id_t, MemoryLocation> &addresses, const std::map<int32_t, uint32_t> &small_data_objects);
+	// | Is $sp read other than as the base of a load or store or to adjust
+	// $sp itself, i.e. could a pointer refer to a local?
+	static bool emitted_locals_escape(const MachineCode &code);
+
+	// | Within each basic block of emitted code, remove loads of values
+	// already in a register and stores that are overwritten before anything
+	// could read them, using MemoryLocation to tell which accesses may alias.
+	static void eliminate_redundant_memory_accesses(MachineCode &code, const std::map<int32_t, uint32_t> &small_data_objects);
+
+	// | Within each basic block, read registers copied with "la $d, ($r)"
+	// from the original register instead, and then remove copies and other
+	// side-effect-free instructions whose results are never read.
+	static void propagate_emitted_copies(MachineCode &code);
+
+	// | Registers that emitted code otherwise leaves alone, available to
+	// hold a promoted scalar while a loop without calls runs.
+	static const std::vector<MachineInstruction::register_id_t> promotion_registers;
+	// | Keep globals and ref parameters that a loop without calls accesses in
+	// registers for the whole loop: load each in front of the loop and store
+	// it back on every exit, including returns and stops.
+	//
+	// Loops are promoted innermost first, or, if lexeme_weights are given,
+	// those whose header labels weigh most first.
+	static void promote_loop_scalars(MachineCode &code, const std::map<int32_t, uint32_t> &small_data_objects, const std::vector<uint64_t> &lexeme_weights = {});
+
+	// | What straight-line emitted code is known to have computed: the value
+	// each register holds, numbered so that equal numbers are equal values,
+	// and which values a branch has shown to be zero or nonzero.
+	class EmittedValues {
+	public:
+		std::map<MachineInstruction::register_id_t, uint64_t> registers;
+		// | Value numbers of computations, e.g. "slt v3 v7", and of loads,
+		// which start with "@" so that stores can forget them.
+		std::map<std::string, uint64_t>                        computations;
+		std::map<uint64_t, bool>                               is_nonzero;
+	};
+	// | Clean up the control flow of emitted code, such as the chains of
+	// branches and jumps if-elseif ladders lower to: thread branches and
+	// jumps to a jump through to its destination, remove jumps to the next
+	// instruction and code nothing reaches, resolve conditional branches
+	// that an earlier test of the same value already decided, and merge the
+	// identical tails of blocks that end by jumping to the same label.
+	static void thread_emitted_jumps(MachineCode &code);
+
+	// | A peephole rewrite of emitted instructions.
+	//
+	// Each operand of the pattern may contain one variable: "%r1" matches a
+	// register, "%i1" an integer, and "%o1" any operand, and a variable must
+	// match the same operand everywhere it appears.  The replacement may also
+	// compute "-%i1" and "%i1+%i2".  Rules are written as text and compiled
+	// to MachineInstructions once.
+	class PeepholeRule {
+	public:
+		PeepholeRule();
+		PeepholeRule(const std::vector<std::vector<std::string>> &pattern, const std::vector<std::vector<std::string>> &replacement);
+
+		// | One or two instructions.  Between two, there may be others that
+		// neither access the registers the first mentions nor, if the pattern
+		// accesses memory, memory.
+		std::vector<std::vector<std::string>> pattern;
+		// | What the matched instructions become.  Shorter replacements
+		// remove the first of the matched instructions.
+		std::vector<std::vector<std::string>> replacement;
+	};
+	static const std::vector<PeepholeRule> peephole_rules;
+	// | Apply peephole_rules to emitted code until none match.  Instructions
+	// whose results the rewrites leave unread are left for
+	// propagate_emitted_copies to remove.
+	static void apply_peephole_rules(MachineCode &code);
+
+	// | How many cycles after an instruction issues its result can be read
+	// without a stall, by kind of instruction, on an in-order pipeline.  The
+	// results of mult and div are in hi and lo.
+	class LatencyModel {
+	public:
+		LatencyModel();
+		LatencyModel(uint32_t alu_latency, uint32_t load_latency, uint32_t mult_latency, uint32_t div_latency);
+
+		uint32_t alu_latency  = 1;
+		uint32_t load_latency = 1;
+		uint32_t mult_latency = 1;
+		uint32_t div_latency  = 1;
+
+		uint32_t get_latency(const MachineInstruction &instruction) const;
+	};
+	// | The CPUs --target-cpu can name.
+	static const std::map<std::string, LatencyModel> target_cpus;
+
+	// | Schedule emitted code for this pipeline, or, if empty, leave it in
+	// emission order.
+	void set_target_cpu(const std::optional<LatencyModel> &target_cpu);
+
+	// | Reorder the instructions of each basic block to hide latency, by list
+	// scheduling: repeatedly issue, among the instructions whose
+	// dependencies have issued, one whose operands are ready, preferring the
+	// longest path of latencies to the end of the block.
+	//
+	// Labels, calls, syscalls, branches, and lines that aren't plain
+	// instructions stay where they are, so the side effects that
+	// MIPSIO::sequences orders stay in order.  Memory accesses keep their
+	// order unless they can't overlap: the same base register, unchanged,
+	// with disjoint offsets, or one relative to $sp and the other to $gp.
+	static void schedule_machine_code(MachineCode &code, const LatencyModel &latency_model);
+
+	// | Emit code for a target that runs the instruction after each branch
+	// or jump, in its delay slot, before the branch takes effect.
+	void set_delayed_branches(bool delayed_branches);
+
+	// | Give every branch and jump a delay slot: move there an independent
+	// instruction from before it in its block; failing that, for a
+	// conditional branch, the next instruction if the branch target doesn't
+	// need what it writes; failing that, a copy of the first instruction at
+	// the target, branching past it instead, if that's safe on the other
+	// path; and failing that, a nop.
+	static void fill_delay_slots(MachineCode &code);
+
+	// | Set which instruction set revision to emit code for.
+	void set_architecture(architecture_t architecture);
+
+	// | Replace each routine's "lw $ra, ($sp); addiu $sp, $sp, N; jr $ra"
+	// epilogue with a jump to a stub that does the same, shared by the
+	// routines with the same frame size if that saves instructions.  With
+	// delayed branches, the epilogue is "lw $ra, ($sp); jr $ra; addiu $sp,
+	// $sp, N", and the load moves into the slot of the jump to the stub.
+	// Returns the stubs.
+	static MachineCode share_epilogues(std::vector<MachineCode> &routines, bool delayed_branches);
+
+	// | Move sequences of instructions that repeat, within or between
+	// routines, into subroutines, replacing each occurrence with a call,
+	// where that saves instructions.  Returns the subroutines.
+	//
+	// Repeats are found as the internal nodes of the suffix tree of all the
+	// code, visited as the intervals of a suffix array with the lengths of
+	// the prefixes neighboring suffixes share.  The most profitable are
+	// taken first.  A sequence can't contain labels, branches, calls,
+	// syscalls, traps, or lines that aren't plain instructions, and it can't
+	// mention $ra or run while $ra is live, since the call overwrites it.
+	//
+	// With delayed branches, the code must already have its delay slots
+	// filled: no sequence begins in a slot, the first instruction of a
+	// sequence stays in the slot of its call, and the last one goes in the
+	// slot of the return.
+	static MachineCode outline_machine_code(std::vector<MachineCode> &routines, bool delayed_branches);
+
+	// | Let frame slots whose lifetimes don't overlap share space.
+	//
+	// stack_slot_sizes maps each slot's offset, as allocated, to its size;
+	// working_storage_slots says which working storage units are slots.  A
+	// slot's lifetime runs from its first to its last access in the
+	// emission schedule, widened to cover any loop it overlaps.  Slots in
+	// fixed_stack_slots, or whose address is taken, keep their offsets; the
+	// others are packed around them, reusing slots of the same size.  Returns
+	// the new offset of every moved slot and updates stack_allocated.
+	static std::map<int32_t, int32_t> share_stack_slots(const MIPSIO &instructions, const MIPSIO::Schedule &schedule, const std::map<int32_t, uint32_t> &stack_slot_sizes, const std::set<int32_t> &fixed_stack_slots, const std::map<Storage::Index, int32_t> &working_storage_slots, int32_t push_ra_allocated, int32_t &stack_allocated);
+
+	// | Choose the order in which to emit the globals, given as identifier,
+	// type pairs in declaration order.  Returns indices into "globals".
+	//
+	// When optimizing, globals are grouped by alignment class, aggregates
+	// first and bytes last, so that little padding is needed between them,
+	// and the most referenced globals of each class come first.
+	std::vector<std::vector<std::pair<std::string, TypeIndex>>::size_type> layout_globals(const std::vector<std::pair<std::string, TypeIndex>> &globals, const IdentifierScope &storage_scope) const;
 
 	// | Get the symbol to a string literal, tracking it if this is the first time encountering it.
 	Symbol string_literal_symbol(const std::string &string);
@@ -1665,6 +2647,25 @@ protected:
 	bool auto_analyze = true;
 	// | Whether to apply optimizations.
 	bool optimize = true;
+	// | How many copies of a small "for" loop body to run per check of the
+	// loop condition.
+	uint32_t unroll_factor = CPSL_CC_SEMANTICS_DEFAULT_UNROLL_FACTOR;
+	// | Whether to memoize eligible functions; see get_memo_table.
+	bool auto_memoize = false;
+	// | The pipeline to schedule emitted code for, if any.
+	std::optional<LatencyModel> target_cpu;
+	// | Whether branches and jumps have delay slots.
+	bool delayed_branches = false;
+	// | Which instruction set revision to emit code for.
+	architecture_t architecture = CPSL_CC_SEMANTICS_DEFAULT_ARCHITECTURE;
+	// | Whether to optimize for code size rather than speed.
+	bool optimize_size = false;
+	// | Whether to check array indices at runtime.
+	bool bounds_check = false;
+	// | Whether to count how often each block runs.
+	bool profile_generate = false;
+	// | See set_profile.
+	Profile profile;
 
 	// | Collection of string constants we collect as we analyze the parse tree.
 	//
@@ -1685,6 +2686,61 @@ protected:
 	// | Ordered copy of the Var identifier bindings in top_level_var_scope.
 	std::vector<IdentifierScope::IdentifierBinding::Var> top_level_vars;
 
+	// | Interprocedural constant propagation.
+	//
+	// The program is analyzed twice.  The first time, each call site's
+	// arguments are collected, as constants where they are known, with the
+	// call site's weight; an argument is std::nullopt if a routine passes
+	// its own parameter along to itself unchanged.  Routine specializations
+	// are then planned for the second time.
+	bool collect_call_sites = false;
+	std::map<Symbol, std::vector<std::pair<std::vector<std::optional<ConstantValue>>, uint64_t>>> call_sites;
+	// | Which of each routine's parameters may be replaced by a constant: value
+	// parameters of type integer, char, or boolean that the routine never
+	// modifies.  Routines too large to copy have a second value of false.
+	std::map<Symbol, std::pair<std::vector<bool>, bool>> specializable_parameters;
+	std::map<Symbol, std::vector<RoutineSpecialization>> routine_specializations;
+	// | See get_lexeme_loop_depths.
+	std::vector<uint64_t> lexeme_loop_depths;
+	// | How often each lexeme runs, for weighing call sites and references:
+	// see get_lexeme_loop_weights, or, if profile_guided, the measured
+	// get_lexeme_profile_weights.
+	std::vector<uint64_t> lexeme_weights;
+	bool profile_guided = false;
+	// | Where each block of the last analysis starts in the source, by
+	// routine and block ID: the lexeme of its label, and whether the label
+	// is where the statement it ends continues, after the lexeme's
+	// statement, rather than the start of a body.
+	std::map<std::pair<std::string, std::string>, std::pair<uint64_t, bool>> profile_block_lexemes;
+	// | How many counters the profile table has.
+	uint64_t num_profile_counters = 0;
+
+	// | The readonly routines analyzed so far, and the globals each may
+	// read; see get_routine_global_reads.
+	std::map<Symbol, std::set<std::string>> readonly_routines;
+	// | The memoized functions and their tables, and descriptions of them to
+	// report.
+	std::map<Symbol, MemoTable> memo_tables;
+	std::vector<std::string>    memoized_functions;
+	// | See get_size_report.
+	std::vector<std::string> size_report;
+	// | See get_num_bounds_checks.
+	uint64_t num_bounds_checks = 0;
+
+	// | The label at the beginning of the small-data section.  main loads it
+	// into $gp, and small globals are then accessed as single off($gp) loads
+	// and stores rather than through an "la" of their own label.
+	static const Symbol small_data_symbol;
+	// | The routine that prints the profile table, and the table's bounds.
+	static const Symbol profile_dump_symbol;
+	static const Symbol profile_table_symbol;
+	static const Symbol profile_table_end_symbol;
+	// | How many bytes of the small-data section have been allocated so far.
+	uint32_t small_data_size = 0;
+	// | The offset and size of each variable in the small-data section, so
+	// that an address computed from one is known to stay within it.
+	std::map<int32_t, uint32_t> small_data_objects;
+
 	// The analyzed assembly output.
 	Output output;
 };
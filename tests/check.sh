@@ -0,0 +1,236 @@
+#!/bin/sh
+# Check the code that cpsl-cc emits for the programs in this directory.
+#
+# Usage: tests/check.sh [CPSL_CC]
+#
+# Most checks count or look for instructions and labels in the emitted
+# assembly.  The checks that run programs need a simulator: MIPS_SIM is a
+# command that runs the assembly file it is given, with the program's
+# input on stdin, and exits with a nonzero status if the program traps,
+# e.g. MIPS_SIM='java -jar Mars4_4.jar nc se2 ae1'.  Without it, they are
+# skipped.
+
+set -u
+
+CPSL_CC="${1:-_build/cpsl-cc}"
+MIPS_SIM="${MIPS_SIM:-}"
+TESTS_DIR="$(dirname -- "$0")"
+WORK_DIR="$(mktemp -d)" || exit 1
+trap 'rm -rf -- "$WORK_DIR"' EXIT
+
+checks=0
+failures=0
+skipped=0
+
+fail() {
+	failures=$((failures + 1))
+	printf 'FAIL: %s\n' "$*" >&2
+}
+
+# compile NAME PROGRAM [OPTION]...
+#
+# Compile PROGRAM to NAME.s, with what cpsl-cc printed in NAME.log.
+compile() {
+	name="$1"
+	program="$2"
+	shift 2
+	checks=$((checks + 1))
+	if ! "$CPSL_CC" "$@" -i "$TESTS_DIR/$program" -o "$WORK_DIR/$name.s" >"$WORK_DIR/$name.log" 2>&1; then
+		fail "$name: cpsl-cc $* -i $program failed: $(cat "$WORK_DIR/$name.log")"
+		: >"$WORK_DIR/$name.s"
+	fi
+}
+
+# compile_fails NAME PROGRAM [OPTION]...
+compile_fails() {
+	name="$1"
+	program="$2"
+	shift 2
+	checks=$((checks + 1))
+	if "$CPSL_CC" "$@" -i "$TESTS_DIR/$program" -o "$WORK_DIR/$name.s" >"$WORK_DIR/$name.log" 2>&1; then
+		fail "$name: cpsl-cc $* -i $program succeeded, but should have failed"
+	fi
+}
+
+# run NAME INPUT: run NAME.s with INPUT, with what it printed in NAME.out,
+# and return the simulator's status.
+run() {
+	printf '%s\n' "$2" | $MIPS_SIM "$WORK_DIR/$1.s" >"$WORK_DIR/$1.out" 2>&1
+}
+
+# expect_output NAME INPUT PATTERN: NAME.s runs with INPUT and prints a
+# line matching PATTERN.
+expect_output() {
+	if [ -z "$MIPS_SIM" ]; then
+		skipped=$((skipped + 1))
+		return
+	fi
+	checks=$((checks + 1))
+	if ! run "$1" "$2"; then
+		fail "$1: running with input $2 failed: $(cat "$WORK_DIR/$1.out")"
+	elif ! grep -q -- "$3" "$WORK_DIR/$1.out"; then
+		fail "$1: running with input $2 printed no line matching \`$3': $(cat "$WORK_DIR/$1.out")"
+	fi
+}
+
+# expect_trap NAME INPUT: NAME.s traps when run with INPUT.
+expect_trap() {
+	if [ -z "$MIPS_SIM" ]; then
+		skipped=$((skipped + 1))
+		return
+	fi
+	checks=$((checks + 1))
+	if run "$1" "$2"; then
+		fail "$1: running with input $2 should have trapped: $(cat "$WORK_DIR/$1.out")"
+	fi
+}
+
+# count NAME MNEMONIC: how many MNEMONIC instructions NAME.s has.
+count() {
+	grep -c "^[[:space:]]*$2[[:space:]]" "$WORK_DIR/$1.s"
+}
+
+# size NAME: how many instructions NAME.s has.
+size() {
+	grep -c '^[[:space:]]*[a-z][a-z0-9]*[[:space:]]' "$WORK_DIR/$1.s"
+}
+
+# expect_count NAME MNEMONIC EXPECTED
+expect_count() {
+	checks=$((checks + 1))
+	actual="$(count "$1" "$2")"
+	if [ "$actual" -ne "$3" ]; then
+		fail "$1: expected $3 $2, found $actual"
+	fi
+}
+
+# expect_line NAME PATTERN: NAME.s or NAME.log has a line matching PATTERN.
+expect_line() {
+	checks=$((checks + 1))
+	if ! grep -q -- "$2" "$WORK_DIR/$1.s" "$WORK_DIR/$1.log"; then
+		fail "$1: expected a line matching \`$2'"
+	fi
+}
+
+# expect_no_line NAME PATTERN
+expect_no_line() {
+	checks=$((checks + 1))
+	if grep -q -- "$2" "$WORK_DIR/$1.s" "$WORK_DIR/$1.log"; then
+		fail "$1: expected no line matching \`$2'"
+	fi
+}
+
+# --march: MIPS I multiplies with mult and mflo, and has no movn or ins.
+compile march_mips1 march.cpsl --march mips1 --auto-memoize
+expect_count march_mips1 mult 3
+expect_count march_mips1 mflo 3
+for mnemonic in mul movn movz seb seh ext ins; do
+	expect_count march_mips1 "$mnemonic" 0
+done
+
+# MIPS32 multiplies with mul and selects with movn.
+compile march_mips32 march.cpsl --march mips32 --auto-memoize
+expect_count march_mips32 mul  3
+expect_count march_mips32 mult 0
+expect_count march_mips32 mflo 0
+expect_count march_mips32 movn 1
+expect_count march_mips32 ins  0
+
+# MIPS32r2 also builds memo table indices with ins.
+compile march_mips32r2 march.cpsl --march mips32r2 --auto-memoize
+expect_count march_mips32r2 mul  3
+expect_count march_mips32r2 mult 0
+expect_count march_mips32r2 movn 1
+expect_count march_mips32r2 ins  3
+
+# --auto-memoize: a char and a boolean parameter get their whole ranges.
+compile memo memo.cpsl --verbose --auto-memoize
+expect_line memo 'table of 512 results, for arguments 0 to 255, 0 to 1\.'
+expect_line memo '^memo_h:'
+expect_output memo '' '^183$'
+
+# --target-cpu: scheduling reorders instructions without changing them.
+compile sched_none march.cpsl
+compile sched_r4000 march.cpsl --target-cpu r4000
+sort "$WORK_DIR/sched_none.s"  >"$WORK_DIR/sched_none.sorted"
+sort "$WORK_DIR/sched_r4000.s" >"$WORK_DIR/sched_r4000.sorted"
+checks=$((checks + 1))
+if ! cmp -s "$WORK_DIR/sched_none.sorted" "$WORK_DIR/sched_r4000.sorted"; then
+	fail "sched_r4000: scheduling changed the instructions, not just their order"
+fi
+checks=$((checks + 1))
+if cmp -s "$WORK_DIR/sched_none.s" "$WORK_DIR/sched_r4000.s"; then
+	fail "sched_r4000: nothing was reordered"
+fi
+expect_output sched_r4000 "3
+5" '^3 571$'
+
+# --delayed-branches: every branch and jump is followed by its delay slot.
+compile delayed march.cpsl --delayed-branches
+checks=$((checks + 1))
+unfilled="$(awk '
+	pending && !/^[[:space:]]+[a-z]/ { print previous }
+	{ pending = 0 }
+	/^[[:space:]]+(b[a-z]*|j|jal|jr|jalr)[[:space:]]/ { pending = 1; previous = $0 }
+' "$WORK_DIR/delayed.s")"
+if [ -n "$unfilled" ]; then
+	fail "delayed: branches without a delay slot: $unfilled"
+fi
+
+# -Os: shared epilogues and no unrolling make less code than -O2.
+compile size_o2 size.cpsl
+compile size_os size.cpsl -O s
+expect_line size_os '^restore_frame_[0-9]*:'
+checks=$((checks + 1))
+if [ "$(size size_os)" -ge "$(size size_o2)" ]; then
+	fail "size_os: expected fewer than $(size size_o2) instructions, found $(size size_os)"
+fi
+
+# --bounds-check: the loop's indices are proven in range, and the second
+# access to a[i] reuses the first's check, which traps on indices out of
+# range.
+compile bounds bounds.cpsl --bounds-check
+expect_count bounds tgeiu 1
+expect_output bounds 3 '^6$'
+expect_trap bounds 10
+expect_trap bounds -1
+compile bounds_off bounds.cpsl
+expect_count bounds_off tgeiu 0
+compile_fails bounds_mips1 bounds.cpsl --bounds-check --march mips1
+
+# Stores through a ref parameter may change a global index, so checks of
+# it aren't reused across them, and a[i] traps once q sets i to 10.
+compile bounds_alias bounds_alias.cpsl --bounds-check
+expect_count bounds_alias tgeiu 3
+expect_trap bounds_alias 0
+
+# Each copy of a fully unrolled loop knows its index, so only the copy
+# for i = 10 is checked, and multiplies to find a[i], and that check
+# traps.
+compile bounds_unroll bounds_unroll.cpsl --bounds-check
+expect_count bounds_unroll tgeiu 1
+expect_count bounds_unroll mul   1
+expect_trap bounds_unroll ''
+
+# --profile-generate adds counters, which print the profile that
+# tests/march.profile records, and --profile-use lays out the rarely
+# taken "return" in h after the hot path.
+compile profile_generate march.cpsl --profile-generate
+expect_line profile_generate '^profile_table:'
+expect_output profile_generate "3
+5" '^profile routine_h if_n_0#1+1 1$'
+compile profile_none march.cpsl
+compile profile_use march.cpsl --profile-use "$TESTS_DIR/march.profile"
+expect_no_line profile_none '_fallthrough:'
+expect_line profile_use '_fallthrough:'
+expect_output profile_use "3
+5" '^3 571$'
+
+if [ "$skipped" -ne 0 ]; then
+	printf 'Skipped %d checks that run programs; set MIPS_SIM to run them.\n' "$skipped"
+fi
+if [ "$failures" -ne 0 ]; then
+	printf '%d of %d checks failed.\n' "$failures" "$checks" >&2
+	exit 1
+fi
+printf 'All %d checks passed.\n' "$checks"
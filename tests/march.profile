@@ -0,0 +1,7 @@
+profile routine_h entry 6
+profile routine_h if_n_0#1 6
+profile routine_h if_n_0#1+1 1
+profile routine_h endif_n_0#1 5
+profile routine_h routine_h_cleanup#1 6
+profile main entry 1
+profile main main_cleanup#1 1